@@ -27,12 +27,12 @@ MpAlarm::MpAlarm( Cpl::Dm::ModelDatabase& myModelBase, const char* symbolicName
 ///////////////////////////////////////////////////////////////////////////////
 uint16_t MpAlarm::acknowledge( LockRequest_T lockRequest ) noexcept
 {
-    m_modelDatabase.lock_();
+    lock_();
 
     Alarm_T newData      = m_data;
     newData.acknowledged = true;
     uint16_t result      = writeData( &newData, sizeof( Alarm_T ), lockRequest );
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
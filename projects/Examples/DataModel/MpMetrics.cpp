@@ -27,7 +27,7 @@ MpMetrics::MpMetrics( Cpl::Dm::ModelDatabase& myModelBase, const char* symbolicN
 ///////////////////////////////////////////////////////////////////////////////
 uint16_t MpMetrics::newSample( uint32_t sampleValue, LockRequest_T lockRequest ) noexcept
 {
-    m_modelDatabase.lock_();
+    lock_();
 
     Metrics_T newData;
     newData           = m_data;
@@ -35,19 +35,19 @@ uint16_t MpMetrics::newSample( uint32_t sampleValue, LockRequest_T lockRequest )
     newData.numSamples++;
 
     uint16_t result = writeData( &newData, sizeof( Metrics_T ), lockRequest );
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
 
 uint16_t MpMetrics::clearAll( LockRequest_T lockRequest ) noexcept
 {
-    m_modelDatabase.lock_();
+    lock_();
 
     Metrics_T newData;  // Note: The default constructor initialize everything to zero
 
     uint16_t result = writeData( &newData, sizeof( Metrics_T ), lockRequest );
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
@@ -43,6 +43,7 @@ namespace Simulator
             m_listener = new Simulator.SocketListener();
 
             m_listener.RegisterCommand(new Simulator.Write(this));
+            m_listener.RegisterCommand(new Simulator.WriteRects(this));
             m_listener.RegisterCommand(new Simulator.UpdateDisplay(this));
             m_listener.RegisterCommand(new Simulator.Led(this));
             m_listener.RegisterCommand(new Simulator.Exit());
@@ -78,6 +78,83 @@ namespace Simulator
 
     }
 
+    // Write LCD 'dirty rectangles' command. Writes one or more run length encoded
+    // rectangles worth of data and then updates the LCD (i.e. the visible screen)
+    // Command Format AFTER the leading (without leading/trailing SOF/EOF framing characters)
+    //
+    // <DD> <HH:MM:SS.sss> writeLCDRects <n> <len> <b64data>
+    // Where:
+    //      <DD>                is CPU time since power-up/reset:  Format is: DD HH:MM:SS.sss
+    //      <HH:MM:SS.sss>      is CPU time since power-up/reset:  Format is: DD HH:MM:SS.sss
+    //      <n>                 Number of rectangles
+    //      <len>               Number of bytes of binary data (after Base64 decoding)
+    //      <b64data>           Binary data encoded as a Base64 string. The binary data is <n> rectangles, each rectangle is:
+    //                              <x0> <w> <y0> <h>   uint16_t values, little endian ordering
+    //                              <rle>               Run length encoded pixels (same pixel layout as writeLCDData).
+    //                                                  The <rle> data is a sequence of a control byte <c> followed by:
+    //                                                      c=0x00-0x7F:  (c+1) literal pixel bytes
+    //                                                      c=0x80-0xFF:  one pixel byte that is repeated (c-0x80+3) times
+    //                                                  Note: runs/literals can span rows
+    public class WriteRects : ICommand
+    {
+        private MainForm m_ui;
+
+        public WriteRects(MainForm ui)
+        {
+            m_ui = ui;
+        }
+
+        public string GetCommandName() { return "writeLCDRects"; }
+        public bool ExecuteCommand(string rawString, List<string> tokenizeString)
+        {
+            // Note: Do not echo the pixel data (it is large)
+            Console.WriteLine("PROCESSING: " + String.Join(" ", tokenizeString.GetRange(0, 5)));
+            int numRects = int.Parse(tokenizeString[3]);
+            int numBytes = int.Parse(tokenizeString[4]);
+            byte[] data = Convert.FromBase64String(tokenizeString[5]);
+            if (data.Length != numBytes)
+            {
+                Console.WriteLine("ERROR: writeLCDRects: data length mismatch: " + data.Length + " != " + numBytes);
+                return true;
+            }
+
+            int dataIndex = 0;
+            for (int r = 0; r < numRects; r++)
+            {
+                int x = data[dataIndex] + (data[dataIndex + 1] << 8);
+                int w = data[dataIndex + 2] + (data[dataIndex + 3] << 8);
+                int y = data[dataIndex + 4] + (data[dataIndex + 5] << 8);
+                int h = data[dataIndex + 6] + (data[dataIndex + 7] << 8);
+                dataIndex += 8;
+
+                int numPixels = w * h;
+                int pixelIndex = 0;
+                while (pixelIndex < numPixels)
+                {
+                    int control = data[dataIndex++];
+                    if (control < 0x80)
+                    {
+                        for (int i = 0; i <= control; i++, pixelIndex++)
+                        {
+                            m_ui.m_lcd.SetPixel(x + pixelIndex % w, y + pixelIndex / w, Utils.ConvertColor(data[dataIndex++]));
+                        }
+                    }
+                    else
+                    {
+                        Color color = Utils.ConvertColor(data[dataIndex++]);
+                        for (int i = 0; i < control - 0x80 + 3; i++, pixelIndex++)
+                        {
+                            m_ui.m_lcd.SetPixel(x + pixelIndex % w, y + pixelIndex / w, color);
+                        }
+                    }
+                }
+            }
+
+            m_ui.UpdateLcd();
+            return true;
+        }
+    }
+
     // Updates the LCD (i.e. the visible screen) with the latest LCD data
     // Command Format AFTER the leading (without leading/trailing SOF/EOF framing characters)
     //
@@ -10,6 +10,7 @@
 *----------------------------------------------------------------------------*/
 
 #include "Crc16CcittFast.h"
+#include "CrcKernels.h"
 
 ///
 using namespace Cpl::Checksum;
@@ -52,6 +53,18 @@ static uint16_t const table_[256] =
 0x6e17, 0x7e36, 0x4e55, 0x5e74, 0x2e93, 0x3eb2, 0x0ed1, 0x1ef0
 };
 
+///////////////////////////////////////
+uint16_t CrcKernels::crc16CcittBytewise( uint16_t crc, const void* bytes, size_t numbytes ) noexcept
+{
+	const uint8_t* ptr = (const uint8_t*) bytes;
+
+	for ( ; numbytes; numbytes--, ptr++ )
+	{
+		crc = table_[( crc >> 8 ^ *ptr ) & 0xffU] ^ ( crc << 8 );
+	}
+	return crc;
+}
+
 ///////////////////////////////////////
 
 Crc16CcittFast::Crc16CcittFast() noexcept
@@ -68,13 +81,11 @@ void Crc16CcittFast::reset( void ) noexcept
 ///////////////////////////////////////
 void Crc16CcittFast::accumulate( const void* bytes, unsigned numbytes ) noexcept
 {
-	unsigned i;
-	uint8_t* ptr = (uint8_t*) bytes;
-
-	for ( i=0; i < numbytes; i++, ptr++ )
-	{
-		m_crc = table_[( m_crc >> 8 ^ *ptr ) & 0xffU] ^ ( m_crc << 8 );
-	}
+#ifdef USE_CPL_CHECKSUM_ACCELERATED_CRC
+	m_crc = CrcKernels::crc16CcittAccelerated( m_crc, bytes, numbytes );
+#else
+	m_crc = CrcKernels::crc16CcittBytewise( m_crc, bytes, numbytes );
+#endif
 }
 
 uint16_t Crc16CcittFast::finalize( void* destBuffer ) noexcept
@@ -10,6 +10,7 @@
 *----------------------------------------------------------------------------*/
 
 #include "Crc32EthernetFast.h"
+#include "CrcKernels.h"
 
 
 using namespace Cpl::Checksum;
@@ -73,6 +74,20 @@ static uint32_t reflect_( uint32_t data, uint8_t nBits )
 #endif
 
 
+///////////////////////////////////////
+uint32_t CrcKernels::crc32EthernetBytewise( uint32_t crc, const void* bytes, size_t numbytes ) noexcept
+{
+	const uint8_t* ptr = (const uint8_t*) bytes;
+
+	for ( ; numbytes; numbytes--, ptr++ )
+	{
+		uint8_t temp = *ptr ^ ( crc >> ( 24 ) );
+		crc          = table_[temp] ^ ( crc << 8 );
+	}
+	return crc;
+}
+
+
 ///////////////////////////////////////
 Crc32EthernetFast::Crc32EthernetFast() noexcept
 {
@@ -88,14 +103,11 @@ void Crc32EthernetFast::reset( void ) noexcept
 ///////////////////////////////////////
 void Crc32EthernetFast::accumulate( const void* bytes, unsigned numbytes ) noexcept
 {
-	unsigned i;
-	uint8_t* ptr = (uint8_t*) bytes;
-
-	for ( i=0; i < numbytes; i++, ptr++ )
-	{
-		uint8_t temp = *ptr ^ ( m_crc >> ( 24 ) );
-		m_crc         = table_[temp] ^ ( m_crc << 8 );
-	}
+#ifdef USE_CPL_CHECKSUM_ACCELERATED_CRC
+	m_crc = CrcKernels::crc32EthernetAccelerated( m_crc, bytes, numbytes );
+#else
+	m_crc = CrcKernels::crc32EthernetBytewise( m_crc, bytes, numbytes );
+#endif
 }
 
 uint32_t Crc32EthernetFast::finalize( void* destBuffer ) noexcept
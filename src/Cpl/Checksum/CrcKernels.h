@@ -0,0 +1,86 @@
+#ifndef Cpl_Checksum_CrcKernels_h_
+#define Cpl_Checksum_CrcKernels_h_
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+/** @file
+
+	The application/build defines USE_CPL_CHECKSUM_ACCELERATED_CRC to have
+	the Crc32EthernetFast and Crc16CcittFast classes use the accelerated()
+	kernels below (vs. the byte-at-a-time table).  This is not the default
+	since the slice-by-8 tables require ~12KB of additional ROM.
+ */
+
+#include "colony_config.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+
+///
+namespace Cpl {
+///
+namespace Checksum {
+
+
+/** This class provides the 'raw' CRC kernels for the CRC algorithms that are
+	implemented by the Crc32EthernetFast and Crc16CcittFast classes.  All of
+	the kernels for a given CRC algorithm produce identical results, i.e. the
+	kernels only differ in their throughput and ROM/RAM foot print.
+
+	The kernels take the current CRC register value (i.e. Api32/Api16
+	semantics: the initial value is ~0, no reflection, no final XOR), and
+	return the updated CRC register value.
+
+		o bytewise() - One byte per iteration using a 256-entry table
+		o slice8()   - Eight bytes per iteration using 8 x 256-entry tables
+		o clmul()    - Carry-less-multiply (x86 PCLMULQDQ) folding of 64 bytes
+					   per iteration. The kernel MUST only be called when
+					   isClmulSupported() returns true.
+		o accelerated() - Uses the fastest kernel supported by the CPU
+					   (selected at run time)
+ */
+class CrcKernels
+{
+public:
+	/// CRC-32 Ethernet (see Crc32EthernetFast): Byte-at-a-time kernel
+	static uint32_t crc32EthernetBytewise( uint32_t crc, const void* bytes, size_t numbytes ) noexcept;
+
+	/// CRC-32 Ethernet (see Crc32EthernetFast): Slice-by-8 kernel
+	static uint32_t crc32EthernetSlice8( uint32_t crc, const void* bytes, size_t numbytes ) noexcept;
+
+	/// CRC-32 Ethernet (see Crc32EthernetFast): Carry-less-multiply kernel
+	static uint32_t crc32EthernetClmul( uint32_t crc, const void* bytes, size_t numbytes ) noexcept;
+
+	/// CRC-32 Ethernet (see Crc32EthernetFast): Fastest available kernel
+	static uint32_t crc32EthernetAccelerated( uint32_t crc, const void* bytes, size_t numbytes ) noexcept;
+
+public:
+	/// CRC-16 CCITT (see Crc16CcittFast): Byte-at-a-time kernel
+	static uint16_t crc16CcittBytewise( uint16_t crc, const void* bytes, size_t numbytes ) noexcept;
+
+	/// CRC-16 CCITT (see Crc16CcittFast): Slice-by-8 kernel
+	static uint16_t crc16CcittSlice8( uint16_t crc, const void* bytes, size_t numbytes ) noexcept;
+
+	/// CRC-16 CCITT (see Crc16CcittFast): Carry-less-multiply kernel
+	static uint16_t crc16CcittClmul( uint16_t crc, const void* bytes, size_t numbytes ) noexcept;
+
+	/// CRC-16 CCITT (see Crc16CcittFast): Fastest available kernel
+	static uint16_t crc16CcittAccelerated( uint16_t crc, const void* bytes, size_t numbytes ) noexcept;
+
+public:
+	/** Returns true if the CPU supports the carry-less-multiply kernels.
+		Always returns false for non-x86 targets.
+	 */
+	static bool isClmulSupported() noexcept;
+};
+
+};      // end namespaces
+};
+#endif  // end header latch
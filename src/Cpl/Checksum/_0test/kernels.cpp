@@ -0,0 +1,153 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+
+#include "Catch/catch.hpp"
+#include "Cpl/System/_testsupport/Shutdown_TS.h"
+#include "Cpl/System/Trace.h"
+#include "Cpl/Checksum/CrcKernels.h"
+#include "Cpl/Checksum/Crc16CcittFast.h"
+#include "Cpl/Checksum/Crc32EthernetFast.h"
+#include <chrono>
+#include <stdlib.h>
+
+
+///
+using namespace Cpl::Checksum;
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+#define SECT_               "_0test"
+
+#define MAX_BUFLEN_         (64*1024 + 64)
+
+static uint8_t buffer_[MAX_BUFLEN_];
+
+static void fillBuffer()
+{
+	srand( 42 );
+	for ( size_t i=0; i < sizeof( buffer_ ); i++ )
+	{
+		buffer_[i] = (uint8_t) rand();
+	}
+}
+
+
+/////////////////////////////
+TEST_CASE( "CrcKernels", "[crckernels]" )
+{
+	Cpl::System::Shutdown_TS::clearAndUseCounter();
+	fillBuffer();
+	CPL_SYSTEM_TRACE_MSG( SECT_, ( "Carry-less-multiply supported: %s", CrcKernels::isClmulSupported() ? "yes" : "no" ) );
+
+	SECTION( "crc32" )
+	{
+		// All lengths/alignments around the block sizes (8, 16, 64 bytes) and a 'random' starting CRC
+		for ( size_t offset=0; offset < 8; offset++ )
+		{
+			for ( size_t len=0; len < 300; len++ )
+			{
+				uint32_t seed     = len & 1 ? 0xFFFFFFFF : 0x12345678 + (uint32_t) len;
+				uint32_t expected = CrcKernels::crc32EthernetBytewise( seed, buffer_ + offset, len );
+				REQUIRE( CrcKernels::crc32EthernetSlice8( seed, buffer_ + offset, len ) == expected );
+				REQUIRE( CrcKernels::crc32EthernetClmul( seed, buffer_ + offset, len ) == expected );
+				REQUIRE( CrcKernels::crc32EthernetAccelerated( seed, buffer_ + offset, len ) == expected );
+			}
+		}
+
+		// Large buffer
+		uint32_t expected = CrcKernels::crc32EthernetBytewise( 0xFFFFFFFF, buffer_ + 3, MAX_BUFLEN_ - 3 );
+		REQUIRE( CrcKernels::crc32EthernetSlice8( 0xFFFFFFFF, buffer_ + 3, MAX_BUFLEN_ - 3 ) == expected );
+		REQUIRE( CrcKernels::crc32EthernetClmul( 0xFFFFFFFF, buffer_ + 3, MAX_BUFLEN_ - 3 ) == expected );
+
+		// The CRC class (multiple accumulate calls)
+		Crc32EthernetFast crc;
+		crc.accumulate( buffer_, 5 );
+		crc.accumulate( buffer_ + 5, 1000 );
+		crc.accumulate( buffer_ + 1005, MAX_BUFLEN_ - 1005 );
+		REQUIRE( crc.finalize() == CrcKernels::crc32EthernetBytewise( 0xFFFFFFFF, buffer_, MAX_BUFLEN_ ) );
+	}
+
+	SECTION( "crc16" )
+	{
+		for ( size_t offset=0; offset < 8; offset++ )
+		{
+			for ( size_t len=0; len < 300; len++ )
+			{
+				uint16_t seed     = len & 1 ? 0xFFFF : 0x1234 + (uint16_t) len;
+				uint16_t expected = CrcKernels::crc16CcittBytewise( seed, buffer_ + offset, len );
+				REQUIRE( CrcKernels::crc16CcittSlice8( seed, buffer_ + offset, len ) == expected );
+				REQUIRE( CrcKernels::crc16CcittClmul( seed, buffer_ + offset, len ) == expected );
+				REQUIRE( CrcKernels::crc16CcittAccelerated( seed, buffer_ + offset, len ) == expected );
+			}
+		}
+
+		uint16_t expected = CrcKernels::crc16CcittBytewise( 0xFFFF, buffer_ + 3, MAX_BUFLEN_ - 3 );
+		REQUIRE( CrcKernels::crc16CcittSlice8( 0xFFFF, buffer_ + 3, MAX_BUFLEN_ - 3 ) == expected );
+		REQUIRE( CrcKernels::crc16CcittClmul( 0xFFFF, buffer_ + 3, MAX_BUFLEN_ - 3 ) == expected );
+
+		Crc16CcittFast crc;
+		crc.accumulate( buffer_, 5 );
+		crc.accumulate( buffer_ + 5, 1000 );
+		crc.accumulate( buffer_ + 1005, MAX_BUFLEN_ - 1005 );
+		REQUIRE( crc.finalize() == CrcKernels::crc16CcittBytewise( 0xFFFF, buffer_, MAX_BUFLEN_ ) );
+	}
+
+	REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 0u );
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+typedef std::chrono::steady_clock Clock_T;
+
+#define BENCH_TOTAL_BYTES_  (64*1024*1024)
+
+/// Prevents the compiler from discarding the results
+static volatile uint32_t sink_;
+
+/// Runs 'kernel' over BENCH_TOTAL_BYTES_ of data.  Returns the throughput in MB/s
+template <class CRC, class KERNEL>
+static double bench( const char* label, KERNEL kernel, size_t len )
+{
+	size_t                iterations = BENCH_TOTAL_BYTES_ / len;
+	CRC                   crc        = (CRC) ~0;
+	Clock_T::time_point   start      = Clock_T::now();
+	for ( size_t i=0; i < iterations; i++ )
+	{
+		crc = kernel( crc, buffer_, len );
+	}
+	double elapsed  = std::chrono::duration<double>( Clock_T::now() - start ).count();
+	double mbPerSec = ( iterations * len ) / ( elapsed * 1024 * 1024 );
+	sink_           = crc;
+	CPL_SYSTEM_TRACE_MSG( SECT_, ( "%-16s len=%6lu: %8.1f MB/s", label, (unsigned long) len, mbPerSec ) );
+	return mbPerSec;
+}
+
+TEST_CASE( "CrcKernels-bench", "[.bench]" )
+{
+	fillBuffer();
+	static const size_t sizes[] = { 16, 64, 256, 1024, 4096, 64 * 1024 };
+	for ( size_t i=0; i < sizeof( sizes ) / sizeof( sizes[0] ); i++ )
+	{
+		bench<uint32_t>( "crc32 bytewise", CrcKernels::crc32EthernetBytewise, sizes[i] );
+		bench<uint32_t>( "crc32 slice8", CrcKernels::crc32EthernetSlice8, sizes[i] );
+		if ( CrcKernels::isClmulSupported() )
+		{
+			bench<uint32_t>( "crc32 clmul", CrcKernels::crc32EthernetClmul, sizes[i] );
+		}
+		bench<uint16_t>( "crc16 bytewise", CrcKernels::crc16CcittBytewise, sizes[i] );
+		bench<uint16_t>( "crc16 slice8", CrcKernels::crc16CcittSlice8, sizes[i] );
+		if ( CrcKernels::isClmulSupported() )
+		{
+			bench<uint16_t>( "crc16 clmul", CrcKernels::crc16CcittClmul, sizes[i] );
+		}
+	}
+}
@@ -0,0 +1,146 @@
+#ifndef Cpl_Container_MpscQueue_h_
+#define Cpl_Container_MpscQueue_h_
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+/** @file */
+
+#include "Cpl/Container/Item.h"
+#include <atomic>
+
+///
+namespace Cpl {
+///
+namespace Container {
+
+
+/** This template class implements a lock-free, intrusive, Multi-Producer,
+    Single-Consumer (MPSC) queue.  Any number of threads can put() items into
+    the queue - without using a lock - and a SINGLE consumer thread removes
+    ALL of the queued items at once using getAll().
+
+    The queue is implemented as an atomic 'stack' of items.  The producers
+    push items using a compare-and-swap loop, and the consumer 'takes' the
+    entire stack with a single atomic exchange and then reverses it so that
+    the items are transferred to the consumer's (non thread safe) container in
+    FIFO order.  The typical usage is for the consumer to keep a private
+    SList/DList of pending items that it refills from the MPSC queue when the
+    private list is empty.
+
+    NOTES:
+        o The implementation requires the platform to support lock-free
+          std::atomic pointer operations (i.e. compare-and-swap).  Do NOT use
+          this class on targets that do not have native CAS instructions (e.g.
+          Cortex-M0) - use a GlobalLock/Mutex protected SList instead.
+        o An item can only be in ONE container at a time (i.e. the same item
+          can NOT be put into the queue again until it has been removed via
+          getAll()).
+
+    Template Args:
+        ITEM:=      Type of the data stored in the queue.  'ITEM' must be a
+                    sub-class of Cpl::Container::Item
+ */
+template <class ITEM>
+class MpscQueue
+{
+public:
+    /// Public constructor initializes the queue to empty.
+    MpscQueue() noexcept :m_head( nullptr ) {}
+
+    /** This is a special constructor for when the queue is statically
+        declared (i.e. it is initialized as part of C++ startup BEFORE main()
+        is executed).  C/C++ guarantees that all statically declared data will
+        be initialized to zero by default (see r.8.4 in C++ Programming
+        Language, Second Edition).
+     */
+    MpscQueue( const char* ignoreThisParameter_usedToCreateAUniqueConstructor ) noexcept {}
+
+
+public:
+    /** Adds an item to the queue.  This method IS thread safe and can be
+        called from any thread.
+     */
+    void put( ITEM& item ) noexcept
+    {
+        if ( item.insert_( this ) )
+        {
+            ITEM* oldHead = m_head.load( std::memory_order_relaxed );
+            do
+            {
+                item.m_nextPtr_ = oldHead;
+            } while ( !m_head.compare_exchange_weak( oldHead, &item, std::memory_order_release, std::memory_order_relaxed ) );
+        }
+    }
+
+    /** Moves ALL of the queued items - in FIFO order - to the end of the
+        'dst' container (i.e. SList or DList).  Returns true if at least one
+        item was moved.
+
+        This method is NOT thread safe, i.e. it can only be called from the
+        consumer thread.
+     */
+    template <class LIST>
+    bool getAll( LIST& dst ) noexcept
+    {
+        ITEM* itemPtr = m_head.exchange( nullptr, std::memory_order_acquire );
+        if ( itemPtr == nullptr )
+        {
+            return false;
+        }
+
+        // Reverse the stack, i.e. convert it to a FIFO list
+        ITEM* fifoPtr = nullptr;
+        while ( itemPtr )
+        {
+            ITEM* nextPtr       = (ITEM*) itemPtr->m_nextPtr_;
+            itemPtr->m_nextPtr_ = fifoPtr;
+            fifoPtr             = itemPtr;
+            itemPtr             = nextPtr;
+        }
+
+        // Transfer the items (note: the destination container overwrites the item's link field)
+        while ( fifoPtr )
+        {
+            ITEM* nextPtr = (ITEM*) fifoPtr->m_nextPtr_;
+            Item::remove_( fifoPtr );
+            dst.put( *fifoPtr );
+            fifoPtr = nextPtr;
+        }
+        return true;
+    }
+
+    /** Returns true if the queue is empty.  This method IS thread safe -
+        however the result is only a 'snapshot' of the queue's state, i.e. it
+        is only reliable when called from the consumer thread (and then it is
+        only reliable for a 'false' result).
+     */
+    bool isEmpty() const noexcept
+    {
+        return m_head.load( std::memory_order_acquire ) == nullptr;
+    }
+
+
+protected:
+    /// Head of the stack of queued items (most recently added item)
+    std::atomic<ITEM*>  m_head;
+
+
+private:
+    /// Prevent access to the copy constructor -->Containers can not be copied!
+    MpscQueue( const MpscQueue& m );
+
+    /// Prevent access to the assignment operator -->Containers can not be copied!
+    const MpscQueue& operator=( const MpscQueue& m );
+};
+
+
+};      // end namespaces
+};
+#endif  // end header latch
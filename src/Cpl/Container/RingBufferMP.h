@@ -27,6 +27,13 @@ namespace Container {
     size of the ring buffer is limited by number of bits in platform's 'unsigned'
     data type.
 
+    By default the element-count Model Point is updated on every add/remove
+    operation.  When the count is only used to monitor the 'fill level' of
+    the buffer, the application can call setPublishThresholds() so that the
+    Model Point is ONLY updated when the element count crosses a threshold -
+    which eliminates the MP write (and the change notifications) from the
+    majority of add/remove operations.
+
     Template Args:
         ITEM:=      Type of the data stored in the Ring Buffer
  */
@@ -42,6 +49,9 @@ public:
     RingBufferMP( unsigned maxElements, ITEM memoryForElements[], Cpl::Dm::Mp::Uint32& mpElementCount ) noexcept
         : RingBufferMT<ITEM>( maxElements, memoryForElements )
         , m_mpElementCount( mpElementCount )
+        , m_lowThreshold( 0 )
+        , m_highThreshold( 0 )
+        , m_lastZone( -1 )
     {
         // NOTE: I would really like to initialize the model point here in the constructor - BUT
         //       if this class is statically created/allocated - that is problem because the CPL
@@ -51,25 +61,54 @@ public:
 
 
 
+public:
+    /** This method configures the element-count Model Point to only be
+        updated when the number of elements in the buffer crosses a threshold,
+        i.e. when the count moves between the 'zones':
+            [0, lowThreshold), [lowThreshold, highThreshold), [highThreshold, max]
+
+        When the MP is updated, it is set to the actual element count.  For
+        example setPublishThresholds(1,N) publishes the empty/not-empty and the
+        'high water' transitions.  Setting both thresholds to zero restores the
+        default behavior of updating the MP on every add/remove operation.
+     */
+    void setPublishThresholds( unsigned lowThreshold, unsigned highThreshold ) noexcept
+    {
+        Cpl::System::Mutex::ScopeBlock criticalSection( this->m_lock );
+        m_lowThreshold  = lowThreshold;
+        m_highThreshold = highThreshold < lowThreshold ? lowThreshold : highThreshold;
+        m_lastZone      = -1;
+    }
+
 public:
     /// See Cpl::Container::RingBuffer.
     bool remove( ITEM& dst ) noexcept
     {
-        bool result = RingBufferMT<ITEM>::remove( dst );
-        if ( result )
-        {
-            decrementMp();
-        }
-        return result;
+        uint16_t seqNum;
+        return remove( dst, seqNum );
     }
 
-    /// Extends remove() to expose/return the MP's sequence number on the update
+    /** Extends remove() to expose/return the MP's sequence number on the
+        update.  Note: When publishing on threshold crossings, 'seqNum' is the
+        MP's current sequence number if the MP was not updated.
+     */
     bool remove( ITEM& dst, uint16_t& seqNum ) noexcept
     {
-        bool result = RingBufferMT<ITEM>::remove( dst );
+        if ( m_highThreshold == 0 )
+        {
+            bool result = RingBufferMT<ITEM>::remove( dst );
+            if ( result )
+            {
+                seqNum = decrementMp();
+            }
+            return result;
+        }
+
+        Cpl::System::Mutex::ScopeBlock criticalSection( this->m_lock );
+        bool result = RingBuffer<ITEM>::remove( dst );
         if ( result )
         {
-            seqNum = decrementMp();
+            seqNum = publishOnThreshold();
         }
         return result;
     }
@@ -77,21 +116,31 @@ public:
     /// See Cpl::Container::RingBuffer.
     bool add( const ITEM& item ) noexcept
     {
-        bool result = RingBufferMT<ITEM>::add( item );
-        if ( result )
-        {
-            incrementMp();
-        }
-        return result;
+        uint16_t seqNum;
+        return add( item, seqNum );
     }
 
-    /// Extends add() to expose/return the MP's sequence number on the update
+    /** Extends add() to expose/return the MP's sequence number on the update.
+        Note: When publishing on threshold crossings, 'seqNum' is the MP's
+        current sequence number if the MP was not updated.
+     */
     bool add( const ITEM& item, uint16_t& seqNum ) noexcept
     {
-        bool result = RingBufferMT<ITEM>::add( item );
+        if ( m_highThreshold == 0 )
+        {
+            bool result = RingBufferMT<ITEM>::add( item );
+            if ( result )
+            {
+                seqNum = incrementMp();
+            }
+            return result;
+        }
+
+        Cpl::System::Mutex::ScopeBlock criticalSection( this->m_lock );
+        bool result = RingBuffer<ITEM>::add( item );
         if ( result )
         {
-            seqNum =  incrementMp();
+            seqNum = publishOnThreshold();
         }
         return result;
     }
@@ -100,15 +149,17 @@ public:
     /// See Cpl::Container::RingBuffer.
     void clearTheBuffer() noexcept
     {
-        RingBufferMT<ITEM>::clearTheBuffer();
-        m_mpElementCount.write( 0 );
+        uint16_t seqNum;
+        clearTheBuffer( seqNum );
     }
 
     /// Extends add() to expose/return the MP's sequence number on the update
     void clearTheBuffer( uint16_t& seqNum ) noexcept
     {
-        RingBufferMT<ITEM>::clearTheBuffer();
-        seqNum = m_mpElementCount.write( 0 );
+        Cpl::System::Mutex::ScopeBlock criticalSection( this->m_lock );
+        RingBuffer<ITEM>::clearTheBuffer();
+        m_lastZone = -1;
+        seqNum     = m_mpElementCount.write( 0 );
     }
 
 protected:
@@ -134,6 +185,19 @@ protected:
         return m_mpElementCount.decrement();
     }
 
+    /// helper method that updates the MP when the element count moves to a different threshold zone.  Note: Must be called while holding m_lock
+    uint16_t publishOnThreshold() noexcept
+    {
+        unsigned numItems = RingBuffer<ITEM>::getNumItems();
+        int      zone     = numItems < m_lowThreshold ? 0 : numItems < m_highThreshold ? 1 : 2;
+        if ( zone != m_lastZone || m_mpElementCount.isNotValid() )
+        {
+            m_lastZone = zone;
+            return m_mpElementCount.write( numItems );
+        }
+        return m_mpElementCount.getSequenceNumber();
+    }
+
 private:
     /// Prevent access to the copy constructor -->Containers can not be copied!
     RingBufferMP( const RingBufferMP& m );
@@ -144,6 +208,16 @@ private:
 public:
     /// Model point to report my element count.  NOTE: Public access is allowed to simply the application subscribing/accessing the MP
     Cpl::Dm::Mp::Uint32& m_mpElementCount;
+
+protected:
+    /// Lower publish threshold
+    unsigned             m_lowThreshold;
+
+    /// Upper publish threshold (zero when publishing on every add/remove)
+    unsigned             m_highThreshold;
+
+    /// Threshold zone of the last published element count (-1 when not published)
+    int                  m_lastZone;
 };
 
 
@@ -0,0 +1,416 @@
+#ifndef Cpl_Container_RingBuffer_SPSC_h_
+#define Cpl_Container_RingBuffer_SPSC_h_
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+/** @file */
+
+#include <atomic>
+
+
+///
+namespace  Cpl {
+///
+namespace Container {
+
+
+/** This template class implements a lock-free, Single-Producer,
+    Single-Consumer (SPSC) Ring Buffer.  The size of the ring buffer is limited
+    by number of bits in platform's 'unsigned' data type.
+
+    The head and tail indexes are std::atomic variables.  The producer is the
+    only writer of the tail index and the consumer is the only writer of the
+    head index.  The producer 'publishes' new items with a release store of
+    the tail index and the consumer 'frees' slots with a release store of the
+    head index - so no mutex is required when there is exactly ONE producer
+    thread/ISR and exactly ONE consumer thread/ISR.
+
+    Thread/ISR Safety Notes:
+        - Producer side methods: add(), addElements(), peekNextAddItems(),
+          peekTail(), isFull()
+        - Consumer side methods: remove(), removeElements(),
+          peekNextRemoveItems(), peekHead(), isEmpty()
+        - getNumItems() can be called from either side.  The result is only a
+          'snapshot' of the buffer's state.
+        - clearTheBuffer() is NOT thread safe, i.e. it can only be called when
+          neither the producer nor the consumer is accessing the buffer.
+        - The implementation requires the platform to support lock-free
+          std::atomic<unsigned> load/store operations.
+
+    Template Args:
+        ITEM:=      Type of the data stored in the Ring Buffer
+ */
+template <class ITEM>
+class RingBufferSPSC
+{
+private:
+    /// Index of the first item in the buffer (only written by the consumer)
+    std::atomic<unsigned>   m_head;
+
+    /// Index of the next free slot in the buffer (only written by the producer)
+    std::atomic<unsigned>   m_tail;
+
+    /// Number of element in the allocate memory
+    const unsigned          m_memoryNumElements;
+
+    /// Memory for the Elements
+    ITEM* const             m_elements;
+
+
+public:
+    /** Constructor.  The application is responsible for providing the memory
+        for the Ring Buffer.  The argument ''numElements' is the number of
+        items that will fit in the memory allocated by 'memoryForElements' - it
+        is NOT the number of bytes of 'memoryForElements'.
+
+        Note: The maximum number of element that can actually be stored is
+              numElements - 1 (one element/index/slot is consumed/used to
+              represents the empty buffer state).
+     */
+    RingBufferSPSC( unsigned numElements, ITEM memoryForElements[] ) noexcept;
+
+
+public:
+    /** Removes the first item in the Buffer. The contents of the removed item
+        will be copied into the 'dst' argument. The method return true if the
+        operation was successful; else false is returned, i.e. the Ring buffer
+        is/was empty.  Consumer ONLY.
+     */
+    bool remove( ITEM& dst ) noexcept;
+
+    /** The contents of 'item' will be copied into the Ring Buffer as the
+        'last' item in the  buffer. Return true if the operation was
+        successful; else false is returned, i.e. the Buffer was full prior to
+        the attempted add().  Producer ONLY.
+     */
+    bool add( const ITEM& item ) noexcept;
+
+    /** Copies up to 'maxElements' items from the Buffer into 'dst'.  The
+        method returns the number of items removed, i.e. zero if the buffer
+        was empty.  The head index is updated ONCE for the entire transfer.
+        Consumer ONLY.
+     */
+    unsigned removeElements( ITEM dst[], unsigned maxElements ) noexcept;
+
+    /** Copies up to 'numElements' items from 'src' into the Buffer.  The
+        method returns the number of items added, i.e. less than 'numElements'
+        if the buffer became full.  The tail index is updated ONCE for the
+        entire transfer.  Producer ONLY.
+     */
+    unsigned addElements( const ITEM src[], unsigned numElements ) noexcept;
+
+
+    /** Returns a pointer to the first item in the Buffer.  The returned item
+        remains in the buffer.  Returns 0 if the Buffer is empty.  Consumer ONLY.
+     */
+    ITEM* peekHead( void ) const noexcept;
+
+    /** Returns a pointer to the last item in the Buffer.  The returned item
+        remains in the Buffer.  Returns 0 if the Buffer is empty.  Producer ONLY.
+     */
+    ITEM* peekTail( void ) const noexcept;
+
+
+public:
+    /// This method returns true if the Ring Buffer is empty
+    bool isEmpty( void ) const noexcept;
+
+    /// This method returns true if the Ring Buffer is full
+    bool isFull( void ) const noexcept;
+
+    /// This method returns the current number of items in the Ring Buffer
+    unsigned getNumItems( void ) const noexcept;
+
+    /// This method returns the maximum number of items that can be stored in the Ring buffer.
+    unsigned getMaxItems( void ) const noexcept;
+
+
+public:
+    /** Empties the Ring Buffer.  All references to the item(s) in the buffer
+        are lost.  This method is NOT thread safe.
+     */
+    void clearTheBuffer() noexcept;
+
+
+public:
+    /** This method returns a pointer to the next item to be removed. In
+        addition it returns the number of elements that can be removed as
+        linear/flat buffer (i.e. without wrapping around raw buffer memory).
+
+        If the Ring buffer is empty, a null pointer is returned (and
+        'dstNumFlatElements' is set to zero).  Consumer ONLY.
+     */
+    ITEM* peekNextRemoveItems( unsigned& dstNumFlatElements ) noexcept;
+
+    /** This method 'removes' N elements - that were removed using the
+        pointer returned from peekNextRemoveItems - from the ring buffer.
+        Basically it updates the head index to reflect items removed using
+        direct memory access.  Consumer ONLY.
+
+        'numElementsToRemove' be less than or equal to the 'dstNumFlatElements'
+        returned from peekNextRemoveItems().
+
+        CAUTION: IF YOU DON'T UNDERSTAND THE USE CASE FOR THIS METHOD - THEN
+                 DON'T USE IT.  If this method is used improperly, it WILL
+                 CORRUPT the Ring Buffer!
+     */
+    void removeElements( unsigned numElementsToRemove ) noexcept;
+
+public:
+    /** This method returns a pointer to the next item to be added. In addition
+        it returns the number of elements that can be added as linear/flat
+        buffer (i.e. without wrapping around raw buffer memory).
+
+        If the Ring buffer is full, a null pointer is returned (and
+        'dstNumFlatElements' is set to zero).  Producer ONLY.
+     */
+    ITEM* peekNextAddItems( unsigned& dstNumFlatElements ) noexcept;
+
+    /** This method 'adds' N elements - that were populated using the
+        pointer returned from peekNextAddItems - to the ring buffer.  Basically
+        its updates the tail index to reflect items added using direct
+        memory access.  The new items are NOT visible to the consumer until
+        this method is called.  Producer ONLY.
+
+        'numElementsAdded' be less than or equal to the 'dstNumFlatElements'
+        returned from peekNextAddItems().
+
+        CAUTION: IF YOU DON'T UNDERSTAND THE USE CASE FOR THIS METHOD - THEN
+                 DON'T USE IT. If this method is used improperly, it WILL
+                 CORRUPT the Ring Buffer!
+     */
+    void addElements( unsigned numElementsAdded ) noexcept;
+
+
+protected:
+    /// Helper method that advances an index (with wrap around)
+    inline unsigned advance( unsigned idx, unsigned numElements ) const noexcept
+    {
+        idx += numElements;
+        return idx >= m_memoryNumElements ? idx - m_memoryNumElements : idx;
+    }
+
+    /// Helper method that returns the number of items given a head/tail index
+    inline unsigned count( unsigned head, unsigned tail ) const noexcept
+    {
+        return tail >= head ? tail - head : tail + m_memoryNumElements - head;
+    }
+
+
+private:
+    /// Prevent access to the copy constructor -->Containers can not be copied!
+    RingBufferSPSC( const RingBufferSPSC& m );
+
+    /// Prevent access to the assignment operator -->Containers can not be copied!
+    const RingBufferSPSC& operator=( const RingBufferSPSC& m );
+};
+
+
+/////////////////////////////////////////////////////////////////////////////
+//                  INLINE IMPLEMENTAION
+/////////////////////////////////////////////////////////////////////////////
+
+template <class ITEM>
+RingBufferSPSC<ITEM>::RingBufferSPSC( unsigned maxElements, ITEM memoryForElements[] ) noexcept
+    : m_head( 0 )
+    , m_tail( 0 )
+    , m_memoryNumElements( maxElements )
+    , m_elements( memoryForElements )
+{
+}
+
+template <class ITEM>
+inline void RingBufferSPSC<ITEM>::clearTheBuffer() noexcept
+{
+    m_head.store( 0, std::memory_order_relaxed );
+    m_tail.store( 0, std::memory_order_release );
+}
+
+
+template <class ITEM>
+inline bool RingBufferSPSC<ITEM>::add( const ITEM& item ) noexcept
+{
+    unsigned tail     = m_tail.load( std::memory_order_relaxed );
+    unsigned nextTail = advance( tail, 1 );
+    if ( nextTail == m_head.load( std::memory_order_acquire ) )
+    {
+        return false;
+    }
+
+    m_elements[tail] = item;
+    m_tail.store( nextTail, std::memory_order_release );
+    return true;
+}
+
+template <class ITEM>
+inline bool RingBufferSPSC<ITEM>::remove( ITEM& dst ) noexcept
+{
+    unsigned head = m_head.load( std::memory_order_relaxed );
+    if ( head == m_tail.load( std::memory_order_acquire ) )
+    {
+        return false;
+    }
+
+    dst = m_elements[head];
+    m_head.store( advance( head, 1 ), std::memory_order_release );
+    return true;
+}
+
+template <class ITEM>
+inline unsigned RingBufferSPSC<ITEM>::addElements( const ITEM src[], unsigned numElements ) noexcept
+{
+    unsigned tail  = m_tail.load( std::memory_order_relaxed );
+    unsigned avail = getMaxItems() - count( m_head.load( std::memory_order_acquire ), tail );
+    if ( numElements > avail )
+    {
+        numElements = avail;
+    }
+
+    // Copy the items BEFORE publishing the new tail index
+    unsigned idx = tail;
+    for ( unsigned i=0; i < numElements; i++ )
+    {
+        m_elements[idx] = src[i];
+        if ( ++idx >= m_memoryNumElements )
+        {
+            idx = 0;
+        }
+    }
+
+    m_tail.store( idx, std::memory_order_release );
+    return numElements;
+}
+
+template <class ITEM>
+inline unsigned RingBufferSPSC<ITEM>::removeElements( ITEM dst[], unsigned maxElements ) noexcept
+{
+    unsigned head     = m_head.load( std::memory_order_relaxed );
+    unsigned numItems = count( head, m_tail.load( std::memory_order_acquire ) );
+    if ( maxElements > numItems )
+    {
+        maxElements = numItems;
+    }
+
+    unsigned idx = head;
+    for ( unsigned i=0; i < maxElements; i++ )
+    {
+        dst[i] = m_elements[idx];
+        if ( ++idx >= m_memoryNumElements )
+        {
+            idx = 0;
+        }
+    }
+
+    m_head.store( idx, std::memory_order_release );
+    return maxElements;
+}
+
+
+template <class ITEM>
+inline ITEM* RingBufferSPSC<ITEM>::peekNextRemoveItems( unsigned& dstNumFlatElements ) noexcept
+{
+    unsigned head     = m_head.load( std::memory_order_relaxed );
+    unsigned numItems = count( head, m_tail.load( std::memory_order_acquire ) );
+    if ( numItems == 0 )
+    {
+        dstNumFlatElements = 0;
+        return nullptr;
+    }
+
+    dstNumFlatElements = m_memoryNumElements - head;
+    if ( dstNumFlatElements > numItems )
+    {
+        dstNumFlatElements = numItems;
+    }
+    return m_elements + head;
+}
+
+template <class ITEM>
+inline void RingBufferSPSC<ITEM>::removeElements( unsigned numElementsToRemove ) noexcept
+{
+    m_head.store( advance( m_head.load( std::memory_order_relaxed ), numElementsToRemove ), std::memory_order_release );
+}
+
+template <class ITEM>
+inline ITEM* RingBufferSPSC<ITEM>::peekNextAddItems( unsigned& dstNumFlatElements ) noexcept
+{
+    unsigned tail  = m_tail.load( std::memory_order_relaxed );
+    unsigned avail = getMaxItems() - count( m_head.load( std::memory_order_acquire ), tail );
+    if ( avail == 0 )
+    {
+        dstNumFlatElements = 0;
+        return nullptr;
+    }
+
+    dstNumFlatElements = m_memoryNumElements - tail;
+    if ( dstNumFlatElements > avail )
+    {
+        dstNumFlatElements = avail;
+    }
+    return m_elements + tail;
+}
+
+template <class ITEM>
+inline void RingBufferSPSC<ITEM>::addElements( unsigned numElementsAdded ) noexcept
+{
+    m_tail.store( advance( m_tail.load( std::memory_order_relaxed ), numElementsAdded ), std::memory_order_release );
+}
+
+template <class ITEM>
+inline ITEM* RingBufferSPSC<ITEM>::peekHead( void ) const noexcept
+{
+    unsigned head = m_head.load( std::memory_order_relaxed );
+    if ( head == m_tail.load( std::memory_order_acquire ) )
+    {
+        return 0;
+    }
+    return m_elements + head;
+}
+
+template <class ITEM>
+inline ITEM* RingBufferSPSC<ITEM>::peekTail( void ) const noexcept
+{
+    unsigned tail = m_tail.load( std::memory_order_relaxed );
+    if ( tail == m_head.load( std::memory_order_acquire ) )
+    {
+        return 0;
+    }
+    return m_elements + (tail == 0 ? m_memoryNumElements - 1 : tail - 1);
+}
+
+
+template <class ITEM>
+inline bool RingBufferSPSC<ITEM>::isEmpty( void ) const noexcept
+{
+    return m_head.load( std::memory_order_acquire ) == m_tail.load( std::memory_order_acquire );
+}
+
+template <class ITEM>
+inline bool RingBufferSPSC<ITEM>::isFull( void ) const noexcept
+{
+    return advance( m_tail.load( std::memory_order_acquire ), 1 ) == m_head.load( std::memory_order_acquire );
+}
+
+template <class ITEM>
+inline unsigned RingBufferSPSC<ITEM>::getNumItems( void ) const noexcept
+{
+    return count( m_head.load( std::memory_order_acquire ), m_tail.load( std::memory_order_acquire ) );
+}
+
+template <class ITEM>
+inline unsigned RingBufferSPSC<ITEM>::getMaxItems( void ) const noexcept
+{
+    return m_memoryNumElements - 1;   // One elem/slot is reserved for the empty-list condition
+}
+
+
+};      // end namespaces
+};
+#endif  // end header latch
@@ -0,0 +1,258 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+
+#include "Catch/catch.hpp"
+#include "Cpl/Container/MpscQueue.h"
+#include "Cpl/Container/SList.h"
+#include "Cpl/Container/DList.h"
+#include "Cpl/System/Thread.h"
+#include "Cpl/System/Api.h"
+#include "Cpl/System/GlobalLock.h"
+#include "Cpl/System/ElapsedTime.h"
+#include "Cpl/System/Trace.h"
+#include "Cpl/System/_testsupport/Shutdown_TS.h"
+
+
+///
+using namespace Cpl::Container;
+///
+using namespace Cpl::System;
+
+#define SECT_   "_0test"
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Use un-named namespace to make my class local-to-the-file in scope
+namespace {
+
+class MyItem : public ExtendedItem
+{
+public:
+    ///
+    MyItem():m_producer( 0 ), m_seqNum( 0 ) {}
+    ///
+    unsigned m_producer;
+    ///
+    unsigned m_seqNum;
+};
+
+/// Puts N items into the queue (or into a GlobalLock protected list)
+class Producer : public Runnable
+{
+public:
+    ///
+    MpscQueue<MyItem>*  m_queue;
+    ///
+    SList<MyItem>*      m_lockedList;
+    ///
+    MyItem*             m_items;
+    ///
+    unsigned            m_numItems;
+    ///
+    unsigned            m_id;
+
+    ///
+    Producer():m_queue( 0 ), m_lockedList( 0 ), m_items( 0 ), m_numItems( 0 ), m_id( 0 ) {}
+
+    ///
+    void appRun()
+    {
+        for ( unsigned i=0; i < m_numItems; i++ )
+        {
+            m_items[i].m_producer = m_id;
+            m_items[i].m_seqNum   = i;
+            if ( m_queue )
+            {
+                m_queue->put( m_items[i] );
+            }
+            else
+            {
+                GlobalLock::begin();
+                m_lockedList->put( m_items[i] );
+                GlobalLock::end();
+            }
+        }
+    }
+};
+
+}; // end namespace
+
+
+////////////////////////////////////////////////////////////////////////////////
+static MpscQueue<MyItem> staticQueue_( "static constructor" );
+
+#define MAX_PRODUCERS_      16
+
+/// Runs 'numProducers' threads and drains the queue/list in the current thread.  Returns elapsed time in msec
+static unsigned long runProducers( unsigned numProducers, unsigned itemsPerProducer, bool lockFree, unsigned& outOfOrder )
+{
+    MpscQueue<MyItem> queue;
+    SList<MyItem>     lockedList;
+    SList<MyItem>     received;
+    Producer          producers[MAX_PRODUCERS_];
+    Thread*           threads[MAX_PRODUCERS_];
+    unsigned          lastSeqNum[MAX_PRODUCERS_];
+    unsigned          count = 0;
+    unsigned          total = numProducers * itemsPerProducer;
+    outOfOrder              = 0;
+
+    for ( unsigned i=0; i < numProducers; i++ )
+    {
+        producers[i].m_queue      = lockFree ? &queue : 0;
+        producers[i].m_lockedList = &lockedList;
+        producers[i].m_items      = new MyItem[itemsPerProducer];
+        producers[i].m_numItems   = itemsPerProducer;
+        producers[i].m_id         = i;
+        lastSeqNum[i]             = 0;
+    }
+
+    unsigned long start = ElapsedTime::milliseconds();
+    for ( unsigned i=0; i < numProducers; i++ )
+    {
+        threads[i] = Thread::create( producers[i], "PRODUCER" );
+    }
+
+    // Consume
+    while ( count < total )
+    {
+        if ( lockFree )
+        {
+            queue.getAll( received );
+        }
+        else
+        {
+            GlobalLock::begin();
+            lockedList.move( received );
+            GlobalLock::end();
+        }
+
+        MyItem* itemPtr;
+        while ( (itemPtr=received.get()) )
+        {
+            if ( itemPtr->m_seqNum != 0 && itemPtr->m_seqNum != lastSeqNum[itemPtr->m_producer] + 1 )
+            {
+                outOfOrder++;
+            }
+            lastSeqNum[itemPtr->m_producer] = itemPtr->m_seqNum;
+            count++;
+        }
+    }
+    unsigned long elapsed = ElapsedTime::deltaMilliseconds( start );
+
+    for ( unsigned i=0; i < numProducers; i++ )
+    {
+        while ( threads[i]->isRunning() )
+        {
+            Api::sleep( 1 );
+        }
+        Thread::destroy( *threads[i] );
+        delete[] producers[i].m_items;
+    }
+    return elapsed;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_CASE( "MPSCQUEUE: Validate member functions", "[mpscqueue]" )
+{
+    Shutdown_TS::clearAndUseCounter();
+
+    SECTION( "FIFO" )
+    {
+        MpscQueue<MyItem> queue;
+        SList<MyItem>     dst;
+        MyItem            items[5];
+
+        REQUIRE( queue.isEmpty() );
+        REQUIRE( queue.getAll( dst ) == false );
+        REQUIRE( dst.first() == 0 );
+
+        queue.put( items[0] );
+        queue.put( items[1] );
+        queue.put( items[2] );
+        REQUIRE( queue.isEmpty() == false );
+        REQUIRE( queue.getAll( dst ) == true );
+        REQUIRE( queue.isEmpty() );
+
+        // Items are appended to the destination list
+        queue.put( items[3] );
+        queue.put( items[4] );
+        REQUIRE( queue.getAll( dst ) == true );
+        REQUIRE( dst.get() == &items[0] );
+        REQUIRE( dst.get() == &items[1] );
+        REQUIRE( dst.get() == &items[2] );
+        REQUIRE( dst.get() == &items[3] );
+        REQUIRE( dst.get() == &items[4] );
+        REQUIRE( dst.get() == 0 );
+
+        // Items can be re-queued once removed
+        queue.put( items[2] );
+        REQUIRE( queue.getAll( dst ) == true );
+        REQUIRE( dst.get() == &items[2] );
+    }
+
+    SECTION( "DList destination" )
+    {
+        MpscQueue<MyItem> queue;
+        DList<MyItem>     dst;
+        MyItem            items[3];
+
+        queue.put( items[0] );
+        queue.put( items[1] );
+        queue.put( items[2] );
+        queue.getAll( dst );
+        REQUIRE( dst.remove( items[1] ) == true );
+        REQUIRE( dst.get() == &items[0] );
+        REQUIRE( dst.get() == &items[2] );
+        REQUIRE( dst.get() == 0 );
+    }
+
+    SECTION( "static" )
+    {
+        SList<MyItem> dst;
+        MyItem        item;
+        REQUIRE( staticQueue_.isEmpty() );
+        staticQueue_.put( item );
+        REQUIRE( staticQueue_.getAll( dst ) == true );
+        REQUIRE( dst.get() == &item );
+    }
+
+    SECTION( "producers" )
+    {
+        unsigned outOfOrder;
+        runProducers( 4, 1000, true, outOfOrder );
+        REQUIRE( outOfOrder == 0 );
+    }
+
+    REQUIRE( Shutdown_TS::getAndClearCounter() == 0u );
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+#define BENCH_ITEMS_PER_PRODUCER_   100000
+
+TEST_CASE( "MPSCQUEUE: benchmark", "[.bench]" )
+{
+    for ( unsigned numProducers=1; numProducers <= MAX_PRODUCERS_; numProducers *= 2 )
+    {
+        unsigned      outOfOrder1, outOfOrder2;
+        unsigned long lockedTime   = runProducers( numProducers, BENCH_ITEMS_PER_PRODUCER_, false, outOfOrder1 );
+        unsigned long lockFreeTime = runProducers( numProducers, BENCH_ITEMS_PER_PRODUCER_, true, outOfOrder2 );
+        REQUIRE( outOfOrder1 == 0 );
+        REQUIRE( outOfOrder2 == 0 );
+        CPL_SYSTEM_TRACE_MSG( SECT_, ("producers=%2u, items=%7u: GlobalLock=%5lu ms, lock-free=%5lu ms",
+                                       numProducers,
+                                       numProducers * BENCH_ITEMS_PER_PRODUCER_,
+                                       lockedTime,
+                                       lockFreeTime) );
+    }
+}
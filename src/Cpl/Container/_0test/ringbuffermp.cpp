@@ -299,5 +299,67 @@ TEST_CASE( "RINGBUFFER-MP: Validate member functions", "[ringbuffer]" )
         REQUIRE( count == buffer.getNumItems() );
     }
 
+    SECTION( "publish thresholds" )
+    {
+        int      item = 0;
+        uint32_t count;
+        uint16_t seqNum1;
+        uint16_t seqNum2;
+
+        buffer.clearTheBuffer();
+        buffer.setPublishThresholds( 1, 4 );
+        seqNum1 = mp_apple_.getSequenceNumber();
+
+        // Empty -->not-empty
+        REQUIRE( buffer.add( item ) == true );
+        mp_apple_.read( count, &seqNum2 );
+        REQUIRE( count == 1 );
+        REQUIRE( seqNum1 + 1 == seqNum2 );
+
+        // No threshold crossings
+        REQUIRE( buffer.add( item ) == true );
+        REQUIRE( buffer.add( item, seqNum1 ) == true );
+        REQUIRE( seqNum1 == seqNum2 );
+        mp_apple_.read( count, &seqNum1 );
+        REQUIRE( count == 1 );
+        REQUIRE( seqNum1 == seqNum2 );
+
+        // High water
+        REQUIRE( buffer.add( item ) == true );
+        mp_apple_.read( count, &seqNum1 );
+        REQUIRE( count == 4 );
+        REQUIRE( seqNum2 + 1 == seqNum1 );
+        REQUIRE( buffer.add( item ) == true );
+        REQUIRE( buffer.add( item ) == false );
+        mp_apple_.read( count, &seqNum2 );
+        REQUIRE( count == 4 );
+        REQUIRE( seqNum1 == seqNum2 );
+
+        // Back below the high water mark
+        REQUIRE( buffer.remove( item ) == true );
+        mp_apple_.read( count );
+        REQUIRE( count == 4 );
+        REQUIRE( buffer.remove( item ) == true );
+        mp_apple_.read( count );
+        REQUIRE( count == 3 );
+        REQUIRE( buffer.remove( item ) == true );
+        REQUIRE( buffer.remove( item ) == true );
+        mp_apple_.read( count );
+        REQUIRE( count == 3 );
+
+        // Not-empty -->empty
+        REQUIRE( buffer.remove( item ) == true );
+        REQUIRE( buffer.remove( item ) == false );
+        mp_apple_.read( count );
+        REQUIRE( count == 0 );
+
+        // Restore the default behavior
+        buffer.setPublishThresholds( 0, 0 );
+        REQUIRE( buffer.add( item ) == true );
+        REQUIRE( buffer.add( item ) == true );
+        mp_apple_.read( count );
+        REQUIRE( count == 2 );
+    }
+
     REQUIRE( Shutdown_TS::getAndClearCounter() == 0u );
 }
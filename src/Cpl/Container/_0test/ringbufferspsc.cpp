@@ -0,0 +1,376 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+
+#include "Catch/catch.hpp"
+#include "Cpl/Container/RingBufferSPSC.h"
+#include "Cpl/Container/RingBufferMT.h"
+#include "Cpl/System/Thread.h"
+#include "Cpl/System/Api.h"
+#include "Cpl/System/ElapsedTime.h"
+#include "Cpl/System/Trace.h"
+#include "Cpl/System/_testsupport/Shutdown_TS.h"
+
+
+///
+using namespace Cpl::Container;
+///
+using namespace Cpl::System;
+
+#define SECT_   "_0test"
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+static int memoryRBuf_[5+1];
+
+#define BULK_SIZE_      16
+
+/// Bulk add: SPSC buffer
+static unsigned addBulk( RingBufferSPSC<unsigned>& buffer, const unsigned* src, unsigned num )
+{
+    return buffer.addElements( src, num );
+}
+
+/// Bulk add: the mutex protected buffer has no bulk copy -->use the zero-copy API
+static unsigned addBulk( RingBufferMT<unsigned>& buffer, const unsigned* src, unsigned num )
+{
+    unsigned flatLen;
+    unsigned* dst = buffer.peekNextAddItems( flatLen );
+    if ( dst == nullptr )
+    {
+        buffer.addElements( 0 );
+        return 0;
+    }
+    num = num < flatLen ? num : flatLen;
+    for ( unsigned i=0; i < num; i++ )
+    {
+        dst[i] = src[i];
+    }
+    buffer.addElements( num );
+    return num;
+}
+
+/// Bulk remove: SPSC buffer
+static unsigned removeBulk( RingBufferSPSC<unsigned>& buffer, unsigned* dst, unsigned max )
+{
+    return buffer.removeElements( dst, max );
+}
+
+/// Bulk remove: the mutex protected buffer has no bulk copy -->use the zero-copy API
+static unsigned removeBulk( RingBufferMT<unsigned>& buffer, unsigned* dst, unsigned max )
+{
+    unsigned flatLen;
+    unsigned* src = buffer.peekNextRemoveItems( flatLen );
+    if ( src == nullptr )
+    {
+        buffer.removeElements( 0 );
+        return 0;
+    }
+    max = max < flatLen ? max : flatLen;
+    for ( unsigned i=0; i < max; i++ )
+    {
+        dst[i] = src[i];
+    }
+    buffer.removeElements( max );
+    return max;
+}
+
+/// Use un-named namespace to make my class local-to-the-file in scope
+namespace {
+
+/// Adds the sequence 0..N-1 to the buffer (spins when the buffer is full)
+template <class BUFFER>
+class Producer : public Runnable
+{
+public:
+    ///
+    BUFFER&     m_buffer;
+    ///
+    unsigned    m_numItems;
+    ///
+    bool        m_bulk;
+
+    ///
+    Producer( BUFFER& buffer, unsigned numItems, bool bulk ):m_buffer( buffer ), m_numItems( numItems ), m_bulk( bulk ) {}
+
+    ///
+    void appRun()
+    {
+        unsigned next = 0;
+        while ( next < m_numItems )
+        {
+            if ( m_bulk )
+            {
+                unsigned src[BULK_SIZE_];
+                unsigned num = m_numItems - next < BULK_SIZE_ ? m_numItems - next : BULK_SIZE_;
+                for ( unsigned i=0; i < num; i++ )
+                {
+                    src[i] = next + i;
+                }
+                next += addBulk( m_buffer, src, num );
+            }
+            else if ( m_buffer.add( next ) )
+            {
+                next++;
+            }
+            else
+            {
+                Api::sleep( 0 );
+            }
+        }
+    }
+};
+
+} // end namespace
+
+/// Runs a producer thread and consumes all of the items in the current thread. Returns the elapsed time in msec
+template <class BUFFER>
+static unsigned long runProducerConsumer( BUFFER& buffer, unsigned numItems, bool bulk, unsigned& outOfOrder )
+{
+    Producer<BUFFER> producer( buffer, numItems, bulk );
+    unsigned         expected = 0;
+    outOfOrder                = 0;
+
+    unsigned long start = ElapsedTime::milliseconds();
+    Thread* t1          = Thread::create( producer, "PRODUCER" );
+    while ( expected < numItems )
+    {
+        unsigned dst[BULK_SIZE_];
+        unsigned num = 0;
+        if ( bulk )
+        {
+            num = removeBulk( buffer, dst, BULK_SIZE_ );
+        }
+        else if ( buffer.remove( dst[0] ) )
+        {
+            num = 1;
+        }
+
+        if ( num == 0 )
+        {
+            Api::sleep( 0 );
+        }
+        for ( unsigned i=0; i < num; i++, expected++ )
+        {
+            if ( dst[i] != expected )
+            {
+                outOfOrder++;
+            }
+        }
+    }
+    unsigned long elapsed = ElapsedTime::deltaMilliseconds( start );
+
+    while ( t1->isRunning() )
+    {
+        Api::sleep( 1 );
+    }
+    Thread::destroy( *t1 );
+    return elapsed;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_CASE( "RINGBUFFER-SPSC: Validate member functions", "[ringbuffer]" )
+{
+    RingBufferSPSC<int> buffer( sizeof( memoryRBuf_ ) / sizeof( memoryRBuf_[0] ), memoryRBuf_ );
+
+    Shutdown_TS::clearAndUseCounter();
+
+    SECTION( "Operations" )
+    {
+        int item = 0;
+
+        REQUIRE( buffer.isEmpty() == true );
+        REQUIRE( buffer.isFull() == false );
+        REQUIRE( buffer.peekHead() == 0 );
+        REQUIRE( buffer.peekTail() == 0 );
+        REQUIRE( buffer.getNumItems() == 0 );
+        REQUIRE( buffer.getMaxItems() == 5 );
+        REQUIRE( buffer.remove( item ) == false );
+
+        for ( int i=1; i <= 5; i++ )
+        {
+            REQUIRE( buffer.add( i * 10 ) == true );
+            REQUIRE( buffer.getNumItems() == (unsigned) i );
+            REQUIRE( *( buffer.peekHead() ) == 10 );
+            REQUIRE( *( buffer.peekTail() ) == i * 10 );
+        }
+        REQUIRE( buffer.isFull() == true );
+        REQUIRE( buffer.add( 60 ) == false );
+
+        REQUIRE( buffer.remove( item ) == true );
+        REQUIRE( item == 10 );
+        REQUIRE( buffer.remove( item ) == true );
+        REQUIRE( item == 20 );
+        REQUIRE( buffer.add( 60 ) == true );
+        REQUIRE( buffer.add( 70 ) == true );        // Wraps around
+        REQUIRE( buffer.isFull() == true );
+        REQUIRE( *( buffer.peekHead() ) == 30 );
+        REQUIRE( *( buffer.peekTail() ) == 70 );
+
+        for ( int i=3; i <= 7; i++ )
+        {
+            REQUIRE( buffer.remove( item ) == true );
+            REQUIRE( item == i * 10 );
+        }
+        REQUIRE( buffer.isEmpty() == true );
+        REQUIRE( buffer.peekHead() == 0 );
+        REQUIRE( buffer.peekTail() == 0 );
+
+        REQUIRE( buffer.add( 10 ) == true );
+        buffer.clearTheBuffer();
+        REQUIRE( buffer.isEmpty() == true );
+        REQUIRE( buffer.getNumItems() == 0 );
+    }
+
+    SECTION( "Bulk" )
+    {
+        int src[] = { 1, 2, 3, 4, 5, 6, 7 };
+        int dst[7];
+
+        REQUIRE( buffer.removeElements( dst, 7 ) == 0 );
+        REQUIRE( buffer.addElements( src, 3 ) == 3 );
+        REQUIRE( buffer.addElements( src + 3, 4 ) == 2 );   // Only 2 fit
+        REQUIRE( buffer.isFull() == true );
+        REQUIRE( buffer.addElements( src, 1 ) == 0 );
+
+        REQUIRE( buffer.removeElements( dst, 4 ) == 4 );
+        REQUIRE( dst[0] == 1 );
+        REQUIRE( dst[3] == 4 );
+        REQUIRE( buffer.addElements( src + 5, 2 ) == 2 );   // Wraps around
+        REQUIRE( buffer.getNumItems() == 3 );
+        REQUIRE( buffer.removeElements( dst, 7 ) == 3 );
+        REQUIRE( dst[0] == 5 );
+        REQUIRE( dst[1] == 6 );
+        REQUIRE( dst[2] == 7 );
+        REQUIRE( buffer.isEmpty() == true );
+    }
+
+    SECTION( "Zero copy" )
+    {
+        unsigned flatLen;
+        REQUIRE( buffer.peekNextRemoveItems( flatLen ) == nullptr );
+        REQUIRE( flatLen == 0 );
+
+        int* ptr = buffer.peekNextAddItems( flatLen );
+        REQUIRE( ptr == memoryRBuf_ );
+        REQUIRE( flatLen == 5 );
+        ptr[0] = 100;
+        ptr[1] = 200;
+        ptr[2] = 300;
+        ptr[3] = 400;
+        REQUIRE( buffer.isEmpty() == true );        // Not visible until added
+        buffer.addElements( 4 );
+        REQUIRE( buffer.getNumItems() == 4 );
+
+        ptr = buffer.peekNextRemoveItems( flatLen );
+        REQUIRE( flatLen == 4 );
+        REQUIRE( ptr[0] == 100 );
+        buffer.removeElements( 3 );
+        REQUIRE( *( buffer.peekHead() ) == 400 );
+
+        ptr = buffer.peekNextAddItems( flatLen );
+        REQUIRE( ptr == memoryRBuf_ + 4 );
+        REQUIRE( flatLen == 2 );                    // Limited by the end of the memory
+        ptr[0] = 500;
+        ptr[1] = 600;
+        buffer.addElements( 2 );
+        ptr = buffer.peekNextAddItems( flatLen );
+        REQUIRE( ptr == memoryRBuf_ );
+        REQUIRE( flatLen == 2 );                    // Limited by the head
+        ptr[0] = 700;
+        buffer.addElements( 1 );
+        REQUIRE( *( buffer.peekTail() ) == 700 );
+
+        ptr = buffer.peekNextRemoveItems( flatLen );
+        REQUIRE( flatLen == 3 );
+        REQUIRE( ptr[0] == 400 );
+        REQUIRE( ptr[2] == 600 );
+        buffer.removeElements( 3 );
+        ptr = buffer.peekNextRemoveItems( flatLen );
+        REQUIRE( flatLen == 1 );
+        REQUIRE( ptr[0] == 700 );
+        buffer.removeElements( 1 );
+        REQUIRE( buffer.isEmpty() == true );
+    }
+
+    SECTION( "Producer/Consumer" )
+    {
+        unsigned                 memory[64];
+        RingBufferSPSC<unsigned> uut( 64, memory );
+        unsigned                 outOfOrder;
+        runProducerConsumer( uut, 100000, false, outOfOrder );
+        REQUIRE( outOfOrder == 0 );
+        runProducerConsumer( uut, 100000, true, outOfOrder );
+        REQUIRE( outOfOrder == 0 );
+    }
+
+    REQUIRE( Shutdown_TS::getAndClearCounter() == 0u );
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+#define BENCH_NUM_ITEMS_    2000000
+#define BENCH_BUF_SIZE_     (256+1)
+
+/// Adds/removes items from the current thread, i.e. measures the per-operation overhead without thread switches
+template <class BUFFER>
+static unsigned long runSingleThread( BUFFER& buffer, unsigned numItems )
+{
+    unsigned      sum   = 0;
+    unsigned long start = ElapsedTime::milliseconds();
+    for ( unsigned i=0; i < numItems; i++ )
+    {
+        unsigned item = 0;
+        buffer.add( i );
+        buffer.remove( item );
+        sum += item;
+    }
+    unsigned long elapsed = ElapsedTime::deltaMilliseconds( start );
+    REQUIRE( sum == (unsigned) ((unsigned long long) numItems * (numItems - 1) / 2) );
+    return elapsed;
+}
+
+TEST_CASE( "RINGBUFFER-SPSC: benchmark", "[.bench]" )
+{
+    static unsigned memory1[BENCH_BUF_SIZE_];
+    static unsigned memory2[BENCH_BUF_SIZE_];
+
+    {
+        RingBufferMT<unsigned>   mtBuffer( BENCH_BUF_SIZE_, memory1 );
+        RingBufferSPSC<unsigned> spscBuffer( BENCH_BUF_SIZE_, memory2 );
+        unsigned long            mtTime   = runSingleThread( mtBuffer, BENCH_NUM_ITEMS_ * 5 );
+        unsigned long            spscTime = runSingleThread( spscBuffer, BENCH_NUM_ITEMS_ * 5 );
+        CPL_SYSTEM_TRACE_MSG( SECT_, ("%-6s items=%u: RingBufferMT=%5lu ms, RingBufferSPSC=%5lu ms",
+                                       "1-thrd",
+                                       BENCH_NUM_ITEMS_ * 5,
+                                       mtTime,
+                                       spscTime) );
+    }
+
+    for ( int bulk=0; bulk < 2; bulk++ )
+    {
+        RingBufferMT<unsigned>   mtBuffer( BENCH_BUF_SIZE_, memory1 );
+        RingBufferSPSC<unsigned> spscBuffer( BENCH_BUF_SIZE_, memory2 );
+        unsigned                 outOfOrder1, outOfOrder2;
+        unsigned long            mtTime   = runProducerConsumer( mtBuffer, BENCH_NUM_ITEMS_, bulk != 0, outOfOrder1 );
+        unsigned long            spscTime = runProducerConsumer( spscBuffer, BENCH_NUM_ITEMS_, bulk != 0, outOfOrder2 );
+        REQUIRE( outOfOrder1 == 0 );
+        REQUIRE( outOfOrder2 == 0 );
+        CPL_SYSTEM_TRACE_MSG( SECT_, ("%-6s items=%u: RingBufferMT=%5lu ms (%lu items/msec), RingBufferSPSC=%5lu ms (%lu items/msec)",
+                                       bulk ? "bulk" : "single",
+                                       BENCH_NUM_ITEMS_,
+                                       mtTime,
+                                       mtTime ? BENCH_NUM_ITEMS_ / mtTime : 0,
+                                       spscTime,
+                                       spscTime ? BENCH_NUM_ITEMS_ / spscTime : 0) );
+    }
+}
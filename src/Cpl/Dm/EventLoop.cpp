@@ -15,6 +15,7 @@
 #include "Cpl/System/Trace.h"
 #include "Cpl/System/Assert.h"
 #include "Cpl/System/GlobalLock.h"
+#include "Cpl/System/ElapsedTime.h"
 
 
 #define SECT_ "Cpl::Dm"
@@ -27,9 +28,21 @@ using namespace Cpl::Dm;
 EventLoop::EventLoop( unsigned long                       timingTickInMsec,
                       Cpl::System::SharedEventHandlerApi* eventHandler ) noexcept
     :Cpl::System::EventLoop( timingTickInMsec, eventHandler )
+    , m_deferredTimer( *this, *this, &EventLoop::deferredTimerExpired )
+    , m_maxNotificationsPerPass( OPTION_CPL_DM_EVENT_LOOP_MAX_NOTIFICATIONS_PER_PASS )
+    , m_maxNotificationTimeMsec( OPTION_CPL_DM_EVENT_LOOP_MAX_NOTIFICATION_TIME_MSEC )
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+    , m_profilePending( 0 )
+#endif
 {
 }
 
+void EventLoop::setNotificationBatching( unsigned maxNotifications, unsigned long maxTimeMsec ) noexcept
+{
+    m_maxNotificationsPerPass = maxNotifications > 0 ? maxNotifications : 1;
+    m_maxNotificationTimeMsec = maxTimeMsec;
+}
+
 
 /////////////////////
 void EventLoop::appRun()
@@ -49,51 +62,244 @@ void EventLoop::appRun()
 
 void EventLoop::processChangeNotifications() noexcept
 {
-    // Get the next pending change notification
+    // Release expired deferred change notifications
     Cpl::System::GlobalLock::begin();
-    SubscriberApi* subscriberPtr = m_pendingMpNotifications.get();
+    bool deferred = m_deferredMpNotifications.first() != nullptr;
     Cpl::System::GlobalLock::end();
+    if ( deferred )
+    {
+        processDeferredNotifications();
+    }
 
-    // Execute - at MOST one - the change notification callback
-    if ( subscriberPtr )
+    unsigned long startTime = m_maxNotificationTimeMsec ? Cpl::System::ElapsedTime::milliseconds() : 0;
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+    unsigned long profileStart = profileTimestamp_();
+    unsigned long depth        = 0;
+#endif
+    unsigned count=0;
+    for ( ; count < m_maxNotificationsPerPass; count++ )
     {
-        // Get the model point that changed
-        ModelPoint* mpPtr = subscriberPtr->getModelPoint_();
-        CPL_SYSTEM_ASSERT( mpPtr != 0 );   // NOTE: getModelPoint_() is guaranteed to return a valid pointer, but just in case...
-        ModelPoint& modelPoint = *mpPtr;
+        // Get the next pending change notification.  Note: Notifications are 
+        // removed one at time (instead of draining the list) so that a callback
+        // can cancel a subscription that has a pending notification.
+#ifdef USE_CPL_DM_EVENT_LOOP_MPSC_QUEUE
+        moveNewNotifications();
+#else
+        Cpl::System::GlobalLock::begin();
+#endif
+        SubscriberApi* subscriberPtr = m_pendingMpNotifications.get();
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+        if ( count == 0 )
+        {
+            depth = m_profilePending;
+        }
+        if ( subscriberPtr )
+        {
+            m_profilePending--;
+        }
+#endif
+#ifndef USE_CPL_DM_EVENT_LOOP_MPSC_QUEUE
+        Cpl::System::GlobalLock::end();
+#endif
+        if ( subscriberPtr == nullptr )
+        {
+            break;
+        }
 
-        // Update the subscriber's state
-        modelPoint.processSubscriptionEvent_( *subscriberPtr, ModelPoint::eNOTIFYING );
+        // Execute the change notification callback
+        processChangeNotification( *subscriberPtr );
 
-        // Execute the callback
-        subscriberPtr->genericModelPointChanged_( modelPoint, *subscriberPtr );
+        // Enforce the time budget
+        if ( m_maxNotificationTimeMsec && Cpl::System::ElapsedTime::expiredMilliseconds( startTime, m_maxNotificationTimeMsec ) )
+        {
+            count++;
+            break;
+        }
+    }
 
-        // Update the subscriber's state
-        modelPoint.processSubscriptionEvent_( *subscriberPtr, ModelPoint::eNOTIFY_COMPLETE );
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+    profileEvents_( ePROFILE_NOTIFICATIONS, count, profileStart );
+    if ( count )
+    {
+        profileQueueDepth_( ePROFILE_NOTIFICATIONS, depth );
     }
+#endif
+}
+
+void EventLoop::processChangeNotification( SubscriberApi& subscriber ) noexcept
+{
+    // Get the model point that changed
+    ModelPoint* mpPtr = subscriber.getModelPoint_();
+    CPL_SYSTEM_ASSERT( mpPtr != 0 );   // NOTE: getModelPoint_() is guaranteed to return a valid pointer, but just in case...
+    ModelPoint& modelPoint = *mpPtr;
+
+    // Update the subscriber's state
+    modelPoint.processSubscriptionEvent_( subscriber, ModelPoint::eNOTIFYING );
+
+    // Execute the callback
+#ifdef USE_CPL_DM_MODEL_POINT_STATS
+    unsigned long startTime = profileTimestamp_();
+    subscriber.genericModelPointChanged_( modelPoint, subscriber );
+    modelPoint.recordCallbackTime_( profileTimestamp_() - startTime );
+#else
+    subscriber.genericModelPointChanged_( modelPoint, subscriber );
+#endif
+
+    // Update the subscriber's state
+    modelPoint.processSubscriptionEvent_( subscriber, ModelPoint::eNOTIFY_COMPLETE );
 }
 
 void EventLoop::addPendingChangingNotification_( SubscriberApi& subscriber ) noexcept
 {
     // Add the notification to my list and send myself an Event to wake up the mailbox
+#ifdef USE_CPL_DM_EVENT_LOOP_MPSC_QUEUE
+    m_newMpNotifications.put( subscriber );
+#else
     Cpl::System::GlobalLock::begin();
     m_pendingMpNotifications.put( subscriber );
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+    m_profilePending++;
+#endif
     Cpl::System::GlobalLock::end();
+#endif
     signal();
 }
 
 void EventLoop::removePendingChangingNotification_( SubscriberApi& subscriber ) noexcept
 {
     // Remove the subscriber from the notification
+#ifdef USE_CPL_DM_EVENT_LOOP_MPSC_QUEUE
+    // Note: Called from my thread, i.e. I am the (only) consumer of the lock-free queue
+    moveNewNotifications();
+#else
     Cpl::System::GlobalLock::begin();
+#endif
+
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+    if ( m_pendingMpNotifications.remove( subscriber ) )
+    {
+        m_profilePending--;
+    }
+#else
     m_pendingMpNotifications.remove( subscriber );
+#endif
+
+#ifndef USE_CPL_DM_EVENT_LOOP_MPSC_QUEUE
     Cpl::System::GlobalLock::end();
+#endif
+}
+
+void EventLoop::addDeferredChangeNotification_( SubscriberApi& subscriber ) noexcept
+{
+    // Add the notification to my list and send myself an Event to wake up the Event Loop (so that the timer gets started)
+    Cpl::System::GlobalLock::begin();
+    m_deferredMpNotifications.put( subscriber );
+    Cpl::System::GlobalLock::end();
+    signal();
+}
+
+void EventLoop::removeDeferredChangeNotification_( SubscriberApi& subscriber ) noexcept
+{
+    Cpl::System::GlobalLock::begin();
+    m_deferredMpNotifications.remove( subscriber );
+    Cpl::System::GlobalLock::end();
+}
+
+void EventLoop::processDeferredNotifications() noexcept
+{
+    // NOTE: The GlobalLock protects the deferred list while it is walked,
+    //       i.e. Model Point writes (from any thread) add entries to the list.
+    //       Attach/detach (which remove entries) execute in this, the
+    //       Subscribers', thread - see the Cpl::Dm::EventLoop class
+    //       description.  An item is only released when it was removed from
+    //       the list in the same critical section that found it, and the list
+    //       is re-walked from the head after each dispatch (the dispatch can
+    //       change the list).
+    unsigned long now = Cpl::System::ElapsedTime::milliseconds();
+    for ( ;;)
+    {
+        unsigned long  nextWait   = 0;
+        SubscriberApi* expiredPtr = nullptr;
+        Cpl::System::GlobalLock::begin();
+        SubscriberApi* itemPtr    = m_deferredMpNotifications.first();
+        while ( itemPtr )
+        {
+            // Release the notification when its minimum interval has expired
+            NotificationOptions_& options = itemPtr->getNotificationOptions_();
+            unsigned long         elapsed = Cpl::System::ElapsedTime::deltaMilliseconds( options.m_lastNotifyMsec, now );
+            if ( elapsed >= options.m_minIntervalMsec )
+            {
+                if ( m_deferredMpNotifications.remove( *itemPtr ) )
+                {
+                    expiredPtr = itemPtr;
+                    break;
+                }
+            }
+
+            // Track the next notification that is due
+            else
+            {
+                unsigned long remaining = options.m_minIntervalMsec - elapsed;
+                if ( nextWait == 0 || remaining < nextWait )
+                {
+                    nextWait = remaining;
+                }
+            }
+
+            itemPtr = m_deferredMpNotifications.next( *itemPtr );
+        }
+        Cpl::System::GlobalLock::end();
+
+        // No more expired notifications
+        if ( expiredPtr == nullptr )
+        {
+            if ( nextWait )
+            {
+                m_deferredTimer.start( nextWait );
+            }
+            return;
+        }
+
+        // Dispatch outside of the critical section
+        ModelPoint* mpPtr = expiredPtr->getModelPoint_();
+        CPL_SYSTEM_ASSERT( mpPtr != 0 );
+        mpPtr->processSubscriptionEvent_( *expiredPtr, ModelPoint::eDEFERRED_EXPIRED );
+    }
+}
+
+void EventLoop::deferredTimerExpired() noexcept
+{
+    // Nothing to do. The deferred change notifications are processed on every pass of the event loop
 }
 
 bool EventLoop::isPendingPendingChangingNotifications() noexcept
 {
+#ifdef USE_CPL_DM_EVENT_LOOP_MPSC_QUEUE
+    return m_pendingMpNotifications.first() != nullptr || !m_newMpNotifications.isEmpty();
+#else
     Cpl::System::GlobalLock::begin();
     bool pending = m_pendingMpNotifications.first() != nullptr;
     Cpl::System::GlobalLock::end();
     return pending;
+#endif
+}
+
+#ifdef USE_CPL_DM_EVENT_LOOP_MPSC_QUEUE
+void EventLoop::moveNewNotifications() noexcept
+{
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+    // Count the moved notifications (the lock-free queue does not track its depth)
+    SubscriberApi* lastPtr = m_pendingMpNotifications.last();
+    if ( m_newMpNotifications.getAll( m_pendingMpNotifications ) )
+    {
+        SubscriberApi* itemPtr = lastPtr ? m_pendingMpNotifications.next( *lastPtr ) : m_pendingMpNotifications.first();
+        for ( ; itemPtr; itemPtr = m_pendingMpNotifications.next( *itemPtr ) )
+        {
+            m_profilePending++;
+        }
+    }
+#else
+    m_newMpNotifications.getAll( m_pendingMpNotifications );
+#endif
 }
+#endif
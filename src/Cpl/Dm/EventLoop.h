@@ -12,11 +12,33 @@
 *----------------------------------------------------------------------------*/
 /** @file */
 
+#include "colony_config.h"
 #include "Cpl/System/EventLoop.h"
 #include "Cpl/System/Thread.h"
+#include "Cpl/System/Timer.h"
 #include "Cpl/Container/DList.h"
 #include "Cpl/Dm/SubscriberApi.h"
 #include "Cpl/Dm/NotificationApi_.h"
+#ifdef USE_CPL_DM_EVENT_LOOP_MPSC_QUEUE
+#include "Cpl/Container/MpscQueue.h"
+#endif
+
+
+/** This symbol defines the default maximum number of Model Point change
+    notifications that are processed per pass of the event loop.  A value of
+    1 gives equal time/priority to all types of events.
+ */
+#ifndef OPTION_CPL_DM_EVENT_LOOP_MAX_NOTIFICATIONS_PER_PASS
+#define OPTION_CPL_DM_EVENT_LOOP_MAX_NOTIFICATIONS_PER_PASS     1
+#endif
+
+/** This symbol defines the default maximum time, in milliseconds, that is
+    spent processing Model Point change notifications per pass of the event
+    loop.  A value of zero disables the time budget.
+ */
+#ifndef OPTION_CPL_DM_EVENT_LOOP_MAX_NOTIFICATION_TIME_MSEC
+#define OPTION_CPL_DM_EVENT_LOOP_MAX_NOTIFICATION_TIME_MSEC     0
+#endif
 
 
 ///
@@ -33,12 +55,26 @@ namespace Dm {
        2. The timers and their callbacks (if any timers have expired) are
           processed.
        3. A single Model Point Change notification (if there is one pending) is
-          processed.
+          processed.  When batching is enabled (see setNotificationBatching()) 
+          up to N pending change notifications are processed.
        4. The loop is repeated until there are no expired timers, no event
           flags, and no MP change notifications - at which point the thread 
           blocks and wait for any of the above asynchronous actions to wake up 
           the thread.
 
+    By default the list of pending change notifications is protected by the
+    Cpl::System::GlobalLock.  When USE_CPL_DM_EVENT_LOOP_MPSC_QUEUE is defined,
+    new change notifications are added to a lock-free
+    Cpl::Container::MpscQueue and are then moved - by the Event Loop's thread -
+    to the list of pending change notifications.  Note: This relies on the
+    Model Point subscription semantics that Subscriptions and
+    Cancel-of-Subscriptions happen in the Subscriber's thread.
+
+    Change notifications for subscribers with a minimum notification interval
+    (see Cpl::Dm::SubscriberBase::setMinimumInterval()) are held in a list of
+    deferred change notifications (protected by the Cpl::System::GlobalLock)
+    until the interval has expired.  A single timer is used to wake up the
+    Event Loop when the next deferred change notification is due.
  */
 class EventLoop : public Cpl::System::EventLoop, public NotificationApi_
 {
@@ -46,6 +82,17 @@ protected:
     /// List of pending Model Point Change Notifications
     Cpl::Container::DList<SubscriberApi>   m_pendingMpNotifications;
 
+#ifdef USE_CPL_DM_EVENT_LOOP_MPSC_QUEUE
+    /// Lock-free queue of new change notifications (that have not been moved to the pending list)
+    Cpl::Container::MpscQueue<SubscriberApi> m_newMpNotifications;
+#endif
+
+    /// List of deferred Model Point Change Notifications (i.e. waiting for the subscriber's minimum notification interval to expire)
+    Cpl::Container::DList<SubscriberApi>   m_deferredMpNotifications;
+
+    /// Timer used to wake up the Event Loop when the next deferred change notification is due
+    Cpl::System::TimerComposer<EventLoop>  m_deferredTimer;
+
 
 public:
     /** Constructor.  The argument 'timingTickInMsec' specifies the timing
@@ -61,6 +108,21 @@ public:
     /// See Cpl::System::Runnable
     void appRun();
 
+public:
+    /** This method configures how many pending change notifications are
+        processed per pass of the event loop.  Processing multiple 
+        notifications per pass reduces the overhead of 'fanning out' a Model
+        Point change to many subscribers.  The 'maxTimeMsec' argument limits
+        the time spent processing notifications in a single pass so that timers
+        and event flags are not starved.  A 'maxTimeMsec' value of zero 
+        disables the time budget.  At least one notification is always 
+        processed per pass (when there is one pending).
+
+        This method should only be called before the Event Loop's thread is
+        started.
+     */
+    void setNotificationBatching( unsigned maxNotifications, unsigned long maxTimeMsec = 0 ) noexcept;
+
 
 public:
     /** This method has PACKAGE Scope, i.e. it is intended to be ONLY accessible
@@ -89,7 +151,8 @@ public:
         of pending change notifications.  It is okay to call this method even if
         the Subscriber is not current registered for change notifications.
 
-        This method IS thread safe.
+        This method IS thread safe (when USE_CPL_DM_EVENT_LOOP_MPSC_QUEUE is
+        defined, this method MUST be called from the Event Loop's thread).
 
         NOTE: The requirements and/or semantics of Model Point subscription is
               that Subscriptions, Notifications, and Cancel-of-Subscriptions
@@ -98,6 +161,22 @@ public:
      */
     void removePendingChangingNotification_( SubscriberApi& subscriber ) noexcept;
 
+    /** This method has PACKAGE Scope, i.e. it is intended to be ONLY accessible
+        by other classes in the Cpl::Dm namespace.  The Application should
+        NEVER call this method.
+
+        See Cpl::Dm::NotificationApi_.  This method IS thread safe.
+     */
+    void addDeferredChangeNotification_( SubscriberApi& subscriber ) noexcept;
+
+    /** This method has PACKAGE Scope, i.e. it is intended to be ONLY accessible
+        by other classes in the Cpl::Dm namespace.  The Application should
+        NEVER call this method.
+
+        See Cpl::Dm::NotificationApi_.  This method IS thread safe.
+     */
+    void removeDeferredChangeNotification_( SubscriberApi& subscriber ) noexcept;
+
 
 protected:
     /** This method returns true if there is at least one pending change
@@ -107,8 +186,39 @@ protected:
      */
     bool isPendingPendingChangingNotifications() noexcept;
 
-    /// This helper method processes pending change notifications
+    /** This helper method processes pending change notifications.  At most
+        'm_maxNotificationsPerPass' notifications are processed per call.
+     */
     virtual void processChangeNotifications() noexcept;
+
+    /// This helper method executes a single change notification
+    virtual void processChangeNotification( SubscriberApi& subscriber ) noexcept;
+
+    /** This helper method releases the deferred change notifications whose
+        minimum notification interval has expired, and (re)starts the timer
+        for the next deferred change notification.
+     */
+    virtual void processDeferredNotifications() noexcept;
+
+    /// Timer callback. Nothing to do since the deferred change notifications are processed on every pass of the Event Loop
+    void deferredTimerExpired() noexcept;
+
+#ifdef USE_CPL_DM_EVENT_LOOP_MPSC_QUEUE
+    /// This helper method moves the new change notifications from the lock-free queue to the pending list
+    void moveNewNotifications() noexcept;
+#endif
+
+protected:
+    /// Maximum number of change notifications to process per pass
+    unsigned        m_maxNotificationsPerPass;
+
+    /// Maximum time, in milliseconds, to spend processing change notifications per pass
+    unsigned long   m_maxNotificationTimeMsec;
+
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+    /// Number of pending change notifications (includes the notifications in the lock-free queue)
+    unsigned long   m_profilePending;
+#endif
 };
 
 };      // end namespaces
@@ -0,0 +1,166 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+/** @file */
+
+#include "IndexedModelDatabase.h"
+#include "ModelPoint.h"
+#include <string.h>
+
+///
+using namespace Cpl::Dm;
+
+
+//////////////////////////////////////////////
+IndexedModelDatabase::IndexedModelDatabase( Cpl::Container::DList<Cpl::Container::DictItem> hashBuckets[],
+                                            unsigned                                         numHashBuckets,
+                                            IndexEntry                                       indexEntryMemory[],
+                                            ModelPoint*                                      sortedIndexMemory[],
+                                            unsigned                                         maxPoints ) noexcept
+    : ModelDatabase()
+    , m_hashIndex( hashBuckets, numHashBuckets )
+    , m_entries( indexEntryMemory )
+    , m_sorted( sortedIndexMemory )
+    , m_maxPoints( numHashBuckets > 0 ? maxPoints : 0 )
+    , m_numIndexed( 0 )
+{
+}
+
+IndexedModelDatabase::IndexedModelDatabase( Cpl::Container::DList<Cpl::Container::DictItem> hashBuckets[],
+                                            unsigned                                         numHashBuckets,
+                                            IndexEntry                                       indexEntryMemory[],
+                                            ModelPoint*                                      sortedIndexMemory[],
+                                            unsigned                                         maxPoints,
+                                            const char*                                      ignoreThisParameter_usedToCreateAUniqueConstructor ) noexcept
+    : ModelDatabase( ignoreThisParameter_usedToCreateAUniqueConstructor )
+    , m_hashIndex( hashBuckets, numHashBuckets )
+    , m_entries( indexEntryMemory )
+    , m_sorted( sortedIndexMemory )
+    , m_maxPoints( numHashBuckets > 0 ? maxPoints : 0 )
+    , m_numIndexed( 0 )
+{
+    // Note: Any Model Points registered before this constructor executes are still on the pending list
+}
+
+//////////////////////////////////////////////
+ModelPoint* IndexedModelDatabase::getFirstByName() noexcept
+{
+    lock_();
+    syncIndexes();
+    ModelPoint* result = m_numIndexed > 0 ? m_sorted[0] : m_list.first();
+    unlock_();
+    return result;
+}
+
+ModelPoint* IndexedModelDatabase::getNextByName( ModelPoint& currentModelPoint ) noexcept
+{
+    lock_();
+    ModelPoint* result = nextByName( currentModelPoint );
+    unlock_();
+    return result;
+}
+
+unsigned IndexedModelDatabase::getNumIndexed() noexcept
+{
+    lock_();
+    syncIndexes();
+    unsigned result = m_numIndexed;
+    unlock_();
+    return result;
+}
+
+//////////////////////////////////////////////
+ModelPoint* IndexedModelDatabase::nextByName( ModelPoint& currentModelPoint ) noexcept
+{
+    syncIndexes();
+
+    // Locate the current point in the sorted index (must handle duplicate names)
+    ModelPoint* result = nullptr;
+    unsigned    idx    = lowerBound( currentModelPoint.getName() );
+    while ( idx < m_numIndexed && m_sorted[idx] != &currentModelPoint && strcmp( m_sorted[idx]->getName(), currentModelPoint.getName() ) == 0 )
+    {
+        idx++;
+    }
+
+    // Indexed point
+    if ( idx < m_numIndexed && m_sorted[idx] == &currentModelPoint )
+    {
+        result = idx + 1 < m_numIndexed ? m_sorted[idx + 1] : m_list.first();
+    }
+
+    // Un-indexed point (i.e. the index overflowed)
+    else
+    {
+        result = m_list.next( currentModelPoint );
+    }
+
+    return result;
+}
+
+ModelPoint* IndexedModelDatabase::find( const char* name ) noexcept
+{
+    syncIndexes();
+
+    IndexEntry* entry = m_hashIndex.find( Cpl::Container::KeyLiteralString( name ) );
+    if ( entry )
+    {
+        return entry->m_modelPoint;
+    }
+
+    // Not found -->check the un-indexed points (if there are any)
+    return ModelDatabase::find( name );
+}
+
+void IndexedModelDatabase::syncIndexes() noexcept
+{
+    while ( m_numIndexed < m_maxPoints )
+    {
+        ModelPoint* mp = m_list.get();
+        if ( mp == nullptr )
+        {
+            return;
+        }
+
+        // Add to the hash index
+        IndexEntry& entry  = m_entries[m_numIndexed];
+        entry.m_name       = Cpl::Container::KeyLiteralString( mp->getName() );
+        entry.m_modelPoint = mp;
+        m_hashIndex.insert( entry );
+
+        // Add to the sorted index (after any existing entries with the same name)
+        unsigned idx = lowerBound( mp->getName() );
+        while ( idx < m_numIndexed && strcmp( m_sorted[idx]->getName(), mp->getName() ) == 0 )
+        {
+            idx++;
+        }
+        memmove( &m_sorted[idx + 1], &m_sorted[idx], sizeof( ModelPoint* ) * (m_numIndexed - idx) );
+        m_sorted[idx] = mp;
+        m_numIndexed++;
+    }
+}
+
+unsigned IndexedModelDatabase::lowerBound( const char* name ) const noexcept
+{
+    unsigned low  = 0;
+    unsigned high = m_numIndexed;
+    while ( low < high )
+    {
+        unsigned mid = low + (high - low) / 2;
+        if ( strcmp( m_sorted[mid]->getName(), name ) < 0 )
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low;
+}
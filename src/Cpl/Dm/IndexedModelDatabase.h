@@ -0,0 +1,144 @@
+#ifndef Cpl_Dm_IndexedModelDatabase_h_
+#define Cpl_Dm_IndexedModelDatabase_h_
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+/** @file */
+
+#include "Cpl/Dm/ModelDatabase.h"
+#include "Cpl/Container/Dictionary.h"
+#include "Cpl/Container/Key.h"
+
+
+///
+namespace Cpl {
+///
+namespace Dm {
+
+
+/** This concrete class implements a Model Database that maintains a hash
+    index (for look-up by name) and a sorted index (for traversal by name) of
+    its Model Points.  Look-ups are O(1) and traversals are O(log n) per step
+    instead of the O(n) look-ups and the one-time O(n^2) sort of the basic
+    ModelDatabase.
+
+    The application is responsible for providing the memory for both indexes.
+    The hash index is a Cpl::Container::Dictionary, i.e. the application
+    provides the hash buckets ('numHashBuckets' should be a prime number, see
+    Cpl::Container::Dictionary for a list of useful primes) and one IndexEntry
+    per indexed Model Point.  An IndexEntry is needed because a Model Point's
+    own container link is used by the database's list of (un-indexed) Model
+    Points.
+
+    Model Points self register with the database via insert_() - which can
+    occur BEFORE the database's constructor has executed (i.e. statically
+    allocated Model Points).  To handle this, newly inserted Model Points are
+    placed on the 'pending' list inherited from ModelDatabase, and are moved
+    to the indexes the next time the database is accessed.  Each pending Model
+    Point is added to the sorted index with a binary search, i.e. the index is
+    always sorted - there is no 'sort the first time' penalty.
+
+    Note: If more than 'maxPoints' Model Points are registered, the extra
+          Model Points remain on the un-indexed list.  They can still be looked
+          up (by a linear search) and are traversed (unsorted) AFTER all of the
+          indexed Model Points.
+
+    Note: All of the methods are thread safe.
+  */
+class IndexedModelDatabase : public ModelDatabase
+{
+public:
+    /// Hash index entry for a single indexed Model Point
+    class IndexEntry : public Cpl::Container::DictItem
+    {
+    public:
+        /// Constructor
+        IndexEntry() :m_name( nullptr ), m_modelPoint( nullptr ) {}
+
+    public:
+        /// The Model Point's name (i.e. the Dictionary key)
+        Cpl::Container::KeyLiteralString    m_name;
+
+        /// The indexed Model Point
+        ModelPoint*                         m_modelPoint;
+
+    protected:
+        /// See Cpl::Container::DictItem
+        const Cpl::Container::Key& getKey() const noexcept { return m_name; }
+    };
+
+public:
+    /** Constructor.  The 'hashBuckets' array must contain 'numHashBuckets'
+        elements, and the 'indexEntryMemory' and 'sortedIndexMemory' arrays
+        must contain 'maxPoints' elements.
+     */
+    IndexedModelDatabase( Cpl::Container::DList<Cpl::Container::DictItem> hashBuckets[],
+                          unsigned                                         numHashBuckets,
+                          IndexEntry                                       indexEntryMemory[],
+                          ModelPoint*                                      sortedIndexMemory[],
+                          unsigned                                         maxPoints ) noexcept;
+
+    /** This is a special constructor for when the Model Database is
+        statically declared.  See ModelDatabase for details.
+     */
+    IndexedModelDatabase( Cpl::Container::DList<Cpl::Container::DictItem> hashBuckets[],
+                          unsigned                                         numHashBuckets,
+                          IndexEntry                                       indexEntryMemory[],
+                          ModelPoint*                                      sortedIndexMemory[],
+                          unsigned                                         maxPoints,
+                          const char*                                      ignoreThisParameter_usedToCreateAUniqueConstructor ) noexcept;
+
+public:
+    /// See Cpl::Dm::ModelDatabaseApi
+    ModelPoint* getFirstByName() noexcept;
+
+    /// See Cpl::Dm::ModelDatabaseApi
+    ModelPoint* getNextByName( ModelPoint& currentModelPoint ) noexcept;
+
+public:
+    /// Returns the number of Model Points that have been indexed
+    unsigned getNumIndexed() noexcept;
+
+protected:
+    /// See Cpl::Dm::ModelDatabase.  Note: The caller is required to have the database locked
+    ModelPoint* find( const char* name ) noexcept;
+
+    /// See Cpl::Dm::ModelDatabase.  Note: The caller is required to have the database locked
+    ModelPoint* nextByName( ModelPoint& currentModelPoint ) noexcept;
+
+    /// Helper method that moves the pending Model Points to the indexes.  Note: The caller is required to have the database locked
+    void syncIndexes() noexcept;
+
+    /** Helper method that returns the index of the first entry in the sorted
+        index whose name is NOT less than 'name'
+     */
+    unsigned lowerBound( const char* name ) const noexcept;
+
+protected:
+    /// Hash index of the indexed Model Points
+    Cpl::Container::Dictionary<IndexEntry>  m_hashIndex;
+
+    /// Memory for the hash index entries
+    IndexEntry*                             m_entries;
+
+    /// Model Points sorted by name
+    ModelPoint**                            m_sorted;
+
+    /// Maximum number of Model Points that can be indexed
+    unsigned                                m_maxPoints;
+
+    /// Number of Model Points currently indexed
+    unsigned                                m_numIndexed;
+};
+
+
+};      // end namespaces
+};
+#endif  // end header latch
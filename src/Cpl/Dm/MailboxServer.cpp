@@ -24,6 +24,7 @@ MailboxServer::MailboxServer( unsigned long                       timingTickInMs
     : Cpl::Dm::EventLoop( timingTickInMsec, eventHandler )
     , Cpl::Itc::Mailbox( *((Cpl::System::Signable*) this) )
 {
+    setProfileEventLoop( this );
 }
 
 
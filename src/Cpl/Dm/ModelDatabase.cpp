@@ -14,6 +14,7 @@
 #include "ModelPoint.h"
 #include "Cpl/Container/Key.h"
 #include <new>
+#include <string.h>
 
 ///
 using namespace Cpl::Dm;
@@ -22,6 +23,12 @@ using namespace Cpl::Dm;
 static Cpl::System::Mutex globalMutex_;
 StaticJsonDocument<OPTION_CPL_DM_MODEL_DATABASE_MAX_CAPACITY_JSON_DOC> ModelDatabase::g_doc_;
 
+const uint32_t ModelDatabase::SNAPSHOT_MAGIC;
+const uint16_t ModelDatabase::SNAPSHOT_VERSION;
+
+// Size of a snapshot record excluding the name and data
+#define SNAPSHOT_RECORD_OVERHEAD_   ( sizeof( uint16_t ) + sizeof( uint16_t ) + sizeof( uint32_t ) )
+
 //////////////////////////////////////////////
 ModelDatabase::ModelDatabase() noexcept
     : m_list()
@@ -79,7 +86,7 @@ ModelPoint* ModelDatabase::getFirstByName() noexcept
 ModelPoint* ModelDatabase::getNextByName( ModelPoint& currentModelPoint ) noexcept
 {
     lock_();
-    ModelPoint* result = m_list.next( currentModelPoint );
+    ModelPoint* result = nextByName( currentModelPoint );
     unlock_();
     return result;
 }
@@ -128,9 +135,17 @@ bool ModelDatabase::fromJSON( const char* src, Cpl::Text::String* errorMsg, Mode
 {
     // Get access to the Global JSON document
     ModelDatabase::globalLock_();
+    bool result = fromJSON( src, ModelDatabase::g_doc_, errorMsg, retMp, retSequenceNumber );
 
+    // Release the Global JSON document
+    ModelDatabase::globalUnlock_();
+    return result;
+}
+
+bool ModelDatabase::fromJSON( const char* src, JsonDocument& doc, Cpl::Text::String* errorMsg, ModelPoint** retMp, uint16_t* retSequenceNumber ) noexcept
+{
     // Parse the JSON payload...
-    DeserializationError err = deserializeJson( ModelDatabase::g_doc_, src );
+    DeserializationError err = deserializeJson( doc, src );
     if ( err )
     {
         if ( errorMsg )
@@ -141,7 +156,7 @@ bool ModelDatabase::fromJSON( const char* src, Cpl::Text::String* errorMsg, Mode
     }
 
     // Valid JSON... Parse the Model Point name
-    const char* name = ModelDatabase::g_doc_["name"];
+    const char* name = doc["name"];
     if ( name == nullptr )
     {
         if ( errorMsg )
@@ -163,9 +178,9 @@ bool ModelDatabase::fromJSON( const char* src, Cpl::Text::String* errorMsg, Mode
     }
 
     // Attempt to parse the key/value pairs of interest
-    JsonVariant               validElem  = ModelDatabase::g_doc_["valid"];
-    JsonVariant               lockedElem = ModelDatabase::g_doc_["locked"];
-    JsonVariant               valElem    = ModelDatabase::g_doc_["val"];
+    JsonVariant               validElem  = doc["valid"];
+    JsonVariant               lockedElem = doc["locked"];
+    JsonVariant               valElem    = doc["val"];
     uint16_t                  seqnum     = 0;
     ModelPoint::LockRequest_T lockAction = ModelPoint::eNO_REQUEST;
     bool                      parsed     = false;
@@ -205,9 +220,6 @@ bool ModelDatabase::fromJSON( const char* src, Cpl::Text::String* errorMsg, Mode
         return false;
     }
 
-    // Release the Global JSON document
-    ModelDatabase::globalUnlock_();
-
     // Return the sequence number (when requested)
     if ( retSequenceNumber )
     {
@@ -223,6 +235,163 @@ bool ModelDatabase::fromJSON( const char* src, Cpl::Text::String* errorMsg, Mode
     return true;
 }
 
+size_t ModelDatabase::getSnapshotSize() noexcept
+{
+    lock_();
+    size_t      total = sizeof( SnapshotHeader_T );
+    ModelPoint* mp    = getFirstByName();
+    while ( mp )
+    {
+        total += SNAPSHOT_RECORD_OVERHEAD_ + strlen( mp->getName() ) + 1 + mp->getExternalSize( true );
+        mp     = nextByName( *mp );
+    }
+    unlock_();
+    return total;
+}
+
+size_t ModelDatabase::snapshot( void* dst, size_t maxDstLength ) noexcept
+{
+    if ( dst == 0 || maxDstLength < sizeof( SnapshotHeader_T ) )
+    {
+        return 0;
+    }
+
+    lock_();
+    uint8_t*         dstPtr = (uint8_t*) dst;
+    size_t           offset = sizeof( SnapshotHeader_T );
+    SnapshotHeader_T header = { SNAPSHOT_MAGIC, SNAPSHOT_VERSION, 0, 0, 0 };
+    ModelPoint*      mp     = getFirstByName();
+    while ( mp )
+    {
+        // Fail if there is not enough space left in the destination
+        size_t   nameLen  = strlen( mp->getName() ) + 1;
+        uint32_t dataLen  = (uint32_t) mp->getExternalSize( true );
+        if ( maxDstLength - offset < SNAPSHOT_RECORD_OVERHEAD_ + nameLen + dataLen )
+        {
+            unlock_();
+            return 0;
+        }
+
+        // Record header + data
+        uint16_t len16 = (uint16_t) nameLen;
+        memcpy( dstPtr + offset, &len16, sizeof( len16 ) );
+        memcpy( dstPtr + offset + sizeof( len16 ), mp->getName(), nameLen );
+        offset += sizeof( len16 ) + nameLen;
+        uint8_t* seqNumPtr = dstPtr + offset;
+        memcpy( dstPtr + offset + sizeof( uint16_t ), &dataLen, sizeof( dataLen ) );
+        offset += sizeof( uint16_t ) + sizeof( dataLen );
+
+        uint16_t seqNum;
+        if ( mp->exportData( dstPtr + offset, dataLen, &seqNum, true ) != dataLen )
+        {
+            unlock_();
+            return 0;
+        }
+        memcpy( seqNumPtr, &seqNum, sizeof( seqNum ) );
+        offset += dataLen;
+
+        header.numPoints++;
+        mp = nextByName( *mp );
+    }
+    unlock_();
+
+    header.totalLength = (uint32_t) offset;
+    memcpy( dst, &header, sizeof( header ) );
+    return offset;
+}
+
+bool ModelDatabase::restore( const void* src, size_t srcLength, unsigned* retNumRestored, bool restoreSequenceNumbers ) noexcept
+{
+    // Validate the header
+    SnapshotHeader_T header;
+    if ( src == 0 || srcLength < sizeof( header ) )
+    {
+        return false;
+    }
+    memcpy( &header, src, sizeof( header ) );
+    if ( header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION || header.totalLength > srcLength || header.totalLength < sizeof( header ) )
+    {
+        return false;
+    }
+
+    // Validate ALL records first, then apply them - all while holding the database lock
+    const uint8_t* records     = ( (const uint8_t*) src ) + sizeof( header );
+    size_t         recordsLen  = header.totalLength - sizeof( header );
+    unsigned       numRestored = 0;
+    lock_();
+    bool result = walkSnapshot( records, header.numPoints, recordsLen, false, restoreSequenceNumbers, numRestored ) &&
+                  walkSnapshot( records, header.numPoints, recordsLen, true, restoreSequenceNumbers, numRestored );
+    unlock_();
+
+    if ( result && retNumRestored )
+    {
+        *retNumRestored = numRestored;
+    }
+    return result;
+}
+
+bool ModelDatabase::walkSnapshot( const uint8_t* src, uint32_t numPoints, size_t srcLength, bool apply, bool restoreSequenceNumbers, unsigned& numRestored ) noexcept
+{
+    ModelPoint* cursor = getFirstByName();
+    size_t      offset = 0;
+    numRestored        = 0;
+    for ( uint32_t i=0; i < numPoints; i++ )
+    {
+        // Parse the record header
+        uint16_t nameLen;
+        uint16_t seqNum;
+        uint32_t dataLen;
+        if ( srcLength - offset < sizeof( nameLen ) )
+        {
+            return false;
+        }
+        memcpy( &nameLen, src + offset, sizeof( nameLen ) );
+        offset += sizeof( nameLen );
+        if ( nameLen == 0 || srcLength - offset < nameLen + sizeof( seqNum ) + sizeof( dataLen ) )
+        {
+            return false;
+        }
+        const char* name = (const char*) ( src + offset );
+        if ( name[nameLen - 1] != '\0' )
+        {
+            return false;
+        }
+        offset += nameLen;
+        memcpy( &seqNum, src + offset, sizeof( seqNum ) );
+        memcpy( &dataLen, src + offset + sizeof( seqNum ), sizeof( dataLen ) );
+        offset += sizeof( seqNum ) + sizeof( dataLen );
+        if ( srcLength - offset < dataLen )
+        {
+            return false;
+        }
+        const uint8_t* data = src + offset;
+        offset += dataLen;
+
+        // Look-up the MP.  Since the image is in name order, the MP is typically the 'next' MP in the database
+        ModelPoint* mp = cursor && strcmp( cursor->getName(), name ) == 0 ? cursor : find( name );
+        if ( mp == 0 )
+        {
+            continue;   // Skip MPs that no longer exist
+        }
+        cursor = nextByName( *mp );
+
+        if ( !apply )
+        {
+            if ( !mp->validateSnapshot_( data, dataLen ) )
+            {
+                return false;
+            }
+        }
+        else if ( mp->importSnapshot_( data, dataLen, restoreSequenceNumbers ? seqNum : ModelPoint::SEQUENCE_NUMBER_UNKNOWN ) == 0 )
+        {
+            return false;
+        }
+        numRestored++;
+    }
+
+    return offset == srcLength;
+}
+
 void ModelDatabase::sortList() noexcept
 {
     // This a BRUTE force sort, because I am lazy (well just in hurry for change)
@@ -277,6 +446,11 @@ void ModelDatabase::sortList() noexcept
     sortedList.move( m_list );
 }
 
+ModelPoint* ModelDatabase::nextByName( ModelPoint& currentModelPoint ) noexcept
+{
+    return m_list.next( currentModelPoint );
+}
+
 ModelPoint* ModelDatabase::find( const char* name ) noexcept
 {
     ModelPoint* item  = m_list.first();
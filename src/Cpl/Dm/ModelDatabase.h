@@ -85,6 +85,46 @@ public:
     /// See Cpl::Dm::ModelDatabaseApi
     bool fromJSON( const char* src, Cpl::Text::String* errorMsg=0, ModelPoint** retMp = 0, uint16_t* retSequenceNumber=0 ) noexcept;
 
+    /// See Cpl::Dm::ModelDatabaseApi
+    bool fromJSON( const char* src, JsonDocument& doc, Cpl::Text::String* errorMsg=0, ModelPoint** retMp = 0, uint16_t* retSequenceNumber=0 ) noexcept;
+
+    /// See Cpl::Dm::ModelDatabaseApi
+    size_t getSnapshotSize() noexcept;
+
+    /// See Cpl::Dm::ModelDatabaseApi
+    size_t snapshot( void* dst, size_t maxDstLength ) noexcept;
+
+    /// See Cpl::Dm::ModelDatabaseApi
+    bool restore( const void* src, size_t srcLength, unsigned* retNumRestored=0, bool restoreSequenceNumbers=false ) noexcept;
+
+public:
+    /** Snapshot image header. The header is followed by 'numPoints' records,
+        one per Model Point (in name order), with the following format:
+        \code
+        uint16_t    nameLength;         // Includes the null terminator
+        char        name[nameLength];   // Null terminated Model Point name
+        uint16_t    seqNumber;          // Sequence number at the time of the snapshot
+        uint32_t    dataLength;         // Always equals getExternalSize(true)
+        uint8_t     data[dataLength];   // Same as exportData(...,includeLockedState=true)
+        \endcode
+
+        Note: All fields are packed/unaligned, i.e. are accessed via memcpy()
+     */
+    struct SnapshotHeader_T
+    {
+        uint32_t magic;         //!< Identifies the image as a Model Database snapshot
+        uint16_t version;       //!< Format version of the image
+        uint16_t reserved;      //!< Reserved (set to zero)
+        uint32_t numPoints;     //!< Number of Model Point records in the image
+        uint32_t totalLength;   //!< Total length, in bytes, of the image (including the header)
+    };
+
+    /// Magic value for the snapshot image
+    static const uint32_t SNAPSHOT_MAGIC   = 0x53444D43; // "CMDS"
+
+    /// Current version of the snapshot image format
+    static const uint16_t SNAPSHOT_VERSION = 1;
+
 public:
     /** This method has 'PACKAGE Scope' in that is should only be called by
         other classes in the Cpl::Dm namespace.  It is ONLY public to avoid
@@ -100,6 +140,10 @@ public:
 
         This method locks the Model Database.  For every call to lock() there must
         be corresponding call to unlock();
+
+        Note: When USE_CPL_DM_MODEL_POINT_LOCKS is defined, the Model Points
+              use their own locks, i.e. this method only protects the Model
+              Database's list of Model Points.
     */
     void lock_() noexcept;
 
@@ -155,6 +199,17 @@ protected:
     /// Helper method to find a point by name
     virtual ModelPoint* find( const char* name ) noexcept;
 
+    /** Helper method that returns the next point by name (see getNextByName()).
+        Note: The caller is required to have the database locked
+     */
+    virtual ModelPoint* nextByName( ModelPoint& currentModelPoint ) noexcept;
+
+    /** Helper method that walks the records of a snapshot image. When 'apply'
+        is false the records are only validated. Returns false if the image is
+        not valid.  Note: The caller is required to have the database locked
+     */
+    virtual bool walkSnapshot( const uint8_t* src, uint32_t numPoints, size_t srcLength, bool apply, bool restoreSequenceNumbers, unsigned& numRestored ) noexcept;
+
 protected:
     /// Map to the store the Model Points
     Cpl::Container::SList<ModelPoint> m_list;
@@ -13,6 +13,7 @@
 /** @file */
 
 #include "Cpl/Text/String.h"
+#include "Cpl/Json/Arduino.h"
 
 ///
 namespace Cpl {
@@ -99,6 +100,66 @@ public:
      */
     virtual bool fromJSON( const char* src, Cpl::Text::String* errorMsg=0, ModelPoint** retMp = 0, uint16_t* retSequenceNumber=0 ) noexcept = 0;
 
+    /** This method is the same as fromJSON() above, except that the parsing
+        is done using the caller supplied JSON document 'doc' instead of the
+        global JSON document, i.e. the global lock is NOT acquired.  This
+        allows multiple threads to concurrently update Model Points from JSON
+        as long each thread uses its own document instance.
+     */
+    virtual bool fromJSON( const char* src, JsonDocument& doc, Cpl::Text::String* errorMsg=0, ModelPoint** retMp = 0, uint16_t* retSequenceNumber=0 ) noexcept = 0;
+
+
+public:
+    /** This method returns the size, in bytes, of a snapshot (see snapshot())
+        of the entire Model Database.
+     */
+    virtual size_t getSnapshotSize() noexcept = 0;
+
+    /** This method writes a versioned binary image of ALL of the Model Points
+        in the Database - i.e. each Model Point's value, valid state, locked
+        state, and sequence number - to 'dst'.  The image is created while
+        holding the Database lock.  When the Model Points share the Database
+        lock (the default) the image is a consistent snapshot of the entire
+        Database.  When USE_CPL_DM_MODEL_POINT_LOCKS is defined, each Model
+        Point is captured atomically, but Model Points can be updated while
+        the image is being created, i.e. the image is NOT a consistent
+        snapshot across Model Points.
+
+        The method returns the number of bytes written to 'dst'.  Zero is
+        returned if 'maxDstLength' is not large enough for the image (see
+        getSnapshotSize()).
+
+        NOTE: The image does NOT account for Endianess, i.e. assumes the
+              'platform' is the same for snapshot/restore
+     */
+    virtual size_t snapshot( void* dst, size_t maxDstLength ) noexcept = 0;
+
+    /** This method restores the Model Points from an image that was created
+        by snapshot().  The image is applied in a single pass while holding
+        the Database lock (and each Model Point's lock while it is updated).
+        Change notifications are coalesced, i.e. only Model
+        Points whose value and/or state changed generate a change notification
+        and each of those Model Points generates at most one notification.
+
+        Model Points in the image that do not exist in the Database are
+        silently skipped (e.g. a point that was removed by a firmware update).
+        Model Points in the Database that are not in the image are not changed.
+
+        When 'restoreSequenceNumbers' is true, each restored Model Point's
+        sequence number is set to its snapshot value. Note: a restored Model
+        Point whose value/state changed will then have its sequence number
+        advanced (per the normal change notification semantics).
+
+        The structure of the entire image (and the size and meta data of each
+        Model Point) is validated before ANY Model Point is updated. If the
+        image is not valid (e.g. wrong version, truncated, a Model Point's size
+        or array layout does not match) then false is returned and no Model
+        Points are updated.  The method optionally returns - via
+        'retNumRestored' - the number of Model Points that were restored.
+     */
+    virtual bool restore( const void* src, size_t srcLength, unsigned* retNumRestored=0, bool restoreSequenceNumbers=false ) noexcept = 0;
+
+
 public:
     /// Virtual destructor to make the compiler happy
     virtual ~ModelDatabaseApi() {}
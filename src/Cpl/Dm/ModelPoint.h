@@ -148,6 +148,24 @@ public:
                          bool   verbose = true,
                          bool   pretty = false ) noexcept = 0;
 
+    /** This method is the same as toJSON() above, except that the conversion
+        is done using the caller supplied JSON document 'doc' instead of the
+        Model Database's global JSON document. This means the conversion does
+        NOT acquire the Model Database's global lock, i.e. multiple threads
+        can concurrently convert Model Points to JSON as long each thread
+        uses its own document instance.
+
+        NOTE: The capacity of 'doc' must be large enough to hold the Model
+              Point's JSON object (see OPTION_CPL_DM_MODEL_DATABASE_MAX_CAPACITY_JSON_DOC).
+              The content of 'doc' is cleared at the start of the conversion.
+     */
+    virtual bool toJSON( JsonDocument& doc,
+                         char*         dst,
+                         size_t        dstSize,
+                         bool&         truncated,
+                         bool          verbose = true,
+                         bool          pretty = false ) noexcept = 0;
+
 
     /** This method returns a string identifier for the Model Point's data type.
         This value IS GUARANTEED to be unique (within an Application).  The
@@ -161,6 +179,30 @@ public:
      */
     virtual const char* getTypeAsText() const noexcept = 0;
 
+public:
+    /// Write and change notification statistics (see getStats())
+    struct Stats_T
+    {
+        unsigned long m_writes;             //!< Number of write operations (not counting writes that were dropped because the MP was locked)
+        unsigned long m_noopWrites;         //!< Number of write operations that did NOT change the MP's value, i.e. were rejected by isDataEqual_()
+        unsigned long m_changes;            //!< Number of times the MP's sequence number was advanced, i.e. change notifications were generated
+        unsigned long m_notifications;      //!< Number of change notifications that were queued for subscribers (including the initial notification when subscribing)
+        unsigned long m_callbacks;          //!< Number of subscriber change notification callbacks that were executed
+        unsigned long m_callbackTicks;      //!< Total time spent in subscriber callbacks (in Cpl::System::EventLoop profiling 'ticks')
+        unsigned long m_maxCallbackTicks;   //!< Maximum time spent in a single subscriber callback
+    };
+
+    /** This method returns the Model Point's write and change notification
+        statistics.  When 'resetStats' is true, the statistics are cleared
+        after being returned.  The method returns false (and 'dstStats' is not
+        updated) when the statistics are not enabled, i.e. the
+        USE_CPL_DM_MODEL_POINT_STATS symbol is not defined.
+
+        The subscriber callback times are measured by the subscriber's
+        Cpl::Dm::EventLoop.
+     */
+    virtual bool getStats( Stats_T& dstStats, bool resetStats = false ) noexcept = 0;
+
 public:
     /** This method returns true if the Model Point is in the locked state.
         In the locked state - ALL WRITE/UPDATE OPERATIONS (except for changing
@@ -367,7 +409,8 @@ public:
         eDETACH,            //!< The Application is requesting to un-subscribe from the model point
         eDATA_CHANGED,      //!< The model point's data/state has change a pending change notification is needed
         eNOTIFYING,         //!< The subscriber's change notification callback is being called
-        eNOTIFY_COMPLETE    //!< The subscriber's change notification callback has been completed
+        eNOTIFY_COMPLETE,   //!< The subscriber's change notification callback has been completed
+        eDEFERRED_EXPIRED   //!< The subscriber's minimum notification interval - for a deferred change notification - has expired
     };
 
     /** This method has PACKAGE Scope, i.e. it is intended to be ONLY accessible
@@ -496,6 +539,68 @@ public:
    */
     virtual bool importMetadata_( const void* srcDataStream, size_t& bytesConsumed ) noexcept { bytesConsumed = 0;  return true; }
 
+    /** This method has PACKAGE Scope, i.e. it is intended to be ONLY accessible
+        by other classes in the Cpl::Dm namespace.  The Application should
+        NEVER call this method.
+
+        This method is NOT Thread Safe.
+
+        This method is used to check - without any side effects - that the
+        incoming meta data is compatible with the Model Point, i.e. it returns
+        the same result as importMetadata_().
+
+        A default implementation is provided that always returns true, i.e. for
+        model points that do not have metadata
+   */
+    virtual bool validateMetadata_( const void* srcDataStream, size_t& bytesConsumed ) const noexcept { bytesConsumed = 0;  return true; }
+
+    /** This method has PACKAGE Scope, i.e. it is intended to be ONLY accessible
+        by other classes in the Cpl::Dm namespace.  The Application should
+        NEVER call this method.
+
+        This method is thread safe, i.e. the Model Point is locked (see
+        ModelPointCommon_::lock_()) while its data and state are updated.  The
+        Model Database additionally holds its own lock for the duration of a
+        restore() operation.
+
+        This method is used by the Model Database to restore the Model Point's
+        value, valid state, and locked state from a database snapshot. The
+        format of 'srcDataStream' is the same as exportData() when
+        'includeLockedState' is true.  The record MUST have already been
+        accepted by validateSnapshot_(), i.e. the size and the meta data of
+        the record are NOT re-checked (and importMetadata_() is not called).
+        Unlike importData(), change notifications are ONLY generated when the
+        Model Point's data and/or state actually changed.  When 'seqNumber' is
+        not SEQUENCE_NUMBER_UNKNOWN, the Model Point's sequence number is set
+        to 'seqNumber' BEFORE any change notifications are generated.
+
+        The method returns the number of bytes consumed.
+     */
+    virtual size_t importSnapshot_( const void* srcDataStream, size_t srcLength, uint16_t seqNumber ) noexcept = 0;
+
+    /** This method has PACKAGE Scope, i.e. it is intended to be ONLY accessible
+        by other classes in the Cpl::Dm namespace.  The Application should
+        NEVER call this method.
+
+        This method is used by the Model Database to check - without modifying
+        the Model Point - that importSnapshot_() will accept the specified
+        snapshot record, i.e. that the size AND the meta data of the record
+        match the Model Point.  The method returns true if the record is
+        compatible; else false is returned.
+     */
+    virtual bool validateSnapshot_( const void* srcDataStream, size_t srcLength ) const noexcept = 0;
+
+    /** This method has PACKAGE Scope, i.e. it is intended to be ONLY accessible
+        by other classes in the Cpl::Dm namespace.  The Application should
+        NEVER call this method.
+
+        This method is used by the Event Loop to record that a subscriber
+        change notification callback took 'elapsedTicks' to execute (see
+        getStats()).  The method does nothing when the statistics are not
+        enabled.
+     */
+    virtual void recordCallbackTime_( unsigned long elapsedTicks ) noexcept = 0;
+
 
     /** This method has PACKAGE Scope, i.e. it is intended to be ONLY accessible
         by other classes in the Cpl::Dm namespace.  The Application should
@@ -14,6 +14,7 @@
 #include "Cpl/Text/strip.h"
 #include "Cpl/Text/atob.h"
 #include "Cpl/System/Assert.h"
+#include "Cpl/System/ElapsedTime.h"
 
 ///
 using namespace Cpl::Dm;
@@ -26,6 +27,7 @@ enum State_T
     eSTATE_NOTIFY_PENDING,            // Subscribed and waiting for next change notification dispatch cycle
     eSTATE_NOTIFY_NOTIFYING,          // The Client change notification callback is being executed
     eSTATE_NOTIFY_PENDING_DETACH,     // The subscription was requested to be cancelled during the change notification callback 
+    eSTATE_NOTIFY_DEFERRED,           // Subscribed and waiting for the minimum notification interval to expire before the change notification is dispatched
 };
 
 
@@ -42,7 +44,16 @@ ModelPointCommon_::ModelPointCommon_( ModelDatabase& myModelBase,
     , m_seqNum( SEQUENCE_NUMBER_UNKNOWN + 1          )
     , m_locked( false )
     , m_valid( isValid )
+#ifdef USE_CPL_DM_MODEL_POINT_LOCKS
+    , m_seqLock( 0 )
+    , m_lockDepth( 0 )
+    , m_lockFreeReads( false )
+#endif
 {
+#ifdef USE_CPL_DM_MODEL_POINT_STATS
+    memset( &m_stats, 0, sizeof( m_stats ) );
+#endif
+
     // Automagically add myself to the Model Database
     myModelBase.insert_( *this );
 
@@ -67,27 +78,49 @@ size_t ModelPointCommon_::getSize() const noexcept
 
 uint16_t ModelPointCommon_::getSequenceNumber() const noexcept
 {
-    m_modelDatabase.lock_();
+#ifdef USE_CPL_DM_MODEL_POINT_LOCKS
+    bool     valid;
+    uint16_t seqNum;
+    if ( readLockFree( 0, 0, valid, seqNum ) )
+    {
+        return seqNum;
+    }
+#endif
+
+    lock_();
     uint16_t result = m_seqNum;
-    m_modelDatabase.unlock_();
+    unlock_();
     return result;
 }
 
 bool ModelPointCommon_::isNotValid( uint16_t* seqNumPtr ) const noexcept
 {
-    m_modelDatabase.lock_();
+#ifdef USE_CPL_DM_MODEL_POINT_LOCKS
+    bool     valid;
+    uint16_t seqNum;
+    if ( readLockFree( 0, 0, valid, seqNum ) )
+    {
+        if ( seqNumPtr )
+        {
+            *seqNumPtr = seqNum;
+        }
+        return !valid;
+    }
+#endif
+
+    lock_();
     bool result = m_valid;
     if ( seqNumPtr )
     {
         *seqNumPtr = m_seqNum;
     }
-    m_modelDatabase.unlock_();
+    unlock_();
     return !result;
 }
 
 uint16_t ModelPointCommon_::setInvalid( LockRequest_T lockRequest ) noexcept
 {
-    m_modelDatabase.lock_();
+    lock_();
     if ( testAndUpdateLock( lockRequest ) )
     {
         if ( m_valid )
@@ -99,10 +132,16 @@ uint16_t ModelPointCommon_::setInvalid( LockRequest_T lockRequest ) noexcept
     }
 
     uint16_t result = m_seqNum;
-    m_modelDatabase.unlock_();
+    unlock_();
     return result;
 }
 
+bool ModelPointCommon_::getNumericValue_( double& dstValue ) const noexcept
+{
+    // Not a numeric Model Point
+    return false;
+}
+
 void ModelPointCommon_::hookSetInvalid() noexcept
 {
     // Set the data to a known state so that transition from the invalid to the 
@@ -112,7 +151,20 @@ void ModelPointCommon_::hookSetInvalid() noexcept
 
 bool ModelPointCommon_::readData( void* dstData, size_t dstSize, uint16_t* seqNumPtr ) const noexcept
 {
-    m_modelDatabase.lock_();
+#ifdef USE_CPL_DM_MODEL_POINT_LOCKS
+    bool     isValid;
+    uint16_t seqNum;
+    if ( readLockFree( dstData, dstSize, isValid, seqNum ) )
+    {
+        if ( seqNumPtr )
+        {
+            *seqNumPtr = seqNum;
+        }
+        return isValid;
+    }
+#endif
+
+    lock_();
     bool valid = m_valid;
     if ( dstData && valid )
     {
@@ -122,24 +174,33 @@ bool ModelPointCommon_::readData( void* dstData, size_t dstSize, uint16_t* seqNu
     {
         *seqNumPtr = m_seqNum;
     }
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return valid;
 }
 
 uint16_t ModelPointCommon_::writeData( const void* srcData, size_t srcSize, LockRequest_T lockRequest ) noexcept
 {
-    m_modelDatabase.lock_();
+    lock_();
     if ( srcData && testAndUpdateLock( lockRequest ) )
     {
+#ifdef USE_CPL_DM_MODEL_POINT_STATS
+        m_stats.m_writes++;
+#endif
         if ( !m_valid || isDataEqual_( srcData ) == false )
         {
             copyDataFrom_( srcData, srcSize );
             processDataUpdated();
         }
+#ifdef USE_CPL_DM_MODEL_POINT_STATS
+        else
+        {
+            m_stats.m_noopWrites++;
+        }
+#endif
     }
     uint16_t result = m_seqNum;
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
@@ -152,21 +213,80 @@ uint16_t ModelPointCommon_::copyDataAndStateFrom( const ModelPointCommon_& src,
         return setInvalid();
     }
 
-    m_modelDatabase.lock_();
+    // Lock both Model Points. Note: The locks are always acquired in the same (address) order to prevent deadlocks
+    const ModelPointCommon_* first  = this < &src ? this : &src;
+    const ModelPointCommon_* second = this < &src ? &src : this;
+    first->lock_();
+    second->lock_();
     uint16_t seqNum = writeData( src.m_dataPtr, src.m_dataSize, lockRequest );
-    m_modelDatabase.unlock_();
+    second->unlock_();
+    first->unlock_();
     return seqNum;
 }
 
 uint16_t ModelPointCommon_::touch() noexcept
 {
-    m_modelDatabase.lock_();
+    lock_();
     processChangeNotifications();
     uint16_t result = m_seqNum;
-    m_modelDatabase.unlock_();
+    unlock_();
     return result;
 }
 
+void ModelPointCommon_::enableLockFreeReads_() noexcept
+{
+#ifdef USE_CPL_DM_MODEL_POINT_LOCKS
+    m_lockFreeReads = m_dataSize <= OPTION_CPL_DM_MODEL_POINT_SEQLOCK_MAX_DATA_SIZE;
+#endif
+}
+
+#ifdef USE_CPL_DM_MODEL_POINT_LOCKS
+bool ModelPointCommon_::readLockFree( void* dstData, size_t dstSize, bool& valid, uint16_t& seqNum ) const noexcept
+{
+    // Data reads are only lock-free when explicitly enabled
+    if ( dstData && !m_lockFreeReads )
+    {
+        return false;
+    }
+
+    CPL_SYSTEM_ASSERT( dstSize <= m_dataSize );
+    uint8_t copy[OPTION_CPL_DM_MODEL_POINT_SEQLOCK_MAX_DATA_SIZE];
+    for ( unsigned i=0; i < OPTION_CPL_DM_MODEL_POINT_SEQLOCK_MAX_RETRIES; i++ )
+    {
+        // Skip the attempt if an update is in progress
+        uint32_t before = m_seqLock.load( std::memory_order_acquire );
+        if ( ( before & 1 ) != 0 )
+        {
+            continue;
+        }
+
+        // Copy the data/state (into a temporary buffer since the data can be inconsistent)
+        bool     isValid = m_valid;
+        uint16_t curSeq  = m_seqNum;
+        if ( dstData && isValid )
+        {
+            memcpy( copy, m_dataPtr, dstSize );
+        }
+
+        // The copy is consistent if there was no update while copying
+        std::atomic_thread_fence( std::memory_order_acquire );
+        if ( m_seqLock.load( std::memory_order_relaxed ) == before )
+        {
+            if ( dstData && isValid )
+            {
+                memcpy( dstData, copy, dstSize );
+            }
+            valid  = isValid;
+            seqNum = curSeq;
+            return true;
+        }
+    }
+
+    // If I get here the lock-free read was not successful
+    return false;
+}
+#endif
+
 void ModelPointCommon_::copyDataTo_( void* dstData, size_t dstSize ) const noexcept
 {
     CPL_SYSTEM_ASSERT( dstSize <= m_dataSize);
@@ -196,29 +316,40 @@ size_t ModelPointCommon_::getInternalDataSize_() const noexcept
 
 /////////////////
 bool ModelPointCommon_::toJSON( char* dst, size_t dstSize, bool& truncated, bool verbose, bool pretty ) noexcept
+{
+    // Get access to the Global JSON document
+    ModelDatabase::globalLock_();
+    bool result = toJSON( ModelDatabase::g_doc_, dst, dstSize, truncated, verbose, pretty );
+
+    // Release the Global JSON document
+    ModelDatabase::globalUnlock_();
+    return result;
+}
+
+bool ModelPointCommon_::toJSON( JsonDocument& doc, char* dst, size_t dstSize, bool& truncated, bool verbose, bool pretty ) noexcept
 {
     // Get a snapshot of the my data and state
-    m_modelDatabase.lock_();
+    lock_();
 
     // Start the conversion
-    JsonDocument& doc = beginJSON( m_valid, m_locked, m_seqNum, verbose );
+    beginJSON( doc, m_valid, m_locked, m_seqNum, verbose );
 
     // Construct the 'val' key/value pair (as a simple numeric)
     if ( m_valid )
     {
         setJSONVal( doc );
     }
+    unlock_();
 
-    // End the conversion
-    endJSON( dst, dstSize, truncated, verbose, pretty );
-    m_modelDatabase.unlock_();
+    // End the conversion.  Note: The document contains a copy of the MP's data, i.e. no lock is required to generate the output string
+    endJSON( doc, dst, dstSize, truncated, verbose, pretty );
     return true;
 }
 
 /////////////////
 uint16_t ModelPointCommon_::setLockState( LockRequest_T lockRequest ) noexcept
 {
-    m_modelDatabase.lock_();
+    lock_();
     if ( lockRequest == eLOCK )
     {
         m_locked = true;
@@ -228,15 +359,15 @@ uint16_t ModelPointCommon_::setLockState( LockRequest_T lockRequest ) noexcept
         m_locked = false;
     }
     uint16_t result = m_seqNum;
-    m_modelDatabase.unlock_();
+    unlock_();
     return result;
 }
 
 bool ModelPointCommon_::isLocked() const noexcept
 {
-    m_modelDatabase.lock_();
+    lock_();
     bool result = m_locked;
-    m_modelDatabase.unlock_();
+    unlock_();
     return result;
 }
 
@@ -247,7 +378,7 @@ size_t ModelPointCommon_::exportData( void* dstDataStream, size_t maxDstLength,
     size_t result = 0;
     if ( dstDataStream )
     {
-        m_modelDatabase.lock_();
+        lock_();
 
         // Do nothing if there is not enough space left in the destination stream
         if ( maxDstLength >= getExternalSize() )
@@ -280,7 +411,7 @@ size_t ModelPointCommon_::exportData( void* dstDataStream, size_t maxDstLength,
             }
         }
 
-        m_modelDatabase.unlock_();
+        unlock_();
     }
     return result;
 }
@@ -290,7 +421,7 @@ size_t ModelPointCommon_::importData( const void* srcDataStream, size_t srcLengt
     size_t result = 0;
     if ( srcDataStream )
     {
-        m_modelDatabase.lock_();
+        lock_();
 
         // Fail the import when there is not enough data left in the input stream
         if ( getExternalSize() <= srcLength )
@@ -324,11 +455,52 @@ size_t ModelPointCommon_::importData( const void* srcDataStream, size_t srcLengt
             }
         }
 
-        m_modelDatabase.unlock_();
+        unlock_();
     }
     return result;
 }
 
+size_t ModelPointCommon_::importSnapshot_( const void* srcDataStream, size_t srcLength, uint16_t seqNumber ) noexcept
+{
+    // NOTE: The record has already been accepted by validateSnapshot_(), i.e. the meta data (if any) is skipped - not re-validated
+    lock_();
+    size_t         dataSize = getSize();
+    const uint8_t* srcPtr   = ( (const uint8_t*)srcDataStream ) + srcLength - dataSize - sizeof( m_valid ) - sizeof( m_locked );
+
+    // Extract the valid/locked state
+    bool           valid;
+    bool           locked;
+    memcpy( &valid, srcPtr + dataSize, sizeof( valid ) );
+    memcpy( &locked, srcPtr + dataSize + sizeof( valid ), sizeof( locked ) );
+
+    // Only update the MP (and generate change notifications) if something actually changed
+    bool changed = valid != m_valid || locked != m_locked || memcmp( getImportExportDataPointer_(), srcPtr, dataSize ) != 0;
+    if ( changed )
+    {
+        memcpy( (void*)getImportExportDataPointer_(), srcPtr, dataSize );
+        m_valid  = valid;
+        m_locked = locked;
+    }
+
+    if ( seqNumber != SEQUENCE_NUMBER_UNKNOWN )
+    {
+        m_seqNum = seqNumber;
+    }
+    if ( changed )
+    {
+        processChangeNotifications();
+    }
+
+    unlock_();
+    return srcLength;
+}
+
+bool ModelPointCommon_::validateSnapshot_( const void* srcDataStream, size_t srcLength ) const noexcept
+{
+    size_t bytesConsumed;
+    return srcDataStream != 0 && srcLength == getExternalSize( true ) && validateMetadata_( srcDataStream, bytesConsumed );
+}
+
 size_t ModelPointCommon_::getExternalSize( bool includeLockedState ) const noexcept
 {
     size_t baseSize =  getInternalDataSize_() + sizeof( m_valid );
@@ -358,32 +530,68 @@ void ModelPointCommon_::processChangeNotifications() noexcept
 {
     // Increment the sequence number
     advanceSequenceNumber();
-
-    // Generate change notifications 
-    SubscriberApi* item = m_subscribers.get();
+#ifdef USE_CPL_DM_MODEL_POINT_STATS
+    m_stats.m_changes++;
+#endif
+
+    // Generate change notifications. Note: Subscribers whose change notification is suppressed (i.e. deadband) are put back into the subscriber list
+    Cpl::Container::DList<SubscriberApi> subscribers;
+    m_subscribers.move( subscribers );
+    SubscriberApi* item = subscribers.get();
     while ( item )
     {
         processSubscriptionEvent_( *item, eDATA_CHANGED );
-        item = m_subscribers.get();
+        item = subscribers.get();
+    }
+}
+
+/////////////////
+bool ModelPointCommon_::getStats( Stats_T& dstStats, bool resetStats ) noexcept
+{
+#ifdef USE_CPL_DM_MODEL_POINT_STATS
+    lock_();
+    dstStats = m_stats;
+    if ( resetStats )
+    {
+        memset( &m_stats, 0, sizeof( m_stats ) );
+    }
+    unlock_();
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ModelPointCommon_::recordCallbackTime_( unsigned long elapsedTicks ) noexcept
+{
+#ifdef USE_CPL_DM_MODEL_POINT_STATS
+    lock_();
+    m_stats.m_callbacks++;
+    m_stats.m_callbackTicks += elapsedTicks;
+    if ( elapsedTicks > m_stats.m_maxCallbackTicks )
+    {
+        m_stats.m_maxCallbackTicks = elapsedTicks;
     }
+    unlock_();
+#endif
 }
 
 /////////////////
 void ModelPointCommon_::attachSubscriber( SubscriberApi& observer, uint16_t initialSeqNumber ) noexcept
 {
-    m_modelDatabase.lock_();
+    lock_();
     observer.setSequenceNumber_( initialSeqNumber );
     observer.setModelPoint_( this );
     processSubscriptionEvent_( observer, eATTACH );
-    m_modelDatabase.unlock_();
+    unlock_();
 }
 
 void ModelPointCommon_::detachSubscriber( SubscriberApi& observer ) noexcept
 {
-    m_modelDatabase.lock_();
+    lock_();
     processSubscriptionEvent_( observer, eDETACH );
     observer.setModelPoint_( 0 );
-    m_modelDatabase.unlock_();
+    unlock_();
 }
 
 void ModelPointCommon_::genericAttach( SubscriberApi& observer, uint16_t initialSeqNumber) noexcept
@@ -400,7 +608,7 @@ void ModelPointCommon_::genericDetach( SubscriberApi& observer ) noexcept
 /////////////////
 void ModelPointCommon_::processSubscriptionEvent_( SubscriberApi& subscriber, Event_T event ) noexcept
 {
-    m_modelDatabase.lock_();
+    lock_();
 
     switch ( (State_T) subscriber.getState_() )
     {
@@ -435,7 +643,7 @@ void ModelPointCommon_::processSubscriptionEvent_( SubscriberApi& subscriber, Ev
 
         case eDATA_CHANGED:
             // NOTE: By definition if the eDATA_CHANGED event was generated - the subscriber is NOT in the MP's subscribers list
-            transitionToNotifyPending( subscriber );
+            transitionOnDataChanged( subscriber );
             break;
 
             // Ignore all other events
@@ -458,9 +666,15 @@ void ModelPointCommon_::processSubscriptionEvent_( SubscriberApi& subscriber, Ev
             break;
 
         case eNOTIFYING:
+        {
+            // Capture the 'delivered' value/time for the subscriber's notification options
+            NotificationOptions_& options = subscriber.getNotificationOptions_();
+            options.m_lastNotifyMsec      = Cpl::System::ElapsedTime::milliseconds();
+            options.m_lastValueValid      = m_valid && options.m_deadband != 0.0 && getNumericValue_( options.m_lastValue );
             subscriber.setSequenceNumber_( m_seqNum );
             subscriber.setState_( eSTATE_NOTIFY_NOTIFYING );
             break;
+        }
 
         case eDATA_CHANGED:
             Cpl::System::FatalError::logf( "ModelPointCommon_::processSubscriptionEvent_(): Data changed received when in the eSTATE_NOTIFY_PENDING state!" );
@@ -513,9 +727,37 @@ void ModelPointCommon_::processSubscriptionEvent_( SubscriberApi& subscriber, Ev
             break;
         }
         break;
+
+    case eSTATE_NOTIFY_DEFERRED:
+        switch ( event )
+        {
+        case eATTACH:
+            subscriber.getNotificationApi_()->removeDeferredChangeNotification_( subscriber );
+            transitionToSubscribed( subscriber );
+            break;
+
+        case eDETACH:
+            subscriber.getNotificationApi_()->removeDeferredChangeNotification_( subscriber );
+            subscriber.setState_( eSTATE_UNSUBSCRIBED );
+            break;
+
+        case eDEFERRED_EXPIRED:
+            // Note: All of the changes that occurred while deferred are coalesced into a single change notification
+            transitionToNotifyPending( subscriber );
+            break;
+
+        case eDATA_CHANGED:
+            Cpl::System::FatalError::logf( "ModelPointCommon_::processSubscriptionEvent_(): Data changed received when in the eSTATE_NOTIFY_DEFERRED state!" );
+            break;
+
+            // Ignore all other events
+        default:
+            break;
+        }
+        break;
     }
 
-    m_modelDatabase.unlock_();
+    unlock_();
 }
 
 void ModelPointCommon_::transitionToSubscribed( SubscriberApi& subscriber ) noexcept
@@ -534,10 +776,42 @@ void ModelPointCommon_::transitionToSubscribed( SubscriberApi& subscriber ) noex
     }
 }
 
+void ModelPointCommon_::transitionOnDataChanged( SubscriberApi& subscriber ) noexcept
+{
+    NotificationOptions_& options = subscriber.getNotificationOptions_();
+
+    // Suppress the change notification when the new value is inside of the deadband
+    double value;
+    if ( options.m_lastValueValid && m_valid && getNumericValue_( value ) )
+    {
+        double delta = value - options.m_lastValue;
+        double band  = options.m_relativeDeadband ? options.m_deadband * options.m_lastValue : options.m_deadband;
+        if ( ( delta < 0.0 ? -delta : delta ) <= ( band < 0.0 ? -band : band ) )
+        {
+            subscriber.setState_( eSTATE_IDLE );
+            m_subscribers.put( subscriber );
+            return;
+        }
+    }
+
+    // Defer the change notification when the minimum notification interval has not expired
+    if ( options.m_minIntervalMsec && !Cpl::System::ElapsedTime::expiredMilliseconds( options.m_lastNotifyMsec, options.m_minIntervalMsec ) )
+    {
+        subscriber.getNotificationApi_()->addDeferredChangeNotification_( subscriber );
+        subscriber.setState_( eSTATE_NOTIFY_DEFERRED );
+        return;
+    }
+
+    transitionToNotifyPending( subscriber );
+}
+
 void ModelPointCommon_::transitionToNotifyPending( SubscriberApi& subscriber ) noexcept
 {
     subscriber.getNotificationApi_()->addPendingChangingNotification_( subscriber );
     subscriber.setState_( eSTATE_NOTIFY_PENDING );
+#ifdef USE_CPL_DM_MODEL_POINT_STATS
+    m_stats.m_notifications++;
+#endif
 }
 
 
@@ -567,25 +841,23 @@ bool ModelPointCommon_::testAndUpdateLock( LockRequest_T lockRequest ) noexcept
 }
 
 /////////////////
-JsonDocument& ModelPointCommon_::beginJSON( bool isValid, bool locked, uint16_t seqnum, bool verbose ) noexcept
+JsonDocument& ModelPointCommon_::beginJSON( JsonDocument& doc, bool isValid, bool locked, uint16_t seqnum, bool verbose ) noexcept
 {
-    // Get access to the Global JSON document
-    ModelDatabase::globalLock_();
-    ModelDatabase::g_doc_.clear();  // Make sure the JSON document is starting "empty"
+    doc.clear();  // Make sure the JSON document is starting "empty"
 
     // Construct the JSON
-    ModelDatabase::g_doc_["name"]  = getName();
-    ModelDatabase::g_doc_["valid"] = isValid;
+    doc["name"]  = getName();
+    doc["valid"] = isValid;
     if ( verbose )
     {
-        ModelDatabase::g_doc_["type"]      = getTypeAsText();
-        ModelDatabase::g_doc_["seqnum"]    = seqnum;
-        ModelDatabase::g_doc_["locked"]    = locked;
+        doc["type"]      = getTypeAsText();
+        doc["seqnum"]    = seqnum;
+        doc["locked"]    = locked;
     }
-    return ModelDatabase::g_doc_;
+    return doc;
 }
 
-void ModelPointCommon_::endJSON( char* dst, size_t dstSize, bool& truncated, bool verbose, bool pretty ) noexcept
+void ModelPointCommon_::endJSON( JsonDocument& doc, char* dst, size_t dstSize, bool& truncated, bool verbose, bool pretty ) noexcept
 {
     size_t jsonLen;
     size_t outputLen;
@@ -593,16 +865,13 @@ void ModelPointCommon_::endJSON( char* dst, size_t dstSize, bool& truncated, boo
     // Generate the actual output string 
     if ( !pretty )
     {
-        jsonLen   = measureJson( ModelDatabase::g_doc_ );
-        outputLen = serializeJson( ModelDatabase::g_doc_, dst, dstSize );
+        jsonLen   = measureJson( doc );
+        outputLen = serializeJson( doc, dst, dstSize );
     }
     else
     {
-        jsonLen   = measureJsonPretty( ModelDatabase::g_doc_ );
-        outputLen = serializeJsonPretty( ModelDatabase::g_doc_, dst, dstSize );
+        jsonLen   = measureJsonPretty( doc );
+        outputLen = serializeJsonPretty( doc, dst, dstSize );
     }
     truncated = outputLen == jsonLen ? false : true;
-
-    // Release the Global JSON document
-    ModelDatabase::globalUnlock_();
 }
@@ -19,6 +19,27 @@
 #include "Cpl/Container/DList.h"
 #include <stdint.h>
 #include <stdlib.h>
+#ifdef USE_CPL_DM_MODEL_POINT_LOCKS
+#include "Cpl/System/Mutex.h"
+#include <atomic>
+#endif
+
+
+/** This symbol defines the number of lock-free (i.e. seqlock) read attempts
+    that are made before a reader falls back to locking the Model Point. Only
+    applicable when USE_CPL_DM_MODEL_POINT_LOCKS is defined.
+ */
+#ifndef OPTION_CPL_DM_MODEL_POINT_SEQLOCK_MAX_RETRIES
+#define OPTION_CPL_DM_MODEL_POINT_SEQLOCK_MAX_RETRIES       4
+#endif
+
+/** This symbol defines the maximum data size, in bytes, of a Model Point that
+    supports lock-free reads.  Only applicable when USE_CPL_DM_MODEL_POINT_LOCKS
+    is defined.
+ */
+#ifndef OPTION_CPL_DM_MODEL_POINT_SEQLOCK_MAX_DATA_SIZE
+#define OPTION_CPL_DM_MODEL_POINT_SEQLOCK_MAX_DATA_SIZE     16
+#endif
 
 ///
 namespace Cpl {
@@ -27,6 +48,18 @@ namespace Dm {
 
 
 /** This concrete class provide common infrastructure for a Model Point.
+
+    By default, the Model Point's data, state, and list of subscribers are
+    protected by the Model Database's mutex, i.e. a single mutex that is shared
+    by ALL Model Points in the database.  When USE_CPL_DM_MODEL_POINT_LOCKS is
+    defined, each Model Point has its own mutex so that operations on unrelated
+    Model Points do not contend with each other.  In addition, a seqlock is
+    maintained for each Model Point so that getSequenceNumber(), isNotValid(),
+    and - for Model Points that call enableLockFreeReads_() (e.g. Numeric<>,
+    Bool, Enum_) - reads are lock-free.  Note: With per-Model Point locking,
+    the Model Database's lock_() method does NOT block updates to the Model
+    Points, i.e. database wide operations (e.g. snapshot()) are only
+    consistent on a per Model Point basis.
  */
 class ModelPointCommon_ : public Cpl::Dm::ModelPoint
 {
@@ -81,6 +114,12 @@ public:
     /// See Cpl::Dm::ModelPoint
     bool toJSON( char* dst, size_t dstSize, bool& truncated, bool verbose=true, bool pretty=false ) noexcept;
 
+    /// See Cpl::Dm::ModelPoint
+    bool toJSON( JsonDocument& doc, char* dst, size_t dstSize, bool& truncated, bool verbose=true, bool pretty=false ) noexcept;
+
+    /// See Cpl::Dm::ModelPoint
+    bool getStats( Stats_T& dstStats, bool resetStats = false ) noexcept;
+
 protected:
     /** This method is used to read the MP contents and synchronize
         the observer with the current MP contents.  This method should ONLY be
@@ -148,6 +187,15 @@ protected:
     /// See Cpl::Dm::ModelPoint.  
     size_t getInternalDataSize_() const noexcept;
 
+    /// See Cpl::Dm::ModelPoint.  Note: The implementation does NOT account for Endianess, i.e. assumes the 'platform' is the same for export/import
+    size_t importSnapshot_( const void* srcDataStream, size_t srcLength, uint16_t seqNumber ) noexcept;
+
+    /// See Cpl::Dm::ModelPoint
+    bool validateSnapshot_( const void* srcDataStream, size_t srcLength ) const noexcept;
+
+    /// See Cpl::Dm::ModelPoint
+    void recordCallbackTime_( unsigned long elapsedTicks ) noexcept;
+
 public:
     /// See Cpl::Dm::ModelPoint
     void processSubscriptionEvent_( SubscriberApi& subscriber, Event_T event ) noexcept;
@@ -200,11 +248,14 @@ protected:
     /// Helper FSM method
     virtual void transitionToSubscribed( SubscriberApi& subscriber ) noexcept;
 
+    /// Helper FSM method. Applies the subscriber's notification options (deadband, minimum interval) to a data change
+    virtual void transitionOnDataChanged( SubscriberApi& subscriber ) noexcept;
+
     /// Helper method when converting MP to a JSON string
-    virtual JsonDocument& beginJSON( bool isValid, bool locked, uint16_t seqnum, bool verbose=true ) noexcept;
+    virtual JsonDocument& beginJSON( JsonDocument& doc, bool isValid, bool locked, uint16_t seqnum, bool verbose=true ) noexcept;
 
     /// Helper method when converting MP to a JSON string
-    virtual void endJSON( char* dst, size_t dstSize, bool& truncated, bool verbose=true, bool pretty=false ) noexcept;
+    virtual void endJSON( JsonDocument& doc, char* dst, size_t dstSize, bool& truncated, bool verbose=true, bool pretty=false ) noexcept;
 
     /** Helper method that a child a class can override to change behavior when
         an MP is set to the invalid state.  The default behavior is to zero out
@@ -212,6 +263,74 @@ protected:
      */
     virtual void hookSetInvalid() noexcept;
 
+    /** Helper method that a numeric child class overrides to return its
+        current value as a double.  The value is used when applying a
+        subscriber's deadband (see Cpl::Dm::SubscriberBase::setDeadband()).
+        The method returns false if the Model Point is not numeric (which is
+        the default behavior).
+
+        This method is NOT thread safe.
+     */
+    virtual bool getNumericValue_( double& dstValue ) const noexcept;
+
+
+protected:
+    /** This method locks the Model Point's data, state, and list of
+        subscribers.  For every call to lock_() there must be corresponding
+        call to unlock_().  The lock is recursive.
+
+        NOTE: Custom Model Points MUST use this method - and NOT the Model
+              Database's lock_() method - to make read-modify-write updates
+              atomic.  With USE_CPL_DM_MODEL_POINT_LOCKS defined, the database
+              lock does not protect the Model Point's data.
+     */
+    inline void lock_() const noexcept
+    {
+#ifdef USE_CPL_DM_MODEL_POINT_LOCKS
+        m_lock.lock();
+        if ( m_lockDepth++ == 0 )
+        {
+            // Odd sequence count: update in progress
+            m_seqLock.store( m_seqLock.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+            std::atomic_thread_fence( std::memory_order_release );
+        }
+#else
+        m_modelDatabase.lock_();
+#endif
+    }
+
+    /// This method unlocks the Model Point
+    inline void unlock_() const noexcept
+    {
+#ifdef USE_CPL_DM_MODEL_POINT_LOCKS
+        if ( --m_lockDepth == 0 )
+        {
+            // Even sequence count: update completed
+            m_seqLock.store( m_seqLock.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+        }
+        m_lock.unlock();
+#else
+        m_modelDatabase.unlock_();
+#endif
+    }
+
+    /** This method is used by a child class to enable lock-free reads (when
+        USE_CPL_DM_MODEL_POINT_LOCKS is defined) of the Model Point data.  The
+        method should only be called by child classes whose data is a small,
+        fixed size, value type that is read using the default copyDataTo_()
+        implementation, e.g. Numeric<>, Bool, Enum_.
+     */
+    void enableLockFreeReads_() noexcept;
+
+#ifdef USE_CPL_DM_MODEL_POINT_LOCKS
+    /** Helper method that attempts a lock-free read of the Model Point's
+        data (when 'dstData' is not null), valid state, and sequence number.
+        Returns true if successful; else false is returned (i.e. the caller
+        must lock the Model Point and read it)
+     */
+    bool readLockFree( void* dstData, size_t dstSize, bool& valid, uint16_t& seqNum ) const noexcept;
+#endif
+
 
 protected:
     /// List of Active Subscribers
@@ -237,6 +356,25 @@ protected:
 
     /// valid/invalid state
     bool                                    m_valid;
+
+#ifdef USE_CPL_DM_MODEL_POINT_STATS
+    /// Write and change notification statistics
+    Stats_T                                 m_stats;
+#endif
+
+#ifdef USE_CPL_DM_MODEL_POINT_LOCKS
+    /// Per Model Point lock
+    mutable Cpl::System::Mutex              m_lock;
+
+    /// Seqlock count (odd while the Model Point is being updated)
+    mutable std::atomic<uint32_t>           m_seqLock;
+
+    /// Nesting depth of lock_() calls
+    mutable unsigned                        m_lockDepth;
+
+    /// Lock-free reads of the Model Point's data are enabled
+    bool                                    m_lockFreeReads;
+#endif
 };
 
 };      // end namespaces
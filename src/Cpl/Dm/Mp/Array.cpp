@@ -78,9 +78,9 @@ uint16_t ArrayBase_::copyArrayFrom( const ArrayBase_& src, LockRequest_T lockReq
         return setInvalid();
     }
 
-    m_modelDatabase.lock_();
+    lock_();
     uint16_t seqNum = ArrayBase_::writeArrayElements( src.m_dataPtr, src.m_numElements, 0, lockRequest );
-    m_modelDatabase.unlock_();
+    unlock_();
     return seqNum;
 }
 
@@ -138,6 +138,12 @@ size_t ArrayBase_::getInternalDataSize_() const noexcept
 }
 
 bool ArrayBase_::importMetadata_( const void* srcDataStream, size_t& bytesConsumed ) noexcept
+{
+    // No additional actions required
+    return validateMetadata_( srcDataStream, bytesConsumed );
+}
+
+bool ArrayBase_::validateMetadata_( const void* srcDataStream, size_t& bytesConsumed ) const noexcept
 {
     // NOTE: Use memcpy instead of the assignment operator since the alignment of 'srcDataStream' is unknown/not-guaranteed 
     uint8_t* incoming = (uint8_t*) srcDataStream;
@@ -152,7 +158,6 @@ bool ArrayBase_::importMetadata_( const void* srcDataStream, size_t& bytesConsum
         return false;
     }
 
-    // No additional actions required
     bytesConsumed = sizeof( incomingNumElements ) + sizeof( incomingElementSize );
     return true;
 }
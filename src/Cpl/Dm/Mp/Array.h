@@ -131,6 +131,9 @@ public:
     /// See Cpl::Dm::ModelPoint.  
     bool importMetadata_( const void* srcDataStream, size_t& bytesConsumed ) noexcept;
 
+    /// See Cpl::Dm::ModelPoint.  
+    bool validateMetadata_( const void* srcDataStream, size_t& bytesConsumed ) const noexcept;
+
     /// See Cpl::Dm::ModelPoint.  
     bool exportMetadata_( void* dstDataStream, size_t& bytesAdded ) const noexcept;
 };
@@ -43,12 +43,14 @@ public:
     Bool( Cpl::Dm::ModelDatabase& myModelBase, const char* symbolicName )
         :Cpl::Dm::ModelPointCommon_( myModelBase, symbolicName, &m_data, sizeof( m_data ), false )
     {
+        enableLockFreeReads_();
     }
 
     /// Constructor. Valid MP.  Requires an initial value
     Bool( Cpl::Dm::ModelDatabase& myModelBase, const char* symbolicName, bool initialValue )
         :Cpl::Dm::ModelPointCommon_( myModelBase, symbolicName, &m_data, sizeof( m_data ), true )
     {
+        enableLockFreeReads_();
         m_data = initialValue;
     }
 
@@ -45,6 +45,7 @@ public:
         : Cpl::Dm::ModelPointCommon_( myModelBase, symbolicName, &m_data, sizeof( m_data ), false )
         , m_data( BETTERENUM_TYPE::_from_index_unchecked( 0 ) )
     {
+        Cpl::Dm::ModelPointCommon_::enableLockFreeReads_();
     }
 
     /// Constructor: Valid MP (requires initial value)
@@ -52,6 +53,7 @@ public:
         : Cpl::Dm::ModelPointCommon_( myModelBase, symbolicName, &m_data, sizeof( m_data ), true )
         , m_data( BETTERENUM_TYPE::_from_index_unchecked( 0 ) )
     {
+        Cpl::Dm::ModelPointCommon_::enableLockFreeReads_();
         m_data = initialValue;
     }
 
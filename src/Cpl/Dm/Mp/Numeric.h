@@ -71,12 +71,14 @@ protected:
     Numeric( Cpl::Dm::ModelDatabase& myModelBase, const char* symbolicName )
         :Cpl::Dm::ModelPointCommon_( myModelBase, symbolicName, &m_data, sizeof( m_data ), false )
     {
+        Cpl::Dm::ModelPointCommon_::enableLockFreeReads_();
     }
 
     /// Constructor: Valid MP (requires initial value)
     Numeric( Cpl::Dm::ModelDatabase& myModelBase, const char* symbolicName, ELEMTYPE initialValue )
         :Cpl::Dm::ModelPointCommon_( myModelBase, symbolicName, &m_data, sizeof( m_data ), true )
     {
+        Cpl::Dm::ModelPointCommon_::enableLockFreeReads_();
         m_data = initialValue;
     }
 
@@ -96,18 +98,18 @@ public:
     /// Atomic increment
     inline uint16_t increment( ELEMTYPE incSize = 1, Cpl::Dm::ModelPoint::LockRequest_T lockRequest = Cpl::Dm::ModelPoint::eNO_REQUEST ) noexcept
     {
-        Cpl::Dm::ModelPointCommon_::m_modelDatabase.lock_();
+        Cpl::Dm::ModelPointCommon_::lock_();
         uint16_t result = write( m_data + incSize, lockRequest );
-        Cpl::Dm::ModelPointCommon_::m_modelDatabase.unlock_();
+        Cpl::Dm::ModelPointCommon_::unlock_();
         return result;
     }
 
     /// Atomic decrement
     inline uint16_t decrement( ELEMTYPE decSize = 1, Cpl::Dm::ModelPoint::LockRequest_T lockRequest = Cpl::Dm::ModelPoint::eNO_REQUEST ) noexcept
     {
-        Cpl::Dm::ModelPointCommon_::m_modelDatabase.lock_();
+        Cpl::Dm::ModelPointCommon_::lock_();
         uint16_t result = write( m_data - decSize, lockRequest );
-        Cpl::Dm::ModelPointCommon_::m_modelDatabase.unlock_();
+        Cpl::Dm::ModelPointCommon_::unlock_();
         return result;
     }
 
@@ -142,6 +144,13 @@ protected:
         doc["val"] = m_data;
     }
 
+    /// See Cpl::Dm::ModelPointCommon_
+    bool getNumericValue_( double& dstValue ) const noexcept
+    {
+        dstValue = (double) m_data;
+        return true;
+    }
+
 public:
     /// See Cpl::Dm::Point.  
     bool fromJSON_( JsonVariant& src, Cpl::Dm::ModelPoint::LockRequest_T lockRequest, uint16_t& retSequenceNumber, Cpl::Text::String* errorMsg ) noexcept
@@ -208,27 +217,27 @@ public:
     /// Atomic operation to set the zero indexed bit to a 1.
     inline uint16_t setBit( uint8_t bitPosition, Cpl::Dm::ModelPoint::LockRequest_T lockRequest = Cpl::Dm::ModelPoint::eNO_REQUEST ) noexcept
     {
-        Cpl::Dm::ModelPointCommon_::m_modelDatabase.lock_();
+        Cpl::Dm::ModelPointCommon_::lock_();
         uint16_t result = Numeric<WORDSIZE, MPTYPE>::write( Numeric<WORDSIZE, MPTYPE>::m_data | ( 1 << bitPosition ), lockRequest );
-        Cpl::Dm::ModelPointCommon_::m_modelDatabase.unlock_();
+        Cpl::Dm::ModelPointCommon_::unlock_();
         return result;
     }
 
     /// Atomic operation to set the zero indexed bit to a 0.
     inline uint16_t clearBit( uint8_t bitPosition, Cpl::Dm::ModelPoint::LockRequest_T lockRequest = Cpl::Dm::ModelPoint::eNO_REQUEST ) noexcept
     {
-        Cpl::Dm::ModelPointCommon_::m_modelDatabase.lock_();
+        Cpl::Dm::ModelPointCommon_::lock_();
         uint16_t result = Numeric<WORDSIZE, MPTYPE>::write( Numeric<WORDSIZE, MPTYPE>::m_data & ( ~( 1 << bitPosition ) ), lockRequest );
-        Cpl::Dm::ModelPointCommon_::m_modelDatabase.unlock_();
+        Cpl::Dm::ModelPointCommon_::unlock_();
         return result;
     }
 
     /// Atomic operation to toggle the zero indexed bit.
     inline uint16_t flipBit( uint8_t bitPosition, Cpl::Dm::ModelPoint::LockRequest_T lockRequest = Cpl::Dm::ModelPoint::eNO_REQUEST ) noexcept
     {
-        Cpl::Dm::ModelPointCommon_::m_modelDatabase.lock_();
+        Cpl::Dm::ModelPointCommon_::lock_();
         uint16_t result = Numeric<WORDSIZE, MPTYPE>::write( Numeric<WORDSIZE, MPTYPE>::m_data ^ ( 1 << bitPosition ), lockRequest );
-        Cpl::Dm::ModelPointCommon_::m_modelDatabase.unlock_();
+        Cpl::Dm::ModelPointCommon_::unlock_();
         return result;
     }
 
@@ -237,27 +246,27 @@ public:
     /// Atomic operation to clear ONLY the bits as specified by the bit mask.  
     inline uint16_t clearBitsByMask( uint16_t bitMask, Cpl::Dm::ModelPoint::LockRequest_T lockRequest = Cpl::Dm::ModelPoint::eNO_REQUEST ) noexcept
     {
-        Cpl::Dm::ModelPointCommon_::m_modelDatabase.lock_();
+        Cpl::Dm::ModelPointCommon_::lock_();
         uint16_t result = Numeric<WORDSIZE, MPTYPE>::write( Numeric<WORDSIZE, MPTYPE>::m_data & ~( bitMask ), lockRequest );
-        Cpl::Dm::ModelPointCommon_::m_modelDatabase.unlock_();
+        Cpl::Dm::ModelPointCommon_::unlock_();
         return result;
     }
 
     /// Atomic operation to set the bits specified by the bit mask
     inline uint16_t setBitsByMask( uint16_t bitMask, Cpl::Dm::ModelPoint::LockRequest_T lockRequest = Cpl::Dm::ModelPoint::eNO_REQUEST ) noexcept
     {
-        Cpl::Dm::ModelPointCommon_::m_modelDatabase.lock_();
+        Cpl::Dm::ModelPointCommon_::lock_();
         uint16_t result = Numeric<WORDSIZE, MPTYPE>::write( Numeric<WORDSIZE, MPTYPE>::m_data | bitMask, lockRequest );
-        Cpl::Dm::ModelPointCommon_::m_modelDatabase.unlock_();
+        Cpl::Dm::ModelPointCommon_::unlock_();
         return result;
     }
 
     /// Atomic operation to flip/toggle ONLY the bits as specified the bit mask
     inline uint16_t flipBitsByMask( uint16_t bitMask, Cpl::Dm::ModelPoint::LockRequest_T lockRequest = Cpl::Dm::ModelPoint::eNO_REQUEST ) noexcept
     {
-        Cpl::Dm::ModelPointCommon_::m_modelDatabase.lock_();
+        Cpl::Dm::ModelPointCommon_::lock_();
         uint16_t result = Numeric<WORDSIZE, MPTYPE>::write( Numeric<WORDSIZE, MPTYPE>::m_data ^ bitMask, lockRequest );
-        Cpl::Dm::ModelPointCommon_::m_modelDatabase.unlock_();
+        Cpl::Dm::ModelPointCommon_::unlock_();
         return result;
     }
 
@@ -45,21 +45,21 @@ void RefCounter::updateAndCheckForChangeNotification( uint32_t newValue )
 
 uint16_t RefCounter::reset( uint32_t newValue, LockRequest_T lockRequest ) noexcept
 {
-    m_modelDatabase.lock_();
+    lock_();
     if ( testAndUpdateLock( lockRequest ) )
     {
         // Generate change notices on transition to valid OR zero-to-not-zero
         updateAndCheckForChangeNotification( newValue );
     }
     uint16_t result = m_seqNum;
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
 
 uint16_t RefCounter::increment( uint32_t incrementAmount, LockRequest_T lockRequest ) noexcept
 {
-    m_modelDatabase.lock_();
+    lock_();
     if ( testAndUpdateLock( lockRequest ) )
     {
         // Increment the counter and prevent overflow
@@ -73,14 +73,14 @@ uint16_t RefCounter::increment( uint32_t incrementAmount, LockRequest_T lockRequ
         updateAndCheckForChangeNotification( newValue );
     }
     uint16_t result = m_seqNum;
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
 
 uint16_t RefCounter::decrement( uint32_t decrementAmount, LockRequest_T lockRequest ) noexcept
 {
-    m_modelDatabase.lock_();
+    lock_();
     if ( testAndUpdateLock( lockRequest ) )
     {
         // Decrement the counter and prevent underflow
@@ -94,7 +94,7 @@ uint16_t RefCounter::decrement( uint32_t decrementAmount, LockRequest_T lockRequ
         updateAndCheckForChangeNotification( newValue );
     }
     uint16_t result = m_seqNum;
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
@@ -87,10 +87,10 @@ uint16_t StringBase_::write( const char* srcData, size_t srcLenInBytesIncludingN
         srcLenInBytesIncludingNullTerminator = m_dataSize;
     }
     
-    m_modelDatabase.lock_();
+    lock_();
     uint16_t seqNum = writeData( srcData, srcLenInBytesIncludingNullTerminator, lockRequest );
     ((char*) (m_dataPtr))[m_dataSize - 1] = '\0'; // Ensure my new value properly null terminated
-    m_modelDatabase.unlock_();
+    unlock_();
     return seqNum;
 }
 
@@ -102,9 +102,9 @@ uint16_t StringBase_::copyFrom( const StringBase_& src, LockRequest_T lockReques
         return setInvalid();
     }
 
-    m_modelDatabase.lock_();
+    lock_();
     uint16_t seqNum = StringBase_::write( (const char*) src.m_dataPtr, src.m_dataSize, lockRequest );
-    m_modelDatabase.unlock_();
+    unlock_();
     return seqNum;
 }
 
@@ -64,6 +64,32 @@ public:
      */
     virtual void removePendingChangingNotification_( SubscriberApi& subscriber ) noexcept = 0;
 
+    /** This method has PACKAGE Scope, i.e. it is intended to be ONLY accessible
+        by other classes in the Cpl::Dm namespace.  The Application should
+        NEVER call this method.
+
+        This method is used add a 'deferred change notification' to its list
+        of deferred change notifications, i.e. a change notification that is
+        delayed until the subscriber's minimum notification interval has
+        expired (see Cpl::Dm::NotificationOptions_).  When the interval has
+        expired, the Model Point is sent a eDEFERRED_EXPIRED event.
+
+        This method IS thread safe.
+     */
+    virtual void addDeferredChangeNotification_( SubscriberApi& subscriber ) noexcept = 0;
+
+    /** This method has PACKAGE Scope, i.e. it is intended to be ONLY accessible
+        by other classes in the Cpl::Dm namespace.  The Application should
+        NEVER call this method.
+
+        This method is used remove a 'deferred change notification' from its
+        list of deferred change notifications.  It is okay to call this method
+        even if the Subscriber does not have a deferred change notification.
+
+        This method IS thread safe.
+     */
+    virtual void removeDeferredChangeNotification_( SubscriberApi& subscriber ) noexcept = 0;
+
 
 public:
     /// Virtual destructor
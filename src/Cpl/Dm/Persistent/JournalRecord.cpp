@@ -0,0 +1,382 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+
+#include "JournalRecord.h"
+#include "Cpl/Persistent/Private_.h"
+#include "Cpl/Checksum/Crc32EthernetFast.h"
+#include "Cpl/System/Assert.h"
+#include "Cpl/System/Trace.h"
+#include <memory.h>
+
+
+#define SECT_ "Cpl::Dm::Persistent"
+
+// Snapshot header: magic, generation, snapshot length
+#define SNAPSHOT_MAGIC          0x4A524E4CUL    // "JRNL"
+#define SNAPSHOT_OFFSET_MAGIC   0
+#define SNAPSHOT_OFFSET_GEN     4
+#define SNAPSHOT_OFFSET_LEN     8
+#define SNAPSHOT_HEADER_SIZE    12
+
+// Journal entry header: item index, data length
+#define ENTRY_OFFSET_INDEX      0
+#define ENTRY_OFFSET_LEN        2
+#define ENTRY_HEADER_SIZE       4
+
+#define CRC_SIZE                (sizeof(uint32_t))
+
+#define WORK_BUFFER_            Cpl::Persistent::g_workBuffer_
+
+
+///
+using namespace Cpl::Dm::Persistent;
+
+//////////////////////////////////////////////////////
+JournalRecord::JournalRecord( Item_T                        itemList[],
+                              Cpl::Persistent::RegionMedia& regionMedia,
+                              uint8_t                       schemaMajorIndex,
+                              uint8_t                       schemaMinorIndex,
+                              uint32_t                      writeDelayMs,
+                              uint32_t                      maxDelayMs ) noexcept
+    : Record( itemList, m_journal, schemaMajorIndex, schemaMinorIndex, writeDelayMs, maxDelayMs )
+    , m_journal( *this )
+    , m_region( regionMedia )
+    , m_seqNums( 0 )
+    , m_numItems( 0 )
+    , m_bankSize( 0 )
+    , m_nextEntryOffset( 0 )
+    , m_generation( 0 )
+    , m_entryCount( 0 )
+    , m_compactionCount( 0 )
+    , m_currentBank( 0 )
+    , m_valid( false )
+{
+}
+
+JournalRecord::~JournalRecord()
+{
+    // Make sure I am stopped (to free any previously allocate memory)
+    stop();
+}
+
+void JournalRecord::start( Cpl::Dm::MailboxServer& myMbox ) noexcept
+{
+    if ( !m_started )
+    {
+        // Allocate the 'last written' sequence numbers
+        m_numItems = 0;
+        while ( m_items[m_numItems].mpPtr != 0 )
+        {
+            m_numItems++;
+        }
+        m_seqNums = new uint16_t[m_numItems + 1];
+        if ( m_seqNums == 0 )
+        {
+            Cpl::System::FatalError::logf( "Cpl::Dm::Persistent::JournalRecord::start().  Failed to allocate sequence numbers (numItems=%u)", m_numItems );
+        }
+
+        // No valid journal until it is loaded/written
+        m_generation = 0;
+        m_valid      = false;
+        Record::start( myMbox );
+    }
+}
+
+void JournalRecord::stop() noexcept
+{
+    if ( m_started )
+    {
+        Record::stop();
+        delete[] m_seqNums;
+        m_seqNums = 0;
+    }
+}
+
+void JournalRecord::syncSequenceNumbers() noexcept
+{
+    for ( unsigned i = 0; i < m_numItems; i++ )
+    {
+        m_seqNums[i] = m_items[i].mpPtr->getSequenceNumber();
+    }
+}
+
+//////////////////////////////////////////////////////
+void JournalRecord::updateNVRAM() noexcept
+{
+    CPL_SYSTEM_TRACE_MSG( SECT_, ("JournalRecord::updateNVRAM(). mp[0]=%s, valid=%d", m_items[0].mpPtr->getName(), m_valid) );
+
+    // No valid snapshot -->a full snapshot is required
+    if ( !m_valid )
+    {
+        writeSnapshot( false );
+        return;
+    }
+
+    // Append an entry for each MP that has changed since it was last written
+    for ( unsigned i = 0; i < m_numItems; i++ )
+    {
+        if ( m_items[i].mpPtr->getSequenceNumber() != m_seqNums[i] )
+        {
+            // Journal is full -->compact (the snapshot contains ALL of the current MP values)
+            if ( !appendEntry( i ) )
+            {
+                writeSnapshot( false );
+                return;
+            }
+        }
+    }
+}
+
+bool JournalRecord::appendEntry( unsigned itemIndex ) noexcept
+{
+    Cpl::Dm::ModelPoint* mp      = m_items[itemIndex].mpPtr;
+    size_t               dataLen = mp->getExternalSize();
+    size_t               entryLen = ENTRY_HEADER_SIZE + dataLen + CRC_SIZE;
+    size_t               bankEnd  = ( m_currentBank + 1 ) * m_bankSize;
+    if ( m_nextEntryOffset + entryLen > bankEnd || entryLen > sizeof( WORK_BUFFER_ ) )
+    {
+        return false;
+    }
+
+    // Build the entry (header, MP data, CRC)
+    uint16_t index16 = (uint16_t) itemIndex;
+    uint16_t len16   = (uint16_t) dataLen;
+    uint16_t seqNum;
+    memcpy( WORK_BUFFER_ + ENTRY_OFFSET_INDEX, &index16, sizeof( index16 ) );
+    memcpy( WORK_BUFFER_ + ENTRY_OFFSET_LEN, &len16, sizeof( len16 ) );
+    if ( mp->exportData( WORK_BUFFER_ + ENTRY_HEADER_SIZE, dataLen, &seqNum ) == 0 )
+    {
+        // Should never happen -->skip the MP (and force a snapshot on the next update)
+        m_valid = false;
+        return true;
+    }
+
+    // Note: The CRC is seeded with the generation number so that stale entries from a previous generation are rejected
+    Cpl::Checksum::Crc32EthernetFast crc;
+    crc.reset();
+    crc.accumulate( &m_generation, sizeof( m_generation ) );
+    crc.accumulate( WORK_BUFFER_, ENTRY_HEADER_SIZE + dataLen );
+    crc.finalize( WORK_BUFFER_ + ENTRY_HEADER_SIZE + dataLen );
+
+    // Write the entry with a single media operation. Note: If the write fails, the RAM contents are still valid and the next update will retry
+    if ( m_region.write( m_nextEntryOffset, WORK_BUFFER_, entryLen ) )
+    {
+        m_seqNums[itemIndex] = seqNum;
+        m_nextEntryOffset   += entryLen;
+        m_entryCount++;
+    }
+    return true;
+}
+
+bool JournalRecord::writeSnapshot( bool invalidate ) noexcept
+{
+    // Erase BOTH banks (i.e. so the older bank does not become the 'newest' bank)
+    if ( invalidate )
+    {
+        memset( WORK_BUFFER_, 0, SNAPSHOT_HEADER_SIZE );
+        bool result  = m_region.write( 0, WORK_BUFFER_, SNAPSHOT_HEADER_SIZE );
+        result      &= m_region.write( m_bankSize, WORK_BUFFER_, SNAPSHOT_HEADER_SIZE );
+        m_valid      = false;
+        return result;
+    }
+
+    // Capture the MP sequence numbers BEFORE the export so that changes that occur during the export are NOT lost
+    syncSequenceNumbers();
+
+    // Get the record data
+    size_t   maxLen = m_bankSize < sizeof( WORK_BUFFER_ ) ? m_bankSize : sizeof( WORK_BUFFER_ );
+    uint32_t len    = 0;
+    if ( maxLen > SNAPSHOT_HEADER_SIZE + CRC_SIZE )
+    {
+        len = (uint32_t) getData( WORK_BUFFER_ + SNAPSHOT_HEADER_SIZE, maxLen - SNAPSHOT_HEADER_SIZE - CRC_SIZE );
+    }
+    if ( len == 0 )
+    {
+        CPL_SYSTEM_TRACE_MSG( SECT_, ("JournalRecord::writeSnapshot(). Record does not fit. mp[0]=%s", m_items[0].mpPtr->getName()) );
+        m_valid = false;
+        return false;
+    }
+
+    // Build the header and CRC.  Note: the snapshot is always written to the 'other' bank
+    uint32_t magic  = SNAPSHOT_MAGIC;
+    uint32_t newGen = m_generation + 1 == 0 ? 1 : m_generation + 1;
+    unsigned bank   = m_generation == 0 ? 0 : m_currentBank ^ 1;
+    memcpy( WORK_BUFFER_ + SNAPSHOT_OFFSET_MAGIC, &magic, sizeof( magic ) );
+    memcpy( WORK_BUFFER_ + SNAPSHOT_OFFSET_GEN, &newGen, sizeof( newGen ) );
+    memcpy( WORK_BUFFER_ + SNAPSHOT_OFFSET_LEN, &len, sizeof( len ) );
+    Cpl::Checksum::Crc32EthernetFast crc;
+    crc.reset();
+    crc.accumulate( WORK_BUFFER_, SNAPSHOT_HEADER_SIZE + len );
+    crc.finalize( WORK_BUFFER_ + SNAPSHOT_HEADER_SIZE + len );
+
+    // Write the snapshot. Note: If the write fails, the RAM contents are still valid and the next update will retry
+    size_t offset = bank * m_bankSize;
+    m_valid       = m_region.write( offset, WORK_BUFFER_, SNAPSHOT_HEADER_SIZE + len + CRC_SIZE );
+    if ( m_valid )
+    {
+        m_generation      = newGen;
+        m_currentBank     = bank;
+        m_nextEntryOffset = offset + SNAPSHOT_HEADER_SIZE + len + CRC_SIZE;
+        m_compactionCount++;
+    }
+    CPL_SYSTEM_TRACE_MSG( SECT_, ("JournalRecord::writeSnapshot(). mp[0]=%s, bank=%u, gen=%lu, success=%d", m_items[0].mpPtr->getName(), bank, (unsigned long) newGen, m_valid) );
+    return m_valid;
+}
+
+//////////////////////////////////////////////////////
+uint32_t JournalRecord::readSnapshot( unsigned bank, size_t& snapshotLen ) noexcept
+{
+    // Read the header
+    size_t  offset = bank * m_bankSize;
+    uint8_t header[SNAPSHOT_HEADER_SIZE];
+    if ( m_region.read( offset, header, SNAPSHOT_HEADER_SIZE ) != SNAPSHOT_HEADER_SIZE )
+    {
+        return 0;
+    }
+    uint32_t magic;
+    uint32_t gen;
+    uint32_t len;
+    memcpy( &magic, header + SNAPSHOT_OFFSET_MAGIC, sizeof( magic ) );
+    memcpy( &gen, header + SNAPSHOT_OFFSET_GEN, sizeof( gen ) );
+    memcpy( &len, header + SNAPSHOT_OFFSET_LEN, sizeof( len ) );
+    if ( magic != SNAPSHOT_MAGIC || gen == 0 || len <= 2 || len + CRC_SIZE > sizeof( WORK_BUFFER_ ) || SNAPSHOT_HEADER_SIZE + len + CRC_SIZE > m_bankSize )
+    {
+        return 0;
+    }
+
+    // Read the snapshot data AND CRC
+    if ( m_region.read( offset + SNAPSHOT_HEADER_SIZE, WORK_BUFFER_, len + CRC_SIZE ) != len + CRC_SIZE )
+    {
+        return 0;
+    }
+    Cpl::Checksum::Crc32EthernetFast crc;
+    crc.reset();
+    crc.accumulate( header, SNAPSHOT_HEADER_SIZE );
+    crc.accumulate( WORK_BUFFER_, len + CRC_SIZE );
+    if ( !crc.isOkay() )
+    {
+        return 0;
+    }
+
+    snapshotLen = len;
+    return gen;
+}
+
+bool JournalRecord::loadJournal() noexcept
+{
+    // Find the newest valid snapshot
+    size_t   len0 = 0;
+    size_t   len1 = 0;
+    uint32_t gen0 = readSnapshot( 0, len0 );
+    uint32_t gen1 = readSnapshot( 1, len1 );
+    if ( gen0 == 0 && gen1 == 0 )
+    {
+        return false;
+    }
+    m_currentBank = gen0 == 0 || ( gen1 != 0 && (int32_t) ( gen1 - gen0 ) > 0 ) ? 1 : 0;
+    m_generation  = m_currentBank == 0 ? gen0 : gen1;
+    size_t len    = m_currentBank == 0 ? len0 : len1;
+
+    // Re-read the snapshot when the newest bank is NOT the last bank read
+    if ( m_currentBank == 0 && readSnapshot( 0, len ) == 0 )
+    {
+        return false;
+    }
+
+    // Load the snapshot (the Record handles schema changes)
+    bool schemaChanged = WORK_BUFFER_[0] != m_major || WORK_BUFFER_[1] != m_minor;
+    if ( !putData( WORK_BUFFER_, len ) )
+    {
+        return false;
+    }
+
+    // The journal entries are in the previous schema's layout -->discard them and write a snapshot with the migrated data
+    if ( schemaChanged )
+    {
+        CPL_SYSTEM_TRACE_MSG( SECT_, ("JournalRecord::loadJournal(). Schema changed, journal discarded. mp[0]=%s, bank=%u, gen=%lu", m_items[0].mpPtr->getName(), m_currentBank, (unsigned long) m_generation) );
+        writeSnapshot( false );
+        return true;
+    }
+
+    // Replay the journal entries (stop at the first invalid entry)
+    size_t   offset  = m_currentBank * m_bankSize + SNAPSHOT_HEADER_SIZE + len + CRC_SIZE;
+    size_t   bankEnd = ( m_currentBank + 1 ) * m_bankSize;
+    unsigned count   = 0;
+    while ( offset + ENTRY_HEADER_SIZE + CRC_SIZE <= bankEnd )
+    {
+        // Header
+        uint16_t index16;
+        uint16_t len16;
+        if ( m_region.read( offset, WORK_BUFFER_, ENTRY_HEADER_SIZE ) != ENTRY_HEADER_SIZE )
+        {
+            break;
+        }
+        memcpy( &index16, WORK_BUFFER_ + ENTRY_OFFSET_INDEX, sizeof( index16 ) );
+        memcpy( &len16, WORK_BUFFER_ + ENTRY_OFFSET_LEN, sizeof( len16 ) );
+        size_t entryLen = ENTRY_HEADER_SIZE + len16 + CRC_SIZE;
+        if ( index16 >= m_numItems || len16 != m_items[index16].mpPtr->getExternalSize() || offset + entryLen > bankEnd || entryLen > sizeof( WORK_BUFFER_ ) )
+        {
+            break;
+        }
+
+        // MP data and CRC
+        if ( m_region.read( offset + ENTRY_HEADER_SIZE, WORK_BUFFER_ + ENTRY_HEADER_SIZE, len16 + CRC_SIZE ) != len16 + CRC_SIZE )
+        {
+            break;
+        }
+        Cpl::Checksum::Crc32EthernetFast crc;
+        crc.reset();
+        crc.accumulate( &m_generation, sizeof( m_generation ) );
+        crc.accumulate( WORK_BUFFER_, entryLen );
+        if ( !crc.isOkay() )
+        {
+            break;
+        }
+
+        // Apply the delta
+        m_items[index16].mpPtr->importData( WORK_BUFFER_ + ENTRY_HEADER_SIZE, len16 );
+        offset += entryLen;
+        count++;
+    }
+
+    CPL_SYSTEM_TRACE_MSG( SECT_, ("JournalRecord::loadJournal(). mp[0]=%s, bank=%u, gen=%lu, entries=%u", m_items[0].mpPtr->getName(), m_currentBank, (unsigned long) m_generation, count) );
+    m_nextEntryOffset = offset;
+    m_valid           = true;
+    syncSequenceNumbers();
+    return true;
+}
+
+//////////////////////////////////////////////////////
+void JournalRecord::Journal_::start( Cpl::Dm::MailboxServer& myMbox ) noexcept
+{
+    m_owner.m_region.start( myMbox );
+    m_owner.m_bankSize = m_owner.m_region.getRegionLength() / 2;
+}
+
+void JournalRecord::Journal_::stop() noexcept
+{
+    m_owner.m_region.stop();
+}
+
+bool JournalRecord::Journal_::loadData( Cpl::Persistent::Payload& dstHandler, size_t index ) noexcept
+{
+    return m_owner.loadJournal();
+}
+
+bool JournalRecord::Journal_::updateData( Cpl::Persistent::Payload& srcHandler, size_t index, bool invalidate ) noexcept
+{
+    return m_owner.writeSnapshot( invalidate );
+}
+
+size_t JournalRecord::Journal_::getMetadataLength() const noexcept
+{
+    return SNAPSHOT_HEADER_SIZE + CRC_SIZE;
+}
@@ -0,0 +1,177 @@
+#ifndef Cpl_Dm_Persistent_JournalRecord_h_
+#define Cpl_Dm_Persistent_JournalRecord_h_
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+/** @file */
+
+#include "Cpl/Dm/Persistent/Record.h"
+#include "Cpl/Persistent/RegionMedia.h"
+#include <stdint.h>
+
+///
+namespace Cpl {
+///
+namespace Dm {
+///
+namespace Persistent {
+
+/** This mostly concrete class is a Record that stores its Model Point data as
+    an append-only journal instead of re-writing the entire Record on every
+    change.  When a Model Point changes, only a 'delta' entry (the MP's index
+    and its exported data) is appended to the persistent media. A full
+    snapshot of the Record is only written (aka compaction) when the journal
+    fills up, on a flush() request, or when the Record is defaulted/erased.
+
+    The Region is split into two equal sized banks.  Each bank contains a
+    snapshot header, the snapshot data (same format as Record::getData()), a
+    CRC, and then zero or more journal entries.  Compaction always writes the
+    snapshot to the 'other' bank with an incremented generation number - so
+    there is always a good copy of the data if power fails during the
+    compaction.  Each journal entry has its own CRC (seeded with the bank's
+    generation number) - so a partially written entry and/or stale entries
+    from a previous generation are discarded on start-up.
+
+    On start-up, the newest valid snapshot is loaded and then all of the valid
+    journal entries are replayed (in order) to rebuild the current state.  When
+    the snapshot's schema indexes do not match the Record's (i.e. the Record's
+    schemaChange() method migrated the data), the journal entries are NOT
+    replayed and a new snapshot is written immediately.
+
+    The Region (which is NOT a Chunk) must be dedicated to the Record instance.
+    The Record's snapshot must fit within the Persistent work buffer (see
+    OPTION_CPL_PERSISTENT_WORK_BUFFER_SIZE) and within half of the region.
+
+    Note: The 'writeDelayMs' settling time still applies, i.e. all Model Points
+          that changed during the settling time are appended as individual
+          entries when the timer expires.
+ */
+class JournalRecord : public Record
+{
+public:
+    /** Constructor. See Cpl::Dm::Persistent::Record for the semantics of the
+        arguments.  The 'regionMedia' is the persistent storage for the journal.
+     */
+    JournalRecord( Item_T                        itemList[],
+                   Cpl::Persistent::RegionMedia& regionMedia,
+                   uint8_t                       schemaMajorIndex,
+                   uint8_t                       schemaMinorIndex,
+                   uint32_t                      writeDelayMs    = 0,
+                   uint32_t                      maxWriteDelayMs = 0 ) noexcept;
+
+    /// Destructor
+    ~JournalRecord();
+
+public:
+    /// See Cpl::Persistent::Record
+    void start( Cpl::Dm::MailboxServer& myMbox ) noexcept;
+
+    /// See Cpl::Persistent::Record
+    void stop() noexcept;
+
+public:
+    /// Returns the number of journal entries appended (since the Record was constructed)
+    uint32_t getEntryCount() const noexcept { return m_entryCount; }
+
+    /// Returns the number of snapshots/compactions written (since the Record was constructed)
+    uint32_t getCompactionCount() const noexcept { return m_compactionCount; }
+
+protected:
+    /// Appends a journal entry for each Model Point that has changed since it was last written
+    void updateNVRAM() noexcept;
+
+protected:
+    /// Loads the newest snapshot and replays its journal entries
+    bool loadJournal() noexcept;
+
+    /// Writes a full snapshot to the 'other' bank.  When 'invalidate' is true both banks are erased
+    bool writeSnapshot( bool invalidate ) noexcept;
+
+    /// Appends a journal entry for the specified item.  Returns false if there is no space in the current bank
+    bool appendEntry( unsigned itemIndex ) noexcept;
+
+    /** Helper method. Validates the bank's snapshot and returns its generation
+        number (zero if the bank is corrupt). The snapshot data is left in the
+        Persistent work buffer
+     */
+    uint32_t readSnapshot( unsigned bank, size_t& snapshotLen ) noexcept;
+
+    /// Helper method. Remembers the sequence numbers of all MPs, i.e. all MPs are 'in-sync' with the journal
+    void syncSequenceNumbers() noexcept;
+
+protected:
+    /// Chunk adapter that connects the Record's full-record operations to the journal
+    class Journal_ : public Cpl::Persistent::Chunk
+    {
+    public:
+        /// Constructor
+        Journal_( JournalRecord& owner ) :m_owner( owner ) {}
+
+    public:
+        /// See Cpl::Persistent::Chunk
+        void start( Cpl::Dm::MailboxServer& myMbox ) noexcept;
+
+        /// See Cpl::Persistent::Chunk
+        void stop() noexcept;
+
+        /// See Cpl::Persistent::Chunk. Note: the Payload is always the owning Record
+        bool loadData( Cpl::Persistent::Payload& dstHandler, size_t index=0 ) noexcept;
+
+        /// See Cpl::Persistent::Chunk. Note: the Payload is always the owning Record
+        bool updateData( Cpl::Persistent::Payload& srcHandler, size_t index=0, bool invalidate=false ) noexcept;
+
+        /// See Cpl::Persistent::Chunk
+        size_t getMetadataLength() const noexcept;
+
+    protected:
+        /// The Record that owns the journal
+        JournalRecord& m_owner;
+    };
+
+protected:
+    /// Chunk adapter (passed to the Record parent class)
+    Journal_                        m_journal;
+
+    /// Persistent storage for the journal
+    Cpl::Persistent::RegionMedia&   m_region;
+
+    /// Sequence numbers of the MPs when they were last written to the journal (allocated when started)
+    uint16_t*                       m_seqNums;
+
+    /// Number of items in the Record
+    unsigned                        m_numItems;
+
+    /// Size, in bytes, of a bank
+    size_t                          m_bankSize;
+
+    /// Offset (relative to the start of the region) of the next journal entry
+    size_t                          m_nextEntryOffset;
+
+    /// Generation number of the newest bank (zero when there is no valid bank)
+    uint32_t                        m_generation;
+
+    /// Number of journal entries written
+    uint32_t                        m_entryCount;
+
+    /// Number of snapshots written
+    uint32_t                        m_compactionCount;
+
+    /// Current bank, i.e. the bank with the newest snapshot
+    unsigned                        m_currentBank;
+
+    /// True when the current bank contains a valid snapshot of the Record, i.e. journal entries can be appended
+    bool                            m_valid;
+};
+
+
+};      // end namespaces
+};
+};
+#endif  // end header latch
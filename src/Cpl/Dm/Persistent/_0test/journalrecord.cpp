@@ -0,0 +1,502 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+
+#include "Catch/catch.hpp"
+#include "Cpl/System/_testsupport/Shutdown_TS.h"
+#include "Cpl/System/Trace.h"
+#include "Cpl/System/Thread.h"
+#include "Cpl/System/Api.h"
+#include "Cpl/System/ElapsedTime.h"
+#include "Cpl/Dm/ModelDatabase.h"
+#include "Cpl/Dm/Persistent/JournalRecord.h"
+#include "Cpl/Dm/Mp/Uint32.h"
+#include "Cpl/Persistent/RecordServer.h"
+#include "Cpl/Persistent/MirroredChunk.h"
+#include "Cpl/Persistent/FileAdapter.h"
+#include "Cpl/Io/File/Api.h"
+#include <string.h>
+
+
+#define SECT_   "_0test"
+
+#define FILE_NAME_JOURNAL   "journal.nvram"
+#define JOURNAL_REGION_LEN  256
+
+using namespace Cpl::Dm::Persistent;
+
+// Allocate/create my Model Database
+static Cpl::Dm::ModelDatabase    modelDb_( "ignoreThisParameter_usedToInvokeTheStaticConstructor" );
+
+// Allocate my Model Points
+static Cpl::Dm::Mp::Uint32       mp_apple_( modelDb_, "APPLE" );
+static Cpl::Dm::Mp::Uint32       mp_orange_( modelDb_, "ORANGE" );
+static Cpl::Dm::Mp::Uint32       mp_plum_( modelDb_, "PLUM" );
+
+#define DEFAULT_APPLE        0xAAAA5555
+#define DEFAULT_ORANGE       0xBBBB7777
+#define DEFAULT_PLUM         0xFFFF9999
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+class MyJournalRecord : public JournalRecord
+{
+public:
+    MyJournalRecord( Cpl::Persistent::RegionMedia& region, uint8_t major, uint8_t minor ) noexcept
+        : JournalRecord( m_itemList, region, major, minor )
+        , m_resetDataCount( 0 )
+    {
+        m_itemList[0] ={ &mp_apple_, CPL_DM_PERISTENCE_RECORD_USE_SUBSCRIBER };
+        m_itemList[1] ={ &mp_orange_, CPL_DM_PERISTENCE_RECORD_USE_SUBSCRIBER };
+        m_itemList[2] ={ &mp_plum_, CPL_DM_PERISTENCE_RECORD_NO_SUBSCRIBER };
+        m_itemList[3] ={ 0,0 };
+    }
+
+    bool resetData() noexcept
+    {
+        mp_apple_.write( DEFAULT_APPLE );
+        mp_orange_.write( DEFAULT_ORANGE );
+        mp_plum_.write( DEFAULT_PLUM );
+        m_resetDataCount++;
+        return true;
+    }
+
+    size_t getNextEntryOffset() const { return m_nextEntryOffset; }
+
+public:
+    Item_T m_itemList[3 + 1];
+    int    m_resetDataCount;
+};
+
+}; // end namespace
+
+static Cpl::Persistent::FileAdapter journalFd_( FILE_NAME_JOURNAL, 0, JOURNAL_REGION_LEN );
+
+/// Waits for the record server to process the pending MP change notification(s)
+static void settle()
+{
+    Cpl::System::Api::sleep( 50 );
+}
+
+static void requireValues( uint32_t apple, uint32_t orange, uint32_t plum )
+{
+    uint32_t value;
+    REQUIRE( mp_apple_.read( value ) );
+    REQUIRE( value == apple );
+    REQUIRE( mp_orange_.read( value ) );
+    REQUIRE( value == orange );
+    REQUIRE( mp_plum_.read( value ) );
+    REQUIRE( value == plum );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_CASE( "journalrecord" )
+{
+    CPL_SYSTEM_TRACE_SCOPE( SECT_, "JOURNALRECORD Test" );
+    Cpl::System::Shutdown_TS::clearAndUseCounter();
+
+    MyJournalRecord uut( journalFd_, 1, 0 );
+    Cpl::Persistent::Record* records[2] ={ &uut, 0 };
+
+    Cpl::Persistent::RecordServer recordServer( records );
+    Cpl::System::Thread* t1 = Cpl::System::Thread::create( recordServer, "UUT" );
+    REQUIRE( t1 );
+
+    mp_apple_.setInvalid();
+    mp_orange_.setInvalid();
+    mp_plum_.setInvalid();
+
+    SECTION( "no persistent data" )
+    {
+        Cpl::Io::File::Api::remove( FILE_NAME_JOURNAL );
+
+        // Defaulted -->full snapshot
+        recordServer.open();
+        REQUIRE( uut.m_resetDataCount == 1 );
+        REQUIRE( uut.getCompactionCount() == 1 );
+        requireValues( DEFAULT_APPLE, DEFAULT_ORANGE, DEFAULT_PLUM );
+
+        // Deltas
+        mp_apple_.write( 1 );
+        settle();
+        mp_orange_.write( 2 );
+        settle();
+        REQUIRE( uut.getEntryCount() == 2 );
+        REQUIRE( uut.getCompactionCount() == 1 );
+        recordServer.close();
+    }
+
+    SECTION( "replay" )
+    {
+        recordServer.open();
+        REQUIRE( uut.m_resetDataCount == 0 );
+        REQUIRE( uut.getCompactionCount() == 0 );
+        requireValues( 1, 2, DEFAULT_PLUM );
+
+        // Fill the journal (3 x 5 byte MPs: 33 byte snapshot, 13 byte entries, 128 byte banks) -->forces a compaction
+        for ( uint32_t i=10; i < 20; i++ )
+        {
+            mp_apple_.write( i );
+            settle();
+        }
+        REQUIRE( uut.getCompactionCount() == 1 );
+        REQUIRE( uut.getEntryCount() == 9 );
+
+        // Un-subscribed MP is journaled on the next update
+        mp_plum_.write( 3 );
+        mp_orange_.write( 4 );
+        settle();
+        REQUIRE( uut.getEntryCount() == 11 );
+        recordServer.close();
+    }
+
+    SECTION( "replay after compaction" )
+    {
+        recordServer.open();
+        REQUIRE( uut.m_resetDataCount == 0 );
+        requireValues( 19, 4, 3 );
+
+        // Corrupt the last entry (i.e. simulate a power failure while writing the entry)
+        mp_orange_.write( 5 );
+        settle();
+        recordServer.close();
+        uint8_t garbage = 0xA5;
+        REQUIRE( journalFd_.write( uut.getNextEntryOffset() - 1, &garbage, 1 ) );
+    }
+
+    SECTION( "torn entry" )
+    {
+        recordServer.open();
+        REQUIRE( uut.m_resetDataCount == 0 );
+        requireValues( 19, 4, 3 );
+
+        // The torn entry is overwritten by the next entry
+        mp_orange_.write( 6 );
+        settle();
+        recordServer.close();
+    }
+
+    SECTION( "flush" )
+    {
+        recordServer.open();
+        requireValues( 19, 6, 3 );
+        REQUIRE( uut.flush( recordServer ) );
+        REQUIRE( uut.getCompactionCount() == 1 );
+        recordServer.close();
+    }
+
+    SECTION( "erase" )
+    {
+        recordServer.open();
+        requireValues( 19, 6, 3 );
+        REQUIRE( uut.erase( recordServer ) );
+        recordServer.close();
+    }
+
+    SECTION( "verify erase" )
+    {
+        recordServer.open();
+        REQUIRE( uut.m_resetDataCount == 1 );
+        requireValues( DEFAULT_APPLE, DEFAULT_ORANGE, DEFAULT_PLUM );
+        recordServer.close();
+    }
+
+    SECTION( "schema change" )
+    {
+        MyJournalRecord uut2( journalFd_, 2, 0 );
+        Cpl::Persistent::Record* records2[2] ={ &uut2, 0 };
+        Cpl::Persistent::RecordServer recordServer2( records2 );
+        Cpl::System::Thread* t2 = Cpl::System::Thread::create( recordServer2, "UUT2" );
+        REQUIRE( t2 );
+        recordServer2.open();
+        REQUIRE( uut2.m_resetDataCount == 1 );
+        REQUIRE( uut2.getCompactionCount() == 1 );
+        recordServer2.close();
+        Cpl::System::Thread::destroy( *t2 );
+    }
+
+    Cpl::System::Thread::destroy( *t1 );
+    Cpl::System::Api::sleep( 100 );
+    REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 0u );
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+#define BENCH_NUM_MPS_          8
+#define BENCH_NUM_UPDATES_      20000
+#define BENCH_REGION_LEN_       1024
+
+static Cpl::Dm::ModelDatabase    benchModelDb_( "ignoreThisParameter_usedToInvokeTheStaticConstructor" );
+static Cpl::Dm::Mp::Uint32       mp_bench0_( benchModelDb_, "BENCH0" );
+static Cpl::Dm::Mp::Uint32       mp_bench1_( benchModelDb_, "BENCH1" );
+static Cpl::Dm::Mp::Uint32       mp_bench2_( benchModelDb_, "BENCH2" );
+static Cpl::Dm::Mp::Uint32       mp_bench3_( benchModelDb_, "BENCH3" );
+static Cpl::Dm::Mp::Uint32       mp_bench4_( benchModelDb_, "BENCH4" );
+static Cpl::Dm::Mp::Uint32       mp_bench5_( benchModelDb_, "BENCH5" );
+static Cpl::Dm::Mp::Uint32       mp_bench6_( benchModelDb_, "BENCH6" );
+static Cpl::Dm::Mp::Uint32       mp_bench7_( benchModelDb_, "BENCH7" );
+static Cpl::Dm::Mp::Uint32*      benchMps_[BENCH_NUM_MPS_] ={ &mp_bench0_, &mp_bench1_, &mp_bench2_, &mp_bench3_, &mp_bench4_, &mp_bench5_, &mp_bench6_, &mp_bench7_ };
+
+namespace {
+
+/// Region media that counts the number of bytes (and write operations) to the wrapped media
+class CountingMedia : public Cpl::Persistent::RegionMedia
+{
+public:
+    ///
+    CountingMedia( Cpl::Persistent::RegionMedia& media ) :RegionMedia( media.getStartAddress(), media.getRegionLength() ), m_media( media ), m_bytes( 0 ), m_writes( 0 ) {}
+    ///
+    void start( Cpl::Dm::MailboxServer& myMbox ) noexcept { m_media.start( myMbox ); }
+    ///
+    void stop() noexcept { m_media.stop(); }
+    ///
+    bool write( size_t offset, const void* srcData, size_t srcLen ) noexcept { m_bytes += srcLen; m_writes++; return m_media.write( offset, srcData, srcLen ); }
+    ///
+    size_t read( size_t offset, void* dstBuffer, size_t bytesToRead ) noexcept { return m_media.read( offset, dstBuffer, bytesToRead ); }
+    ///
+    Cpl::Persistent::RegionMedia& m_media;
+    ///
+    size_t                        m_bytes;
+    ///
+    size_t                        m_writes;
+};
+
+/// RAM based region media
+class RamMedia : public Cpl::Persistent::RegionMedia
+{
+public:
+    ///
+    RamMedia() :RegionMedia( 0, BENCH_REGION_LEN_ ) { memset( m_data, 0xFF, sizeof( m_data ) ); }
+    ///
+    void start( Cpl::Dm::MailboxServer& myMbox ) noexcept {}
+    ///
+    void stop() noexcept {}
+    ///
+    bool write( size_t offset, const void* srcData, size_t srcLen ) noexcept { memcpy( m_data + offset, srcData, srcLen ); return true; }
+    ///
+    size_t read( size_t offset, void* dstBuffer, size_t bytesToRead ) noexcept { memcpy( dstBuffer, m_data + offset, bytesToRead ); return bytesToRead; }
+    ///
+    uint8_t m_data[BENCH_REGION_LEN_];
+};
+
+template <class BASE>
+class BenchRecord : public BASE
+{
+public:
+    ///
+    template <class MEDIA>
+    BenchRecord( MEDIA& media ) noexcept
+        : BASE( m_itemList, media, 1, 0 )
+    {
+        for ( unsigned i=0; i < BENCH_NUM_MPS_; i++ )
+        {
+            m_itemList[i] ={ benchMps_[i], CPL_DM_PERISTENCE_RECORD_NO_SUBSCRIBER };
+        }
+        m_itemList[BENCH_NUM_MPS_] ={ 0,0 };
+    }
+    ///
+    bool resetData() noexcept
+    {
+        for ( unsigned i=0; i < BENCH_NUM_MPS_; i++ )
+        {
+            benchMps_[i]->write( i );
+        }
+        return true;
+    }
+    ///
+    void update() { this->updateNVRAM(); }
+    ///
+    typename BASE::Item_T m_itemList[BENCH_NUM_MPS_ + 1];
+};
+
+}; // end namespace
+
+/// Updates one MP per NVRAM update. Returns the elapsed time in msec
+template <class RECORD>
+static unsigned long runUpdates( RECORD& record, Cpl::Dm::MailboxServer& mbox )
+{
+    record.start( mbox );
+    unsigned long start = Cpl::System::ElapsedTime::milliseconds();
+    for ( unsigned i=0; i < BENCH_NUM_UPDATES_; i++ )
+    {
+        benchMps_[i % BENCH_NUM_MPS_]->increment();
+        record.update();
+    }
+    unsigned long elapsed = Cpl::System::ElapsedTime::deltaMilliseconds( start );
+    record.stop();
+    return elapsed;
+}
+
+static void reportUpdates( const char* label, unsigned long elapsed, size_t bytes, size_t writes )
+{
+    CPL_SYSTEM_TRACE_MSG( SECT_, ("%-24s: %u updates. %lu ms (%lu ns/update), %lu bytes/update, %lu.%02lu writes/update",
+                                   label,
+                                   BENCH_NUM_UPDATES_,
+                                   elapsed,
+                                   (unsigned long) (elapsed * 1000000ULL / BENCH_NUM_UPDATES_),
+                                   (unsigned long) (bytes / BENCH_NUM_UPDATES_),
+                                   (unsigned long) (writes / BENCH_NUM_UPDATES_),
+                                   (unsigned long) (writes * 100 / BENCH_NUM_UPDATES_ % 100)) );
+}
+
+TEST_CASE( "journalrecord-benchmark", "[.bench]" )
+{
+    Cpl::Dm::MailboxServer mbox; // Note: Never runs, i.e. the updates are driven directly by the test
+
+    // RAM media (i.e. the cost of the record logic and the number of bytes written)
+    {
+        RamMedia      ramA;
+        RamMedia      ramB;
+        CountingMedia countA( ramA );
+        CountingMedia countB( ramB );
+        Cpl::Persistent::MirroredChunk chunk( countA, countB );
+        BenchRecord<Record> record( chunk );
+        unsigned long elapsed = runUpdates( record, mbox );
+        reportUpdates( "Record (RAM)", elapsed, countA.m_bytes + countB.m_bytes, countA.m_writes + countB.m_writes );
+    }
+    {
+        RamMedia      ram;
+        CountingMedia count( ram );
+        BenchRecord<JournalRecord> record( count );
+        unsigned long elapsed = runUpdates( record, mbox );
+        reportUpdates( "JournalRecord (RAM)", elapsed, count.m_bytes, count.m_writes );
+        CPL_SYSTEM_TRACE_MSG( SECT_, ("%-24s: entries=%lu, compactions=%lu", "", (unsigned long) record.getEntryCount(), (unsigned long) record.getCompactionCount()) );
+    }
+
+    // File media
+    Cpl::Io::File::Api::remove( "bench1.nvram" );
+    Cpl::Io::File::Api::remove( "bench2.nvram" );
+    Cpl::Io::File::Api::remove( "bench3.nvram" );
+    {
+        Cpl::Persistent::FileAdapter fileA( "bench1.nvram", 0, BENCH_REGION_LEN_ );
+        Cpl::Persistent::FileAdapter fileB( "bench2.nvram", 0, BENCH_REGION_LEN_ );
+        CountingMedia countA( fileA );
+        CountingMedia countB( fileB );
+        Cpl::Persistent::MirroredChunk chunk( countA, countB );
+        BenchRecord<Record> record( chunk );
+        unsigned long elapsed = runUpdates( record, mbox );
+        reportUpdates( "Record (file)", elapsed, countA.m_bytes + countB.m_bytes, countA.m_writes + countB.m_writes );
+    }
+    {
+        Cpl::Persistent::FileAdapter file( "bench3.nvram", 0, BENCH_REGION_LEN_ );
+        CountingMedia count( file );
+        BenchRecord<JournalRecord> record( count );
+        unsigned long elapsed = runUpdates( record, mbox );
+        reportUpdates( "JournalRecord (file)", elapsed, count.m_bytes, count.m_writes );
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+/// Record that migrates the previous schema (1.0) by swapping the APPLE and ORANGE values
+class MigratingJournalRecord : public JournalRecord
+{
+public:
+    ///
+    MigratingJournalRecord( Cpl::Persistent::RegionMedia& region, uint8_t major, uint8_t minor ) noexcept
+        : JournalRecord( m_itemList, region, major, minor )
+        , m_resetDataCount( 0 )
+        , m_schemaChangeCount( 0 )
+    {
+        m_itemList[0] ={ &mp_apple_, CPL_DM_PERISTENCE_RECORD_NO_SUBSCRIBER };
+        m_itemList[1] ={ &mp_orange_, CPL_DM_PERISTENCE_RECORD_NO_SUBSCRIBER };
+        m_itemList[2] ={ &mp_plum_, CPL_DM_PERISTENCE_RECORD_NO_SUBSCRIBER };
+        m_itemList[3] ={ 0,0 };
+    }
+    ///
+    bool resetData() noexcept
+    {
+        mp_apple_.write( DEFAULT_APPLE );
+        mp_orange_.write( DEFAULT_ORANGE );
+        mp_plum_.write( DEFAULT_PLUM );
+        m_resetDataCount++;
+        return true;
+    }
+    ///
+    bool schemaChange( uint8_t previousSchemaMajorIndex, uint8_t previousSchemaMinorIndex, const void* src, size_t srcLen ) noexcept
+    {
+        const uint8_t* srcPtr = (const uint8_t*) src;
+        size_t         mpLen  = mp_apple_.getExternalSize();
+        if ( previousSchemaMajorIndex != 1 || previousSchemaMinorIndex != 0 || srcLen < 3 * mpLen )
+        {
+            return false;
+        }
+        mp_orange_.importData( srcPtr, mpLen );
+        mp_apple_.importData( srcPtr + mpLen, mpLen );
+        mp_plum_.importData( srcPtr + 2 * mpLen, mpLen );
+        m_schemaChangeCount++;
+        return true;
+    }
+    ///
+    void update() { updateNVRAM(); }
+
+public:
+    ///
+    Item_T m_itemList[3 + 1];
+    ///
+    int    m_resetDataCount;
+    ///
+    int    m_schemaChangeCount;
+};
+
+}; // end namespace
+
+TEST_CASE( "journalrecord-schema" )
+{
+    Cpl::System::Shutdown_TS::clearAndUseCounter();
+    Cpl::Dm::MailboxServer mbox; // Note: Never runs, i.e. the updates are driven directly by the test
+    RamMedia               ram;
+
+    // Schema 1.0: Defaulted snapshot + journal entries
+    {
+        MigratingJournalRecord uut( ram, 1, 0 );
+        uut.start( mbox );
+        REQUIRE( uut.m_resetDataCount == 1 );
+        mp_apple_.write( 1 );
+        mp_orange_.write( 2 );
+        uut.update();
+        REQUIRE( uut.getEntryCount() == 2 );
+        uut.stop();
+    }
+
+    // Schema 1.1: The snapshot is migrated and the (schema 1.0) journal entries are NOT replayed
+    {
+        MigratingJournalRecord uut( ram, 1, 1 );
+        uut.start( mbox );
+        REQUIRE( uut.m_resetDataCount == 0 );
+        REQUIRE( uut.m_schemaChangeCount == 1 );
+        REQUIRE( uut.getCompactionCount() == 1 );
+        requireValues( DEFAULT_ORANGE, DEFAULT_APPLE, DEFAULT_PLUM );
+
+        // Journal entries in the new schema
+        mp_plum_.write( 3 );
+        uut.update();
+        REQUIRE( uut.getEntryCount() == 1 );
+        uut.stop();
+    }
+
+    // Schema 1.1: No schema change -->the journal entries are replayed
+    {
+        mp_plum_.write( 0 );
+        MigratingJournalRecord uut( ram, 1, 1 );
+        uut.start( mbox );
+        REQUIRE( uut.m_resetDataCount == 0 );
+        REQUIRE( uut.m_schemaChangeCount == 0 );
+        REQUIRE( uut.getCompactionCount() == 0 );
+        requireValues( DEFAULT_ORANGE, DEFAULT_APPLE, 3 );
+        uut.stop();
+    }
+
+    REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 0u );
+}
@@ -25,6 +25,23 @@ SubscriberBase::SubscriberBase( Cpl::Dm::EventLoop& myEventLoop )
     , m_eventLoopHdl( myEventLoop )
     , m_seqNumber( ModelPoint::SEQUENCE_NUMBER_UNKNOWN )
 {
+    m_options.m_minIntervalMsec  = 0;
+    m_options.m_deadband         = 0.0;
+    m_options.m_relativeDeadband = false;
+    m_options.m_lastValueValid   = false;
+    m_options.m_lastValue        = 0.0;
+    m_options.m_lastNotifyMsec   = 0;
+}
+
+void SubscriberBase::setMinimumInterval( unsigned long minIntervalMsec ) noexcept
+{
+    m_options.m_minIntervalMsec = minIntervalMsec;
+}
+
+void SubscriberBase::setDeadband( double deadband, bool isRelative ) noexcept
+{
+    m_options.m_deadband         = deadband < 0.0 ? -deadband : deadband;
+    m_options.m_relativeDeadband = isRelative;
 }
 
 NotificationApi_* SubscriberBase::getNotificationApi_() const noexcept
@@ -57,6 +74,11 @@ void SubscriberBase::setSequenceNumber_( uint16_t newSeqNumber ) noexcept
     m_seqNumber = newSeqNumber;
 }
 
+NotificationOptions_& SubscriberBase::getNotificationOptions_() noexcept
+{
+    return m_options;
+}
+
 ModelPoint* SubscriberBase::getModelPoint_() noexcept
 {
     if ( m_point == 0 )
@@ -43,10 +43,41 @@ protected:
     /// Sequence number of the subscriber
     uint16_t                        m_seqNumber;
 
+    /// Change notification options
+    NotificationOptions_            m_options;
+
 public:
     /// Constructor
     SubscriberBase( Cpl::Dm::EventLoop& myEventLoop );
 
+public:
+    /** This method sets the minimum time, in milliseconds, between change
+        notifications.  Changes that occur within the interval are coalesced,
+        i.e. the subscriber receives a single change notification - for the
+        latest value - once the interval has expired.  A value of zero (the
+        default) disables the rate limiting.  The subscriber's Event Loop must
+        have timer support enabled (i.e. a non-zero timing tick) for the
+        deferred change notifications to be delivered on time.
+
+        This method should only be called when the subscriber is NOT
+        subscribed to a Model Point.
+     */
+    void setMinimumInterval( unsigned long minIntervalMsec ) noexcept;
+
+    /** This method sets the deadband for a numeric Model Point, e.g.
+        Cpl::Dm::Mp::Float.  A change notification is only generated when the
+        Model Point's value differs from the value at the time of the last
+        delivered change notification by MORE than the deadband.  When
+        'isRelative' is true, the deadband is a fraction of the last delivered
+        value, e.g. 0.01 is 1%.  A deadband of zero (the default) disables the
+        deadband.  Changes to/from the invalid state always generate a change
+        notification.  The deadband is ignored for non-numeric Model Points.
+
+        This method should only be called when the subscriber is NOT
+        subscribed to a Model Point.
+     */
+    void setDeadband( double deadband, bool isRelative = false ) noexcept;
+
 public:
     /// See Cpl::Dm::SubscriberApi
     NotificationApi_* getNotificationApi_() const noexcept;
@@ -68,6 +99,9 @@ public:
 
     /// See Cpl::Dm::SubscriberApi
     void setSequenceNumber_( uint16_t newSeqNumber ) noexcept;
+
+    /// See Cpl::Dm::SubscriberApi
+    NotificationOptions_& getNotificationOptions_() noexcept;
 };
 
 /////////////////////////////////////////////////////////////////////////////
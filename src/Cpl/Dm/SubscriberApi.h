@@ -27,6 +27,24 @@ class ModelPoint;
 class NotificationApi_;
 
 
+/** This struct has PACKAGE Scope, i.e. it is intended to be ONLY accessible
+    by other classes in the Cpl::Dm namespace.  The Application should
+    NEVER directly access this struct.
+
+    This struct contains a Subscriber's change notification options (i.e.
+    rate limiting and deadband) and the state needed to apply the options.
+ */
+struct NotificationOptions_
+{
+    unsigned long   m_minIntervalMsec;      //!< Minimum time, in milliseconds, between change notifications (zero: no rate limit)
+    double          m_deadband;             //!< Deadband for numeric Model Points (zero: no deadband)
+    bool            m_relativeDeadband;     //!< When true, the deadband is a fraction of the last delivered value, e.g. 0.01 is 1%
+    bool            m_lastValueValid;       //!< True if the last delivered numeric value is valid
+    double          m_lastValue;            //!< Numeric value of the Model Point when the last change notification was delivered
+    unsigned long   m_lastNotifyMsec;       //!< Time, in milliseconds, when the last change notification was delivered
+};
+
+
 /** This abstract class defines the Subscriber interface - for change
     notifications - to a Model Points data/state
  */
@@ -103,6 +121,14 @@ public:
       */
     virtual void setSequenceNumber_( uint16_t newSeqNumber ) noexcept = 0;
 
+    /** This method has PACKAGE Scope, i.e. it is intended to be ONLY accessible
+        by other classes in the Cpl::Dm namespace.  The Application should
+        NEVER call this method.
+
+        This method is use to get the Subscriber's change notification options
+      */
+    virtual NotificationOptions_& getNotificationOptions_() noexcept = 0;
+
 
 public:
     /// Virtual destructor
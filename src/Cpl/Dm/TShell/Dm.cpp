@@ -14,12 +14,36 @@
 #include "Cpl/Text/strip.h"
 #include "Cpl/Text/FString.h"
 #include "Cpl/Text/Tokenizer/TextBlock.h"
+#include "Cpl/Text/atob.h"
+#include "Cpl/System/EventLoop.h"
 #include <string.h>
 
 ///
 using namespace Cpl::Dm::TShell;
 
 
+#ifdef USE_CPL_DM_MODEL_POINT_STATS
+/// Statistics that are ranked by the 'stats' sub-command
+enum Metric_T
+{
+	eMETRIC_WRITES = 0,
+	eMETRIC_NOOP_WRITES,
+	eMETRIC_NOTIFICATIONS,
+	eMETRIC_CALLBACK_TIME,
+	eNUM_METRICS
+};
+
+/// Entry in a 'top N' list
+struct TopEntry_T
+{
+	Cpl::Dm::ModelPoint* mp;
+	unsigned long        value;
+};
+
+static void insertTop_( TopEntry_T list[], unsigned numEntries, Cpl::Dm::ModelPoint* mp, unsigned long value );
+#endif
+
+
 ///////////////////////////
 Dm::Dm( Cpl::Container::Map<Cpl::TShell::Command>&  commandList,
 		Cpl::Dm::ModelDatabaseApi&                  modelDatabase,
@@ -159,6 +183,126 @@ Cpl::TShell::Command::Result_T Dm::execute( Cpl::TShell::Context_& context, char
 		return Command::eSUCCESS;
 	}
 
+	// STATS Sub-command (Note: exact match of the sub-command token)
+	else if ( strncmp( subCmd, "stats", 5 ) == 0 && Cpl::Text::stripNotSpace( subCmd ) == subCmd + 5 )
+	{
+		return stats( context, cmdString );
+	}
+
 	// If I get here the command failed!
 	return Command::eERROR_FAILED;
-}
\ No newline at end of file
+}
+
+Cpl::TShell::Command::Result_T Dm::stats( Cpl::TShell::Context_& context, char* cmdString ) noexcept
+{
+	Cpl::Text::Tokenizer::TextBlock tokens( cmdString, context.getDelimiterChar(), context.getTerminatorChar(), context.getQuoteChar(), context.getEscapeChar() );
+
+	// Too many args?
+	if ( tokens.numParameters() > 3 )
+	{
+		return Command::eERROR_EXTRA_ARGS;
+	}
+
+#ifndef USE_CPL_DM_MODEL_POINT_STATS
+	return context.writeFrame( "Model Point statistics were NOT ENABLED at Compiled time" ) ? Command::eSUCCESS : Command::eERROR_IO;
+#else
+	// Parse the optional argument
+	Cpl::Dm::ModelPoint::Stats_T stats;
+	unsigned                     topN = OPTION_CPL_DM_TSHELL_DEFAULT_STATS_TOP_N;
+	if ( tokens.numParameters() == 3 )
+	{
+		// Reset ALL of the statistics
+		if ( strcmp( tokens.getParameter( 2 ), "reset" ) == 0 )
+		{
+			Cpl::Dm::ModelPoint* point = m_database.getFirstByName();
+			while ( point )
+			{
+				point->getStats( stats, true );
+				point = m_database.getNextByName( *point );
+			}
+			return Command::eSUCCESS;
+		}
+
+		if ( !Cpl::Text::a2ui( topN, tokens.getParameter( 2 ) ) || topN == 0 )
+		{
+			return Command::eERROR_INVALID_ARGS;
+		}
+		if ( topN > OPTION_CPL_DM_TSHELL_MAX_STATS_TOP_N )
+		{
+			topN = OPTION_CPL_DM_TSHELL_MAX_STATS_TOP_N;
+		}
+	}
+
+	// Walk the Model database and rank the points
+	TopEntry_T           tops[eNUM_METRICS][OPTION_CPL_DM_TSHELL_MAX_STATS_TOP_N];
+	Cpl::Dm::ModelPoint* point = m_database.getFirstByName();
+	memset( tops, 0, sizeof( tops ) );
+	while ( point )
+	{
+		point->getStats( stats );
+		insertTop_( tops[eMETRIC_WRITES], topN, point, stats.m_writes );
+		insertTop_( tops[eMETRIC_NOOP_WRITES], topN, point, stats.m_noopWrites );
+		insertTop_( tops[eMETRIC_NOTIFICATIONS], topN, point, stats.m_notifications );
+		insertTop_( tops[eMETRIC_CALLBACK_TIME], topN, point, stats.m_callbackTicks );
+		point = m_database.getNextByName( *point );
+	}
+
+	// Display the results
+	static const char* titles[eNUM_METRICS] ={ "Writes", "No-op writes", "Notifications", "Callback time" };
+	Cpl::Text::String& outtext = context.getOutputBuffer();
+	bool               io      = true;
+	for ( unsigned m=0; m < eNUM_METRICS; m++ )
+	{
+		io &= context.writeFrame( " " );
+		if ( m == eMETRIC_CALLBACK_TIME )
+		{
+			outtext.format( "%-13s  %10s  %10s  %10s  (%u ticks per msec)", titles[m], "Total", "Max", "Callbacks", (unsigned) OPTION_CPL_SYSTEM_EVENT_LOOP_PROFILE_TICKS_PER_MSEC );
+		}
+		else
+		{
+			outtext.format( "%-13s  %10s", titles[m], "Count" );
+		}
+		io &= context.writeFrame( outtext );
+
+		for ( unsigned i=0; i < topN && tops[m][i].mp; i++ )
+		{
+			if ( m == eMETRIC_CALLBACK_TIME )
+			{
+				tops[m][i].mp->getStats( stats );
+				outtext.format( "%-13s  %10lu  %10lu  %10lu", "", tops[m][i].value, stats.m_maxCallbackTicks, stats.m_callbacks );
+			}
+			else
+			{
+				outtext.format( "%-13s  %10lu", "", tops[m][i].value );
+			}
+			outtext.formatAppend( "  %s", tops[m][i].mp->getName() );
+			io &= context.writeFrame( outtext );
+		}
+	}
+
+	return io ? Command::eSUCCESS : Command::eERROR_IO;
+#endif
+}
+
+
+///////////////////////////
+#ifdef USE_CPL_DM_MODEL_POINT_STATS
+void insertTop_( TopEntry_T list[], unsigned numEntries, Cpl::Dm::ModelPoint* mp, unsigned long value )
+{
+	// Skip points with nothing to report, or that do not make the list
+	if ( value == 0 || ( list[numEntries - 1].mp && value <= list[numEntries - 1].value ) )
+	{
+		return;
+	}
+
+	// Insert in descending order (the last entry drops off the list)
+	unsigned idx = numEntries - 1;
+	while ( idx > 0 && ( list[idx - 1].mp == 0 || value > list[idx - 1].value ) )
+	{
+		list[idx] = list[idx - 1];
+		idx--;
+	}
+	list[idx].mp    = mp;
+	list[idx].value = value;
+}
+#endif
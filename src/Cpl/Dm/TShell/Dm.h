@@ -17,6 +17,19 @@
 #include "Cpl/Dm/ModelDatabaseApi.h"
 
 
+/** Maximum number of Model Points that are listed - per statistic - by the
+    'dm stats' sub-command
+ */
+#ifndef OPTION_CPL_DM_TSHELL_MAX_STATS_TOP_N
+#define OPTION_CPL_DM_TSHELL_MAX_STATS_TOP_N        10
+#endif
+
+/// Default number of Model Points that are listed - per statistic - by the 'dm stats' sub-command
+#ifndef OPTION_CPL_DM_TSHELL_DEFAULT_STATS_TOP_N
+#define OPTION_CPL_DM_TSHELL_DEFAULT_STATS_TOP_N    5
+#endif
+
+
 ///
 namespace Cpl {
 ///
@@ -39,7 +52,8 @@ public:
     static constexpr const char* usage = "dm ls [<filter>]\n" 
                                          "dm write {<mp-json>}\n" 
                                          "dm read <mpname>\n" 
-                                         "dm touch <mpname>";
+                                         "dm touch <mpname>\n"
+                                         "dm stats [<N>|reset]";
 
     /** The command detailed help string (recommended that lines do not exceed 80 chars)
                                                           1         2         3         4         5         6         7         8
@@ -50,7 +64,10 @@ public:
                                                 "  argument will only list points that contain <filter>.  Updating a Model Point\n" 
                                                 "  is done by specifying a JSON object. See the concrete class definition of the\n" 
                                                 "  Model Point being updated for the JSON format.  When displaying a Model Point\n" 
-                                                "  <mpname> is the string name of the Model Point instance to be displayed.";
+                                                "  <mpname> is the string name of the Model Point instance to be displayed.\n"
+                                                "  When 'stats' is used the top <N> Model Points are listed by: writes, no-op\n"
+                                                "  writes, change notifications issued, and total subscriber callback time.\n"
+                                                "  The 'reset' option clears the statistics of all Model Points.";
 
 
 protected:
@@ -78,6 +95,10 @@ public:
     /// See Cpl::TShell::Command
     Cpl::TShell::Command::Result_T execute( Cpl::TShell::Context_& context, char* cmdString, Cpl::Io::Output& outfd ) noexcept;
 
+protected:
+    /// Helper method that executes the 'stats' sub-command
+    virtual Cpl::TShell::Command::Result_T stats( Cpl::TShell::Context_& context, char* cmdString ) noexcept;
+
 };
 
 };      // end namespaces
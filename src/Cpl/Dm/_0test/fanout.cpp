@@ -0,0 +1,299 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+
+#include "Catch/catch.hpp"
+#include "Cpl/System/_testsupport/Shutdown_TS.h"
+#include "Cpl/System/Thread.h"
+#include "Cpl/System/Api.h"
+#include "Cpl/System/Trace.h"
+#include "Cpl/System/ElapsedTime.h"
+#include "Cpl/Itc/CloseSync.h"
+#include "Cpl/Dm/ModelDatabase.h"
+#include "Cpl/Dm/MailboxServer.h"
+#include "Cpl/Dm/SubscriberComposer.h"
+#include "Cpl/Dm/Mp/Uint32.h"
+
+///
+using namespace Cpl::Dm;
+
+#define SECT_   "_0test"
+
+#define NUM_SUBSCRIBERS_    50
+
+// Allocate/create my Model Database
+static ModelDatabase    modelDb_( "ignoreThisParameter_usedToInvokeTheStaticConstructor" );
+
+// Allocate my Model Points
+static Mp::Uint32       mp_fanout_( modelDb_, "FANOUT" );
+
+
+////////////////////////////////////////////////////////////////////////////////
+/** Subscribes NUM_SUBSCRIBERS_ subscribers to a single model point, and
+    signals the master thread once ALL of the subscribers have received the
+    change notification for the most recent write.
+ */
+class FanOut : public Cpl::Itc::CloseSync
+{
+public:
+    ///
+    Cpl::System::Thread&                        m_masterThread;
+    ///
+    Cpl::Itc::OpenRequest::OpenMsg*             m_pendingOpenMsgPtr;
+    ///
+    Mp::Uint32&                                 m_mp;
+    ///
+    SubscriberComposer<FanOut, Mp::Uint32>*     m_observers[NUM_SUBSCRIBERS_];
+    ///
+    unsigned                                    m_callbackCount;
+    ///
+    unsigned long                               m_totalCallbacks;
+    ///
+    unsigned long                               m_staleCallbacks;
+    ///
+    uint32_t                                    m_expectedValue;
+
+    /// Constructor
+    FanOut( MailboxServer& myMbox, Cpl::System::Thread& masterThread, Mp::Uint32& mp )
+        : Cpl::Itc::CloseSync( myMbox )
+        , m_masterThread( masterThread )
+        , m_pendingOpenMsgPtr( 0 )
+        , m_mp( mp )
+        , m_callbackCount( 0 )
+        , m_totalCallbacks( 0 )
+        , m_staleCallbacks( 0 )
+        , m_expectedValue( 0 )
+    {
+        for ( unsigned i=0; i < NUM_SUBSCRIBERS_; i++ )
+        {
+            m_observers[i] = new SubscriberComposer<FanOut, Mp::Uint32>( myMbox, *this, &FanOut::changed );
+        }
+    }
+
+    /// Destructor
+    ~FanOut()
+    {
+        for ( unsigned i=0; i < NUM_SUBSCRIBERS_; i++ )
+        {
+            delete m_observers[i];
+        }
+    }
+
+public:
+    ///
+    void request( Cpl::Itc::OpenRequest::OpenMsg& msg )
+    {
+        // Note: The open message is returned once all subscribers have received their initial callback
+        m_pendingOpenMsgPtr = &msg;
+        m_callbackCount     = 0;
+        m_mp.read( m_expectedValue );
+        for ( unsigned i=0; i < NUM_SUBSCRIBERS_; i++ )
+        {
+            m_mp.attach( *m_observers[i] );
+        }
+    }
+
+    ///
+    void request( Cpl::Itc::CloseRequest::CloseMsg& msg )
+    {
+        for ( unsigned i=0; i < NUM_SUBSCRIBERS_; i++ )
+        {
+            m_mp.detach( *m_observers[i] );
+        }
+        msg.returnToSender();
+    }
+
+public:
+    ///
+    void changed( Mp::Uint32& mp, SubscriberApi& clientObserver ) noexcept
+    {
+        uint32_t value = 0;
+        mp.readAndSync( value, clientObserver );
+        m_totalCallbacks++;
+        if ( value != m_expectedValue )
+        {
+            m_staleCallbacks++;
+        }
+
+        if ( ++m_callbackCount == NUM_SUBSCRIBERS_ )
+        {
+            m_callbackCount = 0;
+            m_expectedValue++;
+            if ( m_pendingOpenMsgPtr )
+            {
+                m_pendingOpenMsgPtr->returnToSender();
+                m_pendingOpenMsgPtr = 0;
+            }
+            else
+            {
+                m_masterThread.signal();
+            }
+        }
+    }
+};
+
+/** Writes the model point 'numWrites' times - waiting for the change to be
+    delivered to ALL subscribers before the next write.  Returns the elapsed
+    time in milliseconds.
+ */
+static unsigned long runFanOut( unsigned batchSize, unsigned long numWrites, FanOut*& fanOutPtr, MailboxServer& mbox )
+{
+    mbox.setNotificationBatching( batchSize );
+    Cpl::System::Thread* t1 = Cpl::System::Thread::create( mbox, "FANOUT" );
+
+    uint32_t value = 0;
+    mp_fanout_.write( value );
+    fanOutPtr = new FanOut( mbox, Cpl::System::Thread::getCurrent(), mp_fanout_ );
+    fanOutPtr->open();
+
+    unsigned long start = Cpl::System::ElapsedTime::milliseconds();
+    for ( unsigned long i=0; i < numWrites; i++ )
+    {
+        mp_fanout_.write( ++value );
+        Cpl::System::Thread::wait();
+    }
+    unsigned long elapsed = Cpl::System::ElapsedTime::deltaMilliseconds( start );
+
+    fanOutPtr->close();
+    mbox.pleaseStop();
+    Cpl::System::Api::sleep( 100 );
+    REQUIRE( t1->isRunning() == false );
+    Cpl::System::Thread::destroy( *t1 );
+    return elapsed;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+#define NUM_WRITES_     10
+
+TEST_CASE( "fanout" )
+{
+    Cpl::System::Shutdown_TS::clearAndUseCounter();
+
+    SECTION( "unbatched" )
+    {
+        MailboxServer mbox;
+        FanOut*       fanOut = 0;
+        runFanOut( 1, NUM_WRITES_, fanOut, mbox );
+        REQUIRE( fanOut->m_totalCallbacks == NUM_SUBSCRIBERS_ * (NUM_WRITES_ + 1) );
+        REQUIRE( fanOut->m_staleCallbacks == 0 );
+        delete fanOut;
+    }
+
+    SECTION( "batched" )
+    {
+        MailboxServer mbox;
+        FanOut*       fanOut = 0;
+        runFanOut( 10, NUM_WRITES_, fanOut, mbox );
+        REQUIRE( fanOut->m_totalCallbacks == NUM_SUBSCRIBERS_ * (NUM_WRITES_ + 1) );
+        REQUIRE( fanOut->m_staleCallbacks == 0 );
+
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+        // Note: The first notification of each write can be dispatched before all of the notifications are queued
+        Cpl::System::EventLoop::Profile_T profile;
+        REQUIRE( mbox.getProfile( profile ) );
+        REQUIRE( profile.m_categories[Cpl::System::EventLoop::ePROFILE_NOTIFICATIONS].m_count == NUM_SUBSCRIBERS_ * (NUM_WRITES_ + 1) );
+        REQUIRE( profile.m_categories[Cpl::System::EventLoop::ePROFILE_NOTIFICATIONS].m_peakQueueDepth >= 1 );
+        REQUIRE( profile.m_categories[Cpl::System::EventLoop::ePROFILE_NOTIFICATIONS].m_peakQueueDepth <= NUM_SUBSCRIBERS_ );
+        REQUIRE( profile.m_categories[Cpl::System::EventLoop::ePROFILE_MESSAGES].m_count >= 2 );    // open + close
+#endif
+        delete fanOut;
+    }
+
+    SECTION( "time-budget" )
+    {
+        MailboxServer mbox;
+        FanOut*       fanOut = 0;
+        mbox.setNotificationBatching( NUM_SUBSCRIBERS_, 1 );
+        Cpl::System::Thread* t1 = Cpl::System::Thread::create( mbox, "FANOUT" );
+        mp_fanout_.write( 0 );
+        fanOut = new FanOut( mbox, Cpl::System::Thread::getCurrent(), mp_fanout_ );
+        fanOut->open();
+        mp_fanout_.write( 1 );
+        Cpl::System::Thread::wait();
+        REQUIRE( fanOut->m_totalCallbacks == NUM_SUBSCRIBERS_ * 2 );
+        fanOut->close();
+        mbox.pleaseStop();
+        Cpl::System::Api::sleep( 100 );
+        REQUIRE( t1->isRunning() == false );
+        Cpl::System::Thread::destroy( *t1 );
+        delete fanOut;
+    }
+
+    REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 0u );
+}
+
+#ifdef USE_CPL_DM_MODEL_POINT_STATS
+TEST_CASE( "fanout-stats" )
+{
+    Cpl::System::Shutdown_TS::clearAndUseCounter();
+    MailboxServer         mbox;
+    FanOut*               fanOut = 0;
+    ModelPoint::Stats_T   stats;
+
+    mp_fanout_.write( 0 );
+    REQUIRE( mp_fanout_.getStats( stats, true ) );
+    runFanOut( 10, NUM_WRITES_, fanOut, mbox );
+    REQUIRE( fanOut->m_staleCallbacks == 0 );
+
+    REQUIRE( mp_fanout_.getStats( stats ) );
+    REQUIRE( stats.m_writes == NUM_WRITES_ + 1 );
+    REQUIRE( stats.m_noopWrites == 1 );                 // Initial write of zero
+    REQUIRE( stats.m_changes == NUM_WRITES_ );
+    REQUIRE( stats.m_notifications == NUM_SUBSCRIBERS_ * (NUM_WRITES_ + 1) );   // Includes the initial notification on attach
+    REQUIRE( stats.m_callbacks == NUM_SUBSCRIBERS_ * (NUM_WRITES_ + 1) );
+    REQUIRE( stats.m_maxCallbackTicks <= stats.m_callbackTicks );
+
+    // No-op writes
+    uint32_t value;
+    mp_fanout_.read( value );
+    mp_fanout_.write( value );
+    mp_fanout_.write( value );
+    REQUIRE( mp_fanout_.getStats( stats, true ) );
+    REQUIRE( stats.m_writes == NUM_WRITES_ + 3 );
+    REQUIRE( stats.m_noopWrites == 3 );
+    REQUIRE( stats.m_changes == NUM_WRITES_ );
+
+    // Reset
+    REQUIRE( mp_fanout_.getStats( stats ) );
+    REQUIRE( stats.m_writes == 0 );
+    REQUIRE( stats.m_noopWrites == 0 );
+    REQUIRE( stats.m_changes == 0 );
+    REQUIRE( stats.m_notifications == 0 );
+    REQUIRE( stats.m_callbacks == 0 );
+    REQUIRE( stats.m_callbackTicks == 0 );
+
+    delete fanOut;
+    REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 0u );
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+#define BENCH_NUM_WRITES_   2000
+
+TEST_CASE( "fanout-benchmark", "[.bench]" )
+{
+    static unsigned batchSizes[] ={ 1, 5, 10, NUM_SUBSCRIBERS_ };
+
+    for ( unsigned i=0; i < sizeof( batchSizes ) / sizeof( batchSizes[0] ); i++ )
+    {
+        MailboxServer mbox;
+        FanOut*       fanOut  = 0;
+        unsigned long elapsed = runFanOut( batchSizes[i], BENCH_NUM_WRITES_, fanOut, mbox );
+        REQUIRE( fanOut->m_staleCallbacks == 0 );
+        CPL_SYSTEM_TRACE_MSG( SECT_, ("batch=%2u: %u subscribers, %u writes in %lu ms (%lu usec per write-to-last-callback)",
+                                       batchSizes[i],
+                                       NUM_SUBSCRIBERS_,
+                                       BENCH_NUM_WRITES_,
+                                       elapsed,
+                                       elapsed * 1000 / BENCH_NUM_WRITES_) );
+        delete fanOut;
+    }
+}
@@ -0,0 +1,196 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+
+#include "Catch/catch.hpp"
+#include "Cpl/System/_testsupport/Shutdown_TS.h"
+#include "Cpl/System/Trace.h"
+#include "Cpl/System/ElapsedTime.h"
+#include "Cpl/Dm/IndexedModelDatabase.h"
+#include "Cpl/Dm/Mp/Uint32.h"
+#include <stdio.h>
+#include <string.h>
+
+///
+using namespace Cpl::Dm;
+
+#define SECT_   "_0test"
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Allocate/create my Model Database
+#define NUM_BUCKETS_    11
+#define MAX_POINTS_     5
+static Cpl::Container::DList<Cpl::Container::DictItem>  buckets_[NUM_BUCKETS_];
+static IndexedModelDatabase::IndexEntry                 entries_[MAX_POINTS_];
+static ModelPoint*                                      sortedMemory_[MAX_POINTS_];
+static IndexedModelDatabase                             modelDb_( buckets_, NUM_BUCKETS_, entries_, sortedMemory_, MAX_POINTS_, "ignoreThisParameter_usedToInvokeTheStaticConstructor" );
+
+// Allocate my Model Points
+static Mp::Uint32       mp_apple_( modelDb_, "APPLE" );
+static Mp::Uint32       mp_orange_( modelDb_, "ORANGE" );
+static Mp::Uint32       mp_cherry_( modelDb_, "CHERRY" );
+static Mp::Uint32       mp_plum_( modelDb_, "PLUM" );
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_CASE( "indexed" )
+{
+    Cpl::System::Shutdown_TS::clearAndUseCounter();
+
+    SECTION( "find" )
+    {
+        REQUIRE( modelDb_.lookupModelPoint( "APPLE" ) == &mp_apple_ );
+        REQUIRE( modelDb_.lookupModelPoint( "ORANGE" ) == &mp_orange_ );
+        REQUIRE( modelDb_.lookupModelPoint( "CHERRY" ) == &mp_cherry_ );
+        REQUIRE( modelDb_.lookupModelPoint( "PLUM" ) == &mp_plum_ );
+        REQUIRE( modelDb_.lookupModelPoint( "APPLE1" ) == 0 );
+        REQUIRE( modelDb_.lookupModelPoint( "" ) == 0 );
+        REQUIRE( modelDb_.getNumIndexed() == 4 );
+    }
+
+    SECTION( "traverse" )
+    {
+        ModelPoint* mpPtr = modelDb_.getFirstByName();
+        REQUIRE( mpPtr == &mp_apple_ );
+        mpPtr = modelDb_.getNextByName( *mpPtr );
+        REQUIRE( mpPtr == &mp_cherry_ );
+        mpPtr = modelDb_.getNextByName( *mpPtr );
+        REQUIRE( mpPtr == &mp_orange_ );
+        mpPtr = modelDb_.getNextByName( *mpPtr );
+        REQUIRE( mpPtr == &mp_plum_ );
+        mpPtr = modelDb_.getNextByName( *mpPtr );
+        REQUIRE( mpPtr == 0 );
+    }
+
+    SECTION( "runtime_db" )
+    {
+        Cpl::Container::DList<Cpl::Container::DictItem> buckets[7];
+        IndexedModelDatabase::IndexEntry                entries[3];
+        ModelPoint*                                     sortedMemory[3];
+        IndexedModelDatabase                            myDb( buckets, 7, entries, sortedMemory, 3 );
+        ModelPoint* mpPtr = myDb.getFirstByName();
+        REQUIRE( mpPtr == 0 );
+
+        // Points added after the index has been accessed
+        Mp::Uint32  myDate( myDb, "DATE" );
+        Mp::Uint32  myBanana( myDb, "BANANA" );
+        REQUIRE( myDb.lookupModelPoint( "BANANA" ) == &myBanana );
+        Mp::Uint32  myCherry( myDb, "CHERRY" );
+        REQUIRE( myDb.lookupModelPoint( "CHERRY" ) == &myCherry );
+        REQUIRE( myDb.lookupModelPoint( "DATE" ) == &myDate );
+
+        // Overflow the index
+        Mp::Uint32  myApple( myDb, "APPLE" );
+        Mp::Uint32  myFig( myDb, "FIG" );
+        REQUIRE( myDb.lookupModelPoint( "APPLE" ) == &myApple );
+        REQUIRE( myDb.lookupModelPoint( "FIG" ) == &myFig );
+        REQUIRE( myDb.lookupModelPoint( "GRAPE" ) == 0 );
+        REQUIRE( myDb.getNumIndexed() == 3 );
+
+        // Indexed points are sorted, followed by the un-indexed points
+        mpPtr = myDb.getFirstByName();
+        REQUIRE( mpPtr == &myBanana );
+        mpPtr = myDb.getNextByName( *mpPtr );
+        REQUIRE( mpPtr == &myCherry );
+        mpPtr = myDb.getNextByName( *mpPtr );
+        REQUIRE( mpPtr == &myDate );
+        unsigned count = 0;
+        while ( (mpPtr = myDb.getNextByName( *mpPtr )) )
+        {
+            REQUIRE( (mpPtr == &myApple || mpPtr == &myFig) );
+            count++;
+        }
+        REQUIRE( count == 2 );
+    }
+
+    REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 0u );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+#define BENCH_MAX_POINTS_       10000
+#define BENCH_NUM_BUCKETS_      16411
+#define BENCH_NAME_SIZE_        16
+#define BENCH_LOOKUP_PASSES_    10
+
+static void benchmark( ModelDatabase& db, const char* label, char names[][BENCH_NAME_SIZE_], unsigned numPoints )
+{
+    // Iterate (the first pass includes any one-time sorting)
+    unsigned long start = Cpl::System::ElapsedTime::milliseconds();
+    unsigned      count = 0;
+    ModelPoint*   mp    = db.getFirstByName();
+    while ( mp )
+    {
+        count++;
+        mp = db.getNextByName( *mp );
+    }
+    unsigned long iterateTime = Cpl::System::ElapsedTime::deltaMilliseconds( start );
+    REQUIRE( count == numPoints );
+
+    // Look-up every point by name
+    unsigned misses = 0;
+    start = Cpl::System::ElapsedTime::milliseconds();
+    for ( unsigned pass=0; pass < BENCH_LOOKUP_PASSES_; pass++ )
+    {
+        for ( unsigned i=0; i < numPoints; i++ )
+        {
+            if ( db.lookupModelPoint( names[i] ) == 0 )
+            {
+                misses++;
+            }
+        }
+    }
+    unsigned long lookupTime = Cpl::System::ElapsedTime::deltaMilliseconds( start );
+    REQUIRE( misses == 0 );
+
+    CPL_SYSTEM_TRACE_MSG( SECT_, ("%-8s: points=%5u, iterate=%5lu ms, lookups=%6u in %6lu ms", label, numPoints, iterateTime, numPoints * BENCH_LOOKUP_PASSES_, lookupTime) );
+}
+
+TEST_CASE( "indexed-benchmark", "[.bench]" )
+{
+    static char        names[BENCH_MAX_POINTS_][BENCH_NAME_SIZE_];
+    static ModelPoint* sortedMemory[BENCH_MAX_POINTS_];
+    static unsigned    sizes[] ={ 100, 1000, BENCH_MAX_POINTS_ };
+
+    // Names are generated in a 'scrambled' order
+    for ( unsigned i=0; i < BENCH_MAX_POINTS_; i++ )
+    {
+        snprintf( names[i], BENCH_NAME_SIZE_, "mp%08lx", (unsigned long) ((i * 2654435761UL) & 0xFFFFFFFFUL) );
+    }
+
+    for ( unsigned s=0; s < sizeof( sizes ) / sizeof( sizes[0] ); s++ )
+    {
+        // Note: The hash buckets/entries can NOT be re-used across databases
+        unsigned                                         numPoints = sizes[s];
+        Cpl::Container::DList<Cpl::Container::DictItem>* buckets   = new Cpl::Container::DList<Cpl::Container::DictItem>[BENCH_NUM_BUCKETS_];
+        IndexedModelDatabase::IndexEntry*                entries   = new IndexedModelDatabase::IndexEntry[BENCH_MAX_POINTS_];
+        ModelDatabase         listDb;
+        IndexedModelDatabase  indexedDb( buckets, BENCH_NUM_BUCKETS_, entries, sortedMemory, BENCH_MAX_POINTS_ );
+        Mp::Uint32**          listMps    = new Mp::Uint32*[numPoints];
+        Mp::Uint32**          indexedMps = new Mp::Uint32*[numPoints];
+        for ( unsigned i=0; i < numPoints; i++ )
+        {
+            listMps[i]    = new Mp::Uint32( listDb, names[i] );
+            indexedMps[i] = new Mp::Uint32( indexedDb, names[i] );
+        }
+
+        benchmark( listDb, "list", names, numPoints );
+        benchmark( indexedDb, "indexed", names, numPoints );
+
+        for ( unsigned i=0; i < numPoints; i++ )
+        {
+            delete listMps[i];
+            delete indexedMps[i];
+        }
+        delete[] listMps;
+        delete[] indexedMps;
+        delete[] entries;
+        delete[] buckets;
+    }
+}
@@ -0,0 +1,229 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+
+#include "Catch/catch.hpp"
+#include "Cpl/System/_testsupport/Shutdown_TS.h"
+#include "Cpl/System/Trace.h"
+#include "Cpl/System/Thread.h"
+#include "Cpl/System/Semaphore.h"
+#include "Cpl/System/Api.h"
+#include "Cpl/Text/FString.h"
+#include "Cpl/Dm/ModelDatabase.h"
+#include "Cpl/Dm/Mp/Uint32.h"
+#include "Cpl/Dm/Mp/String.h"
+#include <chrono>
+#include <string.h>
+
+///
+using namespace Cpl::Dm;
+
+#define SECT_           "_0test"
+
+#define MAX_STR_LENG    256
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Allocate/create my Model Database
+static ModelDatabase    modelDb_( "ignoreThisParameter_usedToInvokeTheStaticConstructor" );
+
+// Allocate my Model Points
+static Mp::Uint32       mp_apple_( modelDb_, "APPLE", 127 );
+static Mp::Uint32       mp_orange_( modelDb_, "ORANGE" );
+static Mp::String<16>   mp_text_( modelDb_, "TEXT", "hello" );
+
+typedef StaticJsonDocument<OPTION_CPL_DM_MODEL_DATABASE_MAX_CAPACITY_JSON_DOC> JsonDoc_T;
+
+namespace {
+
+/// Converts a set of model points to JSON, 'numPasses' times, using its own (or the global) JSON document
+class Dumper : public Cpl::System::Runnable
+{
+public:
+    Dumper( Cpl::System::Semaphore& doneSema, ModelPoint** mps, unsigned numMps, unsigned numPasses, bool useGlobalDoc )
+        : m_doneSema( doneSema ), m_mps( mps ), m_numMps( numMps ), m_numPasses( numPasses ), m_useGlobalDoc( useGlobalDoc ), m_numErrors( 0 )
+    {
+    }
+
+public:
+    void appRun()
+    {
+        JsonDoc_T doc;
+        char      buffer[MAX_STR_LENG];
+        for ( unsigned p=0; p < m_numPasses; p++ )
+        {
+            for ( unsigned i=0; i < m_numMps; i++ )
+            {
+                bool truncated;
+                bool result = m_useGlobalDoc ? m_mps[i]->toJSON( buffer, sizeof( buffer ), truncated ) : m_mps[i]->toJSON( doc, buffer, sizeof( buffer ), truncated );
+                if ( !result || truncated || strstr( buffer, m_mps[i]->getName() ) == 0 )
+                {
+                    m_numErrors++;
+                }
+            }
+        }
+        m_doneSema.signal();
+    }
+
+public:
+    Cpl::System::Semaphore& m_doneSema;
+    ModelPoint**            m_mps;
+    unsigned                m_numMps;
+    unsigned                m_numPasses;
+    bool                    m_useGlobalDoc;
+    unsigned                m_numErrors;
+};
+
+}; // end anonymous namespace
+
+/// Runs 'numThreads' dumpers concurrently. Returns the total number of errors
+static unsigned runDumpers( unsigned numThreads, ModelPoint** mps, unsigned numMps, unsigned numPasses, bool useGlobalDoc, unsigned long* elapsedMs=0 )
+{
+    Cpl::System::Semaphore doneSema;
+    Dumper*                dumpers[8];
+    Cpl::System::Thread*   threads[8];
+    unsigned               numErrors = 0;
+    REQUIRE( numThreads <= 8 );
+
+    auto start = std::chrono::steady_clock::now();
+    for ( unsigned i=0; i < numThreads; i++ )
+    {
+        Cpl::Text::FString<16> name;
+        name.format( "Dumper%u", i );
+        dumpers[i] = new Dumper( doneSema, mps, numMps, numPasses, useGlobalDoc );
+        threads[i] = Cpl::System::Thread::create( *dumpers[i], name.getString() );
+        REQUIRE( threads[i] );
+    }
+    for ( unsigned i=0; i < numThreads; i++ )
+    {
+        doneSema.wait();
+    }
+    auto end = std::chrono::steady_clock::now();
+    if ( elapsedMs )
+    {
+        *elapsedMs = (unsigned long) std::chrono::duration_cast<std::chrono::milliseconds>( end - start ).count();
+    }
+
+    for ( unsigned i=0; i < numThreads; i++ )
+    {
+        while ( dumpers[i]->isRunning() )
+        {
+            Cpl::System::Api::sleep( 1 );
+        }
+        Cpl::System::Thread::destroy( *threads[i] );
+        numErrors += dumpers[i]->m_numErrors;
+        delete dumpers[i];
+    }
+    return numErrors;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_CASE( "json" )
+{
+    Cpl::System::Shutdown_TS::clearAndUseCounter();
+    Cpl::Text::FString<MAX_STR_LENG> errorMsg = "noerror";
+    char      string1[MAX_STR_LENG];
+    char      string2[MAX_STR_LENG];
+    bool      truncated;
+    JsonDoc_T doc;
+
+    SECTION( "toJSON - caller document" )
+    {
+        ModelPoint* mps[] ={ &mp_apple_, &mp_orange_, &mp_text_ };
+        for ( unsigned i=0; i < sizeof( mps ) / sizeof( mps[0] ); i++ )
+        {
+            REQUIRE( mps[i]->toJSON( string1, sizeof( string1 ), truncated ) );
+            REQUIRE( truncated == false );
+            REQUIRE( mps[i]->toJSON( doc, string2, sizeof( string2 ), truncated ) );
+            REQUIRE( truncated == false );
+            CPL_SYSTEM_TRACE_MSG( SECT_, ( "toJSON: [%s]", string2 ) );
+            REQUIRE( strcmp( string1, string2 ) == 0 );
+
+            REQUIRE( mps[i]->toJSON( string1, sizeof( string1 ), truncated, false, true ) );
+            REQUIRE( mps[i]->toJSON( doc, string2, sizeof( string2 ), truncated, false, true ) );
+            REQUIRE( strcmp( string1, string2 ) == 0 );
+        }
+
+        REQUIRE( mp_text_.toJSON( doc, string2, 10, truncated ) );
+        REQUIRE( truncated == true );
+    }
+
+    SECTION( "fromJSON - caller document" )
+    {
+        ModelPoint* mp = 0;
+        uint16_t    seqNum;
+        REQUIRE( modelDb_.fromJSON( "{name:\"ORANGE\", val:42}", doc, &errorMsg, &mp, &seqNum ) );
+        REQUIRE( mp == &mp_orange_ );
+        uint32_t value;
+        uint16_t seqNum2;
+        REQUIRE( mp_orange_.read( value, &seqNum2 ) );
+        REQUIRE( value == 42 );
+        REQUIRE( seqNum == seqNum2 );
+        REQUIRE( errorMsg == "noerror" );
+
+        REQUIRE( modelDb_.fromJSON( "{name:\"ORANGE\", val:abc}", doc, &errorMsg ) == false );
+        REQUIRE( errorMsg != "noerror" );
+        REQUIRE( modelDb_.fromJSON( "{name:\"BOB\", val:1}", doc ) == false );
+    }
+
+    SECTION( "fromJSON - errors release the global lock" )
+    {
+        REQUIRE( modelDb_.fromJSON( "{name:\"BOB\", val:1}", &errorMsg ) == false );
+        REQUIRE( modelDb_.fromJSON( "{name:", &errorMsg ) == false );
+
+        // A different thread can still use the global document
+        ModelPoint* mps[] ={ &mp_apple_ };
+        REQUIRE( runDumpers( 1, mps, 1, 1, true ) == 0 );
+    }
+
+    SECTION( "concurrent" )
+    {
+        ModelPoint* mps[] ={ &mp_apple_, &mp_orange_, &mp_text_ };
+        REQUIRE( runDumpers( 4, mps, 3, 500, false ) == 0 );
+        REQUIRE( runDumpers( 4, mps, 3, 500, true ) == 0 );
+    }
+
+    REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 0u );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+#define BENCH_NUM_POINTS_   100
+#define BENCH_NUM_PASSES_   200
+
+TEST_CASE( "json-benchmark", "[.bench]" )
+{
+    ModelDatabase   db;
+    Mp::Uint32*     points[BENCH_NUM_POINTS_];
+    ModelPoint*     mps[BENCH_NUM_POINTS_];
+    char            names[BENCH_NUM_POINTS_][16];
+    for ( unsigned i=0; i < BENCH_NUM_POINTS_; i++ )
+    {
+        snprintf( names[i], sizeof( names[i] ), "mp%03u", i );
+        points[i] = new Mp::Uint32( db, names[i], i );
+        mps[i]    = points[i];
+    }
+
+    static const unsigned numThreads[] ={ 1, 2, 4, 8 };
+    for ( unsigned t=0; t < sizeof( numThreads ) / sizeof( numThreads[0] ); t++ )
+    {
+        unsigned long globalMs;
+        unsigned long callerMs;
+        REQUIRE( runDumpers( numThreads[t], mps, BENCH_NUM_POINTS_, BENCH_NUM_PASSES_, true, &globalMs ) == 0 );
+        REQUIRE( runDumpers( numThreads[t], mps, BENCH_NUM_POINTS_, BENCH_NUM_PASSES_, false, &callerMs ) == 0 );
+        unsigned long total = (unsigned long) numThreads[t] * BENCH_NUM_POINTS_ * BENCH_NUM_PASSES_;
+        CPL_SYSTEM_TRACE_MSG( SECT_, ( "threads=%u: %lu toJSON() calls: global document=%lu ms, caller document=%lu ms",
+                                       numThreads[t], total, globalMs, callerMs ) );
+    }
+
+    for ( unsigned i=0; i < BENCH_NUM_POINTS_; i++ )
+    {
+        delete points[i];
+    }
+}
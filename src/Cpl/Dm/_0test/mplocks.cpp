@@ -0,0 +1,299 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+
+#include "Catch/catch.hpp"
+#include "Cpl/System/_testsupport/Shutdown_TS.h"
+#include "Cpl/System/Trace.h"
+#include "Cpl/System/Thread.h"
+#include "Cpl/System/Semaphore.h"
+#include "Cpl/System/Api.h"
+#include "Cpl/Text/FString.h"
+#include "Cpl/Dm/ModelDatabase.h"
+#include "Cpl/Dm/Mp/Uint32.h"
+#include "Cpl/Dm/Mp/Uint64.h"
+#include "Cpl/Dm/Mp/String.h"
+#include <chrono>
+
+///
+using namespace Cpl::Dm;
+
+#define SECT_           "_0test"
+
+#define MAX_THREADS_    8
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Allocate/create my Model Database
+static ModelDatabase    modelDb_( "ignoreThisParameter_usedToInvokeTheStaticConstructor" );
+
+// Allocate my Model Points
+static Mp::Uint32       mp_counter_( modelDb_, "COUNTER", 0 );
+static Mp::Uint64       mp_pair_( modelDb_, "PAIR", 0 );
+static Mp::String<16>   mp_textA_( modelDb_, "TEXTA", "aaaa" );
+static Mp::String<16>   mp_textB_( modelDb_, "TEXTB", "bbbb" );
+static Mp::Uint32       mp_bench0_( modelDb_, "BENCH0", 0 );
+static Mp::Uint32       mp_bench1_( modelDb_, "BENCH1", 0 );
+static Mp::Uint32       mp_bench2_( modelDb_, "BENCH2", 0 );
+static Mp::Uint32       mp_bench3_( modelDb_, "BENCH3", 0 );
+static Mp::Uint32       mp_bench4_( modelDb_, "BENCH4", 0 );
+static Mp::Uint32       mp_bench5_( modelDb_, "BENCH5", 0 );
+static Mp::Uint32       mp_bench6_( modelDb_, "BENCH6", 0 );
+static Mp::Uint32       mp_bench7_( modelDb_, "BENCH7", 0 );
+static Mp::Uint32*      mp_bench_[MAX_THREADS_] ={ &mp_bench0_, &mp_bench1_, &mp_bench2_, &mp_bench3_, &mp_bench4_, &mp_bench5_, &mp_bench6_, &mp_bench7_ };
+
+// Snapshot images
+#define MAX_SNAPSHOT_SIZE_  1024
+static uint8_t          snapshotA_[MAX_SNAPSHOT_SIZE_];
+static uint8_t          snapshotB_[MAX_SNAPSHOT_SIZE_];
+static size_t           snapshotALen_;
+static size_t           snapshotBLen_;
+
+
+namespace {
+
+/// Reads and/or writes model points, 'numPasses' times
+class Worker : public Cpl::System::Runnable
+{
+public:
+    /// Operations
+    enum Op_T
+    {
+        eINCREMENT,         // Increment COUNTER
+        eWRITE_PAIR,        // Write PAIR with equal upper/lower halves
+        eREAD,              // Read COUNTER, PAIR, and their state
+        eCOPY_A_TO_B,       // TEXTB.copyFrom(TEXTA)
+        eCOPY_B_TO_A,       // TEXTA.copyFrom(TEXTB)
+        eBENCH_READ,        // Read 'm_mp'
+        eBENCH_WRITE,       // Write 'm_mp'
+        eRESTORE,           // Alternately restore the snapshot images 'snapshotA_' and 'snapshotB_'
+    };
+
+public:
+    Worker( Cpl::System::Semaphore& doneSema, Op_T op, unsigned long numPasses, Mp::Uint32* mp=0 )
+        : m_doneSema( doneSema ), m_op( op ), m_numPasses( numPasses ), m_mp( mp ), m_numErrors( 0 )
+    {
+    }
+
+public:
+    void appRun()
+    {
+        uint32_t prevCounter = 0;
+        for ( unsigned long i=0; i < m_numPasses; i++ )
+        {
+            switch ( m_op )
+            {
+            case eINCREMENT:
+                mp_counter_.increment();
+                break;
+
+            case eWRITE_PAIR:
+                mp_pair_.write( ( ( (uint64_t) i ) << 32 ) | i );
+                break;
+
+            case eREAD:
+            {
+                uint32_t counter;
+                uint64_t pair;
+                uint16_t seqNum1, seqNum2;
+                if ( !mp_counter_.read( counter, &seqNum1 ) || counter < prevCounter || !mp_pair_.read( pair ) || ( pair >> 32 ) != ( pair & 0xFFFFFFFF ) )
+                {
+                    m_numErrors++;
+                }
+                if ( mp_counter_.isNotValid( &seqNum2 ) || seqNum2 == ModelPoint::SEQUENCE_NUMBER_UNKNOWN || mp_counter_.getSequenceNumber() == ModelPoint::SEQUENCE_NUMBER_UNKNOWN )
+                {
+                    m_numErrors++;
+                }
+                prevCounter = counter;
+                break;
+            }
+
+            case eCOPY_A_TO_B:
+                mp_textB_.copyFrom( mp_textA_ );
+                break;
+
+            case eCOPY_B_TO_A:
+                mp_textA_.copyFrom( mp_textB_ );
+                break;
+
+            case eBENCH_READ:
+            {
+                uint32_t value;
+                m_mp->read( value );
+                break;
+            }
+
+            case eBENCH_WRITE:
+                m_mp->write( (uint32_t) i );
+                break;
+
+            case eRESTORE:
+                if ( ( i & 1 ) ? !modelDb_.restore( snapshotB_, snapshotBLen_ ) : !modelDb_.restore( snapshotA_, snapshotALen_ ) )
+                {
+                    m_numErrors++;
+                }
+                break;
+            }
+        }
+        m_doneSema.signal();
+    }
+
+public:
+    Cpl::System::Semaphore& m_doneSema;
+    Op_T                    m_op;
+    unsigned long           m_numPasses;
+    Mp::Uint32*             m_mp;
+    unsigned                m_numErrors;
+};
+
+}; // end anonymous namespace
+
+/// Runs the workers concurrently. Returns the total number of errors
+static unsigned runWorkers( unsigned numThreads, const Worker::Op_T ops[], unsigned long numPasses, Mp::Uint32* mps[]=0, unsigned long* elapsedMs=0 )
+{
+    Cpl::System::Semaphore doneSema;
+    Worker*                workers[MAX_THREADS_];
+    Cpl::System::Thread*   threads[MAX_THREADS_];
+    unsigned               numErrors = 0;
+    REQUIRE( numThreads <= MAX_THREADS_ );
+
+    auto start = std::chrono::steady_clock::now();
+    for ( unsigned i=0; i < numThreads; i++ )
+    {
+        Cpl::Text::FString<16> name;
+        name.format( "Worker%u", i );
+        workers[i] = new Worker( doneSema, ops[i], numPasses, mps ? mps[i] : 0 );
+        threads[i] = Cpl::System::Thread::create( *workers[i], name.getString() );
+        REQUIRE( threads[i] );
+    }
+    for ( unsigned i=0; i < numThreads; i++ )
+    {
+        doneSema.wait();
+    }
+    auto end = std::chrono::steady_clock::now();
+    if ( elapsedMs )
+    {
+        *elapsedMs = (unsigned long) std::chrono::duration_cast<std::chrono::milliseconds>( end - start ).count();
+    }
+
+    for ( unsigned i=0; i < numThreads; i++ )
+    {
+        while ( workers[i]->isRunning() )
+        {
+            Cpl::System::Api::sleep( 1 );
+        }
+        Cpl::System::Thread::destroy( *threads[i] );
+        numErrors += workers[i]->m_numErrors;
+        delete workers[i];
+    }
+    return numErrors;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+#define NUM_PASSES_     20000
+
+TEST_CASE( "mplocks" )
+{
+    Cpl::System::Shutdown_TS::clearAndUseCounter();
+
+    SECTION( "concurrent read/write" )
+    {
+        mp_counter_.write( 0 );
+        static const Worker::Op_T ops[] ={ Worker::eINCREMENT, Worker::eINCREMENT, Worker::eWRITE_PAIR, Worker::eREAD, Worker::eREAD };
+        REQUIRE( runWorkers( 5, ops, NUM_PASSES_ ) == 0 );
+
+        uint32_t counter;
+        REQUIRE( mp_counter_.read( counter ) );
+        REQUIRE( counter == 2 * NUM_PASSES_ );
+        uint64_t pair;
+        REQUIRE( mp_pair_.read( pair ) );
+        REQUIRE( pair == ( ( ( (uint64_t) ( NUM_PASSES_ - 1 ) ) << 32 ) | ( NUM_PASSES_ - 1 ) ) );
+    }
+
+    SECTION( "invalid state" )
+    {
+        uint16_t seqNum  = mp_counter_.setInvalid();
+        uint16_t seqNum2 = 0;
+        uint32_t counter = 42;
+        REQUIRE( mp_counter_.isNotValid( &seqNum2 ) );
+        REQUIRE( seqNum == seqNum2 );
+        REQUIRE( mp_counter_.getSequenceNumber() == seqNum );
+        REQUIRE( mp_counter_.read( counter, &seqNum2 ) == false );
+        REQUIRE( counter == 42 );
+        REQUIRE( seqNum == seqNum2 );
+        seqNum = mp_counter_.write( 7 );
+        REQUIRE( mp_counter_.read( counter, &seqNum2 ) );
+        REQUIRE( counter == 7 );
+        REQUIRE( seqNum == seqNum2 );
+    }
+
+    SECTION( "restore while reading" )
+    {
+        // Note: The readers verify that PAIR is never 'torn'
+        mp_counter_.write( 0 );
+        mp_pair_.write( 0x1111111111111111ULL );
+        snapshotALen_ = modelDb_.snapshot( snapshotA_, sizeof( snapshotA_ ) );
+        mp_pair_.write( 0x2222222222222222ULL );
+        snapshotBLen_ = modelDb_.snapshot( snapshotB_, sizeof( snapshotB_ ) );
+        REQUIRE( snapshotALen_ > 0 );
+        REQUIRE( snapshotBLen_ > 0 );
+
+        static const Worker::Op_T ops[] ={ Worker::eRESTORE, Worker::eREAD, Worker::eREAD };
+        REQUIRE( runWorkers( 3, ops, NUM_PASSES_ / 10 ) == 0 );
+    }
+
+    SECTION( "copy in both directions" )
+    {
+        // Note: Fails by dead-locking
+        static const Worker::Op_T ops[] ={ Worker::eCOPY_A_TO_B, Worker::eCOPY_B_TO_A };
+        REQUIRE( runWorkers( 2, ops, NUM_PASSES_ ) == 0 );
+    }
+
+    REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 0u );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+#define BENCH_NUM_PASSES_   1000000
+
+TEST_CASE( "mplocks-benchmark", "[.bench]" )
+{
+    // Each thread reads its own (i.e. unrelated) point; then all threads read the same point; then half the threads write
+    static const unsigned numThreads[] ={ 1, 2, 4, 8 };
+    for ( unsigned n=0; n < sizeof( numThreads ) / sizeof( numThreads[0] ); n++ )
+    {
+        Worker::Op_T  ops[MAX_THREADS_];
+        Mp::Uint32*   mps[MAX_THREADS_];
+        unsigned long elapsed;
+        unsigned      threads = numThreads[n];
+
+        for ( unsigned i=0; i < threads; i++ )
+        {
+            ops[i] = Worker::eBENCH_READ;
+            mps[i] = mp_bench_[i];
+        }
+        runWorkers( threads, ops, BENCH_NUM_PASSES_, mps, &elapsed );
+        CPL_SYSTEM_TRACE_MSG( SECT_, ("threads=%u: unrelated reads: %lu ms (%lu reads/ms)", threads, elapsed, elapsed ? threads * BENCH_NUM_PASSES_ / elapsed : 0) );
+
+        for ( unsigned i=0; i < threads; i++ )
+        {
+            mps[i] = mp_bench_[0];
+        }
+        runWorkers( threads, ops, BENCH_NUM_PASSES_, mps, &elapsed );
+        CPL_SYSTEM_TRACE_MSG( SECT_, ("threads=%u: shared reads:    %lu ms (%lu reads/ms)", threads, elapsed, elapsed ? threads * BENCH_NUM_PASSES_ / elapsed : 0) );
+
+        for ( unsigned i=0; i < threads; i++ )
+        {
+            ops[i] = ( i & 1 ) ? Worker::eBENCH_WRITE : Worker::eBENCH_READ;
+            mps[i] = mp_bench_[i / 2];
+        }
+        runWorkers( threads, ops, BENCH_NUM_PASSES_, mps, &elapsed );
+        CPL_SYSTEM_TRACE_MSG( SECT_, ("threads=%u: read+write:      %lu ms (%lu ops/ms)", threads, elapsed, elapsed ? threads * BENCH_NUM_PASSES_ / elapsed : 0) );
+    }
+}
@@ -0,0 +1,232 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+
+#include "Catch/catch.hpp"
+#include "Cpl/System/_testsupport/Shutdown_TS.h"
+#include "Cpl/System/Thread.h"
+#include "Cpl/System/Api.h"
+#include "Cpl/System/Trace.h"
+#include "Cpl/Itc/CloseSync.h"
+#include "Cpl/Dm/ModelDatabase.h"
+#include "Cpl/Dm/MailboxServer.h"
+#include "Cpl/Dm/SubscriberComposer.h"
+#include "Cpl/Dm/Mp/Float.h"
+#include "Cpl/Dm/Mp/String.h"
+
+///
+using namespace Cpl::Dm;
+
+#define SECT_   "_0test"
+
+/// Time to wait for the change notifications to be delivered
+#define SETTLE_MSEC_    50
+
+// Allocate/create my Model Database
+static ModelDatabase    modelDb_( "ignoreThisParameter_usedToInvokeTheStaticConstructor" );
+
+// Allocate my Model Points
+static Mp::Float        mp_sensor_( modelDb_, "SENSOR" );
+static Mp::String<16>   mp_label_( modelDb_, "LABEL" );
+
+
+////////////////////////////////////////////////////////////////////////////////
+/** Subscribes to the SENSOR and LABEL model points - with the specified
+    notification options - and counts the change notifications.
+ */
+class Consumer : public Cpl::Itc::CloseSync
+{
+public:
+    ///
+    SubscriberComposer<Consumer, Mp::Float>         m_sensorObserver;
+    ///
+    SubscriberComposer<Consumer, Mp::String<16>>    m_labelObserver;
+    ///
+    volatile unsigned                               m_sensorCount;
+    ///
+    volatile unsigned                               m_labelCount;
+    ///
+    volatile float                                  m_lastValue;
+    ///
+    volatile bool                                   m_lastValid;
+
+    /// Constructor
+    Consumer( MailboxServer& myMbox, unsigned long minIntervalMsec, double deadband, bool isRelative )
+        : Cpl::Itc::CloseSync( myMbox )
+        , m_sensorObserver( myMbox, *this, &Consumer::sensorChanged )
+        , m_labelObserver( myMbox, *this, &Consumer::labelChanged )
+        , m_sensorCount( 0 )
+        , m_labelCount( 0 )
+        , m_lastValue( 0 )
+        , m_lastValid( false )
+    {
+        m_sensorObserver.setMinimumInterval( minIntervalMsec );
+        m_sensorObserver.setDeadband( deadband, isRelative );
+        m_labelObserver.setDeadband( deadband, isRelative );
+    }
+
+public:
+    ///
+    void request( Cpl::Itc::OpenRequest::OpenMsg& msg )
+    {
+        mp_sensor_.attach( m_sensorObserver );
+        mp_label_.attach( m_labelObserver );
+        msg.returnToSender();
+    }
+
+    ///
+    void request( Cpl::Itc::CloseRequest::CloseMsg& msg )
+    {
+        mp_sensor_.detach( m_sensorObserver );
+        mp_label_.detach( m_labelObserver );
+        msg.returnToSender();
+    }
+
+public:
+    ///
+    void sensorChanged( Mp::Float& mp, SubscriberApi& clientObserver ) noexcept
+    {
+        float value = 0;
+        m_lastValid = mp.readAndSync( value, clientObserver );
+        m_lastValue = value;
+        m_sensorCount++;
+    }
+
+    ///
+    void labelChanged( Mp::String<16>& mp, SubscriberApi& clientObserver ) noexcept
+    {
+        mp.isNotValidAndSync( clientObserver );
+        m_labelCount++;
+    }
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_CASE( "options" )
+{
+    Cpl::System::Shutdown_TS::clearAndUseCounter();
+    MailboxServer        mbox;
+    Cpl::System::Thread* t1 = Cpl::System::Thread::create( mbox, "OPTIONS" );
+    mp_sensor_.write( 10.0F );
+    mp_label_.write( "hello" );
+
+    SECTION( "absolute deadband" )
+    {
+        Consumer consumer( mbox, 0, 1.0, false );
+        consumer.open();
+        Cpl::System::Api::sleep( SETTLE_MSEC_ );
+        REQUIRE( consumer.m_sensorCount == 1 );
+        REQUIRE( consumer.m_lastValue == 10.0F );
+
+        // Inside of the deadband
+        mp_sensor_.write( 10.5F );
+        mp_sensor_.write( 9.25F );
+        mp_sensor_.write( 10.75F );
+        Cpl::System::Api::sleep( SETTLE_MSEC_ );
+        REQUIRE( consumer.m_sensorCount == 1 );
+
+        // Outside of the deadband
+        mp_sensor_.write( 11.5F );
+        Cpl::System::Api::sleep( SETTLE_MSEC_ );
+        REQUIRE( consumer.m_sensorCount == 2 );
+        REQUIRE( consumer.m_lastValue == 11.5F );
+
+        // Deadband is relative to the last delivered value
+        mp_sensor_.write( 12.25F );
+        Cpl::System::Api::sleep( SETTLE_MSEC_ );
+        REQUIRE( consumer.m_sensorCount == 2 );
+        mp_sensor_.write( 12.75F );
+        Cpl::System::Api::sleep( SETTLE_MSEC_ );
+        REQUIRE( consumer.m_sensorCount == 3 );
+
+        // Invalid transitions are always delivered
+        mp_sensor_.setInvalid();
+        Cpl::System::Api::sleep( SETTLE_MSEC_ );
+        REQUIRE( consumer.m_sensorCount == 4 );
+        REQUIRE( consumer.m_lastValid == false );
+        mp_sensor_.write( 12.75F );
+        Cpl::System::Api::sleep( SETTLE_MSEC_ );
+        REQUIRE( consumer.m_sensorCount == 5 );
+        REQUIRE( consumer.m_lastValid == true );
+
+        // Deadband does not apply to non-numeric model points
+        mp_label_.write( "bob" );
+        Cpl::System::Api::sleep( SETTLE_MSEC_ );
+        REQUIRE( consumer.m_labelCount == 2 );
+
+        consumer.close();
+    }
+
+    SECTION( "relative deadband" )
+    {
+        mp_sensor_.write( 100.0F );
+        Consumer consumer( mbox, 0, 0.1, true );
+        consumer.open();
+        Cpl::System::Api::sleep( SETTLE_MSEC_ );
+        REQUIRE( consumer.m_sensorCount == 1 );
+
+        mp_sensor_.write( 109.0F );
+        mp_sensor_.write( 91.0F );
+        Cpl::System::Api::sleep( SETTLE_MSEC_ );
+        REQUIRE( consumer.m_sensorCount == 1 );
+
+        mp_sensor_.write( 111.0F );
+        Cpl::System::Api::sleep( SETTLE_MSEC_ );
+        REQUIRE( consumer.m_sensorCount == 2 );
+        REQUIRE( consumer.m_lastValue == 111.0F );
+
+        consumer.close();
+    }
+
+    SECTION( "minimum interval" )
+    {
+        Consumer consumer( mbox, 200, 0, false );
+        consumer.open();
+        Cpl::System::Api::sleep( SETTLE_MSEC_ );
+        REQUIRE( consumer.m_sensorCount == 1 );
+
+        // Changes within the interval are coalesced into a single (deferred) notification
+        float value = 20.0F;
+        for ( unsigned i=0; i < 50; i++ )
+        {
+            mp_sensor_.write( value );
+            value += 1.0F;
+            Cpl::System::Api::sleep( 1 );
+        }
+        REQUIRE( consumer.m_sensorCount <= 2 );
+        Cpl::System::Api::sleep( 250 );
+        REQUIRE( consumer.m_sensorCount >= 2 );
+        REQUIRE( consumer.m_sensorCount <= 3 );
+        REQUIRE( consumer.m_lastValue == value - 1.0F );
+
+        // No change -->no notification
+        unsigned count = consumer.m_sensorCount;
+        Cpl::System::Api::sleep( 250 );
+        REQUIRE( consumer.m_sensorCount == count );
+
+        // A change after the interval has expired is not delayed
+        mp_sensor_.write( 1.0F );
+        Cpl::System::Api::sleep( SETTLE_MSEC_ );
+        REQUIRE( consumer.m_sensorCount == count + 1 );
+        REQUIRE( consumer.m_lastValue == 1.0F );
+
+        // Cancel the subscription with a deferred notification
+        mp_sensor_.write( 2.0F );
+        consumer.close();
+        Cpl::System::Api::sleep( 250 );
+        REQUIRE( consumer.m_sensorCount == count + 1 );
+    }
+
+    mbox.pleaseStop();
+    Cpl::System::Api::sleep( 100 );
+    REQUIRE( t1->isRunning() == false );
+    Cpl::System::Thread::destroy( *t1 );
+    REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 0u );
+}
@@ -0,0 +1,250 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+
+#include "Catch/catch.hpp"
+#include "Cpl/System/_testsupport/Shutdown_TS.h"
+#include "Cpl/System/Trace.h"
+#include "Cpl/Text/FString.h"
+#include "Cpl/Dm/ModelDatabase.h"
+#include "Cpl/Dm/IndexedModelDatabase.h"
+#include "Cpl/Dm/Mp/Uint32.h"
+#include "Cpl/Dm/Mp/String.h"
+#include "Cpl/Dm/Mp/Array.h"
+#include <chrono>
+#include <string.h>
+#include <stdio.h>
+
+///
+using namespace Cpl::Dm;
+
+#define SECT_           "_0test"
+
+#define MAX_IMAGE_SIZE_ 512
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_CASE( "snapshot" )
+{
+    Cpl::System::Shutdown_TS::clearAndUseCounter();
+    uint8_t  image[MAX_IMAGE_SIZE_];
+    unsigned numRestored;
+
+    ModelDatabase       srcDb;
+    Mp::Uint32          srcApple( srcDb, "APPLE", 127 );
+    Mp::Uint32          srcOrange( srcDb, "ORANGE" );
+    Mp::String<16>      srcText( srcDb, "TEXT", "hello" );
+    Mp::ArrayUint8<4>   srcArray( srcDb, "ARRAY" );
+    uint8_t             arrayVal[4] ={ 1, 2, 3, 4 };
+    srcArray.write( arrayVal, 4 );
+    srcOrange.applyLock();
+
+    SECTION( "snapshot" )
+    {
+        size_t size = srcDb.getSnapshotSize();
+        REQUIRE( size > sizeof( ModelDatabase::SnapshotHeader_T ) );
+        REQUIRE( size <= sizeof( image ) );
+        REQUIRE( srcDb.snapshot( image, size - 1 ) == 0 );
+        REQUIRE( srcDb.snapshot( image, sizeof( image ) ) == size );
+
+        ModelDatabase::SnapshotHeader_T header;
+        memcpy( &header, image, sizeof( header ) );
+        REQUIRE( header.magic == ModelDatabase::SNAPSHOT_MAGIC );
+        REQUIRE( header.version == ModelDatabase::SNAPSHOT_VERSION );
+        REQUIRE( header.numPoints == 4 );
+        REQUIRE( header.totalLength == size );
+        CPL_SYSTEM_TRACE_MSG( SECT_, ( "snapshot size=%u", (unsigned) size ) );
+
+        // Records are in name order
+        uint16_t nameLen;
+        memcpy( &nameLen, image + sizeof( header ), sizeof( nameLen ) );
+        REQUIRE( nameLen == 6 );  // "APPLE" + null terminator
+        REQUIRE( strcmp( (const char*) ( image + sizeof( header ) + sizeof( nameLen ) ), "APPLE" ) == 0 );
+    }
+
+    SECTION( "restore" )
+    {
+        size_t size = srcDb.snapshot( image, sizeof( image ) );
+        REQUIRE( size > 0 );
+
+        ModelDatabase       dstDb;
+        Mp::Uint32          dstApple( dstDb, "APPLE", 127 );    // Same value -->no change notification
+        Mp::Uint32          dstOrange( dstDb, "ORANGE", 1 );
+        Mp::String<16>      dstText( dstDb, "TEXT" );
+        Mp::ArrayUint8<4>   dstArray( dstDb, "ARRAY" );
+        Mp::Uint32          dstExtra( dstDb, "EXTRA", 42 );     // Not in the image
+        uint16_t            appleSeqNum = dstApple.getSequenceNumber();
+        uint16_t            orangeSeqNum = dstOrange.getSequenceNumber();
+        uint16_t            extraSeqNum = dstExtra.getSequenceNumber();
+
+        REQUIRE( dstDb.restore( image, size, &numRestored ) );
+        REQUIRE( numRestored == 4 );
+
+        uint32_t value;
+        REQUIRE( dstApple.read( value ) );
+        REQUIRE( value == 127 );
+        REQUIRE( dstApple.getSequenceNumber() == appleSeqNum );
+        REQUIRE( dstOrange.isNotValid() );
+        REQUIRE( dstOrange.isLocked() );
+        REQUIRE( dstOrange.getSequenceNumber() == (uint16_t) ( orangeSeqNum + 1 ) );
+        Cpl::Text::FString<16> text;
+        REQUIRE( dstText.read( text ) );
+        REQUIRE( text == "hello" );
+        uint8_t arrayDst[4];
+        REQUIRE( dstArray.read( arrayDst, 4 ) );
+        REQUIRE( memcmp( arrayDst, arrayVal, 4 ) == 0 );
+        REQUIRE( dstExtra.read( value ) );
+        REQUIRE( value == 42 );
+        REQUIRE( dstExtra.getSequenceNumber() == extraSeqNum );
+
+        // Restoring the same image is a no-op
+        uint16_t textSeqNum = dstText.getSequenceNumber();
+        REQUIRE( dstDb.restore( image, size ) );
+        REQUIRE( dstText.getSequenceNumber() == textSeqNum );
+        REQUIRE( dstOrange.getSequenceNumber() == (uint16_t) ( orangeSeqNum + 1 ) );
+
+        // Restore the sequence numbers
+        dstApple.write( 1 );
+        REQUIRE( dstDb.restore( image, size, &numRestored, true ) );
+        REQUIRE( dstText.getSequenceNumber() == srcText.getSequenceNumber() );
+        REQUIRE( dstOrange.getSequenceNumber() == srcOrange.getSequenceNumber() );
+        REQUIRE( dstApple.getSequenceNumber() == (uint16_t) ( srcApple.getSequenceNumber() + 1 ) );
+    }
+
+    SECTION( "restore - indexed database" )
+    {
+        size_t size = srcDb.snapshot( image, sizeof( image ) );
+        REQUIRE( size > 0 );
+
+        Cpl::Container::DList<Cpl::Container::DictItem> buckets[11];
+        IndexedModelDatabase::IndexEntry                entries[5];
+        ModelPoint*                                     sortedMemory[5] ={ 0 };
+        IndexedModelDatabase                            dstDb( buckets, 11, entries, sortedMemory, 5 );
+        Mp::Uint32           dstOrange( dstDb, "ORANGE", 1 );
+        Mp::Uint32           dstApple( dstDb, "APPLE" );
+        REQUIRE( dstDb.restore( image, size, &numRestored ) );
+        REQUIRE( numRestored == 2 );
+        uint32_t value;
+        REQUIRE( dstApple.read( value ) );
+        REQUIRE( value == 127 );
+        REQUIRE( dstOrange.isNotValid() );
+    }
+
+    SECTION( "errors" )
+    {
+        size_t size = srcDb.snapshot( image, sizeof( image ) );
+        REQUIRE( size > 0 );
+
+        ModelDatabase       dstDb;
+        Mp::Uint32          dstApple( dstDb, "APPLE", 1 );
+        Mp::String<8>       dstText( dstDb, "TEXT" );   // Different size
+        uint16_t            appleSeqNum = dstApple.getSequenceNumber();
+
+        // Size mismatch -->nothing is restored
+        REQUIRE( dstDb.restore( image, size, &numRestored ) == false );
+        uint32_t value;
+        REQUIRE( dstApple.read( value ) );
+        REQUIRE( value == 1 );
+        REQUIRE( dstApple.getSequenceNumber() == appleSeqNum );
+
+        // Same size, different array layout -->nothing is restored
+        ModelDatabase       dstDb2;
+        Mp::Uint32          dstApple2( dstDb2, "APPLE", 1 );
+        Mp::ArrayUint32<1>  dstArray2( dstDb2, "ARRAY" );
+        uint16_t            apple2SeqNum = dstApple2.getSequenceNumber();
+        REQUIRE( dstArray2.getExternalSize( true ) == srcArray.getExternalSize( true ) );
+        REQUIRE( dstDb2.restore( image, size, &numRestored ) == false );
+        REQUIRE( dstApple2.read( value ) );
+        REQUIRE( value == 1 );
+        REQUIRE( dstApple2.getSequenceNumber() == apple2SeqNum );
+        REQUIRE( dstArray2.isNotValid() );
+
+        // Bad images
+        REQUIRE( srcDb.restore( 0, size ) == false );
+        REQUIRE( srcDb.restore( image, sizeof( ModelDatabase::SnapshotHeader_T ) - 1 ) == false );
+        REQUIRE( srcDb.restore( image, size - 1 ) == false );
+        image[0] ^= 0xFF;
+        REQUIRE( srcDb.restore( image, size ) == false );
+        image[0] ^= 0xFF;
+        uint32_t badNumPoints = 5;
+        memcpy( image + 8, &badNumPoints, sizeof( badNumPoints ) );
+        REQUIRE( srcDb.restore( image, size ) == false );
+        badNumPoints = 4;
+        memcpy( image + 8, &badNumPoints, sizeof( badNumPoints ) );
+        REQUIRE( srcDb.restore( image, size ) );
+    }
+
+    REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 0u );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+#define BENCH_NUM_POINTS_   10000
+#define BENCH_NUM_PASSES_   20
+
+TEST_CASE( "snapshot-benchmark", "[.bench]" )
+{
+    ModelDatabase   srcDb;
+    ModelDatabase   dstDb;
+    Mp::Uint32**    srcPoints = new Mp::Uint32*[BENCH_NUM_POINTS_];
+    Mp::Uint32**    dstPoints = new Mp::Uint32*[BENCH_NUM_POINTS_];
+    char          (*names)[16] = new char[BENCH_NUM_POINTS_][16];
+    for ( unsigned i=0; i < BENCH_NUM_POINTS_; i++ )
+    {
+        snprintf( names[i], sizeof( names[i] ), "mp%05u", i );
+        srcPoints[i] = new Mp::Uint32( srcDb, names[i], i );
+        dstPoints[i] = new Mp::Uint32( dstDb, names[i] );
+    }
+
+    // Per-point export/import (each MP takes the database lock and generates a change notification)
+    size_t   size  = srcDb.getSnapshotSize();
+    uint8_t* image = new uint8_t[size];
+    auto start = std::chrono::steady_clock::now();
+    for ( unsigned p=0; p < BENCH_NUM_PASSES_; p++ )
+    {
+        size_t      offset = 0;
+        ModelPoint* src    = srcDb.getFirstByName();
+        while ( src )
+        {
+            offset += src->exportData( image + offset, size - offset, 0, true );
+            src     = srcDb.getNextByName( *src );
+        }
+        offset          = 0;
+        ModelPoint* dst = dstDb.getFirstByName();
+        while ( dst )
+        {
+            offset += dst->importData( image + offset, size - offset, 0, true );
+            dst     = dstDb.getNextByName( *dst );
+        }
+    }
+    auto perPoint = std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - start ).count();
+
+    // Snapshot/restore
+    unsigned numRestored = 0;
+    start = std::chrono::steady_clock::now();
+    for ( unsigned p=0; p < BENCH_NUM_PASSES_; p++ )
+    {
+        REQUIRE( srcDb.snapshot( image, size ) == size );
+        REQUIRE( dstDb.restore( image, size, &numRestored ) );
+    }
+    auto bulk = std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - start ).count();
+    REQUIRE( numRestored == BENCH_NUM_POINTS_ );
+
+    CPL_SYSTEM_TRACE_MSG( SECT_, ( "%u points x %u passes (image=%u bytes): per-point export/import=%lu ms, snapshot/restore=%lu ms",
+                                   BENCH_NUM_POINTS_, BENCH_NUM_PASSES_, (unsigned) size, (unsigned long) perPoint, (unsigned long) bulk ) );
+
+    delete[] image;
+    for ( unsigned i=0; i < BENCH_NUM_POINTS_; i++ )
+    {
+        delete srcPoints[i];
+        delete dstPoints[i];
+    }
+    delete[] srcPoints;
+    delete[] dstPoints;
+    delete[] names;
+}
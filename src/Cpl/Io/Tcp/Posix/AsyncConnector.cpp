@@ -0,0 +1,254 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+
+#include "AsyncConnector.h"
+#include "Cpl/Text/FString.h"
+#include "Cpl/System/Trace.h"
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <netdb.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+
+using namespace Cpl::Io::Tcp::Posix;
+
+#define SECT_ "Cpl::Io::Tcp::Posix"
+
+#define STATE_IDLE                  0
+#define STATE_CONNECTED             1
+#define STATE_PENDING_CONNECTION    2
+
+
+
+/////////////////////////////////
+AsyncConnector::AsyncConnector()
+    : m_fd( -1 )
+    , m_clientPtr( nullptr )
+    , m_addrListPtr( nullptr )
+    , m_remoteAddrPtr( nullptr )
+    , m_state( STATE_IDLE )
+    , m_connectCalled( false )
+    , m_clientConnected( false )
+{
+}
+
+AsyncConnector::~AsyncConnector()
+{
+    terminate();
+}
+
+void AsyncConnector::notifyConnected()
+{
+    CPL_SYSTEM_TRACE_MSG( SECT_, ("Cpl::Io::Tcp::Posix::AsyncConnector: - Connected") );
+    freeAddresses();
+    Cpl::Io::Descriptor newfd( m_fd );
+    if ( m_clientPtr->newConnection( newfd ) )
+    {
+        m_clientConnected = true;
+        m_state           = STATE_CONNECTED;
+    }
+
+    // Connection refused
+    else
+    {
+        terminate();   // Note: Updates my internal state to: STATE_IDLE
+    }
+}
+
+void AsyncConnector::notifyError( Client::Error_T error, int errNum )
+{
+    CPL_SYSTEM_TRACE_MSG( SECT_, ("Cpl::Io::Tcp::Posix::AsyncConnector: - Connection failed: %d (errno=%d).", error, errNum) );
+    Client* clientPtr = m_clientPtr;
+    terminate();                // Note: Updates my internal state to: STATE_IDLE
+    clientPtr->connectionFailed( error );
+}
+
+void AsyncConnector::freeAddresses()
+{
+    if ( m_addrListPtr )
+    {
+        freeaddrinfo( m_addrListPtr );
+        m_addrListPtr   = nullptr;
+        m_remoteAddrPtr = nullptr;
+    }
+}
+
+///////////////////////////////////////////////////
+bool AsyncConnector::establish( Client&     client,
+                                const char* remoteHostName,
+                                int         portNumToConnectTo )
+{
+    // The previous connection has been closed -->allow a new connection
+    if ( m_state == STATE_CONNECTED && m_clientPtr->isEos() )
+    {
+        terminate();
+    }
+
+    // Ignore if connected or connection in progress
+    if ( m_state == STATE_IDLE )
+    {
+        // Cache the client reference
+        m_clientPtr       = &client;
+        m_clientConnected = false;
+
+        // Resolve the server address and port
+        struct addrinfo hints;
+        Cpl::Text::FString<5> port( portNumToConnectTo );
+        memset( &hints, 0, sizeof( hints ) );
+        hints.ai_family   = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_protocol = IPPROTO_TCP;
+        int err = getaddrinfo( remoteHostName, port, &hints, &m_addrListPtr );
+        if ( err != 0 )
+        {
+            m_addrListPtr = nullptr;
+            notifyError( Client::eERROR, err );                 // Note: Sets my state to IDLE after cleaning-up
+            return false;
+        }
+
+        // Begin the connection request
+        m_remoteAddrPtr = m_addrListPtr;
+        m_connectCalled = false;
+        m_state         = STATE_PENDING_CONNECTION;
+        poll();
+        return true;
+    }
+
+    // If I get here I am not in the state to state a new connection or an error occurred
+    return false;
+}
+
+
+void AsyncConnector::poll() noexcept
+{
+    // Waiting for connection request to succeed
+    if ( m_state == STATE_PENDING_CONNECTION )
+    {
+        // Make the initial call to connect()
+        if ( !m_connectCalled )
+        {
+            m_connectCalled = true;
+
+            // Create a non-blocking socket for connecting to server
+            m_fd = socket( m_remoteAddrPtr->ai_family, m_remoteAddrPtr->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, m_remoteAddrPtr->ai_protocol );
+            if ( m_fd < 0 )
+            {
+                notifyError( Client::eERROR, errno );       // Note: Sets my state to IDLE after cleaning-up
+                return;
+            }
+
+            // Start the connection request 
+            int err = connect( m_fd, m_remoteAddrPtr->ai_addr, m_remoteAddrPtr->ai_addrlen );
+            if ( !err )
+            {
+                notifyConnected();  // Note: Updates my internal state to: STATE_CONNECTED
+            }
+
+            // This is the expect path for connecting with a non-blocking socket for the call to connect
+            else if ( errno == EINPROGRESS )
+            {
+                // Nothing required -->use poll() later to poll the state of the request
+                CPL_SYSTEM_TRACE_MSG( SECT_, ("Cpl::Io::Tcp::Posix::AsyncConnector.connect(): - waiting on request") );
+            }
+
+            // Try the next possible address for the remote host
+            else
+            {
+                nextAddress( errno );   // Note: If there is no 'next' address -->will clean up and set the state to: STATE_IDLE
+            }
+        }
+
+        // Use poll() to monitor the state of the connection request
+        else
+        {
+            struct pollfd fds;
+            fds.fd     = m_fd;
+            fds.events = POLLOUT;
+            int nfds   = ::poll( &fds, 1, 0 );
+            if ( nfds < 0 )
+            {
+                CPL_SYSTEM_TRACE_MSG( SECT_, ("Cpl::Io::Tcp::Posix::AsyncConnector: - poll failed: errno=%d.", errno) );
+                nextAddress( errno );   // Note: If there is no 'next' address -->will clean up and set the state to: STATE_IDLE
+            }
+            else if ( nfds == 1 )
+            {
+                // Get the result of the connection request
+                int       sockErr = 0;
+                socklen_t len     = sizeof( sockErr );
+                if ( getsockopt( m_fd, SOL_SOCKET, SO_ERROR, &sockErr, &len ) < 0 )
+                {
+                    sockErr = errno;
+                }
+                if ( sockErr == 0 )
+                {
+                    notifyConnected();  // Note: Updates my internal state to: STATE_CONNECTED
+                }
+                else
+                {
+                    nextAddress( sockErr );
+                }
+            }
+        }
+    }
+
+    // Monitor the connection (so a new connection can be established once the connection is closed)
+    else if ( m_state == STATE_CONNECTED && m_clientPtr->isEos() )
+    {
+        terminate();
+    }
+}
+
+void AsyncConnector::nextAddress( int errNum )
+{
+    // Clean-up
+    ::close( m_fd );
+    m_fd = -1;
+
+    // Try the 'next' remote address if there is one
+    m_remoteAddrPtr = m_remoteAddrPtr->ai_next;
+    if ( m_remoteAddrPtr != 0 )
+    {
+        m_connectCalled = false;
+    }
+
+    // No more addresses -->fail the request
+    else
+    {
+        notifyError( Client::eREFUSED, errNum );   // Note: Sets my state to IDLE after cleaning-up
+    }
+}
+
+void AsyncConnector::terminate() noexcept
+{
+    if ( m_fd >= 0 )
+    {
+        // If I am connected -->use the client reference to close the socket
+        if ( m_clientConnected && m_clientPtr )
+        {
+            m_clientPtr->close();
+        }
+
+        // Connection in-progress -->close the socket directly
+        else
+        {
+            ::close( m_fd );
+        }
+        m_fd = -1;
+    }
+
+    freeAddresses();
+    m_state           = STATE_IDLE;
+    m_clientPtr       = nullptr;
+    m_clientConnected = false;
+}
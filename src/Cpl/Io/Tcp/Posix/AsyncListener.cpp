@@ -0,0 +1,396 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+
+#include "AsyncListener.h"
+#include "Cpl/System/FatalError.h"
+#include "Cpl/System/Trace.h"
+#include "Cpl/System/ElapsedTime.h"
+#include "Cpl/System/Api.h"
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <arpa/inet.h>
+
+#define SECT_ "Cpl::Io::Tcp::Posix"
+
+using namespace Cpl::Io::Tcp::Posix;
+
+#define STATE_NOT_STARTED       0
+#define STATE_BINDING           1
+#define STATE_RETRING_BINDING   2
+#define STATE_LISTENING         3
+
+
+///////////////////////////////////////////////////
+AsyncListener::AsyncListener( bool acceptMultipleConnections )
+    : m_fd( -1 )
+    , m_epollFd( -1 )
+    , m_stopFd( -1 )
+    , m_clientPtr( nullptr )
+    , m_wakeupPtr( nullptr )
+    , m_wakeupThreadPtr( nullptr )
+    , m_timeMarker( 0 )
+    , m_portNum( 0 )
+    , m_state( STATE_NOT_STARTED )
+    , m_retryCounter( 0 )
+    , m_clientConnected( false )
+    , m_multipleConnections( acceptMultipleConnections )
+{
+}
+
+AsyncListener::~AsyncListener()
+{
+    terminate();
+}
+
+///////////////////////////////////////////////////
+bool AsyncListener::startListening( Client& client,
+                                    int     portNumToListenOn ) noexcept
+{
+    // Once started, must first be terminate() before restarting
+    if ( m_state == STATE_NOT_STARTED )
+    {
+        m_portNum   = portNumToListenOn;
+        m_clientPtr = &client;
+
+        // Create the Socket to listen on
+        m_fd = socket( AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0 );
+        if ( m_fd < 0 )
+        {
+            CPL_SYSTEM_TRACE_MSG( SECT_, ("Cpl::Io::Tcp::Posix::AsyncListener: Can not create Stream Socket") );
+            return false;
+        }
+        int one = 1;
+        if ( setsockopt( m_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof( one ) ) )
+        {
+            CPL_SYSTEM_TRACE_MSG( SECT_, ("Cpl::Io::Tcp::Posix::AsyncListener: Failed setsockopt SO_REUSEADDR") );
+        }
+
+        // Create the epoll instance
+        m_epollFd = epoll_create1( EPOLL_CLOEXEC );
+        m_stopFd  = eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+        if ( m_epollFd < 0 || m_stopFd < 0 )
+        {
+            CPL_SYSTEM_TRACE_MSG( SECT_, ("Cpl::Io::Tcp::Posix::AsyncListener: Can not create the epoll instance") );
+            terminate();
+            return false;
+        }
+
+        // Start the listening sequence
+        m_state           = STATE_BINDING;
+        m_clientConnected = false;
+        m_retryCounter    = OPTION_CPL_IO_TCP_POSIX_BIND_RETRIES;
+        poll();
+        return true;
+    }
+
+    return false;
+}
+
+bool AsyncListener::bindAndListen() noexcept
+{
+    struct sockaddr_in local;
+
+    // Set the "address" of the socket
+    memset( &local, 0, sizeof( local ) );
+    local.sin_family      = AF_INET;
+    local.sin_addr.s_addr = htonl( INADDR_ANY );
+    local.sin_port        = htons( m_portNum );
+    if ( bind( m_fd, (struct sockaddr *) &local, sizeof( local ) ) < 0 )
+    {
+        return false;
+    }
+
+    // Create a queue to hold connection requests
+    if ( ::listen( m_fd, OPTION_CPL_IO_TCP_POSIX_LISTEN_BACKLOG ) < 0 )
+    {
+        Cpl::System::FatalError::logf( "Cpl::Io::Tcp::Posix::AsyncListener: listen() failed" );
+        return false;
+    }
+
+    // Monitor the listening socket (Note: a null pointer identifies the listening socket)
+    struct epoll_event ev;
+    ev.events   = EPOLLIN;
+    ev.data.ptr = nullptr;
+    if ( epoll_ctl( m_epollFd, EPOLL_CTL_ADD, m_fd, &ev ) < 0 )
+    {
+        Cpl::System::FatalError::logf( "Cpl::Io::Tcp::Posix::AsyncListener: epoll_ctl() failed" );
+        return false;
+    }
+    return true;
+}
+
+void AsyncListener::poll() noexcept
+{
+    if ( m_state == STATE_RETRING_BINDING )
+    {
+        // The delay has expired
+        if ( Cpl::System::ElapsedTime::expiredMilliseconds( m_timeMarker, OPTION_CPL_IO_TCP_POSIX_BIND_RETRY_WAIT ) )
+        {
+            m_state = STATE_BINDING;
+        }
+    }
+
+    if ( m_state == STATE_BINDING )
+    {
+        if ( bindAndListen() )
+        {
+            m_state = STATE_LISTENING;
+        }
+
+        // The bind failed -->start retrying
+        else
+        {
+            // Fatal error when retry count is exhausted
+            if ( m_retryCounter-- == 0 )
+            {
+                Cpl::System::FatalError::logf( "Cpl::Io::Tcp::Posix::AsyncListener: Bind error - exceed retry count -->giving up" );
+                return;
+            }
+
+            CPL_SYSTEM_TRACE_MSG( SECT_, ("Cpl::Io::Tcp::Posix::AsyncListener:: Listening on Port=%d. Bind error - retrying...", m_portNum) );
+            m_timeMarker = Cpl::System::ElapsedTime::milliseconds();
+            m_state      = STATE_RETRING_BINDING;
+        }
+    }
+
+    if ( m_state == STATE_LISTENING )
+    {
+        // Monitor the current remote connection (single connection mode)
+        if ( m_clientConnected && m_clientPtr->isEos() )
+        {
+            // Accept connections again
+            m_clientPtr->close();
+            m_clientConnected = false;
+            CPL_SYSTEM_TRACE_MSG( SECT_, ("Cpl::Io::Tcp::Posix::AsyncListener:: Stream EOS, accepting new connection ...") );
+        }
+
+        // Process ALL ready events (without blocking)
+        struct epoll_event events[OPTION_CPL_IO_TCP_POSIX_MAX_EVENTS];
+        int                numEvents;
+        do
+        {
+            numEvents = epoll_wait( m_epollFd, events, OPTION_CPL_IO_TCP_POSIX_MAX_EVENTS, 0 );
+            for ( int i=0; i < numEvents; i++ )
+            {
+                if ( events[i].data.ptr == nullptr )
+                {
+                    acceptConnections();
+                }
+                else
+                {
+                    ((ReadableHandler*) events[i].data.ptr)->readable();
+                }
+            }
+        } while ( numEvents == OPTION_CPL_IO_TCP_POSIX_MAX_EVENTS );
+
+        // Allow the event loop to be woken up again
+        if ( m_wakeupPtr )
+        {
+            m_wakeupPtr->rearm();
+        }
+    }
+}
+
+void AsyncListener::acceptConnections() noexcept
+{
+    for ( ;;)
+    {
+        struct sockaddr_in client_addr;
+        socklen_t          client_len = sizeof( client_addr );
+        int                newfd      = accept4( m_fd, (struct sockaddr *) &client_addr, &client_len, SOCK_NONBLOCK | SOCK_CLOEXEC );
+        if ( newfd < 0 )
+        {
+            // Typically the error is because there are no more incoming
+            // connections (EAGAIN), so we will try again later.  If it something
+            // else - we will still try again later in-case it is something that
+            // is 'recoverable'
+            return;
+        }
+
+        // Enable SO_KEEPALIVE so we know when the client terminated the TCP session
+        int bOptVal = 1;
+        if ( setsockopt( newfd, SOL_SOCKET, SO_KEEPALIVE, (char*) &bOptVal, sizeof( bOptVal ) ) < 0 )
+        {
+            CPL_SYSTEM_TRACE_MSG( SECT_, ("Cpl::Io::Tcp::Posix::AsyncListener:: Failed enable SO_KEEPALIVE. errno=%d.", errno) );
+        }
+
+        // Create a Descriptor for the accepted connection and pass it to the client
+        Cpl::Io::Descriptor streamFd( newfd );
+        if ( (!m_multipleConnections && m_clientConnected) || !m_clientPtr->newConnection( streamFd, inet_ntoa( client_addr.sin_addr ) ) )
+        {
+            ::close( newfd );           // Connection refused
+        }
+        else if ( !m_multipleConnections )
+        {
+            m_clientConnected = true;   // Connection accepted
+        }
+    }
+}
+
+void AsyncListener::terminate() noexcept
+{
+    stopWakeup();
+    if ( m_fd >= 0 )
+    {
+        ::close( m_fd );
+        m_fd = -1;
+    }
+    if ( m_epollFd >= 0 )
+    {
+        ::close( m_epollFd );
+        m_epollFd = -1;
+    }
+    if ( m_stopFd >= 0 )
+    {
+        ::close( m_stopFd );
+        m_stopFd = -1;
+    }
+    if ( m_clientConnected )
+    {
+        if ( m_clientPtr )
+        {
+            m_clientPtr->close();
+        }
+        m_clientConnected = false;
+    }
+    m_state     = STATE_NOT_STARTED;
+    m_clientPtr = nullptr;
+}
+
+///////////////////////////////////////////////////
+bool AsyncListener::monitor( Cpl::Io::Tcp::InputOutput& stream, ReadableHandler& handler ) noexcept
+{
+    int fd = stream.getDescriptor().m_fd;
+    if ( m_epollFd < 0 || fd < 0 )
+    {
+        return false;
+    }
+
+    struct epoll_event ev;
+    ev.events   = EPOLLIN | EPOLLRDHUP;
+    ev.data.ptr = &handler;
+    if ( epoll_ctl( m_epollFd, EPOLL_CTL_ADD, fd, &ev ) < 0 )
+    {
+        if ( errno != EEXIST || epoll_ctl( m_epollFd, EPOLL_CTL_MOD, fd, &ev ) < 0 )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void AsyncListener::unmonitor( Cpl::Io::Tcp::InputOutput& stream ) noexcept
+{
+    int fd = stream.getDescriptor().m_fd;
+    if ( m_epollFd >= 0 && fd >= 0 )
+    {
+        epoll_ctl( m_epollFd, EPOLL_CTL_DEL, fd, nullptr );
+    }
+}
+
+bool AsyncListener::enableEventLoopWakeup( Cpl::System::EventLoop& eventLoop, uint8_t eventNumber ) noexcept
+{
+    if ( m_epollFd < 0 || m_wakeupPtr )
+    {
+        return false;
+    }
+
+    m_wakeupPtr       = new Wakeup_( m_epollFd, m_stopFd, eventLoop, eventNumber );
+    m_wakeupThreadPtr = Cpl::System::Thread::create( *m_wakeupPtr, "TcpWakeup" );
+    if ( m_wakeupThreadPtr == nullptr )
+    {
+        delete m_wakeupPtr;
+        m_wakeupPtr = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void AsyncListener::stopWakeup() noexcept
+{
+    if ( m_wakeupPtr )
+    {
+        m_wakeupPtr->pleaseStop();
+        while ( !m_wakeupPtr->m_done || m_wakeupThreadPtr->isRunning() )
+        {
+            Cpl::System::Api::sleep( 1 );
+        }
+        Cpl::System::Thread::destroy( *m_wakeupThreadPtr );
+        delete m_wakeupPtr;
+        m_wakeupPtr       = nullptr;
+        m_wakeupThreadPtr = nullptr;
+    }
+}
+
+
+///////////////////////////////////////////////////
+AsyncListener::Wakeup_::Wakeup_( int epollFd, int stopFd, Cpl::System::EventLoop& eventLoop, uint8_t eventNumber )
+    : m_done( false )
+    , m_eventLoop( eventLoop )
+    , m_epollFd( epollFd )
+    , m_stopFd( stopFd )
+    , m_eventNumber( eventNumber )
+    , m_pending( false )
+    , m_stop( false )
+{
+}
+
+void AsyncListener::Wakeup_::rearm() noexcept
+{
+    if ( m_pending.exchange( false ) )
+    {
+        m_rearm.signal();
+    }
+}
+
+void AsyncListener::Wakeup_::pleaseStop()
+{
+    m_stop = true;
+    uint64_t one = 1;
+    if ( ::write( m_stopFd, &one, sizeof( one ) ) < 0 )
+    {
+        CPL_SYSTEM_TRACE_MSG( SECT_, ("Cpl::Io::Tcp::Posix::AsyncListener::Wakeup_: Failed to write the stop descriptor. errno=%d", errno) );
+    }
+    m_rearm.signal();
+}
+
+void AsyncListener::Wakeup_::appRun()
+{
+    while ( !m_stop )
+    {
+        // Note: An epoll descriptor is 'readable' when it has ready events
+        struct pollfd fds[2];
+        fds[0].fd     = m_epollFd;
+        fds[0].events = POLLIN;
+        fds[1].fd     = m_stopFd;
+        fds[1].events = POLLIN;
+        int result = ::poll( fds, 2, -1 );
+        if ( m_stop )
+        {
+            break;
+        }
+
+        // Wake up the event loop and wait for poll() to process the events
+        if ( result > 0 && (fds[0].revents & POLLIN) )
+        {
+            m_pending = true;
+            m_eventLoop.notify( m_eventNumber );
+            m_rearm.wait();
+        }
+    }
+    m_done = true;
+}
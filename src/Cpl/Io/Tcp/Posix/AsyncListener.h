@@ -0,0 +1,253 @@
+#ifndef Cpl_Io_Tcp_Posix_AsyncListener_h_
+#define Cpl_Io_Tcp_Posix_AsyncListener_h_
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+/** @file */
+
+#include "colony_config.h"
+#include "Cpl/Io/Tcp/AsyncListener.h"
+#include "Cpl/System/EventLoop.h"
+#include "Cpl/System/Semaphore.h"
+#include "Cpl/System/Thread.h"
+#include <atomic>
+
+
+/** Maximum number of epoll events that are processed per call to epoll_wait()
+    (poll() repeats the call until there are no more ready events)
+ */
+#ifndef OPTION_CPL_IO_TCP_POSIX_MAX_EVENTS
+#define OPTION_CPL_IO_TCP_POSIX_MAX_EVENTS          64
+#endif
+
+/** Size of the listen() backlog
+ */
+#ifndef OPTION_CPL_IO_TCP_POSIX_LISTEN_BACKLOG
+#define OPTION_CPL_IO_TCP_POSIX_LISTEN_BACKLOG      SOMAXCONN
+#endif
+
+/** This value is number of retries that is performed when attempting
+    to bind to the listening port.
+ */
+#ifndef OPTION_CPL_IO_TCP_POSIX_BIND_RETRIES
+#define OPTION_CPL_IO_TCP_POSIX_BIND_RETRIES        5
+#endif
+
+/** This value is time, in milliseconds between retries during the binding
+    process.
+ */
+#ifndef OPTION_CPL_IO_TCP_POSIX_BIND_RETRY_WAIT
+#define OPTION_CPL_IO_TCP_POSIX_BIND_RETRY_WAIT     (10*1000)
+#endif
+
+///
+namespace Cpl {
+///
+namespace Io {
+///
+namespace Tcp {
+///
+namespace Posix {
+
+
+/** This class implements the Asynchronous Listener using non-blocking sockets
+    and epoll.
+
+    In addition to the AsyncListener semantics, the class can be constructed
+    to accept MULTIPLE connections, i.e. the Client's newConnection() method
+    is called for every incoming connection and the Client is responsible for
+    activating a (different) InputOutput stream per connection (or rejecting
+    the connection).  When in multiple-connections mode, the application can
+    register its streams with the listener's epoll set (see monitor()) so that
+    a single thread can service many connections: poll() only calls the
+    ReadableHandler of the streams that have pending input (or have been
+    closed by the remote host) instead of the application having to call
+    available() on every stream.
+
+    The listener can optionally wake up a Cpl::System::EventLoop when there is
+    epoll activity (see enableEventLoopWakeup()).  The application then calls
+    poll() from the event loop's processEventFlag() method.  This allows the
+    event loop to block (instead of periodically polling) while waiting for
+    socket activity.
+
+    The class is NOT thread safe, i.e. all methods (except for the wakeup
+    thread) must be called from the same thread.
+ */
+class AsyncListener : public Cpl::Io::Tcp::AsyncListener
+{
+public:
+    /** This class defines the callback interface for a monitored stream
+     */
+    class ReadableHandler
+    {
+    public:
+        /** This method is called (from poll()) when the monitored stream has
+            input available OR the remote host has closed the connection (i.e.
+            the next read() call will return an End-of-Stream).
+
+            Note: The handler is allowed to close its own stream.  However, it
+                  must NOT close and/or destroy OTHER monitored streams.
+         */
+        virtual void readable() noexcept = 0;
+
+    public:
+        /// Virtual destructor
+        virtual ~ReadableHandler() {}
+    };
+
+public:
+    /** Constructor.  When 'acceptMultipleConnections' is false, the listener
+        only accepts one connection at a time (i.e. the same semantics as the
+        other AsyncListener implementations).
+     */
+    AsyncListener( bool acceptMultipleConnections = false );
+
+    /// Destructor
+    ~AsyncListener();
+
+public:
+    /// Cpl::Io::Tcp::AsyncListener
+    bool startListening( Client& client,
+                         int     portNumToListenOn ) noexcept;
+
+    /// Cpl::Io::Tcp::AsyncListener
+    void terminate() noexcept;
+
+    /** This method must be called periodically (or when the event loop's
+        wakeup event flag is set) to service the listen/connection status
+        AND the monitored streams
+     */
+    void poll() noexcept;
+
+public:
+    /** Adds the stream to the listener's epoll set.  The handler's readable()
+        method is called from poll() when the stream has input available.
+        Closing the stream automatically removes it from the epoll set.
+        Returns false if the stream could not be added.
+
+        Note: The listener must be started before calling this method.
+     */
+    bool monitor( Cpl::Io::Tcp::InputOutput& stream, ReadableHandler& handler ) noexcept;
+
+    /** Removes the stream from the listener's epoll set.  Only required when
+        the application stops monitoring a stream WITHOUT closing it.
+     */
+    void unmonitor( Cpl::Io::Tcp::InputOutput& stream ) noexcept;
+
+    /** Enables waking up the specified event loop, i.e. the 'eventNumber'
+        event flag is set when there is socket activity that requires a call
+        to poll().  This method creates a (light weight) thread that blocks
+        on the epoll descriptor.  The wakeup is 're-armed' every time poll()
+        is called.
+
+        Note: The listener must be started before calling this method. The
+              wakeup thread is stopped when terminate() is called.
+     */
+    bool enableEventLoopWakeup( Cpl::System::EventLoop& eventLoop, uint8_t eventNumber ) noexcept;
+
+protected:
+    /// Helper method. Attempts to bind and listen.  Returns false if the bind failed
+    bool bindAndListen() noexcept;
+
+    /// Helper method. Accepts all pending incoming connections
+    void acceptConnections() noexcept;
+
+    /// Helper method. Stops the wakeup thread
+    void stopWakeup() noexcept;
+
+protected:
+    /// Thread that waits on the epoll descriptor and wakes up the event loop
+    class Wakeup_ : public Cpl::System::Runnable
+    {
+    public:
+        /// Constructor
+        Wakeup_( int epollFd, int stopFd, Cpl::System::EventLoop& eventLoop, uint8_t eventNumber );
+
+    public:
+        /// Called (from poll()) to re-arm the wakeup
+        void rearm() noexcept;
+
+        /// Requests the thread to exit
+        void pleaseStop();
+
+    protected:
+        /// See Cpl::System::Runnable
+        void appRun();
+
+    public:
+        /// Set when the thread exits
+        std::atomic<bool>           m_done;
+
+    protected:
+        /// Semaphore used to re-arm the wakeup
+        Cpl::System::Semaphore      m_rearm;
+
+        /// Event loop to wakeup
+        Cpl::System::EventLoop&     m_eventLoop;
+
+        /// epoll descriptor
+        int                         m_epollFd;
+
+        /// Descriptor used to un-block the thread
+        int                         m_stopFd;
+
+        /// Wakeup event flag
+        uint8_t                     m_eventNumber;
+
+        /// Set when the event loop has been notified (and poll() has not yet been called)
+        std::atomic<bool>           m_pending;
+
+        /// Set to request the thread to exit
+        std::atomic<bool>           m_stop;
+    };
+
+protected:
+    /// Socket I am listen on
+    int                     m_fd;
+
+    /// epoll instance
+    int                     m_epollFd;
+
+    /// Event descriptor used to stop the wakeup thread
+    int                     m_stopFd;
+
+    /// Client
+    Client*                 m_clientPtr;
+
+    /// Wakeup runnable (when enabled)
+    Wakeup_*                m_wakeupPtr;
+
+    /// Wakeup thread (when enabled)
+    Cpl::System::Thread*    m_wakeupThreadPtr;
+
+    /// Time marker
+    unsigned long           m_timeMarker;
+
+    /// Port Number to listen on
+    int                     m_portNum;
+
+    /// Listening state
+    int                     m_state;
+
+    /// Retry counter
+    unsigned                m_retryCounter;
+
+    /// Track if the client is connected (single connection mode)
+    bool                    m_clientConnected;
+
+    /// Connection mode
+    bool                    m_multipleConnections;
+};
+
+};      // end namespaces
+};
+};
+};
+#endif  // end header latch
@@ -0,0 +1,168 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+
+#include "Cpl/Io/Tcp/InputOutput.h"
+#include "Cpl/System/FatalError.h"
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+//
+// NOTE: The implementation ASSUMES that when the socket was created that
+//       is set to non-blocking mode, i.e. the AsyncListener/AsyncConnector
+//       set O_NONBLOCK on all sockets they create
+//
+
+
+///
+using namespace Cpl::Io::Tcp;
+
+
+/////////////////////
+InputOutput::InputOutput()
+    : m_fd( -1 )
+    , m_eos( false )
+{
+}
+
+InputOutput::InputOutput( Cpl::Io::Descriptor fd )
+    : m_fd( fd )
+    , m_eos( false )
+{
+}
+
+InputOutput::~InputOutput( void )
+{
+    close();
+}
+
+
+///////////////////
+void InputOutput::activate( Cpl::Io::Descriptor fd )
+{
+    // Only activate if already closed 
+    if ( m_fd.m_fd < 0 )
+    {
+        m_fd  = fd;
+        m_eos = false;
+    }
+    else
+    {
+        Cpl::System::FatalError::logf( "Cpl:Io::Tcp::InputOutput::activate().  Attempting to Activate an already opened stream." );
+    }
+}
+
+
+///////////////////
+bool InputOutput::read( void* buffer, int numBytes, int& bytesRead )
+{
+    // Throw an error if the socket had already been closed
+    if ( m_fd.m_fd < 0 )
+    {
+        return false;
+    }
+
+    // Ignore read requests of ZERO bytes
+    if ( numBytes == 0 )
+    {
+        bytesRead = 0;
+        return true;
+    }
+
+    // perform the read
+    bytesRead = recv( m_fd.m_fd, (char*) buffer, numBytes, 0 );
+    if ( bytesRead > 0 )
+    {
+        m_eos = false;
+    }
+    else if ( bytesRead < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) )
+    {
+        bytesRead = 0;
+        m_eos     = false;
+    }
+
+    // Zero bytes read -->the remote host closed the connection
+    else
+    {
+        bytesRead = 0;
+        m_eos     = true;
+        close();
+    }
+    return !m_eos;
+}
+
+bool InputOutput::available()
+{
+    // Peek at the socket: returns true if there is data OR if the remote host 
+    // has closed the connection (i.e. read() will not block and will report 
+    // the End-of-Stream). NOTE: If there is error -->then I will return true
+    char c;
+    int  result = recv( m_fd.m_fd, &c, 1, MSG_PEEK | MSG_DONTWAIT );
+    return result >= 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR);
+}
+
+
+//////////////////////
+bool InputOutput::write( const void* buffer, int maxBytes, int& bytesWritten )
+{
+    // Throw an error if the socket had already been closed
+    if ( m_fd.m_fd < 0 )
+    {
+        return false;
+    }
+
+    // Ignore write requests of ZERO bytes
+    if ( maxBytes == 0 )
+    {
+        bytesWritten = 0;
+        return true;
+    }
+
+    // perform the write (and do NOT raise SIGPIPE when the remote host has closed the connection)
+    bytesWritten = send( m_fd.m_fd, (char*) buffer, maxBytes, MSG_NOSIGNAL );
+    if ( bytesWritten > 0 )
+    {
+        m_eos = false;
+    }
+    else if ( bytesWritten < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) )
+    {
+        bytesWritten = 0;
+        m_eos        = false;
+    }
+    else
+    {
+        bytesWritten = 0;
+        m_eos        = true;
+        close();
+    }
+    return !m_eos;
+}
+
+void InputOutput::flush()
+{
+    // Not supported/needed
+}
+
+bool InputOutput::isEos()
+{
+    return m_eos;
+}
+
+void InputOutput::close()
+{
+    m_eos = true;
+    if ( m_fd.m_fd >= 0 )
+    {
+        ::close( m_fd.m_fd );   // Note: Closing the socket also removes it from any epoll set(s)
+        m_fd.m_fd = -1;
+    }
+}
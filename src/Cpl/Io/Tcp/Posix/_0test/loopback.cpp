@@ -0,0 +1,482 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+
+#include "Catch/catch.hpp"
+#include "Cpl/Io/Tcp/Posix/AsyncListener.h"
+#include "Cpl/Io/Tcp/Posix/AsyncConnector.h"
+#include "Cpl/System/EventLoop.h"
+#include "Cpl/System/Thread.h"
+#include "Cpl/System/Api.h"
+#include "Cpl/System/Trace.h"
+#include "Cpl/System/ElapsedTime.h"
+#include "Cpl/System/_testsupport/Shutdown_TS.h"
+#include <string.h>
+#include <atomic>
+
+
+#define SECT_               "_0test"
+
+#define PORT_NUM_           5091
+#define MAX_SERVER_CONNS_   1100
+#define WAKEUP_EVENT_       0
+
+using namespace Cpl::Io::Tcp;
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+/// Server side connection: echoes everything it reads
+class EchoConnection : public Cpl::Io::Tcp::InputOutput, public Posix::AsyncListener::ReadableHandler
+{
+public:
+    ///
+    bool m_inUse;
+
+    ///
+    EchoConnection() :m_inUse( false ) {}
+
+    ///
+    void readable() noexcept
+    {
+        char buf[512];
+        int  bytesRead;
+        while ( read( buf, sizeof( buf ), bytesRead ) && bytesRead > 0 )
+        {
+            int offset = 0;
+            while ( offset < bytesRead )
+            {
+                int bytesWritten;
+                if ( !write( buf + offset, bytesRead - offset, bytesWritten ) )
+                {
+                    break;
+                }
+                offset += bytesWritten;
+            }
+        }
+
+        // Remote host closed the connection
+        if ( isEos() )
+        {
+            close();
+            m_inUse = false;
+        }
+    }
+};
+
+/// Single threaded (event loop) echo server that services all connections
+class EchoServer : public Cpl::System::EventLoop, public Posix::AsyncListener::Client
+{
+public:
+    ///
+    Posix::AsyncListener    m_listener;
+    ///
+    EchoConnection          m_conns[MAX_SERVER_CONNS_];
+    ///
+    std::atomic<unsigned>   m_accepted;
+    ///
+    std::atomic<bool>       m_listening;
+    ///
+    std::atomic<bool>       m_done;
+
+    ///
+    EchoServer() :EventLoop( 1000 ), m_listener( true ), m_accepted( 0 ), m_listening( false ), m_done( false ) {}
+
+    ///
+    bool newConnection( Cpl::Io::Descriptor newFd, const char* rawConnectionInfo ) noexcept
+    {
+        for ( unsigned i=0; i < MAX_SERVER_CONNS_; i++ )
+        {
+            if ( !m_conns[i].m_inUse )
+            {
+                m_conns[i].activate( newFd );
+                m_conns[i].m_inUse = true;
+                m_listener.monitor( m_conns[i], m_conns[i] );
+                m_accepted++;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    ///
+    void processEventFlag( uint8_t eventNumber ) noexcept
+    {
+        if ( eventNumber == WAKEUP_EVENT_ )
+        {
+            m_listener.poll();
+        }
+    }
+
+    ///
+    void appRun()
+    {
+        startEventLoop();
+        m_listener.startListening( *this, PORT_NUM_ );
+        m_listener.enableEventLoopWakeup( *this, WAKEUP_EVENT_ );
+        m_listening = true;
+        while ( waitAndProcessEvents() )
+        {
+            // Poll on timeout as well (e.g. bind retries)
+            m_listener.poll();
+        }
+        m_listener.terminate();
+        for ( unsigned i=0; i < MAX_SERVER_CONNS_; i++ )
+        {
+            m_conns[i].close();
+            m_conns[i].m_inUse = false;
+        }
+        stopEventLoop();
+        m_done = true;
+    }
+};
+
+/// Client side connection
+class EchoClient : public AsyncConnector::Client
+{
+public:
+    ///
+    Posix::AsyncConnector   m_connector;
+    ///
+    bool                    m_connected;
+    ///
+    bool                    m_failed;
+    ///
+    int                     m_pendingBytes;
+
+    ///
+    EchoClient() :m_connected( false ), m_failed( false ), m_pendingBytes( 0 ) {}
+
+    ///
+    bool newConnection( Cpl::Io::Descriptor newFd ) noexcept
+    {
+        activate( newFd );
+        m_connected = true;
+        return true;
+    }
+
+    ///
+    void connectionFailed( Error_T errorCode ) noexcept
+    {
+        m_failed = true;
+    }
+
+    ///
+    void connect()
+    {
+        m_connected    = false;
+        m_failed       = false;
+        m_pendingBytes = 0;
+        m_connector.establish( *this, "127.0.0.1", PORT_NUM_ );
+    }
+
+    /// Sends a message (the echo is consumed by receive())
+    bool send( const char* msg, int len )
+    {
+        int bytesWritten;
+        if ( !write( msg, len, bytesWritten ) || bytesWritten != len )
+        {
+            return false;
+        }
+        m_pendingBytes += len;
+        return true;
+    }
+
+    /// Consumes echoed data. Returns true when all sent data has been echoed
+    bool receive()
+    {
+        char buf[512];
+        int  bytesRead;
+        while ( m_pendingBytes > 0 && read( buf, sizeof( buf ), bytesRead ) && bytesRead > 0 )
+        {
+            m_pendingBytes -= bytesRead;
+        }
+        return m_pendingBytes == 0;
+    }
+};
+
+}; // end namespace
+
+
+/// Polls the connectors until all clients are connected (or failed). Returns the number of connected clients
+static unsigned connectAll( EchoClient* clients, unsigned numClients )
+{
+    unsigned long start = Cpl::System::ElapsedTime::milliseconds();
+    unsigned      done  = 0;
+    while ( done < numClients && !Cpl::System::ElapsedTime::expiredMilliseconds( start, 10000 ) )
+    {
+        done = 0;
+        for ( unsigned i=0; i < numClients; i++ )
+        {
+            clients[i].m_connector.poll();
+            if ( clients[i].m_connected || clients[i].m_failed )
+            {
+                done++;
+            }
+        }
+    }
+    unsigned connected = 0;
+    for ( unsigned i=0; i < numClients; i++ )
+    {
+        connected += clients[i].m_connected ? 1 : 0;
+    }
+    return connected;
+}
+
+/// Sends a message on every client and waits for all of the echoes.  Returns false on error/timeout
+static bool echoAll( EchoClient* clients, unsigned numClients, const char* msg, int len )
+{
+    for ( unsigned i=0; i < numClients; i++ )
+    {
+        if ( !clients[i].send( msg, len ) )
+        {
+            return false;
+        }
+    }
+
+    unsigned long start = Cpl::System::ElapsedTime::milliseconds();
+    unsigned      done  = 0;
+    while ( done < numClients )
+    {
+        if ( Cpl::System::ElapsedTime::expiredMilliseconds( start, 10000 ) )
+        {
+            return false;
+        }
+        done = 0;
+        for ( unsigned i=0; i < numClients; i++ )
+        {
+            done += clients[i].receive() ? 1 : 0;
+        }
+    }
+    return true;
+}
+
+static void closeAll( EchoClient* clients, unsigned numClients )
+{
+    for ( unsigned i=0; i < numClients; i++ )
+    {
+        clients[i].m_connector.terminate();
+        clients[i].close();
+    }
+}
+
+static void waitForServer( EchoServer& server )
+{
+    while ( !server.m_listening )
+    {
+        Cpl::System::Api::sleep( 1 );
+    }
+}
+
+static void stopServer( EchoServer& server, Cpl::System::Thread* t )
+{
+    server.pleaseStop();
+    while ( !server.m_done || t->isRunning() )
+    {
+        Cpl::System::Api::sleep( 1 );
+    }
+    Cpl::System::Thread::destroy( *t );
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+/// Single connection client (for the listener)
+class SingleClient : public AsyncListener::Client
+{
+public:
+    ///
+    int m_count;
+    ///
+    SingleClient() :m_count( 0 ) {}
+    ///
+    bool newConnection( Cpl::Io::Descriptor newFd, const char* rawConnectionInfo ) noexcept
+    {
+        activate( newFd );
+        m_count++;
+        return true;
+    }
+};
+
+}; // end namespace
+
+TEST_CASE( "tcp-posix" )
+{
+    Cpl::System::Shutdown_TS::clearAndUseCounter();
+
+    SECTION( "single connection" )
+    {
+        Posix::AsyncListener listener;
+        SingleClient         serverSide;
+        EchoClient           client1;
+        EchoClient           client2;
+        REQUIRE( listener.startListening( serverSide, PORT_NUM_ + 1 ) );
+
+        // 1st connection
+        client1.m_connector.establish( client1, "127.0.0.1", PORT_NUM_ + 1 );
+        for ( int i=0; i < 100 && serverSide.m_count == 0; i++ )
+        {
+            client1.m_connector.poll();
+            listener.poll();
+            Cpl::System::Api::sleep( 1 );
+        }
+        REQUIRE( client1.m_connected );
+        REQUIRE( serverSide.m_count == 1 );
+
+        // Data transfer
+        int  bytesWritten;
+        int  bytesRead = 0;
+        char buf[16];
+        REQUIRE( client1.write( "hello", 5, bytesWritten ) );
+        for ( int i=0; i < 100 && bytesRead == 0; i++ )
+        {
+            Cpl::System::Api::sleep( 1 );
+            REQUIRE( serverSide.read( buf, sizeof( buf ), bytesRead ) );
+        }
+        REQUIRE( bytesRead == 5 );
+        REQUIRE( strncmp( buf, "hello", 5 ) == 0 );
+
+        // 2nd connection is refused (i.e. closed by the listener)
+        client2.m_connector.establish( client2, "127.0.0.1", PORT_NUM_ + 1 );
+        for ( int i=0; i < 100 && !client2.isEos(); i++ )
+        {
+            client2.m_connector.poll();
+            listener.poll();
+            if ( client2.m_connected )
+            {
+                client2.read( buf, sizeof( buf ), bytesRead );
+            }
+            Cpl::System::Api::sleep( 1 );
+        }
+        REQUIRE( client2.isEos() );
+        REQUIRE( serverSide.m_count == 1 );
+
+        // Remote close -->listener accepts a new connection
+        client1.close();
+        for ( int i=0; i < 100 && !serverSide.isEos(); i++ )
+        {
+            Cpl::System::Api::sleep( 1 );
+            serverSide.read( buf, sizeof( buf ), bytesRead );
+        }
+        REQUIRE( serverSide.isEos() );
+        client1.m_connector.poll();
+        client2.m_connected = false;
+        client2.m_connector.establish( client2, "127.0.0.1", PORT_NUM_ + 1 );
+        for ( int i=0; i < 100 && serverSide.m_count == 1; i++ )
+        {
+            client2.m_connector.poll();
+            listener.poll();
+            Cpl::System::Api::sleep( 1 );
+        }
+        REQUIRE( serverSide.m_count == 2 );
+        client2.close();
+        listener.terminate();
+    }
+
+    SECTION( "connection refused" )
+    {
+        EchoClient client;
+        client.connect();
+        for ( int i=0; i < 100 && !client.m_failed; i++ )
+        {
+            client.m_connector.poll();
+            Cpl::System::Api::sleep( 1 );
+        }
+        REQUIRE( client.m_failed );
+        REQUIRE( client.m_connected == false );
+    }
+
+    SECTION( "multiple connections, event loop" )
+    {
+        EchoServer*          server = new EchoServer();
+        Cpl::System::Thread* t      = Cpl::System::Thread::create( *server, "SERVER" );
+        REQUIRE( t );
+        waitForServer( *server );
+
+        EchoClient* clients = new EchoClient[50];
+        for ( unsigned i=0; i < 50; i++ )
+        {
+            clients[i].connect();
+        }
+        REQUIRE( connectAll( clients, 50 ) == 50 );
+        REQUIRE( echoAll( clients, 50, "hello world", 11 ) );
+        REQUIRE( echoAll( clients, 50, "bye", 3 ) );
+        REQUIRE( server->m_accepted == 50 );
+        closeAll( clients, 50 );
+        delete[] clients;
+
+        stopServer( *server, t );
+        delete server;
+    }
+
+    REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 0u );
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+#define BENCH_NUM_CLIENTS_      1000
+#define BENCH_CHURN_ROUNDS_     5
+#define BENCH_ECHO_ROUNDS_      100
+#define BENCH_MSG_SIZE_         64
+
+TEST_CASE( "tcp-posix-benchmark", "[.bench]" )
+{
+    EchoServer*          server = new EchoServer();
+    Cpl::System::Thread* t      = Cpl::System::Thread::create( *server, "SERVER" );
+    REQUIRE( t );
+    waitForServer( *server );
+    EchoClient* clients = new EchoClient[BENCH_NUM_CLIENTS_];
+    char        msg[BENCH_MSG_SIZE_];
+    memset( msg, 'x', sizeof( msg ) );
+
+    // Connection churn: connect, echo one message, close
+    unsigned long start = Cpl::System::ElapsedTime::milliseconds();
+    for ( unsigned r=0; r < BENCH_CHURN_ROUNDS_; r++ )
+    {
+        for ( unsigned i=0; i < BENCH_NUM_CLIENTS_; i++ )
+        {
+            clients[i].connect();
+        }
+        REQUIRE( connectAll( clients, BENCH_NUM_CLIENTS_ ) == BENCH_NUM_CLIENTS_ );
+        REQUIRE( echoAll( clients, BENCH_NUM_CLIENTS_, msg, 16 ) );
+        closeAll( clients, BENCH_NUM_CLIENTS_ );
+    }
+    unsigned long churnTime = Cpl::System::ElapsedTime::deltaMilliseconds( start );
+    CPL_SYSTEM_TRACE_MSG( SECT_, ("churn: %u connections (%u clients x %u rounds). %lu ms (%lu connections/sec)",
+                                   BENCH_NUM_CLIENTS_ * BENCH_CHURN_ROUNDS_, BENCH_NUM_CLIENTS_, BENCH_CHURN_ROUNDS_,
+                                   churnTime,
+                                   (unsigned long) (BENCH_NUM_CLIENTS_ * BENCH_CHURN_ROUNDS_ * 1000ULL / (churnTime ? churnTime : 1))) );
+
+    // Echo throughput: all clients connected, each round every client sends one message and waits for the echo
+    for ( unsigned i=0; i < BENCH_NUM_CLIENTS_; i++ )
+    {
+        clients[i].connect();
+    }
+    REQUIRE( connectAll( clients, BENCH_NUM_CLIENTS_ ) == BENCH_NUM_CLIENTS_ );
+    start = Cpl::System::ElapsedTime::milliseconds();
+    for ( unsigned r=0; r < BENCH_ECHO_ROUNDS_; r++ )
+    {
+        REQUIRE( echoAll( clients, BENCH_NUM_CLIENTS_, msg, BENCH_MSG_SIZE_ ) );
+    }
+    unsigned long echoTime = Cpl::System::ElapsedTime::deltaMilliseconds( start );
+    closeAll( clients, BENCH_NUM_CLIENTS_ );
+    unsigned long long numMsgs = (unsigned long long) BENCH_NUM_CLIENTS_ * BENCH_ECHO_ROUNDS_;
+    CPL_SYSTEM_TRACE_MSG( SECT_, ("echo:  %u clients x %u rounds x %u bytes. %lu ms (%lu msgs/sec, %lu KB/sec)",
+                                   BENCH_NUM_CLIENTS_, BENCH_ECHO_ROUNDS_, BENCH_MSG_SIZE_,
+                                   echoTime,
+                                   (unsigned long) (numMsgs * 1000ULL / (echoTime ? echoTime : 1)),
+                                   (unsigned long) (numMsgs * BENCH_MSG_SIZE_ * 1000ULL / 1024 / (echoTime ? echoTime : 1))) );
+
+    delete[] clients;
+    stopServer( *server, t );
+    delete server;
+}
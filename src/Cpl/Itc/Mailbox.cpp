@@ -22,16 +22,41 @@ using namespace Cpl::Itc;
 ////////////////////////////////////////////////////////////////////////////////
 Mailbox::Mailbox( Cpl::System::Signable& myEventLoop )
     :m_eventLoop( myEventLoop )
+    , m_maxMessagesPerPass( OPTION_CPL_ITC_MAILBOX_MAX_MESSAGES_PER_PASS )
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+    , m_profileEventLoop( 0 )
+    , m_profileQueued( 0 )
+    , m_profileDrained( 0 )
+#endif
 {
 }
 
+void Mailbox::setMaxMessagesPerPass( unsigned maxMessages ) noexcept
+{
+    m_maxMessagesPerPass = maxMessages > 0 ? maxMessages : 1;
+}
+
+void Mailbox::setProfileEventLoop( Cpl::System::EventLoop* eventLoop ) noexcept
+{
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+    m_profileEventLoop = eventLoop;
+#endif
+}
+
 
 void Mailbox::post( Message& msg ) noexcept
 {
     // Update my internal FIFO
+#ifdef USE_CPL_ITC_MAILBOX_MPSC_QUEUE
+    m_queue.put( msg );
+#else
     Cpl::System::GlobalLock::begin();
     put( msg );
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+    m_profileQueued++;
+#endif
     Cpl::System::GlobalLock::end();
+#endif
 
     // Wake up my event loop to process the message
     m_eventLoop.signal();
@@ -47,25 +72,108 @@ void Mailbox::postSync( Message& msg ) noexcept
 
 void Mailbox::processMessages() noexcept
 {
-    // Get the next message
-    Cpl::System::GlobalLock::begin();
-    Message* msgPtr = get();
-    Cpl::System::GlobalLock::end();
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+    unsigned long startTime = m_profileEventLoop ? Cpl::System::EventLoop::profileTimestamp_() : 0;
+#endif
 
-    // Dispatch at MOST one message
-    if ( msgPtr )
+#ifdef USE_CPL_ITC_MAILBOX_MPSC_QUEUE
+    // Lock-free: Take ALL of the pending messages when there are no previously drained messages
+    if ( m_drained.first() == nullptr )
     {
+        m_queue.getAll( m_drained );
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+        // Note: The lock-free queue does not track its depth -->count the drained messages (they are about to be dispatched anyway)
+        for ( Message* msgPtr = m_drained.first(); msgPtr; msgPtr = m_drained.next( *msgPtr ) )
+        {
+            m_profileDrained++;
+        }
+#endif
+    }
+
+#else
+    // Default behavior: dispatch at MOST one message
+    if ( m_maxMessagesPerPass <= 1 && m_drained.first() == nullptr )
+    {
+        Cpl::System::GlobalLock::begin();
+        Message* msgPtr = get();
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+        unsigned long depth = m_profileQueued;
+        if ( msgPtr )
+        {
+            m_profileQueued--;
+        }
+#endif
+        Cpl::System::GlobalLock::end();
+
+        if ( msgPtr )
+        {
+            msgPtr->process();
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+            if ( m_profileEventLoop )
+            {
+                m_profileEventLoop->profileEvents_( Cpl::System::EventLoop::ePROFILE_MESSAGES, 1, startTime );
+                m_profileEventLoop->profileQueueDepth_( Cpl::System::EventLoop::ePROFILE_MESSAGES, depth );
+            }
+#endif
+        }
+        return;
+    }
+
+    // Drain-all: Take ALL of the pending messages in a single critical section
+    if ( m_drained.first() == nullptr )
+    {
+        Cpl::System::GlobalLock::begin();
+        move( m_drained );
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+        m_profileDrained += m_profileQueued;
+        m_profileQueued   = 0;
+#endif
+        Cpl::System::GlobalLock::end();
+    }
+#endif
+
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+    unsigned long depth = m_profileDrained;
+#endif
+
+    // Dispatch (in order) at MOST N messages.  Any remaining messages are dispatched on the next pass(es)
+    unsigned count=0;
+    for ( ; count < m_maxMessagesPerPass; count++ )
+    {
+        Message* msgPtr = m_drained.get();
+        if ( msgPtr == nullptr )
+        {
+            break;
+        }
         msgPtr->process();
     }
+
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+    m_profileDrained -= count;
+    if ( m_profileEventLoop )
+    {
+        m_profileEventLoop->profileEvents_( Cpl::System::EventLoop::ePROFILE_MESSAGES, count, startTime );
+        m_profileEventLoop->profileQueueDepth_( Cpl::System::EventLoop::ePROFILE_MESSAGES, depth );
+    }
+#endif
 }
 
 
 bool Mailbox::isPendingMessage() noexcept
 {
+    // Previously drained messages
+    if ( m_drained.first() )
+    {
+        return true;
+    }
+
     // Get the next message
+#ifdef USE_CPL_ITC_MAILBOX_MPSC_QUEUE
+    return !m_queue.isEmpty();
+#else
     Cpl::System::GlobalLock::begin();
     Message* msgPtr = first();
     Cpl::System::GlobalLock::end();
     return msgPtr != nullptr;
+#endif
 }
-
@@ -12,10 +12,26 @@
 *----------------------------------------------------------------------------*/
 /** @file */
 
+#include "colony_config.h"
 #include "Cpl/Itc/PostApi.h"
 #include "Cpl/Container/SList.h"
 #include "Cpl/System/Signable.h"
-
+#include "Cpl/System/EventLoop.h"
+#ifdef USE_CPL_ITC_MAILBOX_MPSC_QUEUE
+#include "Cpl/Container/MpscQueue.h"
+#endif
+
+
+/** This symbol defines the default maximum number of ITC messages that are
+    dispatched per pass of the event loop.  A value of 1 gives equal
+    time/priority to all types of events.  When the value is greater than 1,
+    the mailbox operates in 'drain-all' mode, i.e. all of the pending messages
+    are removed from the mailbox in a single critical section and are then
+    dispatched (in FIFO order) at most N messages per pass.
+ */
+#ifndef OPTION_CPL_ITC_MAILBOX_MAX_MESSAGES_PER_PASS
+#define OPTION_CPL_ITC_MAILBOX_MAX_MESSAGES_PER_PASS    1
+#endif
 
 ///
 namespace Cpl {
@@ -26,6 +42,17 @@ namespace Itc {
     queue. There is no limit to the number of messages that can be stored in
     the queue at any given time since the FIFO queue and the messages uses the
     intrusive container mechanisms from the Cpl::Container namespace.
+
+    By default the queue is protected by the Cpl::System::GlobalLock.  When
+    USE_CPL_ITC_MAILBOX_MPSC_QUEUE is defined, the mailbox uses a lock-free
+    Cpl::Container::MpscQueue instead, i.e. post() does NOT take the global
+    lock.  The lock-free queue requires native compare-and-swap support (see
+    Cpl::Container::MpscQueue).
+
+    When USE_CPL_SYSTEM_EVENT_LOOP_PROFILE is defined, the number of messages
+    dispatched, the time spent dispatching them, and the peak queue depth are
+    recorded in the profiling statistics of the Event Loop that is provided by
+    setProfileEventLoop().
  */
 
 class Mailbox :
@@ -44,22 +71,68 @@ public:
     /// See Cpl::Itc::PostApi
     void postSync( Message& msg ) noexcept;
 
+public:
+    /** This method configures the maximum number of messages that are
+        dispatched per pass of the event loop.  A value greater than 1 enables
+        the 'drain-all' mode which reduces the locking overhead - and the
+        number of event loop cycles - when processing a burst of messages.  A
+        value of zero is treated as 1.
+
+        This method should only be called before the mailbox's thread is
+        started.
+     */
+    void setMaxMessagesPerPass( unsigned maxMessages ) noexcept;
+
+    /** This method sets the Event Loop whose profiling statistics are updated
+        when processing messages (see Cpl::System::EventLoop::getProfile()).
+        The method does nothing if USE_CPL_SYSTEM_EVENT_LOOP_PROFILE is not
+        defined.
+
+        This method should only be called before the mailbox's thread is
+        started.
+     */
+    void setProfileEventLoop( Cpl::System::EventLoop* eventLoop ) noexcept;
 
 protected:
-    /** This operation is used process any pending messages.
+    /** This operation is used process any pending messages.  At most
+        'm_maxMessagesPerPass' messages are dispatched per call.
      */
     virtual void processMessages() noexcept;
 
 
-    /** This method IS thread safe.
+    /** This method returns true if there is at least one queued ITC message.
 
-        This method returns true if there is at least one queued ITC message
+        Note: This method is ONLY thread safe when called from the mailbox's
+              thread (which is the only thread that accesses the 'drained'
+              messages).
      */
     bool isPendingMessage() noexcept;
 
 protected:
     /// The EventLoop that I wait-on/dispatch-msgs-from
-    Cpl::System::Signable& m_eventLoop;
+    Cpl::System::Signable&          m_eventLoop;
+
+    /// Messages that have been removed from the mailbox but not yet dispatched (only accessed by the mailbox's thread)
+    Cpl::Container::SList<Message>  m_drained;
+
+#ifdef USE_CPL_ITC_MAILBOX_MPSC_QUEUE
+    /// Lock-free queue of posted messages
+    Cpl::Container::MpscQueue<Message> m_queue;
+#endif
+
+    /// Maximum number of messages to dispatch per pass
+    unsigned                        m_maxMessagesPerPass;
+
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+    /// Event Loop to record the profiling statistics in (can be null)
+    Cpl::System::EventLoop*         m_profileEventLoop;
+
+    /// Number of messages in the mailbox's queue (only used with the GlobalLock protected queue)
+    unsigned long                   m_profileQueued;
+
+    /// Number of messages in the drained list
+    unsigned long                   m_profileDrained;
+#endif
 
 };
 
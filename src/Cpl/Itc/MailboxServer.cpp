@@ -29,6 +29,7 @@ MailboxServer::MailboxServer( unsigned long                       timingTickInMs
     : Mailbox( *((Cpl::System::Signable*)this) )
     , Cpl::System::EventLoop( timingTickInMsec, eventHandler )
 {
+    setProfileEventLoop( this );
 }
 
 
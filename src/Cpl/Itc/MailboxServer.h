@@ -30,7 +30,9 @@ namespace Itc {
        1. Event Flags are processed.  Events are processed in LSb order.
        2. The timers and their callbacks (if any timers have expired) are
           processed.
-       3. A Single ITC message (if one was received) is processed.
+       3. A Single ITC message (if one was received) is processed.  When
+          'drain-all' mode is enabled (see Mailbox::setMaxMessagesPerPass())
+          up to N ITC messages are processed.
 
  */
 class MailboxServer :
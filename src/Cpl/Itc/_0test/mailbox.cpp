@@ -0,0 +1,281 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+
+#include "Catch/catch.hpp"
+#include "Cpl/System/_testsupport/Shutdown_TS.h"
+#include "Cpl/System/Thread.h"
+#include "Cpl/System/Api.h"
+#include "Cpl/System/Trace.h"
+#include "Cpl/Itc/MailboxServer.h"
+#include <chrono>
+#include <algorithm>
+
+///
+using namespace Cpl::Itc;
+
+#define SECT_   "_0test"
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Signable that does nothing (i.e. the test drives the mailbox directly)
+class NullSignable : public Cpl::System::Signable
+{
+public:
+    ///
+    int signal( void ) noexcept { return 0; }
+    ///
+    int su_signal( void ) noexcept { return 0; }
+};
+
+/// Mailbox that exposes its protected methods
+class TestMailbox : public Mailbox
+{
+public:
+    ///
+    TestMailbox( Cpl::System::Signable& myEventLoop ):Mailbox( myEventLoop ) {}
+    ///
+    void process() { processMessages(); }
+    ///
+    bool isPending() { return isPendingMessage(); }
+};
+
+/// Message that records the order in which it was processed
+class OrderMsg : public Message
+{
+public:
+    ///
+    unsigned    m_id;
+    ///
+    unsigned*   m_log;
+    ///
+    unsigned&   m_logIdx;
+
+    ///
+    OrderMsg( unsigned id, unsigned* log, unsigned& logIdx ):m_id( id ), m_log( log ), m_logIdx( logIdx ) {}
+
+    ///
+    void process() noexcept { m_log[m_logIdx++] = m_id; }
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+#define NUM_MSGS_   12
+
+TEST_CASE( "mailbox" )
+{
+    Cpl::System::Shutdown_TS::clearAndUseCounter();
+    NullSignable signable;
+    TestMailbox  uut( signable );
+    unsigned     log[NUM_MSGS_];
+    unsigned     logIdx = 0;
+    OrderMsg*    msgs[NUM_MSGS_];
+    for ( unsigned i=0; i < NUM_MSGS_; i++ )
+    {
+        msgs[i] = new OrderMsg( i, log, logIdx );
+    }
+
+    SECTION( "one-per-pass" )
+    {
+        REQUIRE( uut.isPending() == false );
+        uut.post( *msgs[0] );
+        uut.post( *msgs[1] );
+        REQUIRE( uut.isPending() == true );
+        uut.process();
+        REQUIRE( logIdx == 1 );
+        uut.process();
+        REQUIRE( logIdx == 2 );
+        REQUIRE( uut.isPending() == false );
+        uut.process();
+        REQUIRE( logIdx == 2 );
+        REQUIRE( log[0] == 0 );
+        REQUIRE( log[1] == 1 );
+    }
+
+    SECTION( "drain-all" )
+    {
+        uut.setMaxMessagesPerPass( 4 );
+        for ( unsigned i=0; i < 10; i++ )
+        {
+            uut.post( *msgs[i] );
+        }
+        uut.process();
+        REQUIRE( logIdx == 4 );
+
+        // Messages posted after the drain are processed AFTER the drained messages
+        uut.post( *msgs[10] );
+        uut.post( *msgs[11] );
+        REQUIRE( uut.isPending() == true );
+        uut.process();
+        REQUIRE( logIdx == 8 );
+        uut.process();
+        REQUIRE( logIdx == 10 );
+        REQUIRE( uut.isPending() == true );
+        uut.process();
+        REQUIRE( logIdx == NUM_MSGS_ );
+        REQUIRE( uut.isPending() == false );
+        for ( unsigned i=0; i < NUM_MSGS_; i++ )
+        {
+            REQUIRE( log[i] == i );
+        }
+    }
+
+    SECTION( "zero-cap" )
+    {
+        uut.setMaxMessagesPerPass( 0 );
+        uut.post( *msgs[0] );
+        uut.post( *msgs[1] );
+        uut.process();
+        REQUIRE( logIdx == 1 );
+        uut.process();
+        REQUIRE( logIdx == 2 );
+    }
+
+    for ( unsigned i=0; i < NUM_MSGS_; i++ )
+    {
+        delete msgs[i];
+    }
+    REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 0u );
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+#define BENCH_NUM_MSGS_     100000
+#define BENCH_BURST_SIZE_   100
+#define BENCH_DRAIN_CAP_    64
+
+typedef std::chrono::steady_clock Clock_T;
+
+/// Message that records its post-to-dispatch latency
+class PingMsg : public Message
+{
+public:
+    ///
+    Clock_T::time_point         m_sentTime;
+    ///
+    uint32_t*                   m_latencyUsec;
+    ///
+    Cpl::System::Signable*      m_replyTo;
+
+    ///
+    PingMsg():m_latencyUsec( 0 ), m_replyTo( 0 ) {}
+
+    ///
+    void process() noexcept
+    {
+        *m_latencyUsec = (uint32_t) std::chrono::duration_cast<std::chrono::microseconds>(Clock_T::now() - m_sentTime).count();
+        if ( m_replyTo )
+        {
+            m_replyTo->signal();
+        }
+    }
+};
+
+/// Message that executes a benchmark run in the client's thread
+class RunMsg : public Message
+{
+public:
+    ///
+    Mailbox&                    m_server;
+    ///
+    PingMsg*                    m_pings;
+    ///
+    uint32_t*                   m_latencies;
+    ///
+    bool                        m_useSync;
+    ///
+    Cpl::System::Thread&        m_master;
+    ///
+    unsigned long               m_elapsedUsec;
+
+    ///
+    RunMsg( Mailbox& server, PingMsg* pings, uint32_t* latencies, bool useSync, Cpl::System::Thread& master )
+        :m_server( server ), m_pings( pings ), m_latencies( latencies ), m_useSync( useSync ), m_master( master ), m_elapsedUsec( 0 ) {}
+
+    ///
+    void process() noexcept
+    {
+        Cpl::System::Thread& me    = Cpl::System::Thread::getCurrent();
+        Clock_T::time_point  start = Clock_T::now();
+        for ( unsigned i=0; i < BENCH_NUM_MSGS_; i++ )
+        {
+            PingMsg& ping      = m_pings[i];
+            ping.m_latencyUsec = &m_latencies[i];
+
+            // Synchronous: one message at a time
+            if ( m_useSync )
+            {
+                ping.m_replyTo  = &me;
+                ping.m_sentTime = Clock_T::now();
+                m_server.postSync( ping );
+            }
+
+            // Asynchronous: bursts of messages, the last message in the burst signals the client
+            else
+            {
+                bool lastInBurst = (i + 1) % BENCH_BURST_SIZE_ == 0 || i + 1 == BENCH_NUM_MSGS_;
+                ping.m_replyTo   = lastInBurst ? &me : 0;
+                ping.m_sentTime  = Clock_T::now();
+                m_server.post( ping );
+                if ( lastInBurst )
+                {
+                    Cpl::System::Thread::wait();
+                }
+            }
+        }
+        m_elapsedUsec = (unsigned long) std::chrono::duration_cast<std::chrono::microseconds>(Clock_T::now() - start).count();
+        m_master.signal();
+    }
+};
+
+static void benchmark( bool useSync, unsigned maxMessagesPerPass )
+{
+    MailboxServer server;
+    MailboxServer client;
+    server.setMaxMessagesPerPass( maxMessagesPerPass );
+    Cpl::System::Thread* t1 = Cpl::System::Thread::create( server, "SERVER" );
+    Cpl::System::Thread* t2 = Cpl::System::Thread::create( client, "CLIENT" );
+
+    PingMsg*  pings     = new PingMsg[BENCH_NUM_MSGS_];
+    uint32_t* latencies = new uint32_t[BENCH_NUM_MSGS_];
+    RunMsg    run( server, pings, latencies, useSync, Cpl::System::Thread::getCurrent() );
+    client.post( run );
+    Cpl::System::Thread::wait();
+
+    std::sort( latencies, latencies + BENCH_NUM_MSGS_ );
+    CPL_SYSTEM_TRACE_MSG( SECT_, ("%-8s cap=%2u: %u msgs in %lu ms (%lu msgs/sec). latency usec: p50=%lu, p90=%lu, p99=%lu, max=%lu",
+                                   useSync ? "postSync" : "post",
+                                   maxMessagesPerPass,
+                                   BENCH_NUM_MSGS_,
+                                   run.m_elapsedUsec / 1000,
+                                   run.m_elapsedUsec ? (unsigned long) (BENCH_NUM_MSGS_ * 1000000ULL / run.m_elapsedUsec) : 0,
+                                   (unsigned long) latencies[BENCH_NUM_MSGS_ / 2],
+                                   (unsigned long) latencies[BENCH_NUM_MSGS_ * 90 / 100],
+                                   (unsigned long) latencies[BENCH_NUM_MSGS_ * 99 / 100],
+                                   (unsigned long) latencies[BENCH_NUM_MSGS_ - 1]) );
+
+    server.pleaseStop();
+    client.pleaseStop();
+    Cpl::System::Api::sleep( 100 );
+    REQUIRE( t1->isRunning() == false );
+    REQUIRE( t2->isRunning() == false );
+    Cpl::System::Thread::destroy( *t1 );
+    Cpl::System::Thread::destroy( *t2 );
+    delete[] pings;
+    delete[] latencies;
+}
+
+TEST_CASE( "mailbox-benchmark", "[.bench]" )
+{
+    benchmark( true, 1 );
+    benchmark( true, BENCH_DRAIN_CAP_ );
+    benchmark( false, 1 );
+    benchmark( false, BENCH_DRAIN_CAP_ );
+}
@@ -99,6 +99,9 @@ uint32_t getCategoryEnabledMask() noexcept;
         - There is no limited (other than the BETTER_NUM limits) to number of 
           message IDS.
         - Recommended that each MessageID symbol must be less than 32 characters
+        - When USE_CPL_LOGGING_DEFERRED_FORMATTING is defined, the format
+          string MUST have static storage duration (e.g. a string literal)
+          since the formatting is deferred until the log entry is consumed.
 
 
     \code
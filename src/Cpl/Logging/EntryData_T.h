@@ -12,7 +12,7 @@
 *----------------------------------------------------------------------------*/
 /** @file */
 
-
+#include "colony_config.h"
 #include "Cpl/Logging/TimeApi.h"
 #include "Cpl/Persistent/Payload.h"
 #include <stdint.h>
@@ -45,6 +45,15 @@
 #define OPTION_CPL_LOGGING_MAX_FORMATTED_MSG_TEXT_LEN   (OPTION_CPL_LOGGING_MAX_MSG_TEXT_LEN+OPTION_CPL_LOGGING_MAX_LEN_CATEGORY_ID_TEXT+1+OPTION_CPL_LOGGING_MAX_LEN_MESSAGE_ID_TEXT+2)
 #endif
 
+/** The size, in bytes, reserved to store the 'packed' arguments of a log
+    entry when deferred formatting is enabled (i.e. when the symbol
+    USE_CPL_LOGGING_DEFERRED_FORMATTING is defined).  Log entries whose
+    arguments do not fit are formatted immediately.
+ */
+#ifndef OPTION_CPL_LOGGING_MAX_PACKED_ARGS_LEN
+#define OPTION_CPL_LOGGING_MAX_PACKED_ARGS_LEN          64
+#endif
+
 
 ///
 namespace Cpl {
@@ -60,6 +69,18 @@ public:
     uint16_t            msgId;        //!< Message type enumeration identifier.  
     char                msgText[OPTION_CPL_LOGGING_MAX_MSG_TEXT_LEN + 1];  //!< The 'text' associated with log entry. 
 
+#ifdef USE_CPL_LOGGING_DEFERRED_FORMATTING
+    /** The following fields are used to defer the formatting of the 'text'
+        until the entry is consumed (see Cpl::Logging::expandLogEntry_()).
+        Note: These fields are NOT included in the 'packed' data
+     */
+    const char*         msgFormat;    //!< printf format string (must have static storage), or nullptr when 'msgText' is valid
+    const char*         catIdText;    //!< Category text (used to echo the entry to the trace engine)
+    const char*         msgIdText;    //!< Message ID text (used to echo the entry to the trace engine)
+    uint16_t            msgArgsLen;   //!< Number of bytes stored in 'msgArgs'
+    uint8_t             msgArgs[OPTION_CPL_LOGGING_MAX_PACKED_ARGS_LEN];  //!< Raw/packed printf arguments
+#endif
+
 public:
     /// Total 'packed' length
     static constexpr unsigned entryLen = sizeof( timestamp ) + sizeof( category ) + sizeof( msgId ) + sizeof( msgText );
@@ -70,6 +91,12 @@ public:
         : timestamp( 0 )
         , category( 0 )
         , msgId( 0 )
+#ifdef USE_CPL_LOGGING_DEFERRED_FORMATTING
+        , msgFormat( nullptr )
+        , catIdText( nullptr )
+        , msgIdText( nullptr )
+        , msgArgsLen( 0 )
+#endif
     {
         memset( msgText, 0, sizeof( msgText ) );
     }
@@ -11,6 +11,7 @@
 /** @file */
 
 #include "LogSink.h"
+#include "Private_.h"
 
 using namespace Cpl::Logging;
 
@@ -56,6 +57,9 @@ void LogSink::elementCountChanged( Cpl::Dm::Mp::Uint32& mp, Cpl::Dm::SubscriberA
         Cpl::Logging::EntryData_T  entry;
         while ( iterations < OPTION_CPL_LOGGING_LOGSINK_MAX_BATCH_WRITE && m_logBuffer.remove( entry ) )
         {
+#ifdef USE_CPL_LOGGING_DEFERRED_FORMATTING
+            expandLogEntry_( entry );
+#endif
             dispatchLogEntry( entry );
             iterations++;
         }
@@ -37,6 +37,11 @@ namespace Logging {
     log buffer and discards the entries.  A child class is required to provide
     a meaningful implementation of the dispatchLogEntry() method.
 
+    When deferred formatting is enabled (i.e. USE_CPL_LOGGING_DEFERRED_FORMATTING
+    is defined) the text of each log entry is formatted - and echoed to the
+    trace engine - by the sink's thread immediately before the entry is
+    dispatched.
+
     FYI: The Cpl::Persistent framework provides an alternate 'log sink' that
          writes log entries to Non-volatile storage along with an a API to 
          retrieve the log entries.
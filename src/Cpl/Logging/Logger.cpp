@@ -151,8 +151,32 @@ void Cpl::Logging::createAndAddLogEntry_( uint32_t    category,
         logEntry.category  = category;
         logEntry.msgId     = msgId;
         logEntry.timestamp = now();
+
+#ifdef USE_CPL_LOGGING_DEFERRED_FORMATTING
+        // Defer the formatting (i.e. store the format string and the raw arguments)
+        size_t  argsLen = 0;
+        va_list apCopy;
+        va_copy( apCopy, ap );
+        bool packed = packArgs_( logEntry.msgArgs, sizeof( logEntry.msgArgs ), argsLen, format, apCopy );
+        va_end( apCopy );
+        if ( packed )
+        {
+            logEntry.msgFormat  = format;
+            logEntry.msgArgsLen = (uint16_t) argsLen;
+        }
+
+        // The arguments do not fit (or are not supported) -->format them now
+        else
+        {
+            vsnprintf( logEntry.msgText, sizeof( logEntry.msgText ), format, ap );
+            logEntry.msgText[OPTION_CPL_LOGGING_MAX_MSG_TEXT_LEN] = '\0'; // Ensure the text string is null terminated
+        }
+        logEntry.catIdText = catIdText;
+        logEntry.msgIdText = msgIdText;
+#else
         vsnprintf( logEntry.msgText, sizeof( logEntry.msgText ), format, ap ); 
         logEntry.msgText[OPTION_CPL_LOGGING_MAX_MSG_TEXT_LEN] = '\0'; // Ensure the text string is null terminated
+#endif
 
         // Manage the queue overflow state
         if ( !isQueFull() )
@@ -165,11 +189,36 @@ void Cpl::Logging::createAndAddLogEntry_( uint32_t    category,
             }
         }
 
+#ifndef USE_CPL_LOGGING_DEFERRED_FORMATTING
         // Echo to the Trace engine (always echoed even when not added to the FIFO)
         Cpl::Text::FString<OPTION_CPL_LOGGING_MAX_FORMATTED_MSG_TEXT_LEN> stringBuf;
         startText( stringBuf, catIdText, msgIdText );
         stringBuf += logEntry.msgText;
         CPL_SYSTEM_TRACE_MSG( catIdText, ("%s", stringBuf.getString()) );
+#endif
+    }
+}
+
+#ifdef USE_CPL_LOGGING_DEFERRED_FORMATTING
+void Cpl::Logging::expandLogEntry_( EntryData_T& entry ) noexcept
+{
+    // Format the text
+    if ( entry.msgFormat )
+    {
+        formatPackedArgs_( entry.msgText, sizeof( entry.msgText ), entry.msgFormat, entry.msgArgs, entry.msgArgsLen );
+        entry.msgFormat  = nullptr;
+        entry.msgArgsLen = 0;
+    }
+
+    // Echo to the Trace engine
+    if ( entry.catIdText )
+    {
+        Cpl::Text::FString<OPTION_CPL_LOGGING_MAX_FORMATTED_MSG_TEXT_LEN> stringBuf;
+        startText( stringBuf, entry.catIdText, entry.msgIdText );
+        stringBuf += entry.msgText;
+        CPL_SYSTEM_TRACE_MSG( entry.catIdText, ("%s", stringBuf.getString()) );
+        entry.catIdText = nullptr;
     }
 }
+#endif
 
@@ -0,0 +1,384 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+/** @file */
+
+#include "Private_.h"
+
+#ifdef USE_CPL_LOGGING_DEFERRED_FORMATTING
+
+#include <stdio.h>
+#include <string.h>
+
+using namespace Cpl::Logging;
+
+/// Maximum length of a single conversion specification, e.g. "%-08.3lld"
+#define MAX_SPEC_LEN_       24
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+/// Argument types (after the default argument promotions)
+enum ArgType_T
+{
+    eLITERAL,       // '%%'
+    eINT,
+    eLONG,
+    eLLONG,
+    eSIZE,
+    ePTRDIFF,
+    eINTMAX,
+    eDOUBLE,
+    eLDOUBLE,
+    ePTR,
+    eSTR,
+    eUNSUPPORTED
+};
+
+/// Length modifiers
+enum Length_T
+{
+    eLEN_NONE,
+    eLEN_L,
+    eLEN_LL,
+    eLEN_BIG_L,
+    eLEN_Z,
+    eLEN_J,
+    eLEN_T
+};
+
+/// Parsed conversion specification
+struct Spec_T
+{
+    unsigned    len;        //!< Number of characters in the specification (including the leading '%')
+    unsigned    numStars;   //!< Number of '*' width/precision arguments
+    int         precision;  //!< Precision (-1 when not specified, -2 when it is a '*' argument, i.e. the last '*' argument)
+    ArgType_T   type;       //!< Argument type
+};
+
+} // end anonymous namespace
+
+
+/// Parses the conversion specification that starts at 'fmt' (which points to a '%')
+static void parseSpec( const char* fmt, Spec_T& spec ) noexcept
+{
+    const char* p = fmt + 1;
+    spec.numStars  = 0;
+    spec.precision = -1;
+
+    // Flags
+    while ( *p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0' || *p == '\'' )
+    {
+        p++;
+    }
+
+    // Width
+    if ( *p == '*' )
+    {
+        spec.numStars++;
+        p++;
+    }
+    while ( *p >= '0' && *p <= '9' )
+    {
+        p++;
+    }
+
+    // Precision
+    if ( *p == '.' )
+    {
+        p++;
+        spec.precision = 0;
+        if ( *p == '*' )
+        {
+            spec.numStars++;
+            spec.precision = -2;
+            p++;
+        }
+        while ( *p >= '0' && *p <= '9' )
+        {
+            spec.precision = spec.precision * 10 + ( *p - '0' );
+            p++;
+        }
+    }
+
+    // Length modifier (Note: 'hh' and 'h' arguments are promoted to int)
+    Length_T length = eLEN_NONE;
+    switch ( *p )
+    {
+    case 'h': p++; if ( *p == 'h' ) { p++; } break;
+    case 'l': p++; if ( *p == 'l' ) { p++; length = eLEN_LL; } else { length = eLEN_L; } break;
+    case 'L': p++; length = eLEN_BIG_L; break;
+    case 'z': p++; length = eLEN_Z; break;
+    case 'j': p++; length = eLEN_J; break;
+    case 't': p++; length = eLEN_T; break;
+    default: break;
+    }
+
+    // Conversion
+    char conversion = *p;
+    spec.len        = (unsigned) (p - fmt) + (conversion ? 1 : 0);
+    switch ( conversion )
+    {
+    case '%':
+        spec.type = spec.len == 2 ? eLITERAL : eUNSUPPORTED;
+        break;
+
+    case 'c':
+        spec.type = length == eLEN_NONE ? eINT : eUNSUPPORTED;
+        break;
+
+    case 'd': case 'i': case 'u': case 'x': case 'X': case 'o':
+        switch ( length )
+        {
+        case eLEN_NONE: spec.type = eINT; break;
+        case eLEN_L:    spec.type = eLONG; break;
+        case eLEN_LL:   spec.type = eLLONG; break;
+        case eLEN_Z:    spec.type = eSIZE; break;
+        case eLEN_J:    spec.type = eINTMAX; break;
+        case eLEN_T:    spec.type = ePTRDIFF; break;
+        default:        spec.type = eUNSUPPORTED; break;
+        }
+        break;
+
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+        spec.type = length == eLEN_BIG_L ? eLDOUBLE : length == eLEN_NONE || length == eLEN_L ? eDOUBLE : eUNSUPPORTED;
+        break;
+
+    case 'p':
+        spec.type = length == eLEN_NONE ? ePTR : eUNSUPPORTED;
+        break;
+
+    case 's':
+        spec.type = length == eLEN_NONE ? eSTR : eUNSUPPORTED;
+        break;
+
+    default:
+        spec.type = eUNSUPPORTED;
+        break;
+    }
+
+    if ( spec.len >= MAX_SPEC_LEN_ )
+    {
+        spec.type = eUNSUPPORTED;
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Appends a raw value to the packed arguments
+template <class T>
+static inline bool pack( uint8_t* dst, size_t maxDstLen, size_t& len, T value ) noexcept
+{
+    if ( len + sizeof( T ) > maxDstLen )
+    {
+        return false;
+    }
+    memcpy( dst + len, &value, sizeof( T ) );
+    len += sizeof( T );
+    return true;
+}
+
+/// Retrieves a raw value from the packed arguments
+template <class T>
+static inline bool unpack( const uint8_t* args, size_t argsLen, size_t& idx, T& value ) noexcept
+{
+    if ( idx + sizeof( T ) > argsLen )
+    {
+        return false;
+    }
+    memcpy( &value, args + idx, sizeof( T ) );
+    idx += sizeof( T );
+    return true;
+}
+
+bool Cpl::Logging::packArgs_( uint8_t* dst, size_t maxDstLen, size_t& dstLen, const char* format, va_list ap ) noexcept
+{
+    size_t len = 0;
+    while ( *format )
+    {
+        if ( *format != '%' )
+        {
+            format++;
+            continue;
+        }
+
+        Spec_T spec;
+        parseSpec( format, spec );
+        format += spec.len;
+        if ( spec.type == eUNSUPPORTED )
+        {
+            return false;
+        }
+
+        // Width/precision arguments
+        int starValue = 0;
+        for ( unsigned i=0; i < spec.numStars; i++ )
+        {
+            starValue = va_arg( ap, int );
+            if ( !pack( dst, maxDstLen, len, starValue ) )
+            {
+                return false;
+            }
+        }
+        if ( spec.precision == -2 )
+        {
+            spec.precision = starValue < 0 ? -1 : starValue;  // A negative precision is taken as if the precision were omitted
+        }
+
+        bool fits = true;
+        switch ( spec.type )
+        {
+        case eINT:      fits = pack( dst, maxDstLen, len, va_arg( ap, int ) ); break;
+        case eLONG:     fits = pack( dst, maxDstLen, len, va_arg( ap, long ) ); break;
+        case eLLONG:    fits = pack( dst, maxDstLen, len, va_arg( ap, long long ) ); break;
+        case eSIZE:     fits = pack( dst, maxDstLen, len, va_arg( ap, size_t ) ); break;
+        case ePTRDIFF:  fits = pack( dst, maxDstLen, len, va_arg( ap, ptrdiff_t ) ); break;
+        case eINTMAX:   fits = pack( dst, maxDstLen, len, va_arg( ap, intmax_t ) ); break;
+        case eDOUBLE:   fits = pack( dst, maxDstLen, len, va_arg( ap, double ) ); break;
+        case eLDOUBLE:  fits = pack( dst, maxDstLen, len, va_arg( ap, long double ) ); break;
+        case ePTR:      fits = pack( dst, maxDstLen, len, va_arg( ap, void* ) ); break;
+        case eSTR:
+        {
+            const char* str = va_arg( ap, const char* );
+            if ( str == nullptr )
+            {
+                str = "(null)";
+            }
+            // Note: When a precision is specified, the string does NOT need to be null terminated
+            size_t strLen = spec.precision < 0 ? strlen( str ) : strnlen( str, (size_t) spec.precision );
+            fits          = len + strLen + 1 <= maxDstLen;
+            if ( fits )
+            {
+                memcpy( dst + len, str, strLen );
+                dst[len + strLen] = '\0';
+                len              += strLen + 1;
+            }
+            break;
+        }
+        default:
+            break;
+        }
+
+        if ( !fits )
+        {
+            return false;
+        }
+    }
+
+    dstLen = len;
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void Cpl::Logging::formatPackedArgs_( char* dst, size_t dstSize, const char* format, const uint8_t* args, size_t argsLen ) noexcept
+{
+    if ( dstSize == 0 )
+    {
+        return;
+    }
+
+    size_t outLen = 0;
+    size_t idx    = 0;
+    while ( *format && outLen + 1 < dstSize )
+    {
+        // Literal text
+        if ( *format != '%' )
+        {
+            dst[outLen++] = *format++;
+            continue;
+        }
+
+        Spec_T spec;
+        parseSpec( format, spec );
+        if ( spec.type == eUNSUPPORTED )
+        {
+            break;  // Should never happen, i.e. the entry would not have been packed
+        }
+        if ( spec.type == eLITERAL )
+        {
+            dst[outLen++] = '%';
+            format       += spec.len;
+            continue;
+        }
+
+        // Copy the specification - replacing any '*' with its packed value
+        char     specBuf[MAX_SPEC_LEN_ * 2];
+        unsigned specLen = 0;
+        bool     valid   = true;
+        for ( unsigned i=0; i < spec.len; i++ )
+        {
+            if ( format[i] == '*' )
+            {
+                int starValue = 0;
+                valid         = valid && unpack( args, argsLen, idx, starValue );
+                if ( starValue < 0 && i > 0 && format[i - 1] == '.' )
+                {
+                    specLen--;  // A negative precision is taken as if the precision were omitted
+                }
+                else
+                {
+                    specLen += (unsigned) snprintf( specBuf + specLen, sizeof( specBuf ) - specLen, "%d", starValue );
+                }
+            }
+            else
+            {
+                specBuf[specLen++] = format[i];
+            }
+        }
+        specBuf[specLen] = '\0';
+        format          += spec.len;
+
+        // Format the argument
+        char*  out     = dst + outLen;
+        size_t outSize = dstSize - outLen;
+        int    n       = 0;
+        switch ( spec.type )
+        {
+        case eINT:      { int v = 0;          valid = valid && unpack( args, argsLen, idx, v ); if ( valid ) { n = snprintf( out, outSize, specBuf, v ); } break; }
+        case eLONG:     { long v = 0;         valid = valid && unpack( args, argsLen, idx, v ); if ( valid ) { n = snprintf( out, outSize, specBuf, v ); } break; }
+        case eLLONG:    { long long v = 0;    valid = valid && unpack( args, argsLen, idx, v ); if ( valid ) { n = snprintf( out, outSize, specBuf, v ); } break; }
+        case eSIZE:     { size_t v = 0;       valid = valid && unpack( args, argsLen, idx, v ); if ( valid ) { n = snprintf( out, outSize, specBuf, v ); } break; }
+        case ePTRDIFF:  { ptrdiff_t v = 0;    valid = valid && unpack( args, argsLen, idx, v ); if ( valid ) { n = snprintf( out, outSize, specBuf, v ); } break; }
+        case eINTMAX:   { intmax_t v = 0;     valid = valid && unpack( args, argsLen, idx, v ); if ( valid ) { n = snprintf( out, outSize, specBuf, v ); } break; }
+        case eDOUBLE:   { double v = 0;       valid = valid && unpack( args, argsLen, idx, v ); if ( valid ) { n = snprintf( out, outSize, specBuf, v ); } break; }
+        case eLDOUBLE:  { long double v = 0;  valid = valid && unpack( args, argsLen, idx, v ); if ( valid ) { n = snprintf( out, outSize, specBuf, v ); } break; }
+        case ePTR:      { void* v = nullptr;  valid = valid && unpack( args, argsLen, idx, v ); if ( valid ) { n = snprintf( out, outSize, specBuf, v ); } break; }
+        case eSTR:
+        {
+            const char* str    = (const char*) (args + idx);
+            const char* endStr = idx < argsLen ? (const char*) memchr( str, '\0', argsLen - idx ) : nullptr;
+            valid              = valid && endStr != nullptr;
+            if ( valid )
+            {
+                idx += (size_t) (endStr - str) + 1;
+                n    = snprintf( out, outSize, specBuf, str );
+            }
+            break;
+        }
+        default:
+            break;
+        }
+
+        if ( !valid )
+        {
+            break;  // Should never happen, i.e. the packed arguments do not match the format string
+        }
+        if ( n > 0 )
+        {
+            outLen += (size_t) n < outSize ? (size_t) n : outSize - 1;
+        }
+    }
+
+    dst[outLen] = '\0';
+}
+
+#endif  // end USE_CPL_LOGGING_DEFERRED_FORMATTING
@@ -16,8 +16,11 @@
     method directory for the logging framework
 */
 
+#include "colony_config.h"
+#include "Cpl/Logging/EntryData_T.h"
 #include <stdint.h>
 #include <stdarg.h>
+#include <stddef.h>
 
 ///
 namespace Cpl {
@@ -35,6 +38,36 @@ void createAndAddLogEntry_( uint32_t    category,
                             va_list     ap ) noexcept;
 
 
+#ifdef USE_CPL_LOGGING_DEFERRED_FORMATTING
+/** This method 'expands' a log entry whose formatting was deferred, i.e.
+    it formats the entry's 'msgText' and echoes the entry to the trace engine.
+    The method does nothing if the entry has already been expanded.
+
+    Note: The LogSink calls this method before dispatching an entry.  Any
+          other consumer of the log entry FIFO MUST call this method before
+          accessing the entry's text.
+ */
+void expandLogEntry_( EntryData_T& entry ) noexcept;
+
+/** This method 'packs' the printf arguments specified by 'format' into the
+    'dst' buffer.  The method returns false if the arguments do not fit in
+    the buffer or if 'format' contains an unsupported conversion (e.g. %n,
+    %ls).  On success, 'dstLen' is set to the number of bytes packed.
+
+    Note: The string arguments (i.e. %s) are copied into 'dst'.  When a
+          precision is specified (e.g. %.4s, %.*s) at most 'precision'
+          characters are copied, i.e. the source string does not need to be
+          null terminated.
+ */
+bool packArgs_( uint8_t* dst, size_t maxDstLen, size_t& dstLen, const char* format, va_list ap ) noexcept;
+
+/** This method formats - with printf semantics - the arguments packed by
+    packArgs_() into 'dst'.  The output is always null terminated.
+ */
+void formatPackedArgs_( char* dst, size_t dstSize, const char* format, const uint8_t* args, size_t argsLen ) noexcept;
+#endif
+
+
 
 };      // end namespaces
 };
@@ -0,0 +1,222 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+
+#include "Catch/catch.hpp"
+#include "Cpl/System/Trace.h"
+#include "Cpl/System/ElapsedTime.h"
+#include "Cpl/System/_testsupport/Shutdown_TS.h"
+#include "Cpl/Type/enum.h"
+#include "Cpl/Logging/Api.h"
+#include "Cpl/Logging/Private_.h"
+#include "Cpl/Dm/ModelDatabase.h"
+#include <stdio.h>
+#include <string.h>
+
+#define SECT_     "_0test"
+
+///
+using namespace Cpl::Logging;
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+// NOTE: The trace section for the category is NOT enabled, i.e. the benchmark does not measure the cost of the trace output
+BETTER_ENUM( BenchCategoryId, uint32_t, METRICS = 0x00000008 );
+BETTER_ENUM( MetricsMsg, uint16_t, SAMPLE );
+
+static void logf( MetricsMsg msgId, const char* msgTextFormat, ... ) noexcept
+{
+    va_list ap;
+    va_start( ap, msgTextFormat );
+    vlogf<BenchCategoryId, MetricsMsg>( BenchCategoryId::METRICS, msgId, msgTextFormat, ap );
+    va_end( ap );
+}
+
+static Cpl::Dm::ModelDatabase    benchModelDb_( "ignoreThisParameter_usedToInvokeTheStaticConstructor" );
+static Cpl::Dm::Mp::Uint32       mp_benchFifoCount( benchModelDb_, "benchFifoCount" );
+
+#define BENCH_FIFO_ENTRIES    (4+1)
+static Cpl::Logging::EntryData_T benchFifoMemory_[BENCH_FIFO_ENTRIES];
+static Cpl::Container::RingBufferMP<Cpl::Logging::EntryData_T> benchFifo_( BENCH_FIFO_ENTRIES, benchFifoMemory_, mp_benchFifoCount );
+
+
+////////////////////////////////////////////////////////////////////////////////
+#ifdef USE_CPL_LOGGING_DEFERRED_FORMATTING
+
+/// Packs and then formats the arguments. Returns false if the arguments could not be packed
+static bool formatDeferred( char* dst, size_t dstSize, size_t maxArgsLen, const char* format, ... )
+{
+    uint8_t args[OPTION_CPL_LOGGING_MAX_PACKED_ARGS_LEN * 4];
+    size_t  argsLen = 0;
+    va_list ap;
+    va_start( ap, format );
+    bool result = packArgs_( args, maxArgsLen, argsLen, format, ap );
+    va_end( ap );
+    if ( result )
+    {
+        formatPackedArgs_( dst, dstSize, format, args, argsLen );
+    }
+    return result;
+}
+
+#define MAX_ARGS_   (OPTION_CPL_LOGGING_MAX_PACKED_ARGS_LEN * 4)
+
+TEST_CASE( "deferred" )
+{
+    Cpl::System::Shutdown_TS::clearAndUseCounter();
+    char expected[128];
+    char actual[128];
+
+    SECTION( "integers" )
+    {
+        snprintf( expected, sizeof( expected ), "a=%d, b=%5u, c=%-4x|, d=%08lX, e=%lld, f=%hhd, g=%zu, h=%c", -1, 42u, 0xABu, 0xBEEFUL, -123456789012LL, 7, (size_t) 99, 'Z' );
+        REQUIRE( formatDeferred( actual, sizeof( actual ), MAX_ARGS_, "a=%d, b=%5u, c=%-4x|, d=%08lX, e=%lld, f=%hhd, g=%zu, h=%c", -1, 42u, 0xABu, 0xBEEFUL, -123456789012LL, 7, (size_t) 99, 'Z' ) );
+        REQUIRE( strcmp( expected, actual ) == 0 );
+    }
+
+    SECTION( "floats" )
+    {
+        snprintf( expected, sizeof( expected ), "%5.2f %e %g %Lf", 3.14159, 1.5e10, 0.25, (long double) 2.5 );
+        REQUIRE( formatDeferred( actual, sizeof( actual ), MAX_ARGS_, "%5.2f %e %g %Lf", 3.14159, 1.5e10, 0.25, (long double) 2.5 ) );
+        REQUIRE( strcmp( expected, actual ) == 0 );
+    }
+
+    SECTION( "strings/pointers/stars" )
+    {
+        const char* nullStr = nullptr;
+        snprintf( expected, sizeof( expected ), "[%s] [%-6s] [%.3s] [%*d] [%-*.*f] [%p] 100%%", "hello", "ab", "abcdef", 6, 12, 8, 2, 1.125, (void*) &expected );
+        REQUIRE( formatDeferred( actual, sizeof( actual ), MAX_ARGS_, "[%s] [%-6s] [%.3s] [%*d] [%-*.*f] [%p] 100%%", "hello", "ab", "abcdef", 6, 12, 8, 2, 1.125, (void*) &expected ) );
+        REQUIRE( strcmp( expected, actual ) == 0 );
+        REQUIRE( formatDeferred( actual, sizeof( actual ), MAX_ARGS_, "<%s>", nullStr ) );
+        REQUIRE( strcmp( "<(null)>", actual ) == 0 );
+    }
+
+    SECTION( "string precision" )
+    {
+        // Not null terminated
+        const char buf[4] ={ 'w', 'x', 'y', 'z' };
+        REQUIRE( formatDeferred( actual, sizeof( actual ), MAX_ARGS_, "[%.4s] [%.*s] [%-6.*s]", buf, 3, buf, 2, buf ) );
+        REQUIRE( strcmp( "[wxyz] [wxy] [wx    ]", actual ) == 0 );
+
+        // Only the 'precision' characters are packed
+        REQUIRE( formatDeferred( actual, sizeof( actual ), 5, "%.4s", "abcdefghijklmnopqrstuvwxyz" ) );
+        REQUIRE( strcmp( "abcd", actual ) == 0 );
+        REQUIRE( formatDeferred( actual, sizeof( actual ), 4 + 4, "%.*s", 3, "abcdefghijklmnopqrstuvwxyz" ) );
+        REQUIRE( strcmp( "abc", actual ) == 0 );
+
+        // Negative precision is ignored
+        REQUIRE( formatDeferred( actual, sizeof( actual ), MAX_ARGS_, "%.*s", -1, "abcdef" ) );
+        REQUIRE( strcmp( "abcdef", actual ) == 0 );
+    }
+
+    SECTION( "truncation" )
+    {
+        REQUIRE( formatDeferred( actual, 8, MAX_ARGS_, "%s-%d", "abcdef", 1234 ) );
+        REQUIRE( strcmp( "abcdef-", actual ) == 0 );
+        REQUIRE( formatDeferred( actual, 5, MAX_ARGS_, "%d", 123456 ) );
+        REQUIRE( strcmp( "1234", actual ) == 0 );
+    }
+
+    SECTION( "not packable" )
+    {
+        int count;
+        REQUIRE( formatDeferred( actual, sizeof( actual ), MAX_ARGS_, "%n", &count ) == false );
+        REQUIRE( formatDeferred( actual, sizeof( actual ), MAX_ARGS_, "%ls", L"wide" ) == false );
+        REQUIRE( formatDeferred( actual, sizeof( actual ), 4, "%d%d", 1, 2 ) == false );
+        REQUIRE( formatDeferred( actual, sizeof( actual ), 4, "%s", "abcd" ) == false );
+        REQUIRE( formatDeferred( actual, sizeof( actual ), 5, "%s", "abcd" ) == true );
+    }
+
+    SECTION( "log entry" )
+    {
+        initialize( benchFifo_, BenchCategoryId::METRICS, (+BenchCategoryId::METRICS)._to_string(), MetricsMsg::SAMPLE, (+MetricsMsg::SAMPLE)._to_string() );
+        EntryData_T entry;
+
+        // Deferred
+        logf( MetricsMsg::SAMPLE, "temp=%.1f, name=%s", 21.25, "sensor" );
+        REQUIRE( benchFifo_.remove( entry ) );
+        REQUIRE( entry.msgFormat != nullptr );
+        REQUIRE( entry.msgText[0] == '\0' );
+        expandLogEntry_( entry );
+        REQUIRE( entry.msgFormat == nullptr );
+        REQUIRE( entry.catIdText == nullptr );
+        REQUIRE( strcmp( entry.msgText, "temp=21.2, name=sensor" ) == 0 );
+
+        // A long string with a short precision is still deferred
+        char bigString[OPTION_CPL_LOGGING_MAX_PACKED_ARGS_LEN + 1];
+        memset( bigString, 'x', sizeof( bigString ) - 1 );
+        bigString[sizeof( bigString ) - 1] = '\0';
+        logf( MetricsMsg::SAMPLE, "%.4s", bigString );
+        REQUIRE( benchFifo_.remove( entry ) );
+        REQUIRE( entry.msgFormat != nullptr );
+        expandLogEntry_( entry );
+        REQUIRE( strcmp( entry.msgText, "xxxx" ) == 0 );
+
+        // Fallback to formatting when the entry is created
+        logf( MetricsMsg::SAMPLE, "%.4s%s", "abcdef", bigString );
+        REQUIRE( benchFifo_.remove( entry ) );
+        REQUIRE( entry.msgFormat == nullptr );
+        REQUIRE( strncmp( entry.msgText, "abcdxxxx", 8 ) == 0 );
+        expandLogEntry_( entry );
+        REQUIRE( strncmp( entry.msgText, "abcdxxxx", 8 ) == 0 );
+        shutdown();
+    }
+
+    REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 0u );
+}
+#endif  // end USE_CPL_LOGGING_DEFERRED_FORMATTING
+
+
+////////////////////////////////////////////////////////////////////////////////
+#define BENCH_NUM_CALLS_    200000
+
+#ifdef USE_CPL_LOGGING_DEFERRED_FORMATTING
+#define BENCH_MODE_         "deferred"
+#else
+#define BENCH_MODE_         "formatted"
+#endif
+
+TEST_CASE( "logger-benchmark", "[.bench]" )
+{
+    initialize( benchFifo_, BenchCategoryId::METRICS, (+BenchCategoryId::METRICS)._to_string(), MetricsMsg::SAMPLE, (+MetricsMsg::SAMPLE)._to_string() );
+    EntryData_T   entry;
+    unsigned long callerTime = 0;
+    unsigned long sinkTime   = 0;
+
+    // Caller side cost: create the log entry (the FIFO is drained after each call to keep it from overflowing)
+    unsigned long start = Cpl::System::ElapsedTime::milliseconds();
+    for ( unsigned i=0; i < BENCH_NUM_CALLS_; i++ )
+    {
+        logf( MetricsMsg::SAMPLE, "sample %u: temp=%.2f, state=%s, raw=0x%08X", i, 21.5 + i, "running", i * 7 );
+        benchFifo_.remove( entry );
+    }
+    callerTime = Cpl::System::ElapsedTime::deltaMilliseconds( start );
+
+#ifdef USE_CPL_LOGGING_DEFERRED_FORMATTING
+    // Sink side cost: formatting the deferred text (re-formats the last entry)
+    REQUIRE( entry.msgFormat != nullptr );
+    start = Cpl::System::ElapsedTime::milliseconds();
+    for ( unsigned i=0; i < BENCH_NUM_CALLS_; i++ )
+    {
+        formatPackedArgs_( entry.msgText, sizeof( entry.msgText ), entry.msgFormat, entry.msgArgs, entry.msgArgsLen );
+    }
+    sinkTime = Cpl::System::ElapsedTime::deltaMilliseconds( start );
+#endif
+
+    CPL_SYSTEM_TRACE_MSG( SECT_, ("%-9s: %u calls. caller=%lu ms (%lu ns/call), sink formatting=%lu ms (%lu ns/entry)",
+                                   BENCH_MODE_,
+                                   BENCH_NUM_CALLS_,
+                                   callerTime,
+                                   (unsigned long) (callerTime * 1000000ULL / BENCH_NUM_CALLS_),
+                                   sinkTime,
+                                   (unsigned long) (sinkTime * 1000000ULL / BENCH_NUM_CALLS_)) );
+    shutdown();
+}
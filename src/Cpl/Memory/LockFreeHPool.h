@@ -0,0 +1,111 @@
+#ifndef Cpl_Memory_LockFreeHPool_h_
+#define Cpl_Memory_LockFreeHPool_h_
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+/** @file */
+
+
+#include "Cpl/Memory/LockFreePool_.h"
+#include "Cpl/Memory/Aligned.h"
+
+///
+namespace Cpl {
+///
+namespace Memory {
+
+
+/** This template class defines a concrete Allocator that allocates its block
+	memory from the HEAP.  However, once the initial set of blocks are
+	allocated, no more heap operations are performed.  All of the memory is
+	aligned to size_t boundaries.
+
+	The allocator is THREAD SAFE and lock-free (see Cpl::Memory::LockFreePool_
+	for details).
+
+	NOTES:
+
+		1) If you only need memory for ONE instance - use AlignedClass structure
+		   in Aligned.h instead.
+
+		2) The class is multi-thread safe.  Releasing a block twice, or
+		   releasing a pointer that was not allocated by the pool, always
+		   generates a Cpl::System::FatalError call.
+
+		3) If the requested number of bytes on the allocate() method is greater
+		   than the block size (i.e. sizeof(T)), 0 is returned.
+
+		4) The class can be deleted. However, it is the responsibility of the
+		   Application to properly clean-up/release ALL outstanding block
+		   allocations before deleting the LockFreeHPool instance.
+
+
+	Template args: class "T" is the type of class to allocated
+ */
+
+template <class T>
+class LockFreeHPool : public Allocator
+{
+protected:
+	/// Allocate memory for the free stack links
+	LockFreePool_::Link_T*  m_links;
+
+	/// Allocate blocks
+	AlignedClass<T>*        m_blocks;
+
+	/// My Pool work object
+	LockFreePool_*          m_poolPtr;
+
+
+public:
+	/** Constructor.  When the 'fatalErrors' argument is set to true, memory errors
+		(e.g. out-of-memory) will generate a Cpl::System::FatalError call.
+	 */
+	LockFreeHPool( size_t maxNumBlocks, bool fatalErrors = false )
+		:m_links( new LockFreePool_::Link_T[maxNumBlocks] ),
+		m_blocks( new AlignedClass<T>[maxNumBlocks] ),
+		m_poolPtr( new LockFreePool_( m_links, sizeof( T ), sizeof( AlignedClass<T> ), maxNumBlocks, m_blocks, fatalErrors ) )
+	{
+	}
+
+
+	/// Destructor.
+	~LockFreeHPool()
+	{
+		delete m_poolPtr;
+		delete[] m_blocks;
+		delete[] m_links;
+	}
+
+
+public:
+	/// See Cpl::Memory::Allocator
+	void* allocate( size_t numbytes ) { return m_poolPtr->allocate( numbytes ); }
+
+	/// See Cpl::Memory::Allocator
+	void release( void *ptr ) { m_poolPtr->release( ptr ); }
+
+	/// See Cpl::Memory::Allocator
+	size_t wordSize() const noexcept { return m_poolPtr->wordSize(); }
+
+private:
+	/// Prevent access to the copy constructor -->LockFreeHPools can not be copied!
+	LockFreeHPool( const LockFreeHPool& m );
+
+	/// Prevent access to the assignment operator -->LockFreeHPools can not be copied!
+	const LockFreeHPool& operator=( const LockFreeHPool& m );
+
+};
+
+
+
+};      // end namespaces
+};
+#endif  // end header latch
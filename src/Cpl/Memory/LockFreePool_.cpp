@@ -0,0 +1,140 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+
+#include "LockFreePool_.h"
+#include "Cpl/System/FatalError.h"
+
+
+//
+using namespace Cpl::Memory;
+
+#define INDEX_MASK_     0xFFFFFFFFULL
+#define COUNT_INC_      (1ULL << 32)
+
+constexpr uint32_t LockFreePool_::END_OF_STACK_;
+constexpr uint32_t LockFreePool_::ALLOCATED_;
+constexpr uint32_t LockFreePool_::RELEASING_;
+
+
+/////////////////////////////
+LockFreePool_::LockFreePool_( Link_T links[], size_t blockSize, size_t alignedBlockSize, size_t numBlocks, void* arrayOfBlocks, bool fatalErrors )
+    : m_head( END_OF_STACK_ )
+    , m_links( links )
+    , m_blocks( (char*) arrayOfBlocks )
+    , m_blockSize( blockSize )
+    , m_alignedBlockSize( alignedBlockSize )
+    , m_numBlocks( numBlocks )
+    , m_fatalErrors( fatalErrors )
+{
+    // Trap possible errors
+    if ( !links )
+    {
+        Cpl::System::FatalError::logf( "Cpl::Memory::LockFreePool_::LockFreePool_().  No memory for links[]. Allocator=%p", this );
+    }
+    if ( !arrayOfBlocks )
+    {
+        Cpl::System::FatalError::logf( "Cpl::Memory::LockFreePool_::LockFreePool_().  No memory for arrayOfBlocks[]. Allocator=%p", this );
+    }
+    if ( numBlocks >= RELEASING_ )
+    {
+        Cpl::System::FatalError::logf( "Cpl::Memory::LockFreePool_::LockFreePool_().  Too many blocks (%p). Allocator=%p", (void*) numBlocks, this );
+    }
+
+    // Generate my free stack (lowest address block is on the top of the stack)
+    for ( size_t i=0; i < numBlocks; i++ )
+    {
+        m_links[i].store( i + 1 < numBlocks ? (uint32_t) (i + 1) : END_OF_STACK_, std::memory_order_relaxed );
+    }
+    m_head.store( numBlocks ? 0 : END_OF_STACK_, std::memory_order_release );
+}
+
+
+/////////////////////////////
+size_t LockFreePool_::wordSize() const noexcept
+{
+    return  m_alignedBlockSize;
+}
+
+void* LockFreePool_::allocate( size_t numbytes )
+{
+    // Trap requesting more memory than the block size
+    if ( numbytes > m_blockSize )
+    {
+        if ( m_fatalErrors )
+        {
+            Cpl::System::FatalError::logf( "Cpl::Memory::LockFreePool_::allocate().  Failed allocation: Requested size (%p) > block size (%p). Allocator=%p", (void*) numbytes, (void*) m_blockSize, this );
+        }
+        return 0;
+    }
+
+    // Pop the top of the free stack
+    uint64_t head = m_head.load( std::memory_order_acquire );
+    for ( ;;)
+    {
+        uint32_t idx = (uint32_t) (head & INDEX_MASK_);
+        if ( idx == END_OF_STACK_ )
+        {
+            if ( m_fatalErrors )
+            {
+                Cpl::System::FatalError::logf( "Cpl::Memory::LockFreePool_::allocate().  Out of memory/blocks (requested size=%p). Allocator=%p", (void*) numbytes, this );
+            }
+            return 0;
+        }
+
+        // Note: The 'next' link can be stale (i.e. another thread popped the block) - the modification count in the head detects this case
+        uint32_t next    = m_links[idx].load( std::memory_order_relaxed );
+        uint64_t newHead = ((head & ~INDEX_MASK_) + COUNT_INC_) | next;
+        if ( m_head.compare_exchange_weak( head, newHead, std::memory_order_acq_rel, std::memory_order_acquire ) )
+        {
+            m_links[idx].store( ALLOCATED_, std::memory_order_relaxed );
+            return m_blocks + idx * m_alignedBlockSize;
+        }
+    }
+}
+
+
+void LockFreePool_::release( void *ptr )
+{
+    // Handle the case of ptr == 0  \(per semantic of the Allocator interface)
+    if ( !ptr )
+    {
+        return;
+    }
+
+    // Map the pointer to its block index (the pointer must be the start of a block in my array of blocks)
+    if ( (char*) ptr >= m_blocks )
+    {
+        size_t offset = (size_t) ((char*) ptr - m_blocks);
+        if ( offset % m_alignedBlockSize == 0 && offset / m_alignedBlockSize < m_numBlocks )
+        {
+            // Claim the block (traps double frees)
+            uint32_t idx      = (uint32_t) (offset / m_alignedBlockSize);
+            uint32_t expected = ALLOCATED_;
+            if ( m_links[idx].compare_exchange_strong( expected, RELEASING_, std::memory_order_relaxed ) )
+            {
+                // Push the block onto the free stack
+                uint64_t head = m_head.load( std::memory_order_relaxed );
+                for ( ;;)
+                {
+                    m_links[idx].store( (uint32_t) (head & INDEX_MASK_), std::memory_order_relaxed );
+                    uint64_t newHead = ((head & ~INDEX_MASK_) + COUNT_INC_) | idx;
+                    if ( m_head.compare_exchange_weak( head, newHead, std::memory_order_release, std::memory_order_relaxed ) )
+                    {
+                        return;
+                    }
+                }
+            }
+        }
+    }
+
+    // If I get here than a pointer that I did NOT allocated is trying to released (this is bad!)
+    Cpl::System::FatalError::logf( "Cpl::Memory::LockFreePool_::release().  Freeing a pointer (%p) that was not previously allocated. Allocator=%p", ptr, this );
+}
@@ -0,0 +1,104 @@
+#ifndef Cpl_Memory_LockFreePool_x_h_
+#define Cpl_Memory_LockFreePool_x_h_
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+/** @file */
+
+#include "Cpl/Memory/Allocator.h"
+#include <stdint.h>
+#include <atomic>
+
+
+///
+namespace Cpl {
+///
+namespace Memory {
+
+
+/** This private concrete class implements a THREAD SAFE, lock-free Memory
+    Allocator using a pool of fixed size blocks.  The free blocks are stored
+    in a Treiber stack of block indexes, i.e. allocate() and release() are
+    O(1) and only require a single compare-and-swap operation (when there is
+    no contention).  The head of the stack contains a modification counter
+    to prevent the 'ABA' problem.
+
+    NOTE: The head of the stack is a 64bit atomic, i.e. the implementation is
+          only lock-free on targets that support a 64bit compare-and-swap
+          (e.g. x86 via cmpxchg8b, ARMv7-A/ARMv8 via ldrexd/strexd).  On
+          other targets (e.g. Cortex-M) std::atomic falls back to a lock.
+
+    The implementation relies on a sub-class to allocate the actual memory
+    for the blocks and for the 'next index' array.
+ */
+class LockFreePool_ : public Allocator
+{
+public:
+    /// Type for the 'next' links of the free stack
+    typedef std::atomic<uint32_t>   Link_T;
+
+public:
+    /// Constructor.
+    LockFreePool_( Link_T         links[],
+                   size_t         blockSize,
+                   size_t         alignedBlockSize,
+                   size_t         numBlocks,
+                   void*          arrayOfBlocks,
+                   bool           fatalErrors
+    );
+
+
+public:
+    /// See Cpl::Memory::Allocator
+    void* allocate( size_t numbytes );
+
+    /// See Cpl::Memory::Allocator
+    void release( void *ptr );
+
+    /// See Cpl::Memory::Allocator
+    size_t wordSize() const noexcept;
+
+protected:
+    /// Link value for the end of the free stack
+    static constexpr uint32_t   END_OF_STACK_ = 0xFFFFFFFF;
+
+    /// Link value for an allocated block
+    static constexpr uint32_t   ALLOCATED_    = 0xFFFFFFFE;
+
+    /// Link value for a block that is in the process of being released
+    static constexpr uint32_t   RELEASING_    = 0xFFFFFFFD;
+
+protected:
+    /// Head of the free stack: upper 32 bits is modification count, lower 32 bits is the block index
+    std::atomic<uint64_t>       m_head;
+
+    /// 'Next' link (block index) for each block
+    Link_T*                     m_links;
+
+    /// Start of the array of blocks
+    char*                       m_blocks;
+
+    /// Block size
+    size_t                      m_blockSize;
+
+    /// Block size
+    size_t                      m_alignedBlockSize;
+
+    /// Number of blocks
+    size_t                      m_numBlocks;
+
+    /// Flag that controls memory errors behavior
+    bool                        m_fatalErrors;
+};
+
+
+};      // end namespaces
+};
+#endif  // end header latch
@@ -0,0 +1,101 @@
+#ifndef Cpl_Memory_LockFreeSPool_h_
+#define Cpl_Memory_LockFreeSPool_h_
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+/** @file */
+
+
+#include "Cpl/Memory/LockFreePool_.h"
+#include "Cpl/Memory/Aligned.h"
+
+///
+namespace Cpl {
+///
+namespace Memory {
+
+
+/** This template class defines a concrete Allocator that STATICALLY allocates
+	all of its Memory and can allocate up to N instances of the specified Class.
+	All of the memory is aligned to size_t boundaries.
+
+	The allocator is THREAD SAFE and lock-free, i.e. it is intended for
+	pools that are shared across threads and/or ISRs where using a mutex is
+	not an option (see Cpl::Memory::LockFreePool_ for details).  Use SPool
+	when the pool is only accessed by a single thread (it has less per-block
+	overhead).
+
+	NOTES:
+
+		1) If you only need memory for ONE instance - use AlignedClass structure
+		   in Aligned.h instead.
+
+		2) The class is multi-thread safe.  Releasing a block twice, or
+		   releasing a pointer that was not allocated by the pool, always
+		   generates a Cpl::System::FatalError call.
+
+		3) If the requested number of bytes on the allocate() method is greater
+		   than the block size (i.e. sizeof(T)), 0 is returned.
+
+		4) The class can be deleted. However, it is the responsibility of the
+		   Application to properly clean-up/release ALL outstanding block
+		   allocations before deleting the LockFreeSPool instance.
+
+
+	Template args: class "T" is the type of class to allocated
+				   int   "N" is the number of instances that can be allocate
+ */
+
+template <class T, int N>
+class LockFreeSPool : public Allocator
+{
+protected:
+	/// Allocate blocks
+	AlignedClass<T>         m_blocks[N];
+
+	/// Allocate memory for the free stack links
+	LockFreePool_::Link_T   m_links[N];
+
+	/// My Pool work object
+	LockFreePool_           m_pool;
+
+public:
+	/** Constructor.  When the 'fatalErrors' argument is set to true, memory errors
+		(e.g. out-of-memory) will generate a Cpl::System::FatalError call. .
+	 */
+	LockFreeSPool( bool fatalErrors = false )
+		:m_pool( m_links, sizeof( T ), sizeof( AlignedClass<T> ), N, m_blocks, fatalErrors )
+	{
+	}
+
+public:
+	/// See Cpl::Memory::Allocator
+	void* allocate( size_t numbytes ) { return m_pool.allocate( numbytes ); }
+
+	/// See Cpl::Memory::Allocator
+	void release( void *ptr ) { m_pool.release( ptr ); }
+
+	/// See Cpl::Memory::Allocator
+	size_t wordSize() const noexcept { return m_pool.wordSize(); }
+
+private:
+	/// Prevent access to the copy constructor -->LockFreeSPools can not be copied!
+	LockFreeSPool( const LockFreeSPool& m );
+
+	/// Prevent access to the assignment operator -->LockFreeSPools can not be copied!
+	const LockFreeSPool& operator=( const LockFreeSPool& m );
+
+};
+
+
+
+};      // end namespaces
+};
+#endif  // end header latch
@@ -24,6 +24,9 @@ using namespace Cpl::Memory;
 Pool_::Pool_( BlockInfo_ infoBlocks[], size_t blockSize, size_t alignedBlockSize, size_t numBlocks, void* arrayOfBlocks, bool fatalErrors )
 	: m_blockSize( blockSize )
 	, m_alignedBlockSize( alignedBlockSize )
+	, m_infoBlocks( infoBlocks )
+	, m_blocks( (const char*) arrayOfBlocks )
+	, m_numBlocks( numBlocks )
 	, m_fatalErrors( fatalErrors )
 {
 	// Trap possible errors
@@ -105,19 +108,20 @@ void Pool_::release( void *ptr )
 		return;
 	}
 
-	// Check against my allocated list
-	BlockInfo_* infoPtr = m_allocatedList.first();
-	while ( infoPtr )
+	// Map the pointer to its block index (the pointer must be the start of a block in my array of blocks)
+	if ( (const char*) ptr >= m_blocks )
 	{
-		// Found in the allocated list -->move it the free list
-		if ( infoPtr->m_blockPtr == ptr )
+		size_t offset = (size_t) ((const char*) ptr - m_blocks);
+		if ( offset % m_alignedBlockSize == 0 && offset / m_alignedBlockSize < m_numBlocks )
 		{
-			m_allocatedList.remove( *infoPtr );
-			m_freeList.put( *infoPtr );
-			return;
+			// Still in the allocated list (i.e. not a double free) -->move it the free list
+			BlockInfo_& info = m_infoBlocks[offset / m_alignedBlockSize];
+			if ( m_allocatedList.remove( info ) )
+			{
+				m_freeList.put( info );
+				return;
+			}
 		}
-
-		infoPtr = m_allocatedList.next( *infoPtr );
 	}
 
 	// If I get here than a pointer that I did NOT allocated is trying to released (this is bad!)
@@ -25,6 +25,11 @@ namespace Memory {
 /** This private concrete class implements a Memory Allocator using a pool of
     fixed size blocks.  The implementation relies on a sub-class to allocate
     the actual memory for the blocks.
+
+    Both allocate() and release() are O(1), i.e. release() maps the pointer
+    to its BlockInfo_ instance using address arithmetic (the blocks are a
+    contiguous array and the infoBlocks[] array is 'parallel' to the array
+    of blocks).
  */
 
 class Pool_ : public Allocator
@@ -56,6 +61,15 @@ protected:
     /// Block size
     size_t                              m_alignedBlockSize;
 
+    /// Start of the BlockInfo_ array (same order as the array of blocks)
+    BlockInfo_*                         m_infoBlocks;
+
+    /// Start of the array of blocks
+    const char*                         m_blocks;
+
+    /// Number of blocks
+    size_t                              m_numBlocks;
+
     /// Flag that controls memory errors behavior
     bool                                m_fatalErrors;
 
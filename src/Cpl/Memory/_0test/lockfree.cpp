@@ -0,0 +1,363 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+
+#include "Catch/catch.hpp"
+#include "Cpl/Memory/LockFreeSPool.h"
+#include "Cpl/Memory/LockFreeHPool.h"
+#include "Cpl/Memory/SPool.h"
+#include "Cpl/System/Thread.h"
+#include "Cpl/System/Mutex.h"
+#include "Cpl/System/Api.h"
+#include "Cpl/System/Trace.h"
+#include "Cpl/System/_testsupport/Shutdown_TS.h"
+#include <atomic>
+#include <chrono>
+#include <stdlib.h>
+#include <string.h>
+
+
+#define SECT_   "_0test"
+
+///
+using namespace Cpl::Memory;
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+struct block_T
+{
+    uint32_t owner;
+    uint32_t seqnum;
+    char     data[56];
+};
+
+/// Stress test worker
+class Worker : public Cpl::System::Runnable
+{
+public:
+    ///
+    Allocator&          m_pool;
+    ///
+    Cpl::System::Mutex* m_lock;
+    ///
+    uint32_t            m_id;
+    ///
+    unsigned long       m_iterations;
+    ///
+    unsigned            m_maxHeld;
+    ///
+    unsigned long       m_errors;
+    ///
+    unsigned long       m_outOfMemory;
+    ///
+    std::atomic<bool>   m_done;
+
+    ///
+    Worker( Allocator& pool, uint32_t id, unsigned long iterations, unsigned maxHeld, Cpl::System::Mutex* lock=0 )
+        :m_pool( pool ), m_lock( lock ), m_id( id ), m_iterations( iterations ), m_maxHeld( maxHeld ), m_errors( 0 ), m_outOfMemory( 0 ), m_done( false )
+    {
+    }
+
+    ///
+    void* allocate()
+    {
+        if ( m_lock )
+        {
+            Cpl::System::Mutex::ScopeBlock criticalSection( *m_lock );
+            return m_pool.allocate( sizeof( block_T ) );
+        }
+        return m_pool.allocate( sizeof( block_T ) );
+    }
+
+    ///
+    void release( void* ptr )
+    {
+        if ( m_lock )
+        {
+            Cpl::System::Mutex::ScopeBlock criticalSection( *m_lock );
+            m_pool.release( ptr );
+            return;
+        }
+        m_pool.release( ptr );
+    }
+
+    /// Allocates a 'batch' of blocks, stamps them, and then verifies and releases them
+    void appRun()
+    {
+        block_T* held[16];
+        for ( unsigned long i=0; i < m_iterations; i++ )
+        {
+            unsigned numHeld = 1 + (i % m_maxHeld);
+            for ( unsigned j=0; j < numHeld; j++ )
+            {
+                held[j] = (block_T*) allocate();
+                if ( held[j] == 0 )
+                {
+                    m_outOfMemory++;
+                    numHeld = j;
+                    break;
+                }
+                held[j]->owner  = m_id;
+                held[j]->seqnum = (uint32_t) i;
+                memset( held[j]->data, (int) m_id, sizeof( held[j]->data ) );
+            }
+            for ( unsigned j=0; j < numHeld; j++ )
+            {
+                if ( held[j]->owner != m_id || held[j]->seqnum != (uint32_t) i || held[j]->data[sizeof( held[j]->data ) - 1] != (char) m_id )
+                {
+                    m_errors++;
+                }
+                release( held[j] );
+            }
+        }
+        m_done = true;
+    }
+};
+
+}; // end namespace
+
+#define NUM_WORKERS_        4
+#define MAX_HELD_           16
+
+static void runWorkers( Allocator& pool, unsigned long iterations, unsigned long& errors, unsigned long& outOfMemory, Cpl::System::Mutex* lock=0 )
+{
+    Worker*              workers[NUM_WORKERS_];
+    Cpl::System::Thread* threads[NUM_WORKERS_];
+    for ( unsigned i=0; i < NUM_WORKERS_; i++ )
+    {
+        workers[i] = new Worker( pool, i + 1, iterations, MAX_HELD_, lock );
+        threads[i] = Cpl::System::Thread::create( *workers[i], "WORKER" );
+    }
+
+    errors      = 0;
+    outOfMemory = 0;
+    for ( unsigned i=0; i < NUM_WORKERS_; i++ )
+    {
+        while ( !workers[i]->m_done )
+        {
+            Cpl::System::Api::sleep( 1 );
+        }
+        Cpl::System::Thread::destroy( *threads[i] );
+        errors      += workers[i]->m_errors;
+        outOfMemory += workers[i]->m_outOfMemory;
+        delete workers[i];
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_CASE( "lockfree", "[lockfree]" )
+{
+    Cpl::System::Shutdown_TS::clearAndUseCounter();
+
+    SECTION( "static" )
+    {
+        LockFreeSPool<block_T, 3> uut( true );
+        REQUIRE( uut.wordSize() == sizeof( AlignedClass<block_T> ) );
+
+        void* p1 = uut.allocate( sizeof( block_T ) );
+        void* p2 = uut.allocate( sizeof( block_T ) );
+        void* p3 = uut.allocate( 1 );
+        REQUIRE( p1 != 0 );
+        REQUIRE( p2 != 0 );
+        REQUIRE( p3 != 0 );
+        REQUIRE( p1 != p2 );
+        REQUIRE( p2 != p3 );
+        REQUIRE( ((size_t) p1) % sizeof( size_t ) == 0 );
+        REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 0u );
+
+        // Out of memory
+        REQUIRE( uut.allocate( sizeof( block_T ) ) == 0 );
+        REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 1u );
+
+        // Too big
+        uut.release( p3 );
+        REQUIRE( uut.allocate( sizeof( block_T ) + 1 ) == 0 );
+        REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 1u );
+
+        // Last-released is the next allocated
+        REQUIRE( uut.allocate( sizeof( block_T ) ) == p3 );
+        REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 0u );
+
+        // Null pointer
+        uut.release( 0 );
+        REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 0u );
+
+        // Double free
+        uut.release( p2 );
+        REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 0u );
+        uut.release( p2 );
+        REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 1u );
+
+        // Foreign and misaligned pointers
+        block_T foreign;
+        uut.release( &foreign );
+        REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 1u );
+        uut.release( ((char*) p1) + 1 );
+        REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 1u );
+
+        uut.release( p1 );
+        uut.release( p3 );
+        REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 0u );
+
+        // All blocks are available
+        REQUIRE( uut.allocate( 1 ) != 0 );
+        REQUIRE( uut.allocate( 1 ) != 0 );
+        REQUIRE( uut.allocate( 1 ) != 0 );
+        REQUIRE( uut.allocate( 1 ) == 0 );
+        REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 1u );
+    }
+
+    SECTION( "heap" )
+    {
+        LockFreeHPool<block_T> uut( 2 );
+        void* p1 = uut.allocate( sizeof( block_T ) );
+        void* p2 = uut.allocate( sizeof( block_T ) );
+        REQUIRE( p1 != 0 );
+        REQUIRE( p2 != 0 );
+
+        // No fatal errors for out-of-memory/too-big
+        REQUIRE( uut.allocate( sizeof( block_T ) ) == 0 );
+        REQUIRE( uut.allocate( sizeof( block_T ) + 1 ) == 0 );
+        REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 0u );
+
+        // Invalid releases are always fatal
+        uut.release( p1 );
+        uut.release( p1 );
+        REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 1u );
+        uut.release( p2 );
+        REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 0u );
+    }
+
+    SECTION( "threads" )
+    {
+        // Pool is large enough to hold all of the blocks for all of the workers
+        LockFreeHPool<block_T> uut( NUM_WORKERS_ * MAX_HELD_ );
+        unsigned long          errors;
+        unsigned long          outOfMemory;
+        runWorkers( uut, 20000, errors, outOfMemory );
+        REQUIRE( errors == 0 );
+        REQUIRE( outOfMemory == 0 );
+
+        // Pool is too small -->contention for blocks
+        LockFreeHPool<block_T> small( MAX_HELD_ );
+        runWorkers( small, 20000, errors, outOfMemory );
+        REQUIRE( errors == 0 );
+
+        // All blocks were returned
+        void* ptrs[MAX_HELD_];
+        for ( unsigned i=0; i < MAX_HELD_; i++ )
+        {
+            ptrs[i] = small.allocate( 1 );
+            REQUIRE( ptrs[i] != 0 );
+        }
+        REQUIRE( small.allocate( 1 ) == 0 );
+        for ( unsigned i=0; i < MAX_HELD_; i++ )
+        {
+            small.release( ptrs[i] );
+        }
+    }
+
+    REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 0u );
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+typedef std::chrono::steady_clock Clock_T;
+
+#define BENCH_NUM_BLOCKS_   4096
+#define BENCH_PAIRS_        200000
+
+/// Prevents the compiler from eliding the allocate/release pairs
+static void* volatile sink_;
+
+static uint64_t nowUsec()
+{
+    return (uint64_t) std::chrono::duration_cast<std::chrono::microseconds>(Clock_T::now().time_since_epoch()).count();
+}
+
+/** Measures the cost of an allocate+release pair when the pool has
+    'outstanding' blocks allocated.  The release order is the worst case for
+    a linear search of the allocated blocks.
+ */
+static void benchOccupancy( const char* label, Allocator& pool, unsigned outstanding )
+{
+    void** held = new void*[outstanding];
+    for ( unsigned i=0; i < outstanding; i++ )
+    {
+        held[i] = pool.allocate( sizeof( block_T ) );
+        REQUIRE( held[i] != 0 );
+    }
+
+    uint64_t start = nowUsec();
+    for ( unsigned long i=0; i < BENCH_PAIRS_; i++ )
+    {
+        void* ptr = pool.allocate( sizeof( block_T ) );
+        sink_     = ptr;
+        pool.release( ptr );
+    }
+    uint64_t elapsed = nowUsec() - start;
+    CPL_SYSTEM_TRACE_MSG( SECT_, ("%-14s outstanding=%4u: %7.1f ns/pair", label, outstanding, (elapsed * 1000.0) / BENCH_PAIRS_) );
+
+    for ( unsigned i=0; i < outstanding; i++ )
+    {
+        pool.release( held[i] );
+    }
+    delete[] held;
+}
+
+/// Allocator that uses the heap
+class MallocAllocator : public Allocator
+{
+public:
+    ///
+    void* allocate( size_t numbytes ) { return malloc( numbytes ); }
+    ///
+    void release( void *ptr ) { free( ptr ); }
+    ///
+    size_t wordSize() const noexcept { return sizeof( size_t ); }
+};
+
+TEST_CASE( "lockfree-bench", "[.bench]" )
+{
+    Cpl::System::Shutdown_TS::clearAndUseCounter();
+    SPool<block_T, BENCH_NUM_BLOCKS_>*         spool    = new SPool<block_T, BENCH_NUM_BLOCKS_>( true );
+    LockFreeSPool<block_T, BENCH_NUM_BLOCKS_>* lockfree = new LockFreeSPool<block_T, BENCH_NUM_BLOCKS_>( true );
+    MallocAllocator                            heap;
+
+    static const unsigned occupancy[] ={ 0, 64, 1024, 4000 };
+    for ( unsigned i=0; i < sizeof( occupancy ) / sizeof( occupancy[0] ); i++ )
+    {
+        benchOccupancy( "SPool", *spool, occupancy[i] );
+        benchOccupancy( "LockFreeSPool", *lockfree, occupancy[i] );
+        benchOccupancy( "malloc/free", heap, occupancy[i] );
+    }
+
+    // Multi-threaded: lock-free vs. mutex protected
+    unsigned long       errors;
+    unsigned long       outOfMemory;
+    Cpl::System::Mutex  lock;
+    uint64_t            start = nowUsec();
+    runWorkers( *lockfree, BENCH_PAIRS_ / 8, errors, outOfMemory );
+    uint64_t            elapsed = nowUsec() - start;
+    REQUIRE( errors == 0 );
+    CPL_SYSTEM_TRACE_MSG( SECT_, ("%u threads, LockFreeSPool:     %lu us", NUM_WORKERS_, (unsigned long) elapsed) );
+    start = nowUsec();
+    runWorkers( *spool, BENCH_PAIRS_ / 8, errors, outOfMemory, &lock );
+    elapsed = nowUsec() - start;
+    REQUIRE( errors == 0 );
+    CPL_SYSTEM_TRACE_MSG( SECT_, ("%u threads, SPool+Mutex:       %lu us", NUM_WORKERS_, (unsigned long) elapsed) );
+
+    delete lockfree;
+    delete spool;
+    REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 0u );
+}
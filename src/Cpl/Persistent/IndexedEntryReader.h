@@ -13,6 +13,7 @@
 /** @file */
 
 #include "Cpl/Persistent/Payload.h"
+#include "Cpl/Type/Traverser.h"
 #include <stdint.h>
 
 ///
@@ -49,6 +50,26 @@ public:
         size_t   mediaOffset;       //!< Offset, within a RegionMedia to the start of the Entry
     } EntryMarker_T;
 
+public:
+    /** This abstract class defines the client callback interface for
+        traversing a range of entries (see getRange()).
+     */
+    class EntryVisitor
+    {
+    public:
+        /// Virtual Destructor
+        virtual ~EntryVisitor() {}
+
+    public:
+        /** This method is called once for every valid entry in the requested
+            range.  When called, the entry has been read into the 'dst' Payload
+            instance that was passed to getRange().  The return code from the
+            method is used by the traverser to continue the traversal
+            (eCONTINUE), or abort the traversal (eABORT).
+         */
+        virtual Cpl::Type::Traverser::Status_T item( const EntryMarker_T& entryMarker ) noexcept = 0;
+    };
+
 public:
     /** This method reads/retrieves the latest entry (from the list of Indexed
         Entries) stored in the persistent media.  The method is synchronous in
@@ -93,6 +114,26 @@ public:
                               Payload&             dst,
                               EntryMarker_T&       entryMarker ) noexcept = 0;
 
+public:
+    /** This method traverses all of the entries whose index value is greater
+        than 'newerThan' AND less than 'olderThan'.  The entries are visited
+        oldest to newest, or newest to oldest when 'newestFirst' is true.  The
+        traversal is a single sequential pass over the persistent media, i.e.
+        it is more efficient than repeated getNext()/getPrevious() calls.
+        For each entry visited, the entry is read into 'dst' and then the
+        'visitor' is called.
+
+        Returns the number of entries visited.
+
+        NOTE: 'dst' is ALWAYS updated EVEN if no entry was 'found', basically 'dst'
+              is used as a work buffer when traversing the list.
+     */
+    virtual size_t getRange( uint64_t       newerThan,
+                             uint64_t       olderThan,
+                             Payload&       dst,
+                             EntryVisitor&  visitor,
+                             bool           newestFirst = false ) noexcept = 0;
+
 public:
     /** This method can be used to read an entry by its 'buffer index'.  The
         buffer index is a zero based index. 
@@ -25,7 +25,9 @@ IndexedEntryRecord::IndexedEntryRecord( Chunk&                  entryChunkHandle
                                         size_t                  singleEntrySizeInBytes,
                                         RegionMedia&            entryRegion,
                                         IndexRecord&            secondaryRecord,
-                                        Cpl::Dm::Mp::Uint64&    mpForLatestIndexValue ) noexcept
+                                        Cpl::Dm::Mp::Uint64&    mpForLatestIndexValue,
+                                        uint64_t*               sparseIndexMemory,
+                                        size_t                  numSparseIndexElements ) noexcept
     : DataRecord( entryChunkHandler )
     , m_mpIndex( mpForLatestIndexValue )
     , m_indexRecord( secondaryRecord )
@@ -34,8 +36,18 @@ IndexedEntryRecord::IndexedEntryRecord( Chunk&                  entryChunkHandle
     , m_entrySize( singleEntrySizeInBytes + getMetadataLength() + entryChunkHandler.getMetadataLength() )
     , m_maxEntries( entryRegion.getRegionLength() / ( m_entrySize ) )
     , m_maxOffset( ( m_maxEntries - 1 ) * m_entrySize )
+    , m_sparseIndex( numSparseIndexElements > 0 ? sparseIndexMemory : 0 )
+    , m_sparseNumElems( 0 )
+    , m_sparseStride( 0 )
 {
     CPL_SYSTEM_ASSERT( m_maxEntries >= 1 );
+
+    // Sample every Nth entry slot such that the entire region is covered by the sparse index
+    if ( m_sparseIndex )
+    {
+        m_sparseStride   = ( m_maxEntries + numSparseIndexElements - 1 ) / numSparseIndexElements;
+        m_sparseNumElems = ( m_maxEntries + m_sparseStride - 1 ) / m_sparseStride;
+    }
 }
 
 void IndexedEntryRecord::start( Cpl::Dm::MailboxServer& myMbox ) noexcept
@@ -53,6 +65,7 @@ void IndexedEntryRecord::start( Cpl::Dm::MailboxServer& myMbox ) noexcept
 
     // Get my head/tail pointers
     m_indexRecord.readFromMedia();  // NOTE: If the Index data is corrupt, then the Index record was 'reset' and the head pointer is set to zero
+    buildSparseIndex();
     verifyIndex();
     m_mpIndex.write( m_latestTimestamp );
 }
@@ -115,6 +128,27 @@ bool IndexedEntryRecord::getNext( uint64_t                                  newe
     // Set the starting offset to on where to begin the search
     size_t offset = incrementOffset( beginHereMarker.mediaOffset );
 
+    // Use the sparse index (when enabled) to seek to the next entry
+    if ( m_sparseIndex )
+    {
+        // Typical use case: the next entry immediately follows the marker
+        if ( getByOffset( offset, dst, entryMarker ) && m_entryTimestamp == newerThan + 1 )
+        {
+            return true;
+        }
+
+        size_t numEntries;
+        offset = seekForward( newerThan, numEntries );
+        for ( ; numEntries > 0; numEntries--, offset = incrementOffset( offset ) )
+        {
+            if ( getByOffset( offset, dst, entryMarker ) && m_entryTimestamp > newerThan )
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
     // Loop through all possible entries
     for ( size_t i=0; i < m_maxEntries - 1; i++, offset = incrementOffset( offset ) )
     {
@@ -136,6 +170,27 @@ bool IndexedEntryRecord::getPrevious( uint64_t
     // Set the starting offset to on where to begin the search
     size_t offset = decrementOffset( beginHereMarker.mediaOffset );
 
+    // Use the sparse index (when enabled) to seek to the previous entry
+    if ( m_sparseIndex )
+    {
+        // Typical use case: the previous entry immediately precedes the marker
+        if ( olderThan > 0 && getByOffset( offset, dst, entryMarker ) && m_entryTimestamp == olderThan - 1 )
+        {
+            return true;
+        }
+
+        size_t numEntries;
+        offset = seekBackward( olderThan, numEntries );
+        for ( ; numEntries > 0; numEntries--, offset = decrementOffset( offset ) )
+        {
+            if ( getByOffset( offset, dst, entryMarker ) && m_entryTimestamp < olderThan )
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
     // Loop through all possible entries
     for ( size_t i=0; i < m_maxEntries - 1; i++, offset = decrementOffset( offset ) )
     {
@@ -176,6 +231,62 @@ size_t IndexedEntryRecord::getMaxIndex() const noexcept
     return m_maxEntries - 1;
 }
 
+size_t IndexedEntryRecord::getRange( uint64_t                               newerThan,
+                                     uint64_t                               olderThan,
+                                     Payload&                               dst,
+                                     IndexedEntryReader::EntryVisitor&      visitor,
+                                     bool                                   newestFirst ) noexcept
+{
+    IndexedEntryReader::EntryMarker_T marker;
+    size_t                            numVisited = 0;
+    size_t                            numEntries;
+
+    // Oldest to newest
+    if ( !newestFirst )
+    {
+        size_t offset = seekForward( newerThan, numEntries );
+        for ( ; numEntries > 0; numEntries--, offset = incrementOffset( offset ) )
+        {
+            if ( getByOffset( offset, dst, marker ) && m_entryTimestamp > newerThan )
+            {
+                // Stop once the end of the range has been reached (the entries are stored in index value order)
+                if ( m_entryTimestamp >= olderThan )
+                {
+                    break;
+                }
+                numVisited++;
+                if ( visitor.item( marker ) == Cpl::Type::Traverser::eABORT )
+                {
+                    break;
+                }
+            }
+        }
+    }
+
+    // Newest to oldest
+    else
+    {
+        size_t offset = seekBackward( olderThan, numEntries );
+        for ( ; numEntries > 0; numEntries--, offset = decrementOffset( offset ) )
+        {
+            if ( getByOffset( offset, dst, marker ) && m_entryTimestamp < olderThan )
+            {
+                if ( m_entryTimestamp <= newerThan )
+                {
+                    break;
+                }
+                numVisited++;
+                if ( visitor.item( marker ) == Cpl::Type::Traverser::eABORT )
+                {
+                    break;
+                }
+            }
+        }
+    }
+
+    return numVisited;
+}
+
 bool IndexedEntryRecord::getByOffset( size_t                                offset,
                                       Payload&                              dst,
                                       IndexedEntryReader::EntryMarker_T&    entryMarker ) noexcept
@@ -215,7 +326,9 @@ bool IndexedEntryRecord::addEntry( const Payload& src ) noexcept
     m_entryPayloadHandlerPtr = (Payload*) ( &src );
 
     // Write the entry
-    return writeToMedia( m_latestOffset );
+    bool result = writeToMedia( m_latestOffset );
+    updateSparseIndex( m_latestOffset, result ? m_latestTimestamp : 0 );
+    return result;
 }
 
 bool IndexedEntryRecord::clearAllEntries() noexcept
@@ -238,8 +351,13 @@ bool IndexedEntryRecord::clearAllEntries() noexcept
     // If there was an error -->try our best to recover the actual head pointer
     if ( !result )
     {
+        buildSparseIndex();
         scanAllEntries();
     }
+    else if ( m_sparseIndex )
+    {
+        memset( m_sparseIndex, 0, m_sparseNumElems * sizeof( uint64_t ) );
+    }
 
     // Update the index record in persistent storage
     m_indexRecord.setLatestOffset( m_latestOffset, m_latestTimestamp );
@@ -315,8 +433,16 @@ bool IndexedEntryRecord::putData( const void* src, size_t srcLen ) noexcept
 ////////////////////////////////////////
 void IndexedEntryRecord::scanAllEntries()
 {
-    m_latestOffset    = 0;
-    m_latestTimestamp = 0;
+    // Only interested in the timestamp/meta-data
+    m_entryPayloadHandlerPtr = 0;
+    m_latestOffset           = 0;
+    m_latestTimestamp        = 0;
+
+    // Use the sparse index (when enabled) to limit the number entries read
+    if ( scanSparseEntries() )
+    {
+        return;
+    }
 
     for ( size_t offset = 0; offset <= m_maxOffset; offset += m_entrySize )
     {
@@ -331,3 +457,180 @@ void IndexedEntryRecord::scanAllEntries()
     }
 }
 
+bool IndexedEntryRecord::scanSparseEntries() noexcept
+{
+    if ( m_sparseIndex == 0 )
+    {
+        return false;
+    }
+
+    // Find the newest sparse index element
+    size_t newest = 0;
+    for ( size_t i=1; i < m_sparseNumElems; i++ )
+    {
+        if ( m_sparseIndex[i] > m_sparseIndex[newest] )
+        {
+            newest = i;
+        }
+    }
+    if ( m_sparseIndex[newest] == 0 )
+    {
+        return false;
+    }
+
+    // The latest entry is located between the newest element and the next valid element (which is older)
+    m_latestTimestamp = m_sparseIndex[newest];
+    m_latestOffset    = newest * m_sparseStride * m_entrySize;
+    size_t offset     = incrementOffset( m_latestOffset );
+    for ( size_t i=1; i < m_maxEntries; i++, offset = incrementOffset( offset ) )
+    {
+        size_t slot = offset / m_entrySize;
+        if ( slot % m_sparseStride == 0 && m_sparseIndex[slot / m_sparseStride] != 0 )
+        {
+            break;
+        }
+        if ( readFromMedia( offset ) && m_entryTimestamp > m_latestTimestamp )
+        {
+            m_latestTimestamp = m_entryTimestamp;
+            m_latestOffset    = offset;
+        }
+    }
+
+    return true;
+}
+
+////////////////////////////////////////
+void IndexedEntryRecord::buildSparseIndex() noexcept
+{
+    if ( m_sparseIndex )
+    {
+        // Only interested in the timestamp/meta-data
+        m_entryPayloadHandlerPtr = 0;
+        for ( size_t i=0; i < m_sparseNumElems; i++ )
+        {
+            m_sparseIndex[i] = readFromMedia( i * m_sparseStride * m_entrySize ) ? m_entryTimestamp : 0;
+        }
+    }
+}
+
+void IndexedEntryRecord::updateSparseIndex( size_t offset, uint64_t indexValue ) noexcept
+{
+    if ( m_sparseIndex )
+    {
+        size_t slot = offset / m_entrySize;
+        if ( slot % m_sparseStride == 0 )
+        {
+            m_sparseIndex[slot / m_sparseStride] = indexValue;
+        }
+    }
+}
+
+size_t IndexedEntryRecord::getSlotAge( size_t offset ) const noexcept
+{
+    // The oldest slot is the slot immediately after latest entry
+    size_t oldestSlot = ( m_latestOffset / m_entrySize + 1 ) % m_maxEntries;
+    return ( offset / m_entrySize + m_maxEntries - oldestSlot ) % m_maxEntries;
+}
+
+size_t IndexedEntryRecord::getSparseOffset( size_t ageOrder ) const noexcept
+{
+    // The oldest element is the element immediately after the element that contains the latest entry
+    size_t newestElem = ( m_latestOffset / m_entrySize ) / m_sparseStride;
+    return ( ( newestElem + 1 + ageOrder ) % m_sparseNumElems ) * m_sparseStride * m_entrySize;
+}
+
+uint64_t IndexedEntryRecord::getSparseValue( size_t ageOrder ) const noexcept
+{
+    return m_sparseIndex[getSparseOffset( ageOrder ) / m_entrySize / m_sparseStride];
+}
+
+size_t IndexedEntryRecord::findFirstNewer( uint64_t indexValue ) const noexcept
+{
+    // Binary search (in age order).  Note: Invalid elements (i.e. zero) are treated as the oldest elements
+    size_t lo = 0;
+    size_t hi = m_sparseNumElems;
+    while ( lo < hi )
+    {
+        size_t mid = lo + ( hi - lo ) / 2;
+        if ( getSparseValue( mid ) > indexValue )
+        {
+            hi = mid;
+        }
+        else
+        {
+            lo = mid + 1;
+        }
+    }
+    return lo;
+}
+
+size_t IndexedEntryRecord::getSparseBoundary( size_t firstValid ) const noexcept
+{
+    // Invalid elements that precede the first valid element are unused entry slots, i.e. the
+    // oldest valid entry is located at/after the element immediately preceding the first valid element
+    return firstValid == 0 ? incrementOffset( m_latestOffset ) : getSparseOffset( firstValid - 1 );
+}
+
+size_t IndexedEntryRecord::seekForward( uint64_t newerThan, size_t& numEntries ) const noexcept
+{
+    // Without a sparse index -->start with the oldest entry slot
+    if ( m_sparseIndex == 0 )
+    {
+        numEntries = m_maxEntries;
+        return incrementOffset( m_latestOffset );
+    }
+
+    // Start with the newest valid element that is NOT newer than 'newerThan'
+    size_t firstValid = findFirstNewer( 0 );
+    size_t start      = findFirstNewer( newerThan );
+    while ( start > firstValid && ( getSparseValue( start - 1 ) == 0 || getSparseValue( start - 1 ) > newerThan ) )
+    {
+        start--;    // Skip over corrupt elements
+    }
+
+    size_t offset = start > firstValid ? getSparseOffset( start - 1 ) : getSparseBoundary( firstValid );
+    numEntries    = m_maxEntries - getSlotAge( offset );
+    return offset;
+}
+
+size_t IndexedEntryRecord::seekBackward( uint64_t olderThan, size_t& numEntries ) const noexcept
+{
+    // Without a sparse index -->start with the latest entry slot
+    if ( m_sparseIndex == 0 )
+    {
+        numEntries = m_maxEntries;
+        return m_latestOffset;
+    }
+
+    // Nothing is older than zero
+    numEntries = 0;
+    if ( olderThan == 0 )
+    {
+        return m_latestOffset;
+    }
+
+    // Start immediately before the oldest valid element that is NOT older than 'olderThan'
+    size_t firstValid = findFirstNewer( 0 );
+    size_t end        = findFirstNewer( olderThan - 1 );
+    for ( size_t i=end; i > firstValid; i-- )
+    {
+        uint64_t value = getSparseValue( i - 1 );
+        if ( value != 0 )
+        {
+            if ( value < olderThan )
+            {
+                break;
+            }
+            end = i - 1;    // Skip over corrupt elements
+        }
+    }
+
+    size_t endAge   = end == m_sparseNumElems ? m_maxEntries : getSlotAge( getSparseOffset( end ) );
+    size_t startAge = getSlotAge( getSparseBoundary( firstValid ) );
+    if ( endAge > startAge )
+    {
+        numEntries = endAge - startAge;
+    }
+    return end == m_sparseNumElems ? m_latestOffset : decrementOffset( getSparseOffset( end ) );
+}
+
@@ -46,18 +46,45 @@ namespace Persistent {
     running counter that is used to determine the relative age between entries.
     The larger an 'index value' is, the newer the entry is.
 
+    An optional in-RAM 'sparse index' can be enabled by providing memory for
+    it when the record is constructed.  The sparse index stores the index
+    value of every Nth entry slot in the RegionMedia (the slot's offset is
+    implied by its position in the sparse index), where N is the number of
+    entry slots divided by the number of sparse index elements (rounded up).
+    The sparse index is built once when the record is started (which requires
+    reading every Nth entry) and it is then maintained by addEntry().  When
+    enabled:
+        o getNext(), getPrevious(), and getRange() seek to an index value
+          using a binary search of the sparse index, i.e. at most ~N entries
+          are read from the media instead of the entire region.
+        o The scan to recover the head pointer at start-up (when the index
+          record is corrupt/out-of-sync with the entries) only reads the
+          entries between the two sparse index elements that bracket the
+          newest entry.
+        o The 'beginHereMarker' passed to getNext()/getPrevious() is only
+          used as a hint, i.e. the methods return the oldest entry newer than
+          'newerThan' (or the newest entry older than 'olderThan').
+
+    NOTE: The sparse index relies on the entries being stored in the Ring
+          Buffer in index value order (which is guaranteed by addEntry()).
+
     NOTE: This interface/class is NOT THREAD SAFE and should only be 'used' from
           the Record Server's thread.
  */
 class IndexedEntryRecord : public DataRecord
 {
 public:
-    /// Constructor.
+    /** Constructor.  The sparse index is enabled by specifying a non-zero
+        'sparseIndexMemory' and 'numSparseIndexElements'.  The memory must
+        stay in scope for the lifetime of the record.
+     */
     IndexedEntryRecord( Chunk&                  entryChunkHandler,
                         size_t                  singleEntrySizeInBytes,
                         RegionMedia&            entryRegion,
                         IndexRecord&            secondaryRecord,
-                        Cpl::Dm::Mp::Uint64&    mpForLatestIndexValue ) noexcept;
+                        Cpl::Dm::Mp::Uint64&    mpForLatestIndexValue,
+                        uint64_t*               sparseIndexMemory = 0,
+                        size_t                  numSparseIndexElements = 0 ) noexcept;
 
 public:
     /// See Cpl::Persistent::Record
@@ -108,6 +135,20 @@ public:
     /// See Cpl::Persistent::IndexedEntryReader
     size_t getMaxIndex() const noexcept;
 
+    /// See Cpl::Persistent::IndexedEntryReader
+    size_t getRange( uint64_t                               newerThan,
+                     uint64_t                               olderThan,
+                     Payload&                               dst,
+                     IndexedEntryReader::EntryVisitor&      visitor,
+                     bool                                   newestFirst = false ) noexcept;
+
+public:
+    /// Returns true if the in-RAM sparse index is enabled
+    inline bool isSparseIndexEnabled() const noexcept { return m_sparseIndex != 0; }
+
+    /// Returns the number of entry slots between sparse index elements (returns zero if the sparse index is NOT enabled)
+    inline size_t getSparseIndexStride() const noexcept { return m_sparseStride; }
+
 protected:
     /// Helper method: Verifies the 'correctness' of the index/head pointer and 'fixes' the head pointer if it is 'bad'
     void verifyIndex() noexcept;
@@ -121,6 +162,42 @@ protected:
     /// Helper method: 'decrements' the offset by the size of entry (and handles the 'roll-over' case)
     size_t decrementOffset( size_t offsetToDecrement ) const noexcept;
 
+    /// Helper method: reads the sparse index values from the media
+    void buildSparseIndex() noexcept;
+
+    /// Helper method: updates the sparse index (if the entry slot at 'offset' is sampled by the sparse index)
+    void updateSparseIndex( size_t offset, uint64_t indexValue ) noexcept;
+
+    /// Helper method: scans the entries bracketed by the newest sparse index element. Returns false if the sparse index contains no valid entries
+    bool scanSparseEntries() noexcept;
+
+    /** Helper method: returns the offset to begin a forward traversal for entries
+        newer than 'newerThan'.  'numEntries' is set to number of entry slots
+        from the returned offset through the latest entry.
+     */
+    size_t seekForward( uint64_t newerThan, size_t& numEntries ) const noexcept;
+
+    /** Helper method: returns the offset to begin a backward traversal for entries
+        older than 'olderThan'.  'numEntries' is set to number of entry slots
+        from the returned offset back through the oldest entry slot.
+     */
+    size_t seekBackward( uint64_t olderThan, size_t& numEntries ) const noexcept;
+
+    /// Helper method: returns the relative age of an entry slot, i.e. zero is the oldest slot and m_maxEntries-1 is the latest slot
+    size_t getSlotAge( size_t offset ) const noexcept;
+
+    /// Helper method: returns the offset of the entry slot for the Nth oldest sparse index element
+    size_t getSparseOffset( size_t ageOrder ) const noexcept;
+
+    /// Helper method: returns the index value of the Nth oldest sparse index element
+    uint64_t getSparseValue( size_t ageOrder ) const noexcept;
+
+    /// Helper method: returns the age order of the first sparse index element with an index value greater than 'indexValue'
+    size_t findFirstNewer( uint64_t indexValue ) const noexcept;
+
+    /// Helper method: returns the offset of the oldest entry slot that can contain a valid entry (as determined by the sparse index)
+    size_t getSparseBoundary( size_t firstValid ) const noexcept;
+
     /// Helper method: get an entry by its offset
     bool getByOffset( size_t                                offset, 
                       Payload&                              dst,
@@ -160,6 +237,15 @@ protected:
 
     /// Offset of the latest record;
     size_t                  m_latestOffset;
+
+    /// Sparse index: index value of every Nth entry slot (zero indicates an invalid/empty entry)
+    uint64_t*               m_sparseIndex;
+
+    /// Number of elements in the sparse index
+    size_t                  m_sparseNumElems;
+
+    /// Number of entry slots between sparse index elements
+    size_t                  m_sparseStride;
 };
 
 
@@ -361,6 +361,97 @@ public:
 };
 
 
+////////////////////////////////////////////////////////////////////////////////
+/** This abstract class define ITC message type and payload for the application
+    to read a range of Indexed Entries in a single request.
+
+    See the Cpl/Itc/README.txt file for the semantics for the 'ownership' of the
+    payload contents.
+
+    NOTE: The visitor callback executes in the server's thread, i.e. the
+          callback should copy the entry and return without blocking.
+
+    NOTE: This interface can/should NOT be used synchronously.  The application
+          is required to only use asynchronous semantics.
+ */
+class GetRangeRequest
+{
+public:
+    /// SAP for this API
+    typedef Cpl::Itc::SAP<GetRangeRequest> SAP;
+
+public:
+    /// Payload for Message: GetRange
+    class Payload
+    {
+    public:
+        /// INPUT: Only entries newer than this index value are retrieved
+        uint64_t                            m_newerThan;
+
+        /// INPUT: Only entries older than this index value are retrieved
+        uint64_t                            m_olderThan;
+
+        /// INPUT/OUTPUT: Memory to hold the retrieved entries
+        Cpl::Persistent::Payload&           m_entryDst;
+
+        /// INPUT: Callback that is called for each entry retrieved
+        IndexedEntryReader::EntryVisitor&   m_visitor;
+
+        /// INPUT: Traversal order (false:= oldest to newest, true:= newest to oldest)
+        bool                                m_newestFirst;
+
+        /// OUTPUT (response field): The number of entries retrieved
+        size_t                              m_numEntries;
+
+    public:
+        /// Constructor. Use for getRange() message
+        Payload( Cpl::Persistent::Payload&          entryDst,
+                 IndexedEntryReader::EntryVisitor&  visitor,
+                 uint64_t                           newerThan,
+                 uint64_t                           olderThan,
+                 bool                               newestFirst = false )
+            :m_newerThan( newerThan ), m_olderThan( olderThan ), m_entryDst( entryDst ), m_visitor( visitor ), m_newestFirst( newestFirst ), m_numEntries( 0 )
+        {
+        }
+    };
+
+
+    /// Message Type: GetRange
+    typedef Cpl::Itc::RequestMessage<GetRangeRequest, Payload> GetRangeMsg;
+
+    /// Request: GetRange message
+    virtual void request( GetRangeMsg& msg ) = 0;
+
+public:
+    /// Virtual Destructor
+    virtual ~GetRangeRequest() {}
+};
+
+
+/** This abstract class define ITC message type and payload for asynchronous
+    response (to the application) of a GetRange message.
+
+    The Application is responsible for implementing the response method(s).
+ */
+class GetRangeResponse
+{
+public:
+    /// Response Message Type
+    typedef Cpl::Itc::ResponseMessage<GetRangeResponse,
+        GetRangeRequest,
+        GetRangeRequest::Payload> GetRangeMsg;
+
+public:
+    /// Response
+    virtual void response( GetRangeMsg& msg ) = 0;
+
+
+public:
+    /// Virtual destructor
+    virtual ~GetRangeResponse() {}
+};
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /** This abstract class define ITC message type and payload for the application
     to clear/delete all entries
@@ -47,6 +47,7 @@ class IndexedEntryServer : public Cpl::Itc::CloseSync,
     public GetNextRequest,
     public GetPreviousRequest,
     public GetByBufferIndexRequest,
+    public GetRangeRequest,
     public ClearAllEntriesRequest
 {
 public:
@@ -148,6 +149,14 @@ public:
         msg.returnToSender();
     }
 
+    /// See Cpl::Persistent::GetRangeRequest
+    void request( GetRangeMsg& msg )
+    {
+        GetRangeRequest::Payload& payload = msg.getPayload();
+        payload.m_numEntries              = m_record.getRange( payload.m_newerThan, payload.m_olderThan, payload.m_entryDst, payload.m_visitor, payload.m_newestFirst );
+        msg.returnToSender();
+    }
+
     /// See Cpl::Persistent::IndexEntryReader
     size_t getMaxIndex() const noexcept
     {
@@ -23,8 +23,9 @@
 #include "Cpl/Dm/ModelDatabase.h"
 #include "Cpl/Dm/MailboxServer.h"
 #include "Cpl/Dm/Mp/Uint64.h"
-
+#include <chrono>
 #include <stdio.h>
+#include <stdlib.h>
 
 #define SECT_   "_0test"
 
@@ -50,8 +51,10 @@ public:
            size_t                  singleEntrySizeInBytes,
            RegionMedia&            entryRegion,
            IndexRecord&            secondaryRecord,
-           Cpl::Dm::Mp::Uint64&    mpForLatestIndexValue ) noexcept
-        :IndexedEntryRecord( entryChunkHandler, singleEntrySizeInBytes, entryRegion, secondaryRecord, mpForLatestIndexValue )
+           Cpl::Dm::Mp::Uint64&    mpForLatestIndexValue,
+           uint64_t*               sparseIndexMemory = 0,
+           size_t                  numSparseIndexElements = 0 ) noexcept
+        :IndexedEntryRecord( entryChunkHandler, singleEntrySizeInBytes, entryRegion, secondaryRecord, mpForLatestIndexValue, sparseIndexMemory, numSparseIndexElements )
     {
     }
 public:
@@ -92,6 +95,56 @@ public:
     char m_buffer[ENTRY_MAX_SIZE];
 };
 
+class CountingFileAdapter : public FileAdapter
+{
+public:
+    CountingFileAdapter( const char* fileName, size_t regionStartAddress, size_t regionLen ) noexcept
+        :FileAdapter( fileName, regionStartAddress, regionLen ), m_numReads( 0 )
+    {
+    }
+
+public:
+    size_t read( size_t offset, void* dstBuffer, size_t bytesToRead ) noexcept
+    {
+        m_numReads++;
+        return FileAdapter::read( offset, dstBuffer, bytesToRead );
+    }
+
+public:
+    unsigned long m_numReads;
+};
+
+class RangeVisitor : public IndexedEntryReader::EntryVisitor
+{
+public:
+    RangeVisitor( AppEntryPayload& entry, unsigned maxEntries = 0xFFFF ):m_entry( entry ), m_count( 0 ), m_maxEntries( maxEntries ), m_first( 0 ), m_last( 0 ), m_inOrder( true ) {}
+
+public:
+    Cpl::Type::Traverser::Status_T item( const IndexedEntryReader::EntryMarker_T& entryMarker ) noexcept
+    {
+        if ( m_count > 0 && entryMarker.indexValue != m_last + 1 && entryMarker.indexValue != m_last - 1 )
+        {
+            m_inOrder = false;
+        }
+        if ( m_count == 0 )
+        {
+            m_first = entryMarker.indexValue;
+        }
+        m_inOrder &= strtoul( m_entry.m_buffer, 0, 10 ) == entryMarker.indexValue;
+        m_last     = entryMarker.indexValue;
+        m_count++;
+        return m_count < m_maxEntries ? Cpl::Type::Traverser::eCONTINUE : Cpl::Type::Traverser::eABORT;
+    }
+
+public:
+    AppEntryPayload& m_entry;
+    unsigned         m_count;
+    unsigned         m_maxEntries;
+    uint64_t         m_first;
+    uint64_t         m_last;
+    bool             m_inOrder;
+};
+
 }; // end anonymous namespace
 
 // Allocate/create my Model Database
@@ -301,3 +354,270 @@ TEST_CASE( "IndexedEntryRecord" )
     Cpl::System::Api::sleep( 1000 );
     REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 0u );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+#define FILE_NAME_SPARSE_INDEX_REGION1  "sparse-index1.nvram"
+#define FILE_NAME_SPARSE_INDEX_REGION2  "sparse-index2.nvram"
+#define FILE_NAME_SPARSE_ENTRY_REGION   "sparse-entries.nvram"
+
+#define SPARSE_TOTAL_ENTRY_SIZE         (ENTRY_MAX_SIZE + 8 + 4 + sizeof(size_t))
+#define SPARSE_MAX_ENTRIES              100
+#define SPARSE_NUM_ELEMS                8
+#define SPARSE_MAX_READS_PER_ENTRY      3
+
+static Cpl::Persistent::FileAdapter     sparseIndexFd1( FILE_NAME_SPARSE_INDEX_REGION1, 0, 128 );
+static Cpl::Persistent::FileAdapter     sparseIndexFd2( FILE_NAME_SPARSE_INDEX_REGION2, 0, 128 );
+static CountingFileAdapter              sparseEntriesFd( FILE_NAME_SPARSE_ENTRY_REGION, 0, SPARSE_TOTAL_ENTRY_SIZE * SPARSE_MAX_ENTRIES );
+static Cpl::Persistent::MirroredChunk   sparseIndexRecChunk( sparseIndexFd1, sparseIndexFd2 );
+static Cpl::Persistent::CrcChunk        sparseEntriesChunk( sparseEntriesFd );
+static uint64_t                         sparseMemory_[SPARSE_NUM_ELEMS];
+
+static void addEntries( MyUut& uut, uint64_t& latest, unsigned numEntries )
+{
+    AppEntryPayload payload;
+    for ( unsigned i=0; i < numEntries; i++ )
+    {
+        char buf[ENTRY_MAX_SIZE];
+        snprintf( buf, sizeof( buf ), "%lu", (unsigned long) ( latest + 1 ) );
+        payload.appSet( buf );
+        REQUIRE( uut.addEntry( payload ) );
+        latest++;
+    }
+}
+
+static void verifyNextPrevious( MyUut& uut, uint64_t oldest, uint64_t latest )
+{
+    AppEntryPayload                   payload;
+    IndexedEntryReader::EntryMarker_T hint;
+    IndexedEntryReader::EntryMarker_T marker;
+    REQUIRE( uut.getLatest( payload, hint ) );
+    REQUIRE( hint.indexValue == latest );
+
+    // Note: The 'hint' is NOT adjacent to the requested entries, i.e. the sparse index is used to seek
+    for ( uint64_t t=0; t <= latest + 1; t++ )
+    {
+        uint64_t expected = t < oldest ? oldest : t + 1;
+        bool     result   = uut.getNext( t, hint, payload, marker );
+        REQUIRE( result == ( expected <= latest ) );
+        if ( result )
+        {
+            REQUIRE( marker.indexValue == expected );
+            REQUIRE( strtoul( payload.m_buffer, 0, 10 ) == expected );
+        }
+
+        expected = t > latest ? latest : t - 1;
+        result   = uut.getPrevious( t, hint, payload, marker );
+        REQUIRE( result == ( t > oldest ) );
+        if ( result )
+        {
+            REQUIRE( marker.indexValue == expected );
+            REQUIRE( strtoul( payload.m_buffer, 0, 10 ) == expected );
+        }
+    }
+
+    // Walk all entries
+    unsigned count = 1;
+    REQUIRE( uut.getLatest( payload, marker ) );
+    while ( uut.getPrevious( marker.indexValue, marker, payload, marker ) )
+    {
+        count++;
+    }
+    REQUIRE( marker.indexValue == oldest );
+    REQUIRE( count == latest - oldest + 1 );
+
+    // Seeks are bounded by the sparse index
+    unsigned long maxReads = SPARSE_MAX_READS_PER_ENTRY * ( uut.getSparseIndexStride() * 2 + 2 );
+    sparseEntriesFd.m_numReads = 0;
+    REQUIRE( uut.getNext( ( oldest + latest ) / 2, hint, payload, marker ) );
+    CPL_SYSTEM_TRACE_MSG( SECT_, ( "getNext() seek reads=%lu (max=%lu)", sparseEntriesFd.m_numReads, maxReads ) );
+    REQUIRE( sparseEntriesFd.m_numReads <= maxReads );
+    sparseEntriesFd.m_numReads = 0;
+    REQUIRE( uut.getPrevious( ( oldest + latest ) / 2, hint, payload, marker ) );
+    REQUIRE( sparseEntriesFd.m_numReads <= maxReads );
+    sparseEntriesFd.m_numReads = 0;
+    REQUIRE( uut.getPrevious( oldest, hint, payload, marker ) == false );
+    REQUIRE( sparseEntriesFd.m_numReads <= maxReads );
+}
+
+TEST_CASE( "IndexedEntryRecord-sparse" )
+{
+    CPL_SYSTEM_TRACE_SCOPE( SECT_, "INDEXED-ENTRY-RECORD-SPARSE Test" );
+    Cpl::System::Shutdown_TS::clearAndUseCounter();
+
+    Cpl::Io::File::Api::remove( FILE_NAME_SPARSE_INDEX_REGION1 );
+    Cpl::Io::File::Api::remove( FILE_NAME_SPARSE_INDEX_REGION2 );
+    Cpl::Io::File::Api::remove( FILE_NAME_SPARSE_ENTRY_REGION );
+
+    mp_index_.setInvalid();
+    AppEntryPayload    appPayload;
+    IndexRecord        indexRecord( sparseIndexRecChunk );
+    MyUut              uut( sparseEntriesChunk, ENTRY_MAX_SIZE, sparseEntriesFd, indexRecord, mp_index_, sparseMemory_, SPARSE_NUM_ELEMS );
+    Cpl::Persistent::Record* records[2] = { &uut, 0 };
+    Cpl::Persistent::RecordServer recordServer( records );
+    Cpl::System::Thread* t1 = Cpl::System::Thread::create( recordServer, "UUT" );
+    REQUIRE( t1 );
+    REQUIRE( uut.getTotalEntryLength() == SPARSE_TOTAL_ENTRY_SIZE );
+    REQUIRE( uut.getMaxIndex() == SPARSE_MAX_ENTRIES - 1 );
+    REQUIRE( uut.isSparseIndexEnabled() );
+    REQUIRE( uut.getSparseIndexStride() == ( SPARSE_MAX_ENTRIES + SPARSE_NUM_ELEMS - 1 ) / SPARSE_NUM_ELEMS );
+
+    // Empty
+    recordServer.open();
+    uint64_t                          latest = 0;
+    IndexedEntryReader::EntryMarker_T marker = { 0, 0 };
+    REQUIRE( uut.getNext( 0, marker, appPayload, marker ) == false );
+    REQUIRE( uut.getPrevious( 10, marker, appPayload, marker ) == false );
+
+    // Partially filled
+    addEntries( uut, latest, 30 );
+    verifyNextPrevious( uut, 1, latest );
+
+    // Wrapped
+    addEntries( uut, latest, 220 );
+    verifyNextPrevious( uut, latest - SPARSE_MAX_ENTRIES + 1, latest );
+
+    // Range reads
+    RangeVisitor visitor( appPayload );
+    REQUIRE( uut.getRange( 200, 210, appPayload, visitor ) == 9 );
+    REQUIRE( visitor.m_first == 201 );
+    REQUIRE( visitor.m_last == 209 );
+    REQUIRE( visitor.m_inOrder );
+    RangeVisitor visitor2( appPayload );
+    REQUIRE( uut.getRange( 200, 210, appPayload, visitor2, true ) == 9 );
+    REQUIRE( visitor2.m_first == 209 );
+    REQUIRE( visitor2.m_last == 201 );
+    REQUIRE( visitor2.m_inOrder );
+    RangeVisitor visitor3( appPayload, 3 );
+    REQUIRE( uut.getRange( 0, UINT64_MAX, appPayload, visitor3, true ) == 3 );
+    REQUIRE( visitor3.m_first == latest );
+    REQUIRE( visitor3.m_last == latest - 2 );
+    RangeVisitor visitor4( appPayload );
+    REQUIRE( uut.getRange( 0, UINT64_MAX, appPayload, visitor4 ) == SPARSE_MAX_ENTRIES );
+    REQUIRE( visitor4.m_first == latest - SPARSE_MAX_ENTRIES + 1 );
+    REQUIRE( visitor4.m_last == latest );
+    REQUIRE( visitor4.m_inOrder );
+    RangeVisitor visitor5( appPayload );
+    REQUIRE( uut.getRange( latest, UINT64_MAX, appPayload, visitor5 ) == 0 );
+    recordServer.close();
+
+    // Restart with a corrupt index record (i.e. the head pointer is recovered using the sparse index)
+    Cpl::Io::File::Api::remove( FILE_NAME_SPARSE_INDEX_REGION1 );
+    Cpl::Io::File::Api::remove( FILE_NAME_SPARSE_INDEX_REGION2 );
+    sparseEntriesFd.m_numReads = 0;
+    recordServer.open();
+    CPL_SYSTEM_TRACE_MSG( SECT_, ( "start-up reads=%lu", sparseEntriesFd.m_numReads ) );
+    REQUIRE( sparseEntriesFd.m_numReads <= SPARSE_MAX_READS_PER_ENTRY * ( SPARSE_NUM_ELEMS + uut.getSparseIndexStride() * 2 + 2 ) );
+    REQUIRE( uut.getLatest( appPayload, marker ) );
+    REQUIRE( marker.indexValue == latest );
+    addEntries( uut, latest, 7 );
+    verifyNextPrevious( uut, latest - SPARSE_MAX_ENTRIES + 1, latest );
+
+    // Clear
+    REQUIRE( uut.clearAllEntries() );
+    REQUIRE( uut.getLatest( appPayload, marker ) == false );
+    REQUIRE( uut.getNext( 0, marker, appPayload, marker ) == false );
+    latest = 0;
+    addEntries( uut, latest, 5 );
+    verifyNextPrevious( uut, 1, latest );
+    recordServer.close();
+
+    Cpl::System::Thread::destroy( *t1 );
+    Cpl::System::Api::sleep( 100 );
+    REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 0u );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+#define FILE_NAME_BENCH_INDEX_REGION1   "bench-index1.nvram"
+#define FILE_NAME_BENCH_INDEX_REGION2   "bench-index2.nvram"
+#define FILE_NAME_BENCH_ENTRY_REGION    "bench-entries.nvram"
+#define BENCH_MAX_ENTRIES               10000
+#define BENCH_NUM_ELEMS                 256
+#define BENCH_NUM_SEEKS                 100
+
+static Cpl::Persistent::FileAdapter     benchIndexFd1( FILE_NAME_BENCH_INDEX_REGION1, 0, 128 );
+static Cpl::Persistent::FileAdapter     benchIndexFd2( FILE_NAME_BENCH_INDEX_REGION2, 0, 128 );
+static CountingFileAdapter              benchEntriesFd( FILE_NAME_BENCH_ENTRY_REGION, 0, SPARSE_TOTAL_ENTRY_SIZE * BENCH_MAX_ENTRIES );
+static Cpl::Persistent::MirroredChunk   benchIndexRecChunk( benchIndexFd1, benchIndexFd2 );
+static Cpl::Persistent::CrcChunk        benchEntriesChunk( benchEntriesFd );
+static uint64_t                         benchMemory_[BENCH_NUM_ELEMS];
+
+static void runBench( const char* label, uint64_t* sparseMemory, uint64_t latest )
+{
+    AppEntryPayload    appPayload;
+    IndexRecord        indexRecord( benchIndexRecChunk );
+    MyUut              uut( benchEntriesChunk, ENTRY_MAX_SIZE, benchEntriesFd, indexRecord, mp_index_, sparseMemory, sparseMemory ? BENCH_NUM_ELEMS : 0 );
+    Cpl::Persistent::Record* records[2] = { &uut, 0 };
+    Cpl::Persistent::RecordServer recordServer( records );
+    Cpl::System::Thread* t1 = Cpl::System::Thread::create( recordServer, "UUT" );
+    REQUIRE( t1 );
+
+    // Start-up with a corrupt index record
+    Cpl::Io::File::Api::remove( FILE_NAME_BENCH_INDEX_REGION1 );
+    Cpl::Io::File::Api::remove( FILE_NAME_BENCH_INDEX_REGION2 );
+    benchEntriesFd.m_numReads = 0;
+    auto start = std::chrono::steady_clock::now();
+    recordServer.open();
+    auto end   = std::chrono::steady_clock::now();
+    IndexedEntryReader::EntryMarker_T hint;
+    REQUIRE( uut.getLatest( appPayload, hint ) );
+    REQUIRE( hint.indexValue == latest );
+    CPL_SYSTEM_TRACE_MSG( SECT_, ( "%s: start-up scan: %lu reads, %.2f ms", label, benchEntriesFd.m_numReads, std::chrono::duration<double, std::milli>( end - start ).count() ) );
+
+    // Random seeks
+    uint64_t oldest = latest - BENCH_MAX_ENTRIES + 1;
+    srand( 42 );
+    benchEntriesFd.m_numReads = 0;
+    start = std::chrono::steady_clock::now();
+    for ( unsigned i=0; i < BENCH_NUM_SEEKS; i++ )
+    {
+        IndexedEntryReader::EntryMarker_T marker;
+        uint64_t                          target = oldest + ( rand() % ( BENCH_MAX_ENTRIES - 1 ) );
+        REQUIRE( uut.getNext( target, hint, appPayload, marker ) );
+        REQUIRE( marker.indexValue == target + 1 );
+    }
+    end = std::chrono::steady_clock::now();
+    CPL_SYSTEM_TRACE_MSG( SECT_, ( "%s: %u getNext() seeks: %lu reads, %.2f ms", label, BENCH_NUM_SEEKS, benchEntriesFd.m_numReads, std::chrono::duration<double, std::milli>( end - start ).count() ) );
+
+    // Range read of the newest 1000 entries
+    RangeVisitor visitor( appPayload );
+    benchEntriesFd.m_numReads = 0;
+    start = std::chrono::steady_clock::now();
+    REQUIRE( uut.getRange( latest - 1000, UINT64_MAX, appPayload, visitor ) == 1000 );
+    end = std::chrono::steady_clock::now();
+    REQUIRE( visitor.m_inOrder );
+    CPL_SYSTEM_TRACE_MSG( SECT_, ( "%s: range read of 1000 entries: %lu reads, %.2f ms", label, benchEntriesFd.m_numReads, std::chrono::duration<double, std::milli>( end - start ).count() ) );
+
+    recordServer.close();
+    Cpl::System::Thread::destroy( *t1 );
+    Cpl::System::Api::sleep( 100 );
+}
+
+TEST_CASE( "IndexedEntryRecord-bench", "[.bench]" )
+{
+    Cpl::Io::File::Api::remove( FILE_NAME_BENCH_INDEX_REGION1 );
+    Cpl::Io::File::Api::remove( FILE_NAME_BENCH_INDEX_REGION2 );
+    Cpl::Io::File::Api::remove( FILE_NAME_BENCH_ENTRY_REGION );
+
+    // Populate the region (wrap the ring buffer)
+    uint64_t latest = 0;
+    {
+        IndexRecord        indexRecord( benchIndexRecChunk );
+        MyUut              uut( benchEntriesChunk, ENTRY_MAX_SIZE, benchEntriesFd, indexRecord, mp_index_, benchMemory_, BENCH_NUM_ELEMS );
+        Cpl::Persistent::Record* records[2] = { &uut, 0 };
+        Cpl::Persistent::RecordServer recordServer( records );
+        Cpl::System::Thread* t1 = Cpl::System::Thread::create( recordServer, "UUT" );
+        REQUIRE( t1 );
+        recordServer.open();
+        addEntries( uut, latest, BENCH_MAX_ENTRIES + BENCH_MAX_ENTRIES / 3 );
+        recordServer.close();
+        Cpl::System::Thread::destroy( *t1 );
+        Cpl::System::Api::sleep( 100 );
+    }
+
+    runBench( "linear", 0, latest );
+    runBench( "sparse", benchMemory_, latest );
+
+    Cpl::Io::File::Api::remove( FILE_NAME_BENCH_INDEX_REGION1 );
+    Cpl::Io::File::Api::remove( FILE_NAME_BENCH_INDEX_REGION2 );
+    Cpl::Io::File::Api::remove( FILE_NAME_BENCH_ENTRY_REGION );
+}
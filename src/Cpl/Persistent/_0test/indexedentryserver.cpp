@@ -97,6 +97,27 @@ public:
     char m_buffer[ENTRY_MAX_LEN];
 };
 
+class MyVisitor : public IndexedEntryReader::EntryVisitor
+{
+public:
+    MyVisitor( AppEntryPayload& entry ):m_entry( entry ), m_count( 0 ) {}
+
+public:
+    Cpl::Type::Traverser::Status_T item( const IndexedEntryReader::EntryMarker_T& entryMarker ) noexcept
+    {
+        m_indexValues[m_count] = entryMarker.indexValue;
+        memcpy( m_entries[m_count], m_entry.m_buffer, ENTRY_MAX_LEN );
+        m_count++;
+        return m_count < MAX_ENTRIES ? Cpl::Type::Traverser::eCONTINUE : Cpl::Type::Traverser::eABORT;
+    }
+
+public:
+    AppEntryPayload& m_entry;
+    unsigned         m_count;
+    uint64_t         m_indexValues[MAX_ENTRIES];
+    char             m_entries[MAX_ENTRIES][ENTRY_MAX_LEN];
+};
+
 }; // end anonymous namespace
 
 // Allocate/create my Model Database
@@ -216,6 +237,18 @@ TEST_CASE( "IndexedEntryServer" )
         REQUIRE( strncmp( appPayload.m_buffer, ENTRY1, strlen( ENTRY1 ) ) == 0 );
         REQUIRE( uut.getMaxIndex() == MAX_ENTRIES - 1 );
 
+        MyVisitor                    visitor( appPayload );
+        GetRangeRequest::Payload     payload5( appPayload, visitor, 1, 4, true );
+        Cpl::Itc::SyncReturnHandler  srh5;
+        GetRangeRequest::GetRangeMsg msg5( uut, payload5, srh5 );
+        recordServer.postSync( msg5 );
+        REQUIRE( payload5.m_numEntries == 2 );
+        REQUIRE( visitor.m_count == 2 );
+        REQUIRE( visitor.m_indexValues[0] == 3 );
+        REQUIRE( strncmp( visitor.m_entries[0], ENTRY3, strlen( ENTRY3 ) ) == 0 );
+        REQUIRE( visitor.m_indexValues[1] == 2 );
+        REQUIRE( strncmp( visitor.m_entries[1], ENTRY2, strlen( ENTRY2 ) ) == 0 );
+
         uut.close();
         recordServer.close();
     }
@@ -15,6 +15,7 @@
 #include "FatalError.h"
 #include "GlobalLock.h"
 #include "ElapsedTime.h"
+#include <string.h>
 
 #define SECT_ "Cpl::System"
 
@@ -30,14 +31,26 @@ EventLoop::EventLoop( unsigned long          timeOutPeriodInMsec,
     , m_sema()
     , m_timeout( timeOutPeriodInMsec )
     , m_timeStartOfLoop( 0 )
+    , m_timeStatsReset( 0 )
+    , m_wakeups( 0 )
+    , m_timeouts( 0 )
     , m_events( 0 )
     , m_run( true )
+    , m_deadlineWakeups( false )
 {
     if ( timeOutPeriodInMsec == 0 )
     {
         FatalError::logf( "EventLoop(%p): timeOutPeriodInMsec can NOT be set to zero", this );
     }
+
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+    memset( &m_profile, 0, sizeof( m_profile ) );
+    m_profileReset       = 0;
+    m_profileStartOfLoop = 0;
+    m_profileIdle        = 0;
+#endif
 }
+
 void EventLoop::setThreadOfExecution_( Thread* myThreadPtr )
 {
     m_myThreadPtr = myThreadPtr;
@@ -68,6 +81,77 @@ void EventLoop::startEventLoop() noexcept
 {
     // Initialize/start the timer manager
     startManager();
+    m_timeStatsReset = ElapsedTime::milliseconds();
+
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+    m_profileReset       = profileTimestamp_();
+    m_profileStartOfLoop = m_profileReset;
+    m_profileIdle        = 0;
+#endif
+}
+
+void EventLoop::setDeadlineWakeups( bool enabled ) noexcept
+{
+    m_deadlineWakeups = enabled;
+}
+
+void EventLoop::getWakeupStats( WakeupStats_T& dstStats, bool resetStats ) noexcept
+{
+    unsigned long now      = ElapsedTime::milliseconds();
+    dstStats.m_elapsedMsec = ElapsedTime::deltaMilliseconds( m_timeStatsReset, now );
+    dstStats.m_wakeups     = m_wakeups;
+    dstStats.m_timeouts    = m_timeouts;
+    getTimerStats( dstStats.m_timers, resetStats );
+    if ( resetStats )
+    {
+        m_timeStatsReset = now;
+        m_wakeups        = 0;
+        m_timeouts       = 0;
+    }
+}
+
+bool EventLoop::getProfile( Profile_T& dstProfile, bool resetProfile ) noexcept
+{
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+    unsigned long now         = profileTimestamp_();
+    dstProfile                = m_profile;
+    dstProfile.m_elapsedTicks = now - m_profileReset;
+    if ( resetProfile )
+    {
+        memset( &m_profile, 0, sizeof( m_profile ) );
+        m_profileReset = now;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void EventLoop::profileEvents_( ProfileCategory_T category, unsigned long count, unsigned long startTime ) noexcept
+{
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+    if ( count )
+    {
+        unsigned long           elapsed = profileTimestamp_() - startTime;
+        ProfileCategoryStats_T& stats   = m_profile.m_categories[category];
+        stats.m_count      += count;
+        stats.m_totalTicks += elapsed;
+        if ( elapsed > stats.m_maxTicks )
+        {
+            stats.m_maxTicks = elapsed;
+        }
+    }
+#endif
+}
+
+void EventLoop::profileQueueDepth_( ProfileCategory_T category, unsigned long queueDepth ) noexcept
+{
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+    if ( queueDepth > m_profile.m_categories[category].m_peakQueueDepth )
+    {
+        m_profile.m_categories[category].m_peakQueueDepth = queueDepth;
+    }
+#endif
 }
 
 void EventLoop::stopEventLoop() noexcept
@@ -102,10 +186,47 @@ bool EventLoop::waitAndProcessEvents( bool skipWait ) noexcept
     }
     m_timeStartOfLoop = now;
 
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+    // Record the previous pass of the loop, i.e. everything - including the child class's processing - since the previous call
+    unsigned long profileNow  = profileTimestamp_();
+    unsigned long busy        = profileNow - m_profileStartOfLoop - m_profileIdle;
+    unsigned      bucket      = 0;
+    m_profile.m_busyTicks    += busy;
+    m_profile.m_loops++;
+    for ( ; busy && bucket < OPTION_CPL_SYSTEM_EVENT_LOOP_PROFILE_NUM_BUCKETS - 1; busy >>= 1 )
+    {
+        bucket++;
+    }
+    m_profile.m_histogram[bucket]++;
+    m_profileStartOfLoop = profileNow;
+    m_profileIdle        = 0;
+#endif
+
+    // Wait until the next timer expires (or until I am signaled)
+    unsigned long waitTime = m_timeout;
+    if ( m_deadlineWakeups && !skipWait )
+    {
+        waitTime = msecToNextExpiration( m_timeout );
+        if ( waitTime == 0 )
+        {
+            skipWait = true;
+        }
+    }
+
     // Wait for something to happen...
     if ( !skipWait )
     {
-        m_sema.timedWait( m_timeout ); // Note: For Tick Simulation: the timedWait() calls topLevelWait() if the semaphore has not been signaled
+        // Note: For Tick Simulation: the timedWait() calls topLevelWait() if the semaphore has not been signaled
+        if ( !m_sema.timedWait( waitTime ) )
+        {
+            m_timeouts++;
+        }
+        m_wakeups++;
+
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+        m_profileIdle          = profileTimestamp_() - m_profileStartOfLoop;
+        m_profile.m_idleTicks += m_profileIdle;
+#endif
     }
 
     // Trap my exit/please-stop condition AGAIN since a lot could have happen while I was waiting....
@@ -126,6 +247,10 @@ bool EventLoop::waitAndProcessEvents( bool skipWait ) noexcept
     // Process Event Flags
     if ( events )
     {
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+        unsigned long          startTime   = profileTimestamp_();
+        unsigned long          count       = 0;
+#endif
         Cpl_System_EventFlag_T eventMask   = 1;
         uint8_t                eventNumber = 0;
         for ( ; eventMask; eventMask <<= 1, eventNumber++ )
@@ -133,12 +258,27 @@ bool EventLoop::waitAndProcessEvents( bool skipWait ) noexcept
             if ( (events & eventMask) )
             {
                 processEventFlag( eventNumber );
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+                count++;
+#endif
             }
         }
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+        profileEvents_( ePROFILE_EVENT_FLAGS, count, startTime );
+        profileQueueDepth_( ePROFILE_EVENT_FLAGS, count );
+#endif
     }
 
     // Timer Check
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+    unsigned long startTime  = profileTimestamp_();
+    unsigned long numExpired = m_timerStats.m_numExpired;
+    processTimers();
+    unsigned long expired    = m_timerStats.m_numExpired;   // Note: The timer statistics can be reset by a different thread
+    profileEvents_( ePROFILE_TIMERS, expired >= numExpired ? expired - numExpired : expired, startTime );
+#else
     processTimers();
+#endif
     return true;
 }
 
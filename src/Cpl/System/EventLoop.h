@@ -12,18 +12,45 @@
 *----------------------------------------------------------------------------*/
 /** @file */
 
+#include "colony_config.h"
 #include "Cpl/System/Runnable.h"
 #include "Cpl/System/Semaphore.h"
 #include "Cpl/System/Signable.h"
 #include "Cpl/System/EventFlag.h"
 #include "Cpl/System/SharedEventHandler.h"
 #include "Cpl/System/TimerManager.h"
+#include "Cpl/System/ElapsedTime.h"
 
 
 /** Specifies the default timeout period for waiting on a event.
  */
 #ifndef OPTION_CPL_SYSTEM_EVENT_LOOP_TIMEOUT_PERIOD
 #define OPTION_CPL_SYSTEM_EVENT_LOOP_TIMEOUT_PERIOD       1  //!< 1 msec timeout, aka 1 msec timer resolution for Software Timers
+#endif
+
+/** This symbol defines the number of buckets in the Event Loop profiling
+    histogram of loop durations (see USE_CPL_SYSTEM_EVENT_LOOP_PROFILE).
+    Bucket 0 counts the loops that took zero ticks, bucket N counts the loops
+    that took [2^(N-1), 2^N) ticks, and the last bucket counts everything
+    longer.
+ */
+#ifndef OPTION_CPL_SYSTEM_EVENT_LOOP_PROFILE_NUM_BUCKETS
+#define OPTION_CPL_SYSTEM_EVENT_LOOP_PROFILE_NUM_BUCKETS  10
+#endif
+
+/** This symbol defines the free running time source, in 'ticks', that is used
+    for Event Loop profiling.  The default is the millisecond elapsed time.
+    Platforms that have a high resolution counter (e.g. a cycle counter)
+    should override both this symbol and
+    OPTION_CPL_SYSTEM_EVENT_LOOP_PROFILE_TICKS_PER_MSEC.
+ */
+#ifndef CPL_SYSTEM_EVENT_LOOP_PROFILE_TIMESTAMP
+#define CPL_SYSTEM_EVENT_LOOP_PROFILE_TIMESTAMP()         Cpl::System::ElapsedTime::milliseconds()
+#endif
+
+/// Number of profiling 'ticks' per millisecond
+#ifndef OPTION_CPL_SYSTEM_EVENT_LOOP_PROFILE_TICKS_PER_MSEC
+#define OPTION_CPL_SYSTEM_EVENT_LOOP_PROFILE_TICKS_PER_MSEC   1
 #endif
 
  ///
@@ -46,10 +73,58 @@ namespace System {
     The class also provides a mechanism for registering 'other' events to
     be processed.
 
+    When USE_CPL_SYSTEM_EVENT_LOOP_PROFILE is defined, the Event Loop
+    records how its time is spent, i.e. busy vs. idle time, a histogram of the
+    loop (busy) durations, and per category (timers, event flags, ITC messages,
+    and Model Point change notifications) counts, execution times, and peak
+    queue depths.  The recording only uses a handful of time stamps and
+    counter updates per pass of the loop, i.e. it is intended to be left
+    enabled in production builds.  See getProfile().
+
     Note: The EventLoop does NOT use/consume the Thread Semaphore.
  */
 class EventLoop : public Runnable, public EventFlag, public Signable, public TimerManager
 {
+public:
+    /// Wake-up statistics
+    struct WakeupStats_T
+    {
+        unsigned long m_elapsedMsec;        //!< Time, in milliseconds, that the statistics were collected over
+        unsigned long m_wakeups;            //!< Number of times the Event Loop woke up after waiting
+        unsigned long m_timeouts;           //!< Number of wake-ups that were caused by the wait timing out (vs. being signaled)
+        TimerStats_T  m_timers;             //!< Timer expiration/lateness statistics
+    };
+
+    /// Profiling categories
+    enum ProfileCategory_T
+    {
+        ePROFILE_TIMERS = 0,                //!< Software timer callbacks
+        ePROFILE_EVENT_FLAGS,               //!< Event Flag callbacks
+        ePROFILE_MESSAGES,                  //!< ITC messages
+        ePROFILE_NOTIFICATIONS,             //!< Model Point change notifications
+        ePROFILE_NUM_CATEGORIES             //!< Number of categories
+    };
+
+    /// Profiling statistics for a single category.  Times are in profiling 'ticks'
+    struct ProfileCategoryStats_T
+    {
+        unsigned long m_count;              //!< Number of events (timer callbacks, event flags, messages, notifications) that were processed
+        unsigned long m_totalTicks;         //!< Total time spent processing the events
+        unsigned long m_maxTicks;           //!< Maximum time spent processing the events in a single pass of the loop
+        unsigned long m_peakQueueDepth;     //!< Maximum number of events that were pending at the start of a pass (not used for timers)
+    };
+
+    /// Profiling statistics.  Times are in profiling 'ticks' (see OPTION_CPL_SYSTEM_EVENT_LOOP_PROFILE_TICKS_PER_MSEC)
+    struct Profile_T
+    {
+        unsigned long          m_elapsedTicks;                                          //!< Time that the statistics were collected over
+        unsigned long          m_busyTicks;                                             //!< Time spent NOT waiting for an event
+        unsigned long          m_idleTicks;                                             //!< Time spent waiting for an event
+        unsigned long          m_loops;                                                 //!< Number of passes of the loop
+        unsigned long          m_histogram[OPTION_CPL_SYSTEM_EVENT_LOOP_PROFILE_NUM_BUCKETS];  //!< Histogram of the busy time per pass of the loop
+        ProfileCategoryStats_T m_categories[ePROFILE_NUM_CATEGORIES];                   //!< Per category statistics
+    };
+
 public:
     /** Constructor. The 'timeOutPeriodInMsec' parameter specifies how
         long the EventLoop will wait for an event before timing out and
@@ -66,6 +141,66 @@ public:
     /// Virtual destructor
     virtual ~EventLoop() {};
 
+public:
+    /** This method enables/disables deadline driven wake-ups.  When enabled,
+        the Event Loop waits until the next Software Timer expires (or until
+        it is signaled) instead of waking up every 'timeOutPeriodInMsec'
+        milliseconds.  The constructor's 'timeOutPeriodInMsec' argument
+        becomes the maximum time the Event Loop will wait, i.e. the application
+        should specify a 'large' timeout period when deadline wake-ups are
+        enabled.
+
+        Deadline wake-ups should NOT be enabled for Event Loops that have
+        processing that depends on periodic wake-ups (e.g. the PeriodicScheduler
+        variants of the MailboxServer).
+
+        This method should only be called before the Event Loop's thread is
+        started.
+     */
+    void setDeadlineWakeups( bool enabled ) noexcept;
+
+    /** This method returns the Event Loop's wake-up statistics.  When
+        'resetStats' is true, the statistics are cleared after being returned.
+        The statistics can be used to calculate wake-ups per second and timer
+        lateness for idle and busy event loops.
+
+        This method is NOT thread safe, i.e. the values are only approximate
+        when called from a different thread than the Event Loop's thread.
+     */
+    void getWakeupStats( WakeupStats_T& dstStats, bool resetStats = false ) noexcept;
+
+    /** This method returns the Event Loop's profiling statistics.  When
+        'resetProfile' is true, the statistics are cleared after being
+        returned. The method returns false (and 'dstProfile' is not updated)
+        when profiling is not enabled, i.e. USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+        is not defined.
+
+        This method is NOT thread safe, i.e. the values are only approximate
+        when called from a different thread than the Event Loop's thread.
+     */
+    bool getProfile( Profile_T& dstProfile, bool resetProfile = false ) noexcept;
+
+public:
+    /** This method has PACKAGE Scope, i.e. it is intended to be ONLY accessible
+        by the Cpl::System, Cpl::Itc, and Cpl::Dm namespaces.  The Application
+        should NEVER call this method.
+
+        This method records that 'count' events of type 'category' were
+        processed starting at the time 'startTime' (see profileTimestamp_()).
+        Nothing is recorded when 'count' is zero.  This method MUST be called
+        from the Event Loop's thread.
+     */
+    void profileEvents_( ProfileCategory_T category, unsigned long count, unsigned long startTime ) noexcept;
+
+    /** This method has PACKAGE Scope.  This method records the number of
+        events of type 'category' that were pending at the start of a pass of
+        the loop. This method MUST be called from the Event Loop's thread.
+     */
+    void profileQueueDepth_( ProfileCategory_T category, unsigned long queueDepth ) noexcept;
+
+    /// This method has PACKAGE Scope.  Returns the current profiling time stamp
+    static inline unsigned long profileTimestamp_() noexcept { return CPL_SYSTEM_EVENT_LOOP_PROFILE_TIMESTAMP(); }
+
 
 protected:
     /** This method is used to initialize the Event Loop's thread has started
@@ -177,6 +312,9 @@ public:
     /// See Cpl::System::Runnable
     void setThreadOfExecution_( Thread* myThreadPtr );
 
+    /// See Cpl::System::Runnable
+    EventLoop* getEventLoop_() noexcept { return this; }
+
 protected:
     /// A pointer to the thread the Event Loop executes in
     Thread*                 m_myThreadPtr;
@@ -193,12 +331,38 @@ protected:
     /// Timestamp, in milliseconds, of start of event/wait loop
     unsigned long           m_timeStartOfLoop;
 
+    /// Timestamp, in milliseconds, of when the wake-up statistics were last reset
+    unsigned long           m_timeStatsReset;
+
+    /// Number of wake-ups
+    unsigned long           m_wakeups;
+
+    /// Number of wake-ups caused by the wait timing out
+    unsigned long           m_timeouts;
+
     /// The variable holds the current state of all Event Flags
     Cpl_System_EventFlag_T  m_events;
 
     /// Flag used to help with the pleaseStop() request
     bool                    m_run;
 
+    /// Flag that enables deadline driven wake-ups
+    bool                    m_deadlineWakeups;
+
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+    /// Profiling statistics
+    Profile_T               m_profile;
+
+    /// Profiling time stamp of when the profiling statistics were last reset
+    unsigned long           m_profileReset;
+
+    /// Profiling time stamp of the start of the current pass of the loop
+    unsigned long           m_profileStartOfLoop;
+
+    /// Idle time for the current pass of the loop
+    unsigned long           m_profileIdle;
+#endif
+
 };
 
 };      // end namespaces
@@ -21,6 +21,9 @@ namespace System {
 /// Forward class reference to avoid a circular dependency.
 class Thread;
 
+/// Forward class reference to avoid a circular dependency.
+class EventLoop;
+
 
 /** This is an abstract class defines the interface for an object
     that is "executed" when a Thread object is created.
@@ -99,6 +102,17 @@ public:
      */
     virtual void setThreadOfExecution_( Thread* myThreadPtr ) {}
 
+    /** This method has COMPONENT Scope.  The application SHOULD NEVER
+        call/use this method.
+
+        This method returns a pointer to the runnable instance's Event Loop,
+        i.e. if the runnable object is a Cpl::System::EventLoop. If the runnable
+        object is not an Event Loop then 0 is returned.  This method allows
+        diagnostics (e.g. the TShell 'loops' command) to locate the Event
+        Loops when traversing the list of threads.
+     */
+    virtual EventLoop* getEventLoop_() noexcept { return 0; }
+
 
 };
 
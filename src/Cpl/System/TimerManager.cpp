@@ -24,19 +24,21 @@ using namespace Cpl::System;
 TimerManager::TimerManager()
     :m_timeMark( 0 )
     , m_timeNow( 0 )
+    , m_timerStats( { 0, 0, 0 } )
     , m_inTickCall( false )
 {
+#ifdef USE_CPL_SYSTEM_TIMER_MANAGER_TIMING_WHEEL
+    m_wheelTime = 0;
+    m_numActive = 0;
+#endif
 }
 
 void TimerManager::startManager( void ) noexcept
 {
     m_timeMark = Cpl::System::ElapsedTime::milliseconds();
+    m_timeNow  = m_timeMark;
 }
 
-bool TimerManager::areActiveTimers( void ) noexcept
-{
-    return m_counters.first() == 0;
-}
 
 void TimerManager::processTimers( void ) noexcept
 {
@@ -53,46 +55,40 @@ void TimerManager::processTimers( void ) noexcept
 }
 
 
-/////////////////////////
-void TimerManager::tick( unsigned long msec ) noexcept
+unsigned long TimerManager::msecToNextExpiration( unsigned long maxMsec ) noexcept
 {
-    // Set my state to: PROCESSING TICK(S)    
-    m_inTickCall = true;
+    unsigned long nextExpiration;
+    if ( !getNextExpiration( nextExpiration ) )
+    {
+        return maxMsec;
+    }
 
-    while ( msec )
+    unsigned long elapsed   = Cpl::System::ElapsedTime::deltaMilliseconds( m_timeMark );
+    unsigned long remaining = nextExpiration > elapsed ? nextExpiration - elapsed : 0;
+    return remaining < maxMsec ? remaining : maxMsec;
+}
+
+void TimerManager::getTimerStats( TimerStats_T& dstStats, bool resetStats ) noexcept
+{
+    dstStats = m_timerStats;
+    if ( resetStats )
     {
-        CounterCallback_* counterPtr = m_counters.first();
-        if ( counterPtr == 0 )
-        {
-            // No timers registered -->do NOTHING
-            break;
-        }
-        else
-        {
-            // Decrement the first/active counter in the list
-            unsigned long nextCount = counterPtr->count();
-            if ( msec <= nextCount )
-            {
-                counterPtr->decrement( msec );
-                msec = 0;
-            }
-            else
-            {
-                counterPtr->decrement( nextCount );
-                msec -= nextCount;
-            }
+        m_timerStats = { 0, 0, 0 };
+    }
+}
 
-            // Process ALL local Timers that have a ZERO countdown value
-            while ( counterPtr && counterPtr->count() == 0 )
-            {
-                m_counters.get();                // Remove the expired counter from the list
-                counterPtr->expired();           // Expire the counter
-                counterPtr = m_counters.first(); // Get next counter
-            }
-        }
+void TimerManager::recordExpiration( unsigned long latenessMsec ) noexcept
+{
+    m_timerStats.m_numExpired++;
+    m_timerStats.m_totalLatenessMsec += latenessMsec;
+    if ( latenessMsec > m_timerStats.m_maxLatenessMsec )
+    {
+        m_timerStats.m_maxLatenessMsec = latenessMsec;
     }
 }
 
+
+/////////////////////////
 void TimerManager::tickComplete( void ) noexcept
 {
     // Process pending attaches now that the tick cycle has completed
@@ -126,6 +122,191 @@ void TimerManager::attach( CounterCallback_& clientToCallback ) noexcept
 }
 
 
+unsigned long TimerManager::msecToCounts( unsigned long milliseconds ) noexcept
+{
+    unsigned long delta = Cpl::System::ElapsedTime::deltaMilliseconds( m_timeNow );
+    CPL_SYSTEM_TRACE_MSG( SECT_, ("milliseconds IN=%lu, count out=%lu", milliseconds, milliseconds + delta) );
+    return milliseconds + delta;
+}
+
+
+/////////////////////////
+#ifdef USE_CPL_SYSTEM_TIMER_MANAGER_TIMING_WHEEL
+
+#define WHEEL_MASK_     (OPTION_CPL_SYSTEM_TIMER_MANAGER_WHEEL_SLOTS-1)
+
+bool TimerManager::areActiveTimers( void ) noexcept
+{
+    return m_numActive == 0;
+}
+
+void TimerManager::tick( unsigned long msec ) noexcept
+{
+    // Set my state to: PROCESSING TICK(S)    
+    m_inTickCall = true;
+
+    while ( msec )
+    {
+        // No timers registered -->just advance the wheel's time
+        if ( m_numActive == 0 )
+        {
+            m_wheelTime += msec;
+            break;
+        }
+
+        // Advance the wheel one slot
+        m_wheelTime++;
+        msec--;
+
+        // Move the expired counters in the slot to my expiring list (a slot can contain counters for future revolutions)
+        Cpl::Container::DList<CounterCallback_>& slot       = m_wheel[m_wheelTime & WHEEL_MASK_];
+        CounterCallback_*                        counterPtr = slot.first();
+        while ( counterPtr )
+        {
+            CounterCallback_* nextPtr = slot.next( *counterPtr );
+            if ( (long) (counterPtr->count() - m_wheelTime) <= 0 )
+            {
+                slot.remove( *counterPtr );
+                m_expiring.put( *counterPtr );
+                m_numActive--;
+            }
+            counterPtr = nextPtr;
+        }
+
+        // Expire the counters (Note: the expired() callbacks are allowed to detach counters that are in the expiring list)
+        while ( (counterPtr = m_expiring.get()) )
+        {
+            recordExpiration( msec );
+            counterPtr->decrement( counterPtr->count() );
+            counterPtr->expired();
+        }
+    }
+}
+
+bool TimerManager::getNextExpiration( unsigned long& msecFromLastTick ) noexcept
+{
+    if ( m_numActive == 0 )
+    {
+        return false;
+    }
+
+    // Search (at most) one revolution of the wheel for the first slot that contains a counter that expires in the current revolution
+    for ( unsigned long delta=1; delta <= OPTION_CPL_SYSTEM_TIMER_MANAGER_WHEEL_SLOTS; delta++ )
+    {
+        Cpl::Container::DList<CounterCallback_>& slot       = m_wheel[(m_wheelTime + delta) & WHEEL_MASK_];
+        CounterCallback_*                        counterPtr = slot.first();
+        while ( counterPtr )
+        {
+            if ( (long) (counterPtr->count() - (m_wheelTime + delta)) <= 0 )
+            {
+                msecFromLastTick = delta;
+                return true;
+            }
+            counterPtr = slot.next( *counterPtr );
+        }
+    }
+
+    // All active counters expire in a future revolution
+    msecFromLastTick = OPTION_CPL_SYSTEM_TIMER_MANAGER_WHEEL_SLOTS;
+    return true;
+}
+
+void TimerManager::addToActiveList( CounterCallback_& clientToCallback ) noexcept
+{
+    // Convert the counter's relative count to an absolute expiration time (a zero count expires on the next tick)
+    clientToCallback.increment( m_wheelTime + (clientToCallback.count() == 0 ? 1 : 0) );
+    CPL_SYSTEM_TRACE_MSG( SECT_, (">> INSERT: %p, expires=%lu, now=%lu", &clientToCallback, clientToCallback.count(), m_wheelTime) );
+    m_wheel[clientToCallback.count() & WHEEL_MASK_].put( clientToCallback );
+    m_numActive++;
+}
+
+bool TimerManager::detach( CounterCallback_& clientToCallback ) noexcept
+{
+    // Try my pending list FIRST
+    if ( m_pendingAttach.remove( clientToCallback ) )
+    {
+        return true;
+    }
+
+    // Expired, but the callback has not been called yet
+    if ( m_expiring.remove( clientToCallback ) )
+    {
+        return true;
+    }
+
+    // If I have the counter/timer -->it will be in the slot for its expiration time
+    if ( m_wheel[clientToCallback.count() & WHEEL_MASK_].remove( clientToCallback ) )
+    {
+        // Convert the counter back to a relative count
+        unsigned long remaining = (long) (clientToCallback.count() - m_wheelTime) > 0 ? clientToCallback.count() - m_wheelTime : 0;
+        clientToCallback.decrement( clientToCallback.count() - remaining );
+        m_numActive--;
+        return true;
+    }
+
+    // If I get here, the Counter was NOT in the active list (AND it was not in the staging list)
+    return false;
+}
+
+#else  // Delta list
+
+bool TimerManager::areActiveTimers( void ) noexcept
+{
+    return m_counters.first() == 0;
+}
+
+bool TimerManager::getNextExpiration( unsigned long& msecFromLastTick ) noexcept
+{
+    // The first counter in the list is the next counter to expire
+    CounterCallback_* counterPtr = m_counters.first();
+    if ( counterPtr == 0 )
+    {
+        return false;
+    }
+    msecFromLastTick = counterPtr->count();
+    return true;
+}
+
+void TimerManager::tick( unsigned long msec ) noexcept
+{
+    // Set my state to: PROCESSING TICK(S)    
+    m_inTickCall = true;
+
+    while ( msec )
+    {
+        CounterCallback_* counterPtr = m_counters.first();
+        if ( counterPtr == 0 )
+        {
+            // No timers registered -->do NOTHING
+            break;
+        }
+        else
+        {
+            // Decrement the first/active counter in the list
+            unsigned long nextCount = counterPtr->count();
+            if ( msec <= nextCount )
+            {
+                counterPtr->decrement( msec );
+                msec = 0;
+            }
+            else
+            {
+                counterPtr->decrement( nextCount );
+                msec -= nextCount;
+            }
+
+            // Process ALL local Timers that have a ZERO countdown value
+            while ( counterPtr && counterPtr->count() == 0 )
+            {
+                recordExpiration( msec );        // Note: 'msec' is the time remaining in the tick cycle after the counter expired
+                m_counters.get();                // Remove the expired counter from the list
+                counterPtr->expired();           // Expire the counter
+                counterPtr = m_counters.first(); // Get next counter
+            }
+        }
+    }
+}
+
 void TimerManager::addToActiveList( CounterCallback_& clientToCallback ) noexcept
 {
     // Insert the counter wisely into the list.  The counters are
@@ -191,9 +372,4 @@ bool TimerManager::detach( CounterCallback_& clientToCallback ) noexcept
 }
 
 
-unsigned long TimerManager::msecToCounts( unsigned long milliseconds ) noexcept
-{
-    unsigned long delta = Cpl::System::ElapsedTime::deltaMilliseconds( m_timeNow );
-    CPL_SYSTEM_TRACE_MSG( SECT_, ("milliseconds IN=%lu, count out=%lu", milliseconds, milliseconds + delta) );
-    return milliseconds + delta;
-}
+#endif  // end USE_CPL_SYSTEM_TIMER_MANAGER_TIMING_WHEEL
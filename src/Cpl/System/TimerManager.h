@@ -12,10 +12,20 @@
 *----------------------------------------------------------------------------*/
 /** @file */
 
+#include "colony_config.h"
 #include "Cpl/System/Counter_.h"
 #include "Cpl/Container/DList.h"
 
 
+/** Number of slots, i.e. milliseconds per revolution, in the timing wheel
+    (see USE_CPL_SYSTEM_TIMER_MANAGER_TIMING_WHEEL).  The value MUST be a power
+    of 2.
+ */
+#ifndef OPTION_CPL_SYSTEM_TIMER_MANAGER_WHEEL_SLOTS
+#define OPTION_CPL_SYSTEM_TIMER_MANAGER_WHEEL_SLOTS     256
+#endif
+
+
 ///
 namespace Cpl {
 ///
@@ -28,12 +38,31 @@ namespace System {
     are many Timers in the list, i.e. the amount of time to decrement the
     individual Timers is NOT a function of the number of active Timers.
 
+    When USE_CPL_SYSTEM_TIMER_MANAGER_TIMING_WHEEL is defined, the active
+    Timers are stored in a hashed timing wheel instead, i.e. each Timer is
+    placed in the slot for its absolute expiration time (modulo the number of
+    slots) and only the slots for the elapsed milliseconds are examined when
+    processing ticks.  Starting and stopping a Timer is then O(1) (vs. O(n) for
+    the delta list) at the cost of OPTION_CPL_SYSTEM_TIMER_MANAGER_WHEEL_SLOTS
+    list heads of RAM per Timer Manager instance.  With the timing wheel, the
+    Counter's count() value is the absolute expiration time (in the Timer
+    Manager's time base) while the counter is active.
+
     The Timer Manager requires that the Timer Manager instances, all Timer
     instances, add the Timer's Context (i.e. the code that executes the
     timer expired callbacks) all execute in the SAME thread.
  */
 class TimerManager : public CounterSource_
 {
+public:
+    /// Timer statistics
+    struct TimerStats_T
+    {
+        unsigned long m_numExpired;         //!< Number of counters that have expired
+        unsigned long m_totalLatenessMsec;  //!< Sum of the times, in milliseconds, between when the counters expired and when the expired callbacks were called
+        unsigned long m_maxLatenessMsec;    //!< Maximum time, in milliseconds, between when a counter expired and its expired callback was called
+    };
+
 public:
     /// Constructor
     TimerManager();
@@ -56,6 +85,30 @@ public:
     /// Returns true if there are NO active timers
     bool areActiveTimers( void ) noexcept;
 
+    /** This method returns the number of milliseconds, from 'now', until the
+        next active timer expires.  If there are no active timers, or the next
+        expiration is more than 'maxMsec' milliseconds away, 'maxMsec' is
+        returned.  Zero is returned if a timer has already expired, but has
+        not been processed.
+
+        Note: When the Timer Manager is implemented as a timing wheel, the
+              returned value can be earlier than the actual next expiration
+              (but never later), i.e. the timing wheel only searches one
+              revolution of the wheel.
+
+        This method must be called from the same thread that the Timer Manager
+        executes in.
+     */
+    unsigned long msecToNextExpiration( unsigned long maxMsec ) noexcept;
+
+    /** This method returns the Timer Manager's timer statistics.  When
+        'resetStats' is true, the statistics are cleared after being returned.
+
+        This method is NOT thread safe, i.e. the values are only approximate
+        when called from a different thread than the Timer Manager's thread.
+     */
+    void getTimerStats( TimerStats_T& dstStats, bool resetStats = false ) noexcept;
+
 
 public:
     ///  See Cpl::System::CounterCallback_
@@ -82,9 +135,32 @@ protected:
      */
     virtual void tickComplete( void ) noexcept;
 
+    /** Helper method that returns the number of milliseconds - relative to the
+        last tick cycle - until the next active counter expires.  The method
+        returns false if there are no active counters.
+     */
+    bool getNextExpiration( unsigned long& msecFromLastTick ) noexcept;
+
+    /// Helper method that updates the timer statistics for an expired counter
+    void recordExpiration( unsigned long latenessMsec ) noexcept;
+
 protected:
+#ifdef USE_CPL_SYSTEM_TIMER_MANAGER_TIMING_WHEEL
+    /// Timing wheel of active counters
+    Cpl::Container::DList<CounterCallback_> m_wheel[OPTION_CPL_SYSTEM_TIMER_MANAGER_WHEEL_SLOTS];
+
+    /// List of counters that have expired, but whose callbacks have not yet been called
+    Cpl::Container::DList<CounterCallback_> m_expiring;
+
+    /// Current time of the timing wheel (in milliseconds)
+    unsigned long                           m_wheelTime;
+
+    /// Number of counters in the timing wheel
+    unsigned long                           m_numActive;
+#else
     /// List of active counters
     Cpl::Container::DList<CounterCallback_> m_counters;
+#endif
 
     /// List of Pending-to-attach counters (this happens when timers attach from the timer-expired-callbacks)
     Cpl::Container::DList<CounterCallback_> m_pendingAttach;
@@ -95,6 +171,9 @@ protected:
     /// Elapsed time of the current processing cycle
     unsigned long                           m_timeNow;
 
+    /// Timer statistics
+    TimerStats_T                            m_timerStats;
+
     /// Flag to tracks when I am actively processing/consuming ticks
     bool                                    m_inTickCall;
 };
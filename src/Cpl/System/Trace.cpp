@@ -23,13 +23,35 @@ using namespace Cpl::System;
 
 typedef Cpl::Text::FString<OPTION_CPL_SYSTEM_TRACE_MAX_SECTION_NAME_LEN> Section_T;
 
-static bool               threadFilterEnabled_ = false;
+typedef Cpl::Text::FString<OPTION_CPL_SYSTEM_TRACE_MAX_BUFFER> Text_T;
+
+static std::atomic<bool>  threadFilterEnabled_( false );
 static bool               enabled_             = OPTION_CPL_SYSTEM_TRACE_DEFAULT_ENABLE_STATE;
 static Trace::InfoLevel_T infoLevel_           = OPTION_CPL_SYSTEM_TRACE_DEFAULT_INFO_LEVEL;
 static Section_T          activeSections_[OPTION_CPL_SYSTEM_TRACE_MAX_SECTIONS];
 static const char*        threadFilters_[NUM_THREAD_FILTERS_];
 
-static Cpl::Text::FString<OPTION_CPL_SYSTEM_TRACE_MAX_BUFFER> buffer_;
+#ifdef USE_CPL_SYSTEM_TRACE_LOCK_FREE
+#define NUM_BUFFERS_        OPTION_CPL_SYSTEM_TRACE_NUM_BUFFERS
+#else
+#define NUM_BUFFERS_        0
+#endif
+
+// Buffers (Note: the LAST buffer is the 'overflow' buffer that is used while holding the trace output mutex)
+static Text_T             text_[NUM_BUFFERS_ + 1];
+static Trace::Buffer_     buffers_[NUM_BUFFERS_ + 1];
+
+#define OVERFLOW_BUFFER_    buffers_[NUM_BUFFERS_]
+
+#ifdef USE_CPL_SYSTEM_TRACE_LOCK_FREE
+std::atomic<uint32_t> Trace::generation_( 1 );
+
+/// Invalidates the call-site caches
+#define NEW_GENERATION_()   newGeneration_()
+#else
+/// There are no call-site caches
+#define NEW_GENERATION_()
+#endif
 
 
 ////////////////////////////////////////////////////////////////////////
@@ -42,8 +64,7 @@ Trace::Trace( const char* filename, int linenum, const char* funcname, const cha
 {
     if ( isSectionEnabled_( section ) && passedThreadFilter_() )
     {
-        traceLocation_( section, filename, linenum, funcname );
-        traceUserMsg_( "->ENTER: %s", scope );
+        traceLocation_( section, filename, linenum, funcname ).traceUserMsg_( "->ENTER: %s", scope );
     }
 }
 
@@ -51,8 +72,7 @@ Trace::~Trace()
 {
     if ( isSectionEnabled_( m_section ) && passedThreadFilter_() )
     {
-        traceLocation_( m_section, m_filename, m_linenum, m_funcname );
-        traceUserMsg_( "->EXIT:  %s", m_scope );
+        traceLocation_( m_section, m_filename, m_linenum, m_funcname ).traceUserMsg_( "->EXIT:  %s", m_scope );
     }
 }
 
@@ -61,38 +81,73 @@ Trace::~Trace()
 // NOTE The following two methods MUST be called in order AND always
 //      as pair!
 //
-void Trace::traceLocation_( const char* section, const char* filename, int linenum, const char* funcname )
+Trace::Buffer_& Trace::traceLocation_( const char* section, const char* filename, int linenum, const char* funcname )
 {
     // Get the current tracing level parameter
     Locks_::tracing().lock();
     Trace::InfoLevel_T infoLevel = infoLevel_;
     Locks_::tracing().unlock();
 
-    // Serialize the output
-    Locks_::tracingOutput().lock();
-    buffer_ = OPTION_CPL_SYSTEM_TRACE_PREFIX_STRING;
-    TracePlatform_::appendInfo( buffer_, infoLevel, section, filename, linenum, funcname );
+    // Claim a free buffer
+    Buffer_* bufPtr = &OVERFLOW_BUFFER_;
+#ifdef USE_CPL_SYSTEM_TRACE_LOCK_FREE
+    for ( int i=0; i < NUM_BUFFERS_; i++ )
+    {
+        if ( !buffers_[i].m_inUse.test_and_set( std::memory_order_acquire ) )
+        {
+            bufPtr = &buffers_[i];
+            break;
+        }
+    }
+#endif
+
+    // All buffers are in use -->serialize the formatting AND the output
+    if ( bufPtr == &OVERFLOW_BUFFER_ )
+    {
+        Locks_::tracingOutput().lock();
+    }
+
+    Text_T& text = text_[bufPtr - buffers_];
+    text         = OPTION_CPL_SYSTEM_TRACE_PREFIX_STRING;
+    TracePlatform_::appendInfo( text, infoLevel, section, filename, linenum, funcname );
+    return *bufPtr;
 }
 
 
-void Trace::traceUserMsg_( const char* format, ... )
+void Trace::Buffer_::traceUserMsg_( const char* format, ... )
 {
+    Text_T& text = text_[this - buffers_];
     va_list ap;
     va_start( ap, format );
-    buffer_.vformatAppend( format, ap );
+    text.vformatAppend( format, ap );
     va_end( ap );
 
-    buffer_ += OPTION_CPL_SYSTEM_TRACE_SUFFIX_STRING;
+    text += OPTION_CPL_SYSTEM_TRACE_SUFFIX_STRING;
 
     // Ensure that the suffix is ALWAYS valid when appended (at the expense of truncating the user msg)
-    if ( buffer_.truncated() )
+    if ( text.truncated() )
     {
-        buffer_.trimRight( strlen( OPTION_CPL_SYSTEM_TRACE_SUFFIX_STRING ) );
-        buffer_ += OPTION_CPL_SYSTEM_TRACE_SUFFIX_STRING;
+        text.trimRight( strlen( OPTION_CPL_SYSTEM_TRACE_SUFFIX_STRING ) );
+        text += OPTION_CPL_SYSTEM_TRACE_SUFFIX_STRING;
     }
 
-    TracePlatform_::output( buffer_ );
-    Locks_::tracingOutput().unlock();
+    // Overflow buffer: the output mutex is already held
+    if ( this == &OVERFLOW_BUFFER_ )
+    {
+        TracePlatform_::output( text );
+        Locks_::tracingOutput().unlock();
+    }
+
+#ifdef USE_CPL_SYSTEM_TRACE_LOCK_FREE
+    // Only the output is serialized
+    else
+    {
+        Locks_::tracingOutput().lock();
+        TracePlatform_::output( text );
+        Locks_::tracingOutput().unlock();
+        m_inUse.clear( std::memory_order_release );
+    }
+#endif
 }
 
 
@@ -102,6 +157,7 @@ void Trace::enable_( void )
 {
     Locks_::tracing().lock();
     enabled_ = true;
+    NEW_GENERATION_();
     Locks_::tracing().unlock();
 }
 
@@ -110,6 +166,7 @@ void Trace::disable_( void )
 {
     Locks_::tracing().lock();
     enabled_ = false;
+    NEW_GENERATION_();
     Locks_::tracing().unlock();
 }
 
@@ -156,6 +213,7 @@ bool Trace::enableSection_( const char* sectionToEnable )
             {
                 activeSections_[i] = sectionToEnable;
                 result            = true;
+                NEW_GENERATION_();
                 break;
             }
         }
@@ -195,6 +253,7 @@ void Trace::disableSection_( const char* sectionToDisable )
         }
     }
 
+    NEW_GENERATION_();
     Locks_::tracing().unlock();
 }
 
@@ -231,6 +290,23 @@ bool Trace::isSectionEnabled_( const char* section )
     return result;
 }
 
+#ifdef USE_CPL_SYSTEM_TRACE_LOCK_FREE
+bool Trace::resolveSiteCache_( const char* section, SiteCache_& siteCache, uint32_t generation ) noexcept
+{
+    // NOTE: If the settings change while resolving - the cached value is stale on arrival, i.e. it will be resolved again on the next call
+    bool result = isSectionEnabled_( section );
+    siteCache.store( ( generation << 1 ) | ( result ? 1 : 0 ), std::memory_order_relaxed );
+    return result;
+}
+
+void Trace::newGeneration_() noexcept
+{
+    // Note: The generation is limited to 31 bits (and skips zero) since it is stored 'shifted' in the call-site caches
+    uint32_t next = ( generation_.load( std::memory_order_relaxed ) + 1 ) & 0x7FFFFFFF;
+    generation_.store( next == 0 ? 1 : next, std::memory_order_release );
+}
+#endif
+
 unsigned Trace::getSections_( Cpl::Text::String& dst )
 {
     bool     first = true;
@@ -298,6 +374,12 @@ void Trace::clearThreadFilter_( void )
 
 bool Trace::passedThreadFilter_()
 {
+    // Skip the lock when there is no active filter
+    if ( !threadFilterEnabled_.load( std::memory_order_acquire ) )
+    {
+        return true;
+    }
+
     // Safely get the current's thread name (i.e. works with non-CPL threads)
     const char* threadNameToTest = nullptr;
     Thread*     curThread        = Thread::tryGetCurrent();
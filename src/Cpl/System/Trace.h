@@ -17,6 +17,9 @@
 #include "Cpl/Text/String.h"
 #include "Cpl/System/Thread.h" 
 #include "Cpl/Io/Output.h"
+#include <atomic>
+#include <type_traits>
+#include <stdint.h>
 
 
 /// 
@@ -33,6 +36,20 @@ namespace System {
     trace message (info + user msg) is an Atomic operation within a multi-thread
     environment.
 
+    When USE_CPL_SYSTEM_TRACE_LOCK_FREE is defined, each CPL_SYSTEM_TRACE_MSG()
+    call site - whose section is a string literal - caches the 'enabled' state
+    of its section.  The cache is invalidated by a generation counter that is
+    incremented every time the trace settings are changed, i.e. a call site
+    with a disabled section only costs two atomic loads (no mutex, no string
+    compares).  The trace messages are formatted in a per-thread buffer (i.e.
+    claimed from a pool of buffers - see OPTION_CPL_SYSTEM_TRACE_NUM_BUFFERS)
+    so that concurrently tracing threads are only serialized when the
+    formatted message is written to the output stream.  The option is off by
+    default because claiming a buffer requires native atomic read-modify-write
+    support (e.g. it is NOT available on a Cortex M0+).  When the option is
+    not defined, all trace messages are formatted in a single buffer while
+    holding the trace output mutex.
+
     All of the `methods SHOULD be access via the preprocessor macros below to
     allow the 'trace code' to be compiled out of a 'release' build if desired.
     In addition to a compile time decision to use/exclude tracing, there are
@@ -125,18 +142,53 @@ public:
     };
 
 public:
-    /** This function is used to trace the 'location' for general purpose trace
-        messages.
+    /** This class is a buffer that is used to construct a single trace
+        message.  A buffer is 'owned' by a single thread from the time
+        traceLocation_() returns until the buffer's traceUserMsg_() method
+        returns.
 
-        NOTE: NEVER call this method directly
+        NOTE: NEVER use this class directly
      */
-    static void traceLocation_( const char* section, const char* filename, int linenum, const char* funcname );
+    class Buffer_
+    {
+    public:
+#ifdef USE_CPL_SYSTEM_TRACE_LOCK_FREE
+        /// Constructor
+        Buffer_() noexcept { m_inUse.clear(); }
+#endif
 
-    /** This function is used to generate general purpose trace messages.
+    public:
+        /** This function is used to generate general purpose trace messages.
+            The method releases the buffer.
+
+            NOTE: NEVER call this method directly
+         */
+        void traceUserMsg_( const char* format, ... );
+
+#ifdef USE_CPL_SYSTEM_TRACE_LOCK_FREE
+    public:
+        /// Ownership flag (Note: the message storage is private to the trace engine)
+        std::atomic_flag    m_inUse;
+#endif
+    };
+
+#ifdef USE_CPL_SYSTEM_TRACE_LOCK_FREE
+    /** Per call-site cache of the 'section is enabled' state.  The cached value
+        is: (generation << 1) | enabledBit
+
+        NOTE: NEVER use this type directly
+     */
+    typedef std::atomic<uint32_t> SiteCache_;
+#endif
+
+public:
+    /** This function is used to trace the 'location' for general purpose trace
+        messages.  The function returns the buffer that the caller MUST use to
+        complete - via Buffer_::traceUserMsg_() - the trace message.
 
         NOTE: NEVER call this method directly
      */
-    static void traceUserMsg_( const char* format, ... );
+    static Buffer_& traceLocation_( const char* section, const char* filename, int linenum, const char* funcname );
 
 public:
     /** This method enables the output/logging of trace message at run-time.
@@ -204,6 +256,33 @@ public:
      */
     static bool isSectionEnabled_( const char* section );
 
+#ifdef USE_CPL_SYSTEM_TRACE_LOCK_FREE
+    /** Same as isSectionEnabled_( section ) - except that the result is
+        cached in 'siteCache' when 'section' is a string literal (or a char
+        array).  The cached result is used until the trace settings are changed.
+
+        NOTE: NEVER call this method directly -->use the CPL_SYSTEM_TRACE_xxx()
+              macros.
+     */
+    template <class T>
+    static inline bool isSectionEnabled_( const T& section, SiteCache_& siteCache ) noexcept
+    {
+        // Section names that are NOT arrays (e.g. a 'const char*' variable) can vary per call -->no caching
+        if ( !std::is_array<T>::value )
+        {
+            return isSectionEnabled_( section );
+        }
+
+        uint32_t generation = generation_.load( std::memory_order_acquire );
+        uint32_t cached     = siteCache.load( std::memory_order_relaxed );
+        if ( (cached >> 1) == generation )
+        {
+            return ( cached & 1 ) != 0;
+        }
+        return resolveSiteCache_( section, siteCache, generation );
+    }
+#endif
+
     /** This method returns the number of enabled 'sections' and returns the
         actual section name(s) via the String 'dst'.  It is the caller
         responsibility to ensure that 'dst' is large enough to hold all of the
@@ -290,6 +369,18 @@ public:
     static Cpl::Io::Output* getDefaultOutputStream_( void ) noexcept;
 
 
+#ifdef USE_CPL_SYSTEM_TRACE_LOCK_FREE
+protected:
+    /// Helper method that updates a call-site cache
+    static bool resolveSiteCache_( const char* section, SiteCache_& siteCache, uint32_t generation ) noexcept;
+
+    /// Helper method that invalidates all of the call-site caches.  Note: Must be called while holding the tracing lock
+    static void newGeneration_() noexcept;
+
+    /// Current generation of the trace settings (is never zero)
+    static std::atomic<uint32_t> generation_;
+#endif
+
 protected:
     /// Caches trace info for exit message
     const char* m_filename;
@@ -336,8 +427,13 @@ protected:
 /// Macro Wrapper
 #define CPL_SYSTEM_TRACE_SCOPE(sect,label)         Cpl::System::Trace cplSystemTraceInstance_ (__FILE__,__LINE__,CPL_SYSTEM_TRACE_PRETTY_FUNCNAME,sect,label)
 
+#ifdef USE_CPL_SYSTEM_TRACE_LOCK_FREE
+/// Macro Wrapper
+#define CPL_SYSTEM_TRACE_MSG(sect, var_args)        do { static Cpl::System::Trace::SiteCache_ cplSystemTraceSite_; if ( Cpl::System::Trace::isSectionEnabled_(sect,cplSystemTraceSite_) && Cpl::System::Trace::passedThreadFilter_() ) {Cpl::System::Trace::traceLocation_(sect,__FILE__,__LINE__,CPL_SYSTEM_TRACE_PRETTY_FUNCNAME).traceUserMsg_ var_args;}} while(0)
+#else
 /// Macro Wrapper
-#define CPL_SYSTEM_TRACE_MSG(sect, var_args)        do { if ( Cpl::System::Trace::isSectionEnabled_(sect) && Cpl::System::Trace::passedThreadFilter_() ) {Cpl::System::Trace::traceLocation_(sect,__FILE__,__LINE__,CPL_SYSTEM_TRACE_PRETTY_FUNCNAME);Cpl::System::Trace::traceUserMsg_ var_args;}} while(0)
+#define CPL_SYSTEM_TRACE_MSG(sect, var_args)        do { if ( Cpl::System::Trace::isSectionEnabled_(sect) && Cpl::System::Trace::passedThreadFilter_() ) {Cpl::System::Trace::traceLocation_(sect,__FILE__,__LINE__,CPL_SYSTEM_TRACE_PRETTY_FUNCNAME).traceUserMsg_ var_args;}} while(0)
+#endif
 
 /// Macro Wrapper
 #define CPL_SYSTEM_TRACE_ENABLE()                   Cpl::System::Trace::enable_()
@@ -491,6 +587,18 @@ protected:
 #define OPTION_CPL_SYSTEM_TRACE_MAX_BUFFER              511
 #endif
 
+   /** The number of trace buffers (each OPTION_CPL_SYSTEM_TRACE_MAX_BUFFER in
+       size) that can be used concurrently by different threads to format
+       their trace messages.  There is always one additional buffer that is
+       used - while holding the trace output mutex - when all of the other
+       buffers are in use, i.e. setting this value to zero serializes ALL
+       trace message formatting.  Only applies when USE_CPL_SYSTEM_TRACE_LOCK_FREE
+       is defined.
+    */
+#ifndef OPTION_CPL_SYSTEM_TRACE_NUM_BUFFERS
+#define OPTION_CPL_SYSTEM_TRACE_NUM_BUFFERS             2
+#endif
+
 
    /** String literal that is the prefix for all trace messages
     */
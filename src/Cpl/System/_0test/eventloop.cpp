@@ -0,0 +1,272 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+
+#include "Catch/catch.hpp"
+#include "Cpl/System/_testsupport/Shutdown_TS.h"
+#include "Cpl/System/EventLoop.h"
+#include "Cpl/System/Timer.h"
+#include "Cpl/System/Thread.h"
+#include "Cpl/System/Api.h"
+#include "Cpl/System/Trace.h"
+#include "Cpl/Itc/MailboxServer.h"
+
+using namespace Cpl::System;
+
+#define SECT_   "_0test"
+
+#define TIMER_PERIOD_       50
+#define NUM_EXPIRES_        5
+
+/// Event loop that runs a periodic timer NUM_EXPIRES_ times
+class PeriodicLoop : public EventLoop
+{
+public:
+    ///
+    TimerComposer<PeriodicLoop> m_timer;
+    ///
+    volatile unsigned           m_expiredCount;
+
+public:
+    ///
+    PeriodicLoop( unsigned long timeout, bool deadlineWakeups )
+        : EventLoop( timeout )
+        , m_timer( *this, *this, &PeriodicLoop::expired )
+        , m_expiredCount( 0 )
+    {
+        setDeadlineWakeups( deadlineWakeups );
+    }
+
+    ///
+    void appRun()
+    {
+        startEventLoop();
+        m_timer.start( TIMER_PERIOD_ );
+        while ( waitAndProcessEvents() )
+            ;
+        stopEventLoop();
+    }
+
+    ///
+    void expired()
+    {
+        if ( ++m_expiredCount < NUM_EXPIRES_ )
+        {
+            m_timer.start( TIMER_PERIOD_ );
+        }
+    }
+};
+
+static void run( PeriodicLoop& loop, const char* label, EventLoop::WakeupStats_T& stats )
+{
+    Thread* t = Thread::create( loop, label );
+    Api::sleep( TIMER_PERIOD_ * (NUM_EXPIRES_ + 2) );
+    loop.getWakeupStats( stats );
+    loop.pleaseStop();
+    Api::sleep( 100 );
+    REQUIRE( t->isRunning() == false );
+    Thread::destroy( *t );
+
+    CPL_SYSTEM_TRACE_MSG( SECT_, ("%s: elapsed=%lu ms, wakeups=%lu (%lu/sec), timeouts=%lu, timers=%lu, max lateness=%lu ms, total lateness=%lu ms",
+                                   label,
+                                   stats.m_elapsedMsec,
+                                   stats.m_wakeups,
+                                   stats.m_elapsedMsec ? stats.m_wakeups * 1000 / stats.m_elapsedMsec : 0,
+                                   stats.m_timeouts,
+                                   stats.m_timers.m_numExpired,
+                                   stats.m_timers.m_maxLatenessMsec,
+                                   stats.m_timers.m_totalLatenessMsec) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_CASE( "eventloop" )
+{
+    Cpl::System::Shutdown_TS::clearAndUseCounter();
+
+    SECTION( "polling" )
+    {
+        PeriodicLoop             loop( 1, false );
+        EventLoop::WakeupStats_T stats;
+        run( loop, "POLLING", stats );
+        REQUIRE( loop.m_expiredCount == NUM_EXPIRES_ );
+        REQUIRE( stats.m_timers.m_numExpired == NUM_EXPIRES_ );
+        REQUIRE( stats.m_wakeups > NUM_EXPIRES_ * 2 );
+    }
+
+    SECTION( "deadline" )
+    {
+        PeriodicLoop             loop( 10000, true );
+        EventLoop::WakeupStats_T stats;
+        run( loop, "DEADLINE", stats );
+        REQUIRE( loop.m_expiredCount == NUM_EXPIRES_ );
+        REQUIRE( stats.m_timers.m_numExpired == NUM_EXPIRES_ );
+
+        // One wake-up per timer expiration (plus some slack for early wake-ups)
+        REQUIRE( stats.m_wakeups <= NUM_EXPIRES_ * 2 );
+    }
+
+    REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 0u );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+#ifdef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+
+#define PROFILE_NUM_MSGS_       10
+
+/// Mailbox server that runs a periodic timer NUM_EXPIRES_ times (the timer is started by a message)
+class ProfiledServer : public Cpl::Itc::MailboxServer
+{
+public:
+    ///
+    TimerComposer<ProfiledServer>   m_timer;
+    ///
+    volatile unsigned               m_expiredCount;
+    ///
+    volatile unsigned               m_eventCount;
+
+public:
+    ///
+    ProfiledServer()
+        : m_timer( *this, *this, &ProfiledServer::expired )
+        , m_expiredCount( 0 )
+        , m_eventCount( 0 )
+    {
+    }
+
+    ///
+    void expired()
+    {
+        if ( ++m_expiredCount < NUM_EXPIRES_ )
+        {
+            m_timer.start( 10 );
+        }
+    }
+
+    ///
+    void processEventFlag( uint8_t eventNumber ) noexcept
+    {
+        m_eventCount++;
+    }
+};
+
+/// Message that (optionally) starts the server's timer
+class ProfiledMsg : public Cpl::Itc::Message
+{
+public:
+    ///
+    ProfiledServer& m_server;
+    ///
+    bool            m_startTimer;
+    ///
+    unsigned&       m_processed;
+
+    ///
+    ProfiledMsg( ProfiledServer& server, bool startTimer, unsigned& processed )
+        :m_server( server ), m_startTimer( startTimer ), m_processed( processed ) {}
+
+    ///
+    void process() noexcept
+    {
+        m_processed++;
+        if ( m_startTimer )
+        {
+            m_server.m_timer.start( 10 );
+        }
+    }
+};
+
+static void runProfile( unsigned maxMessagesPerPass )
+{
+    ProfiledServer server;
+    unsigned       processed = 0;
+    ProfiledMsg*   msgs[PROFILE_NUM_MSGS_];
+    server.setMaxMessagesPerPass( maxMessagesPerPass );
+    REQUIRE( ((Runnable&) server).getEventLoop_() == (EventLoop*) &server );
+
+    // Queue the messages and events BEFORE the thread runs
+    for ( unsigned i=0; i < PROFILE_NUM_MSGS_; i++ )
+    {
+        msgs[i] = new ProfiledMsg( server, i == 0, processed );
+        server.post( *msgs[i] );
+    }
+    server.notifyEvents( 0x09 );
+
+    Thread* t = Thread::create( server, "PROFILE" );
+    Api::sleep( 200 );
+    EventLoop::Profile_T profile;
+    REQUIRE( server.getProfile( profile ) );
+    REQUIRE( processed == PROFILE_NUM_MSGS_ );
+    REQUIRE( server.m_expiredCount == NUM_EXPIRES_ );
+    REQUIRE( server.m_eventCount == 2 );
+
+    CPL_SYSTEM_TRACE_MSG( SECT_, ("msgsPerPass=%u: elapsed=%lu, busy=%lu, idle=%lu, loops=%lu, timers=%lu, flags=%lu (peak=%lu), msgs=%lu (peak=%lu)",
+                                   maxMessagesPerPass,
+                                   profile.m_elapsedTicks,
+                                   profile.m_busyTicks,
+                                   profile.m_idleTicks,
+                                   profile.m_loops,
+                                   profile.m_categories[EventLoop::ePROFILE_TIMERS].m_count,
+                                   profile.m_categories[EventLoop::ePROFILE_EVENT_FLAGS].m_count,
+                                   profile.m_categories[EventLoop::ePROFILE_EVENT_FLAGS].m_peakQueueDepth,
+                                   profile.m_categories[EventLoop::ePROFILE_MESSAGES].m_count,
+                                   profile.m_categories[EventLoop::ePROFILE_MESSAGES].m_peakQueueDepth) );
+
+    REQUIRE( profile.m_elapsedTicks >= 150 * OPTION_CPL_SYSTEM_EVENT_LOOP_PROFILE_TICKS_PER_MSEC );
+    REQUIRE( profile.m_busyTicks + profile.m_idleTicks <= profile.m_elapsedTicks );
+    REQUIRE( profile.m_idleTicks > 0 );
+    REQUIRE( profile.m_categories[EventLoop::ePROFILE_TIMERS].m_count == NUM_EXPIRES_ );
+    REQUIRE( profile.m_categories[EventLoop::ePROFILE_TIMERS].m_peakQueueDepth == 0 );
+    REQUIRE( profile.m_categories[EventLoop::ePROFILE_EVENT_FLAGS].m_count == 2 );
+    REQUIRE( profile.m_categories[EventLoop::ePROFILE_EVENT_FLAGS].m_peakQueueDepth == 2 );
+    REQUIRE( profile.m_categories[EventLoop::ePROFILE_MESSAGES].m_count == PROFILE_NUM_MSGS_ );
+    REQUIRE( profile.m_categories[EventLoop::ePROFILE_MESSAGES].m_peakQueueDepth == PROFILE_NUM_MSGS_ );
+    REQUIRE( profile.m_categories[EventLoop::ePROFILE_NOTIFICATIONS].m_count == 0 );
+    unsigned long loops = 0;
+    for ( unsigned i=0; i < OPTION_CPL_SYSTEM_EVENT_LOOP_PROFILE_NUM_BUCKETS; i++ )
+    {
+        loops += profile.m_histogram[i];
+    }
+    REQUIRE( loops == profile.m_loops );
+    REQUIRE( loops > NUM_EXPIRES_ );
+
+    // Reset
+    REQUIRE( server.getProfile( profile, true ) );
+    REQUIRE( server.getProfile( profile ) );
+    REQUIRE( profile.m_categories[EventLoop::ePROFILE_MESSAGES].m_count == 0 );
+    REQUIRE( profile.m_categories[EventLoop::ePROFILE_MESSAGES].m_peakQueueDepth == 0 );
+    REQUIRE( profile.m_categories[EventLoop::ePROFILE_TIMERS].m_count == 0 );
+
+    server.pleaseStop();
+    Api::sleep( 100 );
+    REQUIRE( t->isRunning() == false );
+    Thread::destroy( *t );
+    for ( unsigned i=0; i < PROFILE_NUM_MSGS_; i++ )
+    {
+        delete msgs[i];
+    }
+}
+
+TEST_CASE( "eventloop-profile" )
+{
+    Cpl::System::Shutdown_TS::clearAndUseCounter();
+
+    SECTION( "one message per pass" )
+    {
+        runProfile( 1 );
+    }
+
+    SECTION( "drain-all" )
+    {
+        runProfile( 4 );
+    }
+
+    REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 0u );
+}
+#endif
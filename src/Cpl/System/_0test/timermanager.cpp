@@ -0,0 +1,317 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+
+#include "Catch/catch.hpp"
+#include "Cpl/System/_testsupport/Shutdown_TS.h"
+#include "Cpl/System/Timer.h"
+#include "Cpl/System/ElapsedTime.h"
+#include "Cpl/System/Trace.h"
+
+using namespace Cpl::System;
+
+#define SECT_   "_0test"
+
+/// Virtual time (in milliseconds)
+static unsigned long now_;
+
+/// Timer Manager that is driven by virtual time
+class VirtualTimerManager : public TimerManager
+{
+public:
+    /// Advances virtual time one millisecond at a time
+    void advance( unsigned long milliseconds )
+    {
+        while ( milliseconds-- )
+        {
+            now_++;
+            tick( 1 );
+            tickComplete();
+        }
+    }
+
+    /// Advances virtual time in a single tick cycle
+    void jump( unsigned long milliseconds )
+    {
+        now_ += milliseconds;
+        tick( milliseconds );
+        tickComplete();
+    }
+
+    /// Exposes the next expiration (relative to virtual time)
+    bool nextExpiration( unsigned long& msec )
+    {
+        return getNextExpiration( msec );
+    }
+
+    /// No compensation for real time that has elapsed since the last tick
+    unsigned long msecToCounts( unsigned long milliseconds ) noexcept
+    {
+        return milliseconds;
+    }
+};
+
+/// Test timer
+class TestTimer : public Timer
+{
+public:
+    ///
+    unsigned long   m_expiredCount;
+    ///
+    unsigned long   m_expiredTime;
+    ///
+    unsigned long   m_restartDuration;
+    ///
+    TestTimer*      m_stopTimer;
+
+public:
+    ///
+    TestTimer( TimerManager& timingSource )
+        : Timer( timingSource )
+        , m_expiredCount( 0 )
+        , m_expiredTime( 0 )
+        , m_restartDuration( 0 )
+        , m_stopTimer( 0 )
+    {
+    }
+
+    ///
+    void expired() noexcept
+    {
+        m_expiredCount++;
+        m_expiredTime = now_;
+        if ( m_stopTimer )
+        {
+            m_stopTimer->stop();
+        }
+        if ( m_restartDuration )
+        {
+            start( m_restartDuration );
+        }
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_CASE( "timermanager" )
+{
+    Cpl::System::Shutdown_TS::clearAndUseCounter();
+    VirtualTimerManager uut;
+    TestTimer           t1( uut );
+    TestTimer           t2( uut );
+    TestTimer           t3( uut );
+    TestTimer           t4( uut );
+    TestTimer           t5( uut );
+    now_ = 0;
+
+    SECTION( "expire" )
+    {
+        REQUIRE( uut.areActiveTimers() == true );
+        t1.start( 1 );
+        t2.start( 5 );
+        t3.start( 300 );
+        t4.start( 1000 );
+        t5.start( 0 );
+        REQUIRE( uut.areActiveTimers() == false );
+
+        uut.advance( 1000 );
+        REQUIRE( t1.m_expiredCount == 1 );
+        REQUIRE( t1.m_expiredTime == 1 );
+        REQUIRE( t2.m_expiredCount == 1 );
+        REQUIRE( t2.m_expiredTime == 5 );
+        REQUIRE( t3.m_expiredCount == 1 );
+        REQUIRE( t3.m_expiredTime == 300 );
+        REQUIRE( t4.m_expiredCount == 1 );
+        REQUIRE( t4.m_expiredTime == 1000 );
+        REQUIRE( t5.m_expiredCount == 1 );
+        REQUIRE( t5.m_expiredTime == 1 );
+        REQUIRE( t1.count() == 0 );
+        REQUIRE( uut.areActiveTimers() == true );
+    }
+
+    SECTION( "stop" )
+    {
+        t1.start( 10 );
+        t2.start( 20 );
+        t3.start( 700 );
+        uut.advance( 5 );
+        t2.stop();
+        t3.stop();
+        t3.stop();
+        uut.advance( 1000 );
+        REQUIRE( t1.m_expiredCount == 1 );
+        REQUIRE( t1.m_expiredTime == 10 );
+        REQUIRE( t2.m_expiredCount == 0 );
+        REQUIRE( t3.m_expiredCount == 0 );
+        REQUIRE( uut.areActiveTimers() == true );
+    }
+
+    SECTION( "restart" )
+    {
+        t1.start( 10 );
+        uut.advance( 5 );
+        t1.start( 10 );
+        uut.advance( 20 );
+        REQUIRE( t1.m_expiredCount == 1 );
+        REQUIRE( t1.m_expiredTime == 15 );
+
+        t2.m_restartDuration = 10;
+        t2.start( 10 );
+        uut.advance( 35 );
+        REQUIRE( t2.m_expiredCount == 3 );
+        REQUIRE( t2.m_expiredTime == 55 );
+        t2.stop();
+        uut.advance( 100 );
+        REQUIRE( t2.m_expiredCount == 3 );
+    }
+
+    SECTION( "stop-from-callback" )
+    {
+        t1.m_stopTimer = &t2;
+        t1.start( 10 );
+        t2.start( 10 );
+        t3.start( 10 );
+        uut.advance( 10 );
+        REQUIRE( t1.m_expiredCount == 1 );
+        REQUIRE( t3.m_expiredCount == 1 );
+        REQUIRE( t2.m_expiredCount == 0 );
+        uut.advance( 100 );
+        REQUIRE( t2.m_expiredCount == 0 );
+    }
+
+    SECTION( "jump" )
+    {
+        t1.start( 10 );
+        t2.start( 600 );
+        t3.start( 2000 );
+        t4.m_restartDuration = 100;
+        t4.start( 100 );
+        uut.jump( 1000 );
+        REQUIRE( t1.m_expiredCount == 1 );
+        REQUIRE( t2.m_expiredCount == 1 );
+        REQUIRE( t3.m_expiredCount == 0 );
+        REQUIRE( t4.m_expiredCount == 1 );
+        uut.advance( 999 );
+        REQUIRE( t3.m_expiredCount == 0 );
+        uut.advance( 1 );
+        REQUIRE( t3.m_expiredCount == 1 );
+        REQUIRE( t3.m_expiredTime == 2000 );
+        t4.stop();
+    }
+
+    SECTION( "next-expiration" )
+    {
+        unsigned long msec;
+        REQUIRE( uut.nextExpiration( msec ) == false );
+        t1.start( 100 );
+        REQUIRE( uut.nextExpiration( msec ) == true );
+        REQUIRE( msec == 100 );
+        t2.start( 30 );
+        REQUIRE( uut.nextExpiration( msec ) == true );
+        REQUIRE( msec == 30 );
+        uut.advance( 10 );
+        REQUIRE( uut.nextExpiration( msec ) == true );
+        REQUIRE( msec == 20 );
+        uut.advance( 20 );
+        REQUIRE( t2.m_expiredCount == 1 );
+        REQUIRE( uut.nextExpiration( msec ) == true );
+        REQUIRE( msec == 70 );
+        t1.stop();
+        REQUIRE( uut.nextExpiration( msec ) == false );
+
+        // Note: The timing wheel only searches one revolution of the wheel
+        t3.start( 5000 );
+        REQUIRE( uut.nextExpiration( msec ) == true );
+        REQUIRE( msec > 0 );
+        REQUIRE( msec <= 5000 );
+        t3.stop();
+    }
+
+    SECTION( "stats" )
+    {
+        TimerManager::TimerStats_T stats;
+        uut.getTimerStats( stats, true );
+        t1.start( 10 );
+        t2.start( 20 );
+        t3.start( 50 );
+        uut.jump( 25 );
+        uut.advance( 25 );
+        uut.getTimerStats( stats, true );
+        REQUIRE( stats.m_numExpired == 3 );
+        REQUIRE( stats.m_maxLatenessMsec == 15 );
+        REQUIRE( stats.m_totalLatenessMsec == 15 + 5 );
+        uut.getTimerStats( stats );
+        REQUIRE( stats.m_numExpired == 0 );
+    }
+
+    REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 0u );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+#define BENCH_NUM_TIMERS_       10000
+#define BENCH_MAX_DURATION_     5000
+#define BENCH_NUM_TICKS_        2000
+#define BENCH_RESTARTS_PER_MS_  50
+
+static unsigned long random_( unsigned long& seed )
+{
+    seed = seed * 1103515245UL + 12345UL;
+    return (seed >> 16) & 0x7FFF;
+}
+
+TEST_CASE( "timermanager-benchmark", "[.bench]" )
+{
+    VirtualTimerManager uut;
+    TestTimer**         timers = new TestTimer*[BENCH_NUM_TIMERS_];
+    unsigned long       seed   = 1;
+    now_ = 0;
+
+    // Start all of the timers
+    unsigned long start = ElapsedTime::milliseconds();
+    for ( unsigned i=0; i < BENCH_NUM_TIMERS_; i++ )
+    {
+        timers[i] = new TestTimer( uut );
+        timers[i]->m_restartDuration = 1 + random_( seed ) % BENCH_MAX_DURATION_;
+        timers[i]->start( timers[i]->m_restartDuration );
+    }
+    unsigned long startTime = ElapsedTime::deltaMilliseconds( start );
+
+    // Churn: restart (and stop) random timers every millisecond
+    unsigned long expiredCount = 0;
+    start = ElapsedTime::milliseconds();
+    for ( unsigned tick=0; tick < BENCH_NUM_TICKS_; tick++ )
+    {
+        for ( unsigned j=0; j < BENCH_RESTARTS_PER_MS_; j++ )
+        {
+            TestTimer* t = timers[random_( seed ) % BENCH_NUM_TIMERS_];
+            t->stop();
+            t->start( 1 + random_( seed ) % BENCH_MAX_DURATION_ );
+        }
+        uut.advance( 1 );
+    }
+    unsigned long churnTime = ElapsedTime::deltaMilliseconds( start );
+
+    for ( unsigned i=0; i < BENCH_NUM_TIMERS_; i++ )
+    {
+        expiredCount += timers[i]->m_expiredCount;
+        timers[i]->m_restartDuration = 0;
+        timers[i]->stop();
+        delete timers[i];
+    }
+    delete[] timers;
+    REQUIRE( uut.areActiveTimers() == true );
+
+#ifdef USE_CPL_SYSTEM_TIMER_MANAGER_TIMING_WHEEL
+    const char* impl = "timing-wheel";
+#else
+    const char* impl = "delta-list";
+#endif
+    CPL_SYSTEM_TRACE_MSG( SECT_, ("%s: %u timers started in %lu ms", impl, BENCH_NUM_TIMERS_, startTime) );
+    CPL_SYSTEM_TRACE_MSG( SECT_, ("%s: %u ticks with %u stop/starts per tick (%lu expirations) in %lu ms", impl, BENCH_NUM_TICKS_, BENCH_RESTARTS_PER_MS_, expiredCount, churnTime) );
+}
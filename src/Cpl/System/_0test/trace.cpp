@@ -0,0 +1,258 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+
+#include "Catch/catch.hpp"
+#include "Cpl/System/Trace.h"
+#include "Cpl/System/Thread.h"
+#include "Cpl/System/Api.h"
+#include "Cpl/System/ElapsedTime.h"
+#include "Cpl/System/_testsupport/Shutdown_TS.h"
+#include "Cpl/Io/Output.h"
+#include <string.h>
+#include <atomic>
+
+
+#define SECT_       "_0test"
+#define MY_SECT_    "Cpl::System::_0test::trace"
+
+///
+using namespace Cpl::System;
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+/// Output stream that counts (and validates) the trace messages
+class CaptureOutput : public Cpl::Io::Output
+{
+public:
+    ///
+    std::atomic<unsigned>   m_count;
+    ///
+    std::atomic<unsigned>   m_errors;
+    ///
+    char                    m_last[OPTION_CPL_SYSTEM_TRACE_MAX_BUFFER + 1];
+
+    ///
+    CaptureOutput() { reset(); }
+
+    ///
+    void reset() { m_count = 0; m_errors = 0; m_last[0] = '\0'; }
+
+    /// Each write MUST be a single, complete trace message
+    bool write( const void* buffer, int maxBytes, int& bytesWritten )
+    {
+        const char* msg = (const char*) buffer;
+        if ( maxBytes < 4 || strncmp( msg, ">> ", 3 ) != 0 || msg[maxBytes - 1] != '\n' || memchr( msg, '\n', maxBytes ) != msg + maxBytes - 1 )
+        {
+            m_errors++;
+        }
+        int len = maxBytes < OPTION_CPL_SYSTEM_TRACE_MAX_BUFFER ? maxBytes : OPTION_CPL_SYSTEM_TRACE_MAX_BUFFER;
+        memcpy( m_last, msg, len );
+        m_last[len]  = '\0';
+        bytesWritten = maxBytes;
+        m_count++;
+        return true;
+    }
+    ///
+    void flush() {}
+    ///
+    bool isEos() { return false; }
+    ///
+    void close() {}
+};
+
+/// Generates N trace messages
+class Tracer : public Runnable
+{
+public:
+    ///
+    unsigned            m_numMsgs;
+    ///
+    std::atomic<bool>   m_done;
+    ///
+    Tracer( unsigned numMsgs ):m_numMsgs( numMsgs ), m_done( false ) {}
+    ///
+    void appRun()
+    {
+        for ( unsigned i=0; i < m_numMsgs; i++ )
+        {
+            CPL_SYSTEM_TRACE_MSG( MY_SECT_, ("msg #%u from %s. Some more text to format: %d, %f, %s", i, Thread::myName(), -1, 3.14, "hello world") );
+        }
+        m_done = true;
+    }
+};
+
+}; // end namespace
+
+
+/// Trace call site with a literal section name
+static void traceLiteral( unsigned value )
+{
+    CPL_SYSTEM_TRACE_MSG( MY_SECT_, ("literal=%u", value) );
+}
+
+/// Trace call site with a variable section name
+static void traceVariable( const char* section, unsigned value )
+{
+    CPL_SYSTEM_TRACE_MSG( section, ("variable=%u", value) );
+}
+
+#define MAX_THREADS_    8
+
+/// Runs 'numThreads' threads that each generate 'numMsgs' trace messages. Returns the elapsed time in msec
+static unsigned long runTracers( unsigned numThreads, unsigned numMsgs )
+{
+    Tracer* tracers[MAX_THREADS_];
+    Thread* threads[MAX_THREADS_];
+    for ( unsigned i=0; i < numThreads; i++ )
+    {
+        tracers[i] = new Tracer( numMsgs );
+    }
+
+    unsigned long start = ElapsedTime::milliseconds();
+    for ( unsigned i=0; i < numThreads; i++ )
+    {
+        threads[i] = Thread::create( *tracers[i], "TRACER" );
+    }
+    for ( unsigned i=0; i < numThreads; i++ )
+    {
+        while ( !tracers[i]->m_done )
+        {
+            Api::sleep( 1 );
+        }
+    }
+    unsigned long elapsed = ElapsedTime::deltaMilliseconds( start );
+    for ( unsigned i=0; i < numThreads; i++ )
+    {
+        while ( threads[i]->isRunning() )
+        {
+            Api::sleep( 1 );
+        }
+    }
+    for ( unsigned i=0; i < numThreads; i++ )
+    {
+        Thread::destroy( *threads[i] );
+        delete tracers[i];
+    }
+    return elapsed;
+}
+
+static CaptureOutput capture_;
+
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_CASE( "trace" )
+{
+    Shutdown_TS::clearAndUseCounter();
+    CPL_SYSTEM_TRACE_REDIRECT( capture_ );
+    Trace::InfoLevel_T prevLevel = CPL_SYSTEM_TRACE_SET_INFO_LEVEL( Trace::eNONE );
+    capture_.reset();
+
+    SECTION( "cached section" )
+    {
+        traceLiteral( 1 );
+        REQUIRE( capture_.m_count == 0 );
+        CPL_SYSTEM_TRACE_ENABLE_SECTION( MY_SECT_ );
+        traceLiteral( 2 );
+        REQUIRE( capture_.m_count == 1 );
+        REQUIRE( strcmp( capture_.m_last, ">> literal=2\n" ) == 0 );
+        traceLiteral( 3 );
+        REQUIRE( capture_.m_count == 2 );
+        CPL_SYSTEM_TRACE_DISABLE();
+        traceLiteral( 4 );
+        REQUIRE( capture_.m_count == 2 );
+        CPL_SYSTEM_TRACE_ENABLE();
+        traceLiteral( 5 );
+        REQUIRE( capture_.m_count == 3 );
+        CPL_SYSTEM_TRACE_DISABLE_SECTION( MY_SECT_ );
+        traceLiteral( 6 );
+        REQUIRE( capture_.m_count == 3 );
+        REQUIRE( capture_.m_errors == 0 );
+    }
+
+    SECTION( "variable section" )
+    {
+        CPL_SYSTEM_TRACE_ENABLE_SECTION( MY_SECT_ );
+        traceVariable( "not-enabled", 1 );
+        REQUIRE( capture_.m_count == 0 );
+        traceVariable( MY_SECT_, 2 );
+        REQUIRE( capture_.m_count == 1 );
+        REQUIRE( strcmp( capture_.m_last, ">> variable=2\n" ) == 0 );
+        traceVariable( "not-enabled", 3 );
+        REQUIRE( capture_.m_count == 1 );
+        CPL_SYSTEM_TRACE_DISABLE_SECTION( MY_SECT_ );
+        traceVariable( MY_SECT_, 4 );
+        REQUIRE( capture_.m_count == 1 );
+    }
+
+    SECTION( "threads" )
+    {
+        CPL_SYSTEM_TRACE_ENABLE_SECTION( MY_SECT_ );
+        runTracers( 4, 250 );
+        CPL_SYSTEM_TRACE_DISABLE_SECTION( MY_SECT_ );
+        REQUIRE( capture_.m_count == 4 * 250 );
+        REQUIRE( capture_.m_errors == 0 );
+    }
+
+    CPL_SYSTEM_TRACE_SET_INFO_LEVEL( prevLevel );
+    CPL_SYSTEM_TRACE_REVERT();
+    REQUIRE( Shutdown_TS::getAndClearCounter() == 0u );
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+#define BENCH_DISABLED_CALLS_   10000000
+#define BENCH_ENABLED_CALLS_    200000
+
+TEST_CASE( "trace-benchmark", "[.bench]" )
+{
+    // Disabled: cached (literal section) vs. uncached (variable section)
+    unsigned long start = ElapsedTime::milliseconds();
+    for ( unsigned i=0; i < BENCH_DISABLED_CALLS_; i++ )
+    {
+        traceLiteral( i );
+    }
+    unsigned long cachedTime = ElapsedTime::deltaMilliseconds( start );
+    start                    = ElapsedTime::milliseconds();
+    for ( unsigned i=0; i < BENCH_DISABLED_CALLS_; i++ )
+    {
+        traceVariable( MY_SECT_, i );
+    }
+    unsigned long uncachedTime = ElapsedTime::deltaMilliseconds( start );
+    CPL_SYSTEM_TRACE_MSG( SECT_, ("disabled: %u calls. cached=%lu ms (%lu ns/call), uncached=%lu ms (%lu ns/call)",
+                                   BENCH_DISABLED_CALLS_,
+                                   cachedTime,
+                                   (unsigned long) (cachedTime * 1000000ULL / BENCH_DISABLED_CALLS_),
+                                   uncachedTime,
+                                   (unsigned long) (uncachedTime * 1000000ULL / BENCH_DISABLED_CALLS_)) );
+
+    // Enabled (output is discarded)
+    CPL_SYSTEM_TRACE_REDIRECT( capture_ );
+    Trace::InfoLevel_T prevLevel = CPL_SYSTEM_TRACE_SET_INFO_LEVEL( Trace::eBRIEF );
+    CPL_SYSTEM_TRACE_ENABLE_SECTION( MY_SECT_ );
+    capture_.reset();
+    unsigned long oneThread   = runTracers( 1, BENCH_ENABLED_CALLS_ );
+    unsigned long fourThreads = runTracers( 4, BENCH_ENABLED_CALLS_ / 4 );
+    CPL_SYSTEM_TRACE_DISABLE_SECTION( MY_SECT_ );
+    CPL_SYSTEM_TRACE_SET_INFO_LEVEL( prevLevel );
+    CPL_SYSTEM_TRACE_REVERT();
+    REQUIRE( capture_.m_errors == 0 );
+    REQUIRE( capture_.m_count == BENCH_ENABLED_CALLS_ * 2 );
+
+    CPL_SYSTEM_TRACE_MSG( SECT_, ("enabled: %u calls. 1 thread=%lu ms (%lu ns/call), 4 threads=%lu ms (%lu ns/call). buffers=%d",
+                                   BENCH_ENABLED_CALLS_,
+                                   oneThread,
+                                   (unsigned long) (oneThread * 1000000ULL / BENCH_ENABLED_CALLS_),
+                                   fourThreads,
+                                   (unsigned long) (fourThreads * 1000000ULL / BENCH_ENABLED_CALLS_),
+                                   OPTION_CPL_SYSTEM_TRACE_NUM_BUFFERS) );
+}
@@ -0,0 +1,207 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+
+#include "Loops.h"
+#include "Cpl/Text/Tokenizer/TextBlock.h"
+#include <string.h>
+
+
+///
+using namespace Cpl::TShell::Cmd;
+
+#define TICKS_TO_MSEC_(t)   ((t) / OPTION_CPL_SYSTEM_EVENT_LOOP_PROFILE_TICKS_PER_MSEC)
+
+static unsigned percent_( unsigned long part, unsigned long whole );
+
+static const char* categoryNames_[Cpl::System::EventLoop::ePROFILE_NUM_CATEGORIES] ={ "Timers", "Event Flags", "Messages", "Notifications" };
+
+
+///////////////////////////
+Loops::Loops( Cpl::Container::Map<Cpl::TShell::Command>& commandList,
+			  Security::Permission_T                     minPermLevel ) noexcept
+	:Command( commandList, verb, minPermLevel )
+	, m_contextPtr( 0 )
+	, m_threadName( 0 )
+	, m_count( 0 )
+	, m_reset( false )
+	, m_io( true )
+{
+}
+
+
+///////////////////////////
+Cpl::TShell::Command::Result_T Loops::execute( Cpl::TShell::Context_& context, char* cmdString, Cpl::Io::Output& outfd ) noexcept
+{
+	Cpl::Text::Tokenizer::TextBlock tokens( cmdString, context.getDelimiterChar(), context.getTerminatorChar(), context.getQuoteChar(), context.getEscapeChar() );
+	unsigned                        numParms = tokens.numParameters();
+
+	// Error checking
+	if ( numParms > 3 )
+	{
+		return Cpl::TShell::Command::eERROR_EXTRA_ARGS;
+	}
+
+	// Do nothing if profiling was not compiled in
+#ifndef USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+	return context.writeFrame( "Event Loop profiling was NOT ENABLED at Compiled time" ) ? Command::eSUCCESS : Command::eERROR_IO;
+#else
+
+	// Parse the arguments
+	m_threadName = 0;
+	m_reset      = false;
+	if ( numParms > 1 && strcmp( tokens.getParameter( numParms - 1 ), "reset" ) == 0 )
+	{
+		m_reset = true;
+		numParms--;
+	}
+	if ( numParms == 2 )
+	{
+		m_threadName = tokens.getParameter( 1 );
+	}
+	else if ( numParms > 2 )
+	{
+		return Cpl::TShell::Command::eERROR_INVALID_ARGS;
+	}
+
+	// House keeping
+	Cpl::Text::String& outtext = context.getOutputBuffer();
+	m_contextPtr               = &context;
+	m_count                    = 0;
+	m_io                       = true;
+
+	// Display list header
+	m_io &= context.writeFrame( " " );
+	if ( m_threadName == 0 )
+	{
+		outtext.format( "%-16s  %5s  %10s  %10s  %10s  %10s  %10s", "Name", "Busy%", "Loops", "Timers", "EventFlags", "Messages", "Notifs" );
+		m_io &= context.writeFrame( outtext );
+		outtext.format( "%-16s  %5s  %10s  %10s  %10s  %10s  %10s", "----", "-----", "-----", "------", "----------", "--------", "------" );
+		m_io &= context.writeFrame( outtext );
+	}
+
+	// Display the Event Loops
+	Cpl::System::Thread::traverse( *this );
+
+	// Finished-up and exit
+	if ( m_threadName && m_count == 0 )
+	{
+		outtext.format( "Event Loop thread '%s' not found", m_threadName );
+		m_io &= context.writeFrame( outtext );
+		return m_io ? Command::eERROR_INVALID_ARGS : Command::eERROR_IO;
+	}
+	if ( m_threadName == 0 )
+	{
+		outtext.format( "Total number of Event Loops: %u", m_count );
+		m_io &= context.writeFrame( " " );
+		m_io &= context.writeFrame( outtext );
+	}
+	return m_io ? Command::eSUCCESS : Command::eERROR_IO;
+#endif
+}
+
+
+Cpl::Type::Traverser::Status_T Loops::item( Cpl::System::Thread& t )
+{
+	// Skip threads that are not Event Loops (or are not the requested thread)
+	Cpl::System::EventLoop* loopPtr = t.getRunnable().getEventLoop_();
+	if ( loopPtr == 0 || ( m_threadName && strcmp( m_threadName, t.getName() ) != 0 ) )
+	{
+		return Cpl::Type::Traverser::eCONTINUE;
+	}
+
+	Cpl::System::EventLoop::Profile_T profile;
+	if ( loopPtr->getProfile( profile, m_reset ) )
+	{
+		m_count++;
+		if ( m_threadName )
+		{
+			displayDetails( t, profile );
+			return Cpl::Type::Traverser::eABORT;
+		}
+		displaySummary( t, profile );
+	}
+	return Cpl::Type::Traverser::eCONTINUE;
+}
+
+
+/////////////////////////////////////////////////////////
+void Loops::displaySummary( Cpl::System::Thread& t, Cpl::System::EventLoop::Profile_T& profile )
+{
+	Cpl::Text::String& outtext = m_contextPtr->getOutputBuffer();
+	outtext.format( "%-16s  %5u  %10lu  %10lu  %10lu  %10lu  %10lu",
+					t.getName(),
+					percent_( profile.m_busyTicks, profile.m_elapsedTicks ),
+					profile.m_loops,
+					profile.m_categories[Cpl::System::EventLoop::ePROFILE_TIMERS].m_count,
+					profile.m_categories[Cpl::System::EventLoop::ePROFILE_EVENT_FLAGS].m_count,
+					profile.m_categories[Cpl::System::EventLoop::ePROFILE_MESSAGES].m_count,
+					profile.m_categories[Cpl::System::EventLoop::ePROFILE_NOTIFICATIONS].m_count );
+	m_io &= m_contextPtr->writeFrame( outtext );
+}
+
+void Loops::displayDetails( Cpl::System::Thread& t, Cpl::System::EventLoop::Profile_T& profile )
+{
+	Cpl::Text::String& outtext = m_contextPtr->getOutputBuffer();
+
+	// Busy/idle times
+	outtext.format( "Event Loop: %s", t.getName() );
+	m_io &= m_contextPtr->writeFrame( outtext );
+	outtext.format( "  Elapsed: %lu, Busy: %lu (%u%%), Idle: %lu, Loops: %lu",
+					TICKS_TO_MSEC_( profile.m_elapsedTicks ),
+					TICKS_TO_MSEC_( profile.m_busyTicks ),
+					percent_( profile.m_busyTicks, profile.m_elapsedTicks ),
+					TICKS_TO_MSEC_( profile.m_idleTicks ),
+					profile.m_loops );
+	m_io &= m_contextPtr->writeFrame( outtext );
+
+	// Per category statistics
+	m_io &= m_contextPtr->writeFrame( " " );
+	outtext.format( "  %-14s  %10s  %10s  %10s  %10s", "Category", "Count", "Total", "Max", "PeakQueue" );
+	m_io &= m_contextPtr->writeFrame( outtext );
+	outtext.format( "  %-14s  %10s  %10s  %10s  %10s", "--------", "-----", "-----", "---", "---------" );
+	m_io &= m_contextPtr->writeFrame( outtext );
+	for ( unsigned i=0; i < Cpl::System::EventLoop::ePROFILE_NUM_CATEGORIES; i++ )
+	{
+		Cpl::System::EventLoop::ProfileCategoryStats_T& stats = profile.m_categories[i];
+		outtext.format( "  %-14s  %10lu  %10lu  %10lu  %10lu",
+						categoryNames_[i],
+						stats.m_count,
+						TICKS_TO_MSEC_( stats.m_totalTicks ),
+						TICKS_TO_MSEC_( stats.m_maxTicks ),
+						stats.m_peakQueueDepth );
+		m_io &= m_contextPtr->writeFrame( outtext );
+	}
+
+	// Loop duration histogram (in ticks)
+	m_io &= m_contextPtr->writeFrame( " " );
+	outtext.format( "  Loop busy time histogram (%u ticks per msec):", (unsigned) OPTION_CPL_SYSTEM_EVENT_LOOP_PROFILE_TICKS_PER_MSEC );
+	m_io &= m_contextPtr->writeFrame( outtext );
+	for ( unsigned i=0; i < OPTION_CPL_SYSTEM_EVENT_LOOP_PROFILE_NUM_BUCKETS; i++ )
+	{
+		unsigned long low = i == 0 ? 0 : 1UL << ( i - 1 );
+		if ( i == OPTION_CPL_SYSTEM_EVENT_LOOP_PROFILE_NUM_BUCKETS - 1 )
+		{
+			outtext.format( "  >= %-10lu  %10lu", low, profile.m_histogram[i] );
+		}
+		else
+		{
+			outtext.format( "  <  %-10lu  %10lu", i == 0 ? 1UL : low << 1, profile.m_histogram[i] );
+		}
+		m_io &= m_contextPtr->writeFrame( outtext );
+	}
+}
+
+
+/////////////////////////////////////////////////////////
+unsigned percent_( unsigned long part, unsigned long whole )
+{
+	return whole ? (unsigned) ( ( (unsigned long long) part * 100 ) / whole ) : 0;
+}
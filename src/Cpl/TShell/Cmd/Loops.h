@@ -0,0 +1,108 @@
+#ifndef Cpl_TShell_Cmd_Loops_h
+#define Cpl_TShell_Cmd_Loops_h
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+/** @file */
+
+#include "colony_config.h"
+#include "Cpl/TShell/Cmd/Command.h"
+#include "Cpl/Text/String.h"
+#include "Cpl/System/Thread.h"
+#include "Cpl/System/EventLoop.h"
+
+
+
+///
+namespace Cpl {
+///
+namespace TShell {
+///
+namespace Cmd {
+
+
+
+/** This class implements a  Shell command that displays the profiling
+	statistics of the threads that are Event Loops (see
+	Cpl::System::EventLoop::getProfile()).  The Event Loop profiling must be
+	enabled at compile time, i.e. USE_CPL_SYSTEM_EVENT_LOOP_PROFILE defined.
+ */
+class Loops : public Command, public Cpl::System::Thread::Traverser
+{
+public:
+	/// The command verb/identifier
+	static constexpr const char* verb = "loops";
+
+	/// The command usage string
+	static constexpr const char* usage = "loops [reset]\n"
+                                         "loops <threadname> [reset]";
+
+	/** The command detailed help string (recommended that lines do not exceed 80 chars)
+														  1         2         3         4         5         6         7         8
+												 12345678901234567890123456789012345678901234567890123456789012345678901234567890
+	 */
+	static constexpr const char* detailedHelp = "  Displays the profiling statistics of the Event Loop threads.  When no thread\n"
+                                                "  name is specified, a summary of all Event Loops is displayed, i.e. busy time\n"
+                                                "  and the number of timer, event flag, message, and change notification events\n"
+                                                "  processed.  When a thread name is specified, the loop duration histogram and\n"
+                                                "  the per-category times and peak queue depths are also displayed. The 'reset'\n"
+                                                "  option clears the statistics after they are displayed.  Times are in msec.";
+
+public:
+	/// See Cpl::TShell::Command
+	const char* getUsage() const noexcept { return usage; }
+
+	/// See Cpl::TShell::Command
+	const char* getHelp() const noexcept { return detailedHelp; }
+
+
+protected:
+	/// Cache my Processor/Shell context when traversing the thread list
+	Cpl::TShell::Context_*  m_contextPtr;
+
+	/// Name of the thread to display (null when displaying all Event Loops)
+	const char*             m_threadName;
+
+	/// Count of Event Loops
+	unsigned                m_count;
+
+	/// Reset the statistics after displaying them
+	bool                    m_reset;
+
+	/// Cache IO status/errors
+	bool                    m_io;
+
+
+public:
+	/// Constructor
+	Loops( Cpl::Container::Map<Cpl::TShell::Command>& commandList,
+		   Security::Permission_T                     minPermLevel=OPTION_TSHELL_CMD_COMMAND_DEFAULT_PERMISSION_LEVEL ) noexcept;
+
+public:
+	/// See Cpl::TShell::Command
+	Cpl::TShell::Command::Result_T execute( Cpl::TShell::Context_& context, char* cmdString, Cpl::Io::Output& outfd ) noexcept;
+
+
+public:
+	/// See Cpl::System::Thread::Traverser
+	Cpl::Type::Traverser::Status_T item( Cpl::System::Thread& nextThread );
+
+protected:
+	/// Helper method that displays the summary row for an Event Loop
+	virtual void displaySummary( Cpl::System::Thread& thread, Cpl::System::EventLoop::Profile_T& profile );
+
+	/// Helper method that displays the detailed statistics for an Event Loop
+	virtual void displayDetails( Cpl::System::Thread& thread, Cpl::System::EventLoop::Profile_T& profile );
+};
+
+};      // end namespaces
+};
+};
+#endif  // end header latch
@@ -25,6 +25,7 @@
 #include "Cpl/TShell/Cmd/Trace.h"
 #include "Cpl/TShell/Cmd/TPrint.h"
 #include "Cpl/TShell/Cmd/Threads.h"
+#include "Cpl/TShell/Cmd/Loops.h"
 
 
 #define SECT_     "_0test"
@@ -28,6 +28,7 @@ static Cpl::TShell::Cmd::Help    helpCmd_( cmdlist );
 static Cpl::TShell::Cmd::Bye     byeCmd_( cmdlist );
 static Cpl::TShell::Cmd::Trace   traceCmd_( cmdlist );
 static Cpl::TShell::Cmd::TPrint  tprintCmd_( cmdlist );
+static Cpl::TShell::Cmd::Loops   loopsCmd_( cmdlist );
 
 
 static Apple   mockApp;
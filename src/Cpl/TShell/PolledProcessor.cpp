@@ -30,6 +30,7 @@ PolledProcessor::PolledProcessor( Cpl::Container::Map<Command>&     commands,
 )
 	: Processor( commands, deframer, framer, outputLock, commentChar, argEscape, argDelimiter, argQuote, argTerminator, initialPermissionLevel )
 	, m_outFd( nullptr )
+	, m_frameFound( false )
 {
 }
 
@@ -48,11 +49,13 @@ bool PolledProcessor::start( Cpl::Io::Input & infd, Cpl::Io::Output & outfd, boo
 int PolledProcessor::readInput( size_t& frameSize ) noexcept
 {
 	bool isEof;
+	m_frameFound = false;
 	if ( !m_deframer.scan( OPTION_CPL_TSHELL_PROCESSOR_INPUT_SIZE, m_inputBuffer, frameSize, isEof ) )
 	{
 		// Error reading raw input -->exit the Command processor
 		return -1;
 	}
 
+	m_frameFound = isEof;
 	return isEof? 1: 0;
 }
\ No newline at end of file
@@ -69,6 +69,13 @@ public:
 	/// See Cpl::TShell::ProcessorApi
 	int poll() noexcept;
 
+	/** This method returns true if the most recent call to poll() found (and
+		executed) a complete command frame.  When true, the input stream and/or
+		the decoder may have additional buffered input, i.e. the application
+		should call poll() again without waiting for new input to arrive.
+	 */
+	bool lastPollFoundFrame() const noexcept { return m_frameFound; }
+
 protected:
 	/** Helper method that executes the decoder, i.e. logic to parse the incoming
 		text.  Returns 1 if a full/valid frame was found. Returns 0 if input frame
@@ -79,6 +86,9 @@ protected:
 protected:
 	/// Cached output stream pointer 
 	Cpl::Io::Output*	m_outFd;
+
+	/// Result of the last decoder scan
+	bool				m_frameFound;
 };
 
 
@@ -0,0 +1,162 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+
+#include "MultiSession.h"
+#include "Cpl/System/Trace.h"
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+
+#define SECT_   "Cpl::TShell::Posix"
+
+///
+using namespace Cpl::TShell::Posix;
+
+
+///////////////////////////////////
+MultiSession::MultiSession( Cpl::Container::Map<Command>& commands,
+                            int                           portNum,
+                            unsigned                      maxSessions,
+                            Cpl::System::Mutex&           outputLock,
+                            unsigned long                 timeOutPeriodInMsec )
+    : Cpl::System::EventLoop( timeOutPeriodInMsec )
+    , m_listener( true )
+    , m_maxSessions( maxSessions )
+    , m_numActive( 0 )
+    , m_numAccepted( 0 )
+    , m_portNum( portNum )
+{
+    m_sessions = new Session*[maxSessions];
+    for ( unsigned i=0; i < maxSessions; i++ )
+    {
+        m_sessions[i] = new Session( *this, commands, outputLock );
+    }
+}
+
+MultiSession::~MultiSession()
+{
+    for ( unsigned i=0; i < m_maxSessions; i++ )
+    {
+        delete m_sessions[i];
+    }
+    delete[] m_sessions;
+}
+
+///////////////////////////////////
+void MultiSession::startEventLoop() noexcept
+{
+    Cpl::System::EventLoop::startEventLoop();
+
+    // Note: The listener is NOT thread safe -->it must be started (and used) in the event loop's thread
+    m_listener.startListening( *this, m_portNum );
+    m_listener.enableEventLoopWakeup( *this, OPTION_CPL_TSHELL_POSIX_MULTISESSION_EVENT_NUMBER );
+}
+
+void MultiSession::stopEventLoop() noexcept
+{
+    m_listener.terminate();
+    for ( unsigned i=0; i < m_maxSessions; i++ )
+    {
+        if ( m_sessions[i]->m_inUse )
+        {
+            m_sessions[i]->end();
+        }
+    }
+
+    Cpl::System::EventLoop::stopEventLoop();
+}
+
+void MultiSession::processEventFlag( uint8_t eventNumber ) noexcept
+{
+    if ( eventNumber == OPTION_CPL_TSHELL_POSIX_MULTISESSION_EVENT_NUMBER )
+    {
+        m_listener.poll();
+    }
+}
+
+bool MultiSession::newConnection( Cpl::Io::Descriptor newFd, const char* rawConnectionInfo ) noexcept
+{
+    for ( unsigned i=0; i < m_maxSessions; i++ )
+    {
+        if ( !m_sessions[i]->m_inUse )
+        {
+            // Note: The session 'consumes' the descriptor, i.e. it closes the socket if the session fails to start
+            if ( m_sessions[i]->open( newFd ) )
+            {
+                m_numActive++;
+                m_numAccepted++;
+                CPL_SYSTEM_TRACE_MSG( SECT_, ("New session from %s (active=%u)", rawConnectionInfo, m_numActive) );
+            }
+            return true;
+        }
+    }
+
+    CPL_SYSTEM_TRACE_MSG( SECT_, ("Session refused from %s - no free sessions (max=%u)", rawConnectionInfo, m_maxSessions) );
+    return false;
+}
+
+void MultiSession::sessionEnded() noexcept
+{
+    m_numActive--;
+    CPL_SYSTEM_TRACE_MSG( SECT_, ("Session ended (active=%u)", m_numActive) );
+}
+
+
+///////////////////////////////////
+MultiSession::Session::Session( MultiSession& server, Cpl::Container::Map<Command>& commands, Cpl::System::Mutex& outputLock )
+    : m_inUse( false )
+    , m_server( server )
+    , m_framer( m_outBuffer, sizeof( m_outBuffer ), 0, '\0', '\n', '\0', false )
+    , m_deframer( 0, ' ', false )
+    , m_processor( commands, m_deframer, m_framer, outputLock )
+{
+}
+
+bool MultiSession::Session::open( Cpl::Io::Descriptor newFd ) noexcept
+{
+    // The shell output is a sequence of small writes (frame, prompt) -->disable the Nagle algorithm so the remote user is not subjected to delayed-ACK latency
+    int noDelay = 1;
+    setsockopt( newFd.m_fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof( noDelay ) );
+
+    activate( newFd );
+    if ( !m_server.m_listener.monitor( *this, *this ) || !m_processor.start( *this, *this, false ) )
+    {
+        close();
+        return false;
+    }
+
+    m_inUse = true;
+    return true;
+}
+
+void MultiSession::Session::end() noexcept
+{
+    close();    // Note: closing the socket removes it from the epoll set
+    m_inUse = false;
+}
+
+void MultiSession::Session::readable() noexcept
+{
+    // Process ALL complete commands (the decoder can have buffered multiple commands from a single read)
+    int result;
+    do
+    {
+        result = m_processor.poll();
+    } while ( result == 0 && m_processor.lastPollFoundFrame() );
+
+    // Session terminated (stream error, remote host closed the connection, or the 'bye' command)
+    if ( result != 0 )
+    {
+        end();
+        m_server.sessionEnded();
+    }
+}
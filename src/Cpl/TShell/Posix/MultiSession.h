@@ -0,0 +1,183 @@
+#ifndef Cpl_TShell_Posix_MultiSession_h_
+#define Cpl_TShell_Posix_MultiSession_h_
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+/** @file */
+
+#include "colony_config.h"
+#include "Cpl/TShell/PolledProcessor.h"
+#include "Cpl/Text/Frame/LineDecoder.h"
+#include "Cpl/Text/Frame/BlockEncoder.h"
+#include "Cpl/Io/Tcp/Posix/AsyncListener.h"
+#include "Cpl/System/EventLoop.h"
+#include "Cpl/System/Private_.h"
+
+
+/** Default maximum number of concurrent shell sessions
+ */
+#ifndef OPTION_CPL_TSHELL_POSIX_MULTISESSION_MAX_SESSIONS
+#define OPTION_CPL_TSHELL_POSIX_MULTISESSION_MAX_SESSIONS       16
+#endif
+
+/** Size, in bytes, of the per-session output block buffer, i.e. the encoded
+    output of a frame is written to the socket in chunks of (at most) this size
+ */
+#ifndef OPTION_CPL_TSHELL_POSIX_MULTISESSION_OUTPUT_BLOCK_SIZE
+#define OPTION_CPL_TSHELL_POSIX_MULTISESSION_OUTPUT_BLOCK_SIZE  (OPTION_CPL_TSHELL_PROCESSOR_OUTPUT_SIZE+2)
+#endif
+
+/** Event flag number used by the socket layer to wake up the event loop
+ */
+#ifndef OPTION_CPL_TSHELL_POSIX_MULTISESSION_EVENT_NUMBER
+#define OPTION_CPL_TSHELL_POSIX_MULTISESSION_EVENT_NUMBER       0
+#endif
+
+
+///
+namespace Cpl {
+///
+namespace TShell {
+///
+namespace Posix {
+
+
+/** This concrete class provides a TCP server that multiplexes MANY concurrent
+    TShell sessions on a single thread (vs. Cpl::TShell::Socket that only
+    supports a single - blocking - session at a time).
+
+    Each session has its own Command Processor context (i.e. user permission
+    level, working buffers), input decoder, and output encoder.  The sessions
+    share the same command set.  The class is an Event Loop, i.e. the
+    application creates a thread for the instance.  The sessions are serviced
+    when there is socket activity (via epoll), i.e. the thread blocks when
+    all sessions are idle.
+
+    The commands execute in the context of the MultiSession thread, i.e. a
+    long running command blocks all sessions (the same as a command blocks
+    other threads that share an Event Loop).
+
+    NOTE: This class dynamically allocates memory (for the sessions) when it
+          is constructed.
+ */
+class MultiSession : public Cpl::System::EventLoop, public Cpl::Io::Tcp::AsyncListener::Client
+{
+public:
+    /** Constructor.
+
+        @param commands         Set of supported commands (shared by all sessions)
+        @param portNum          Port number to listen on
+        @param maxSessions      Maximum number of concurrent sessions. Additional
+                                connection requests are refused
+        @param outputLock       Mutex used to ensure the atomic output of the commands
+        @param timeOutPeriodInMsec  See Cpl::System::EventLoop
+     */
+    MultiSession( Cpl::Container::Map<Command>& commands,
+                  int                           portNum,
+                  unsigned                      maxSessions         = OPTION_CPL_TSHELL_POSIX_MULTISESSION_MAX_SESSIONS,
+                  Cpl::System::Mutex&           outputLock          = Cpl::System::Locks_::tracingOutput(),
+                  unsigned long                 timeOutPeriodInMsec = OPTION_CPL_SYSTEM_EVENT_LOOP_TIMEOUT_PERIOD );
+
+    /// Destructor
+    ~MultiSession();
+
+public:
+    /** Returns the number of currently active sessions.  Note: This method
+        is NOT thread safe, i.e. the value is approximate when called from a
+        different thread.
+     */
+    unsigned getNumActiveSessions() const noexcept { return m_numActive; }
+
+    /** Returns the total number of sessions that have been accepted. Note:
+        This method is NOT thread safe.
+     */
+    unsigned long getNumAcceptedSessions() const noexcept { return m_numAccepted; }
+
+public:
+    /// See Cpl::Io::Tcp::AsyncListener::Client
+    bool newConnection( Cpl::Io::Descriptor newFd, const char* rawConnectionInfo ) noexcept;
+
+protected:
+    /// See Cpl::System::EventLoop
+    void startEventLoop() noexcept;
+
+    /// See Cpl::System::EventLoop
+    void stopEventLoop() noexcept;
+
+    /// See Cpl::System::EventLoop
+    void processEventFlag( uint8_t eventNumber ) noexcept;
+
+protected:
+    /// A single shell session
+    class Session : public Cpl::Io::Tcp::InputOutput, public Cpl::Io::Tcp::Posix::AsyncListener::ReadableHandler
+    {
+    public:
+        /// Constructor
+        Session( MultiSession& server, Cpl::Container::Map<Command>& commands, Cpl::System::Mutex& outputLock );
+
+    public:
+        /// Starts the session on the specified socket.  Returns false (and closes the socket) if the session could not be started
+        bool open( Cpl::Io::Descriptor newFd ) noexcept;
+
+        /// Ends the session
+        void end() noexcept;
+
+        /// See Cpl::Io::Tcp::Posix::AsyncListener::ReadableHandler
+        void readable() noexcept;
+
+    public:
+        /// Set when the session is in use
+        bool                m_inUse;
+
+    protected:
+        /// My server
+        MultiSession&       m_server;
+
+        /// Output block buffer
+        uint8_t             m_outBuffer[OPTION_CPL_TSHELL_POSIX_MULTISESSION_OUTPUT_BLOCK_SIZE];
+
+        /// Framer for the output
+        Cpl::Text::Frame::BlockEncoder                                          m_framer;
+
+        /// De-framer for the input stream
+        Cpl::Text::Frame::LineDecoder<OPTION_CPL_TSHELL_PROCESSOR_INPUT_SIZE>   m_deframer;
+
+        /// Command Processor
+        Cpl::TShell::PolledProcessor                                            m_processor;
+    };
+
+    /// Helper method: bookkeeping when a session ends
+    void sessionEnded() noexcept;
+
+protected:
+    /// Socket listener
+    Cpl::Io::Tcp::Posix::AsyncListener  m_listener;
+
+    /// Sessions
+    Session**                           m_sessions;
+
+    /// Maximum number of sessions
+    unsigned                            m_maxSessions;
+
+    /// Number of active sessions
+    unsigned                            m_numActive;
+
+    /// Total number of accepted sessions
+    unsigned long                       m_numAccepted;
+
+    /// Port number to listen on
+    int                                 m_portNum;
+};
+
+
+};      // end namespaces
+};
+};
+#endif  // end header latch
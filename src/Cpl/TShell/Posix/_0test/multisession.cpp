@@ -0,0 +1,354 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+
+#include "Catch/catch.hpp"
+#include "Cpl/TShell/Posix/MultiSession.h"
+#include "Cpl/TShell/Cmd/Help.h"
+#include "Cpl/TShell/Cmd/Bye.h"
+#include "Cpl/TShell/Cmd/TPrint.h"
+#include "Cpl/Io/Tcp/Posix/AsyncConnector.h"
+#include "Cpl/System/Thread.h"
+#include "Cpl/System/Api.h"
+#include "Cpl/System/Trace.h"
+#include "Cpl/System/ElapsedTime.h"
+#include "Cpl/System/_testsupport/Shutdown_TS.h"
+#include "Cpl/Text/FString.h"
+#include <chrono>
+#include <algorithm>
+#include <vector>
+#include <string.h>
+
+
+#define SECT_               "_0test"
+
+#define PORT_NUM_           5095
+#define TIMEOUT_MS_         5000
+
+using namespace Cpl::TShell::Posix;
+
+static Cpl::Container::Map<Cpl::TShell::Command>    cmdlist_( "ignore_this_parameter-used to invoke the static constructor" );
+static Cpl::TShell::Cmd::Help                       helpCmd_( cmdlist_ );
+static Cpl::TShell::Cmd::Bye                        byeCmd_( cmdlist_ );
+static Cpl::TShell::Cmd::TPrint                     tprintCmd_( cmdlist_ );
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+/// Server that runs in its own thread
+class Server : public MultiSession
+{
+public:
+    ///
+    Server( unsigned maxSessions ) :MultiSession( cmdlist_, PORT_NUM_, maxSessions ), m_thread( nullptr ) {}
+
+    ///
+    void launch()
+    {
+        m_thread = Cpl::System::Thread::create( *this, "TSHELL" );
+        Cpl::System::Api::sleep( 50 ); // Allow time for the listener to start
+    }
+
+    ///
+    void shutdown()
+    {
+        pleaseStop();
+        while ( m_thread->isRunning() )
+        {
+            Cpl::System::Api::sleep( 1 );
+        }
+        Cpl::System::Thread::destroy( *m_thread );
+    }
+
+    ///
+    Cpl::System::Thread* m_thread;
+};
+
+
+/** Remote shell user (i.e. the load generator's client).  A command has
+    completed when the command prompt is received.
+ */
+class Client : public Cpl::Io::Tcp::AsyncConnector::Client
+{
+public:
+    ///
+    Cpl::Io::Tcp::Posix::AsyncConnector m_connector;
+    ///
+    Cpl::Text::FString<1024>            m_rx;
+    ///
+    unsigned                            m_prompts;
+    ///
+    bool                                m_connected;
+    ///
+    bool                                m_failed;
+    ///
+    char                                m_prevChar;
+
+    ///
+    Client() :m_prompts( 0 ), m_connected( false ), m_failed( false ), m_prevChar( 0 ) {}
+
+    ///
+    bool newConnection( Cpl::Io::Descriptor newFd ) noexcept
+    {
+        activate( newFd );
+        m_connected = true;
+        return true;
+    }
+
+    ///
+    void connectionFailed( Error_T errorCode ) noexcept
+    {
+        m_failed = true;
+    }
+
+    ///
+    void connect()
+    {
+        m_connected = false;
+        m_failed    = false;
+        m_prompts   = 0;
+        m_prevChar  = 0;
+        m_rx.clear();
+        m_connector.establish( *this, "127.0.0.1", PORT_NUM_ );
+    }
+
+    /// Reads available input and counts the received command prompts
+    void service()
+    {
+        if ( !m_connected )
+        {
+            m_connector.poll();
+            return;
+        }
+
+        char buf[256];
+        int  bytesRead;
+        while ( read( buf, sizeof( buf ), bytesRead ) && bytesRead > 0 )
+        {
+            for ( int i=0; i < bytesRead; i++ )
+            {
+                if ( m_prevChar == '$' && buf[i] == ' ' )
+                {
+                    m_prompts++;
+                }
+                m_prevChar = buf[i];
+            }
+            if ( m_rx.length() + bytesRead > m_rx.maxLength() )
+            {
+                m_rx.clear();
+            }
+            m_rx.appendTo( buf, bytesRead );
+        }
+    }
+
+    ///
+    bool send( const char* text )
+    {
+        return write( text );
+    }
+};
+
+}; // end namespace
+
+/// Services the clients until the condition is true (or timeout)
+template <class COND>
+static bool waitFor( Client* clients, unsigned numClients, COND cond )
+{
+    unsigned long start = Cpl::System::ElapsedTime::milliseconds();
+    while ( !cond() )
+    {
+        if ( Cpl::System::ElapsedTime::expiredMilliseconds( start, TIMEOUT_MS_ ) )
+        {
+            return false;
+        }
+        for ( unsigned i=0; i < numClients; i++ )
+        {
+            clients[i].service();
+        }
+        Cpl::System::Api::sleep( 0 );
+    }
+    return true;
+}
+
+/// Connects the clients and waits for the initial prompt
+static bool connectAll( Client* clients, unsigned numClients )
+{
+    for ( unsigned i=0; i < numClients; i++ )
+    {
+        clients[i].connect();
+    }
+    return waitFor( clients, numClients, [&]() {
+        for ( unsigned i=0; i < numClients; i++ )
+        {
+            if ( clients[i].m_prompts == 0 )
+            {
+                return false;
+            }
+        }
+        return true;
+    } );
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_CASE( "multisession" )
+{
+    Cpl::System::Shutdown_TS::clearAndUseCounter();
+    Server* server = new Server( 3 );
+    server->launch();
+
+    SECTION( "concurrent sessions" )
+    {
+        Client clients[3];
+        REQUIRE( connectAll( clients, 3 ) );
+        REQUIRE( server->getNumActiveSessions() == 3 );
+
+        // Interleave a partial command from one session with complete commands from the other sessions
+        REQUIRE( clients[0].send( "tprint \"al" ) );
+        REQUIRE( clients[1].send( "tprint bob\n" ) );
+        REQUIRE( clients[2].send( "tprint charlie\ntprint delta\n" ) );   // Multiple commands in a single write
+        REQUIRE( waitFor( clients, 3, [&]() { return clients[1].m_prompts == 2 && clients[2].m_prompts == 3; } ) );
+        REQUIRE( clients[0].m_prompts == 1 );
+        REQUIRE( clients[0].send( "pha\"\n" ) );
+        REQUIRE( waitFor( clients, 3, [&]() { return clients[0].m_prompts == 2; } ) );
+
+        REQUIRE( strstr( clients[0].m_rx, "alpha" ) );
+        REQUIRE( strstr( clients[1].m_rx, "bob" ) );
+        REQUIRE( strstr( clients[1].m_rx, "alpha" ) == 0 );
+        REQUIRE( strstr( clients[2].m_rx, "charlie" ) );
+        REQUIRE( strstr( clients[2].m_rx, "delta" ) );
+        REQUIRE( strstr( clients[2].m_rx, "bob" ) == 0 );
+
+        // No free sessions -->connection is closed by the server
+        Client extra;
+        extra.connect();
+        REQUIRE( waitFor( &extra, 1, [&]() { return extra.m_connected && extra.isEos(); } ) );
+        REQUIRE( server->getNumActiveSessions() == 3 );
+
+        // End a session -->a new session can be started
+        REQUIRE( clients[1].send( "bye\n" ) );
+        REQUIRE( waitFor( clients, 3, [&]() { return clients[1].isEos(); } ) );
+        REQUIRE( strstr( clients[1].m_rx, "melting" ) );
+        REQUIRE( waitFor( clients, 3, [&]() { return server->getNumActiveSessions() == 2; } ) );
+        REQUIRE( connectAll( &extra, 1 ) );
+        REQUIRE( server->getNumActiveSessions() == 3 );
+
+        // Remote host closes the connection
+        clients[0].close();
+        REQUIRE( waitFor( clients, 0, [&]() { return server->getNumActiveSessions() == 2; } ) );
+        REQUIRE( server->getNumAcceptedSessions() == 4 );
+
+        // Invalid command is reported to the session
+        REQUIRE( extra.send( "bogus\n" ) );
+        REQUIRE( waitFor( &extra, 1, [&]() { return extra.m_prompts == 2; } ) );
+        REQUIRE( strstr( extra.m_rx, "ERROR: [bogus]" ) );
+        extra.close();
+        clients[2].close();
+    }
+
+    server->shutdown();
+    delete server;
+    REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 0u );
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+typedef std::chrono::steady_clock Clock_T;
+
+static uint64_t nowUsec()
+{
+    return (uint64_t) std::chrono::duration_cast<std::chrono::microseconds>(Clock_T::now().time_since_epoch()).count();
+}
+
+/** Load generator. All sessions issue commands concurrently, i.e. each
+    session sends its next command as soon as the previous command completes.
+    The latency of a command is the time from sending the command to receiving
+    the command prompt.
+ */
+static void runLoad( unsigned numSessions, unsigned numCommands )
+{
+    Server* server = new Server( numSessions );
+    server->launch();
+    Client* clients = new Client[numSessions];
+    REQUIRE( connectAll( clients, numSessions ) );
+
+    std::vector<uint64_t>  latencies;
+    std::vector<uint64_t>  sentAt( numSessions );
+    std::vector<unsigned>  remaining( numSessions, numCommands );
+    latencies.reserve( numSessions * numCommands );
+
+    Cpl::Text::FString<64> cmd;
+    unsigned long          start = Cpl::System::ElapsedTime::milliseconds();
+    for ( unsigned i=0; i < numSessions; i++ )
+    {
+        cmd.format( "tprint s%u-%u\n", i, remaining[i] );
+        sentAt[i] = nowUsec();
+        REQUIRE( clients[i].send( cmd ) );
+    }
+
+    unsigned outstanding = numSessions;
+    while ( outstanding )
+    {
+        if ( Cpl::System::ElapsedTime::expiredMilliseconds( start, 60 * 1000 ) )
+        {
+            FAIL( "load generator timed out" );
+        }
+        for ( unsigned i=0; i < numSessions; i++ )
+        {
+            unsigned before = clients[i].m_prompts;
+            clients[i].service();
+            if ( clients[i].m_prompts != before && remaining[i] > 0 )
+            {
+                uint64_t now = nowUsec();
+                latencies.push_back( now - sentAt[i] );
+                if ( --remaining[i] == 0 )
+                {
+                    outstanding--;
+                    continue;
+                }
+                cmd.format( "tprint s%u-%u\n", i, remaining[i] );
+                sentAt[i] = now;
+                REQUIRE( clients[i].send( cmd ) );
+            }
+        }
+    }
+    unsigned long elapsed = Cpl::System::ElapsedTime::deltaMilliseconds( start );
+
+    std::sort( latencies.begin(), latencies.end() );
+    uint64_t sum = 0;
+    for ( size_t i=0; i < latencies.size(); i++ )
+    {
+        sum += latencies[i];
+    }
+    size_t n = latencies.size();
+    CPL_SYSTEM_TRACE_MSG( SECT_, ("%3u sessions x %u cmds: %lu ms, %lu cmds/sec. latency(us): avg=%lu p50=%lu p99=%lu max=%lu",
+                                   numSessions, numCommands, elapsed,
+                                   (unsigned long) (n * 1000ULL / (elapsed ? elapsed : 1)),
+                                   (unsigned long) (sum / n),
+                                   (unsigned long) latencies[n / 2],
+                                   (unsigned long) latencies[(n * 99) / 100],
+                                   (unsigned long) latencies[n - 1]) );
+
+    for ( unsigned i=0; i < numSessions; i++ )
+    {
+        clients[i].close();
+    }
+    delete[] clients;
+    server->shutdown();
+    delete server;
+}
+
+TEST_CASE( "multisession-loadgen", "[.bench]" )
+{
+    runLoad( 1, 2000 );
+    runLoad( 12, 500 );
+    runLoad( 64, 100 );
+}
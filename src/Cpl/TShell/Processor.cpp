@@ -64,6 +64,7 @@ Processor::Processor( Cpl::Container::Map<Command>&commands,
     , m_quote( argQuote )
     , m_term( argTerminator )
     , m_running( false )
+    , m_blocking( true )
 {
 }
 
@@ -103,7 +104,10 @@ int Processor::getAndProcessFrame( Cpl::Io::Output & outfd ) noexcept
     if ( !run )
     {
         OUTPUT_FAREWELL();
-        Cpl::System::Api::sleep( 250 ); // Allow time for the farewell message to be outputted
+        if ( m_blocking )
+        {
+            Cpl::System::Api::sleep( 250 ); // Allow time for the farewell message to be outputted (but do not stall a polled/shared thread)
+        }
         return 1;
     }
 
@@ -141,7 +145,8 @@ int Processor::getAndProcessFrame( Cpl::Io::Output & outfd ) noexcept
 bool Processor::start( Cpl::Io::Input & infd, Cpl::Io::Output & outfd, bool blocking ) noexcept
 {
     // Housekeeping
-    m_running = true;
+    m_running  = true;
+    m_blocking = blocking;
     m_outputBuffer.clear();
     m_framer.setOutput( outfd );
 
@@ -161,8 +166,8 @@ bool Processor::start( Cpl::Io::Input & infd, Cpl::Io::Output & outfd, bool bloc
     } while ( blocking );
 
 
-    // If I get here, then the command processor self terminated
-    return false;
+    // If I get here, then the command processor was successfully started (non-blocking semantics)
+    return true;
 }
 
 
@@ -259,6 +259,9 @@ protected:
     /// My run state
     bool                                m_running;
 
+    /// Blocking/polled semantics (as specified by start())
+    bool                                m_blocking;
+
     /// Input Frame buffer
     char                                m_inputBuffer[OPTION_CPL_TSHELL_PROCESSOR_INPUT_SIZE + 1];
 
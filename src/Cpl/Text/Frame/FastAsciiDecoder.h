@@ -0,0 +1,65 @@
+#ifndef Cpl_Text_Frame_FastAsciiDecoder_h_
+#define Cpl_Text_Frame_FastAsciiDecoder_h_
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+/** @file */
+
+
+#include "Cpl/Text/Frame/FastStreamDecoder.h"
+
+
+///
+namespace Cpl {
+///
+namespace Text {
+///
+namespace Frame {
+
+
+
+/** This concrete template class is a drop-in replacement for
+	Cpl::Text::Frame::AsciiDecoder that uses the FastStreamDecoder's bulk
+	scanning algorithm.
+
+	Template args:
+		BUFSIZE     Size of the internal buffer to use when reading raw
+					characters from the Input stream.
+ */
+template <int BUFSIZE>
+class FastAsciiDecoder : public FastStreamDecoder
+{
+protected:
+	/// Raw input buffer for reading characters in 'chunks' from my Input stream (i.e. minimize the calls to read())
+	char            m_buffer[BUFSIZE];
+
+
+public:
+	/** Constructor.  If 'restrict' is set to true ONLY printable ASCII
+		characters (0x20-0x7E) are accepted inside a frame.  If false, then
+		all ASCII characters (0x00-0x7F) are accepted inside a frame.  When
+		a illegal character is detected, it causes the Decoder's state machine
+		to reset and begin searching/looking-for the next start-of-frame
+		character.
+	 */
+	FastAsciiDecoder( char startOfFrame, char endOfFrame, char escapeChar, bool restrict=true, Cpl::Io::Input* inputSource=0, bool blocking = true )
+		:FastStreamDecoder( m_buffer, BUFSIZE, startOfFrame, endOfFrame, escapeChar, restrict ? ePRINTABLE_CHARS : eASCII_CHARS, inputSource, blocking )
+	{
+	}
+};
+
+
+
+
+
+};      // end namespaces
+};
+};
+#endif  // end header latch
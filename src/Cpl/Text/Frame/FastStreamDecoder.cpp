@@ -0,0 +1,243 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+
+
+#include "FastStreamDecoder.h"
+#include <string.h>
+
+
+///
+using namespace Cpl::Text::Frame;
+
+
+
+///////////////////////////////////
+FastStreamDecoder::FastStreamDecoder( char            rawInputBuffer[],
+									  size_t          sizeOfRawInputBuffer,
+									  char            startOfFrame,
+									  char            endOfFrame,
+									  char            escapeChar,
+									  LegalChars_T    legalChars,
+									  Cpl::Io::Input* inputSource,
+									  bool            blocking )
+	:StreamDecoder( rawInputBuffer, sizeOfRawInputBuffer, inputSource, blocking )
+	, m_numSearchChars( 0 )
+	, m_sof( startOfFrame )
+	, m_eof( endOfFrame )
+	, m_esc( escapeChar )
+{
+	// Build the character class table.  Note: Illegal characters take precedence (same as Decoder_::scan())
+	for ( unsigned i=0; i < 256; i++ )
+	{
+		bool legal = legalChars == eALL_CHARS ||
+			( legalChars == eNON_NULL_CHARS && i != 0 ) ||
+			( legalChars == eASCII_CHARS && i < 0x80 ) ||
+			( legalChars == ePRINTABLE_CHARS && i >= 0x20 && i <= 0x7E );
+		m_class[i] = legal ? eCLASS_REGULAR : eCLASS_ILLEGAL;
+	}
+	if ( m_class[(uint8_t) m_esc] == eCLASS_REGULAR )
+	{
+		m_class[(uint8_t) m_esc] = eCLASS_ESC;
+	}
+	if ( m_class[(uint8_t) m_eof] == eCLASS_REGULAR )
+	{
+		m_class[(uint8_t) m_eof] = eCLASS_EOF;
+	}
+
+	// Use memchr() when there are only a few special characters
+	if ( legalChars == eALL_CHARS || legalChars == eNON_NULL_CHARS )
+	{
+		m_searchChars[m_numSearchChars++] = m_eof;
+		m_searchChars[m_numSearchChars++] = m_esc;
+		if ( legalChars == eNON_NULL_CHARS )
+		{
+			m_searchChars[m_numSearchChars++] = '\0';
+		}
+	}
+	memset( m_nextSearch, 0, sizeof( m_nextSearch ) );
+}
+
+
+///////////////////////////////////
+bool FastStreamDecoder::read( void* buffer, int numBytes, int& bytesRead )
+{
+	// The raw input buffer is being refilled -->the cached search results are no longer valid
+	memset( m_nextSearch, 0, sizeof( m_nextSearch ) );
+	return StreamDecoder::read( buffer, numBytes, bytesRead );
+}
+
+const char* FastStreamDecoder::findSpecial( const char* start, const char* end ) noexcept
+{
+	// Class table search
+	if ( m_numSearchChars == 0 )
+	{
+		while ( start < end && m_class[(uint8_t) *start] == eCLASS_REGULAR )
+		{
+			start++;
+		}
+		return start;
+	}
+
+	// memchr() search. Only search for a character again once its previous search result has been consumed
+	const char* nearest = end;
+	for ( unsigned i=0; i < m_numSearchChars; i++ )
+	{
+		if ( m_nextSearch[i] == 0 || m_nextSearch[i] < start )
+		{
+			const char* found = (const char*) memchr( start, m_searchChars[i], end - start );
+			m_nextSearch[i]   = found ? found : end;
+		}
+		if ( m_nextSearch[i] < nearest )
+		{
+			nearest = m_nextSearch[i];
+		}
+	}
+	return nearest;
+}
+
+
+///////////////////////////////////
+bool FastStreamDecoder::scan( size_t maxSizeOfFrame, char* frame, size_t& frameSize, bool& isEof ) noexcept
+{
+	// Default to in-progress
+	isEof = false;
+
+	// Get more input data once my local buffer/cache is empty
+	if ( !m_dataLen )
+	{
+		if ( !read( m_buffer, m_bufSize, m_dataLen ) )
+		{
+			// Error reading data -->exit scan
+			m_dataLen = 0; // Reset my internal count so I start 'over' on the next call (if there is one)
+			frameSize = m_frameSize;
+			initializeFrame();
+			return false;
+		}
+
+		// Reset my data pointer
+		m_dataPtr = m_buffer;
+	}
+
+	// Process my input buffer a 'run' at a time
+	char* end = m_dataPtr + m_dataLen;
+	while ( m_dataPtr < end )
+	{
+		// OUTSIDE of a frame: skip everything up to and including the SOF character
+		if ( !m_inFrame )
+		{
+			char* sof = (char*) memchr( m_dataPtr, m_sof, end - m_dataPtr );
+			if ( sof == 0 )
+			{
+				m_dataPtr = end;
+				break;
+			}
+			m_dataPtr   = sof + 1;
+			m_inFrame   = true;
+			m_escaping  = false;
+			m_frameSize = 0;
+			m_framePtr  = frame;
+			continue;
+		}
+
+		// Escape Sequence
+		if ( m_escaping )
+		{
+			char c = *m_dataPtr++;
+			if ( m_class[(uint8_t) c] == eCLASS_ILLEGAL )
+			{
+				m_inFrame = false;
+			}
+			else if ( m_frameSize < maxSizeOfFrame )
+			{
+				m_escaping    = false;
+				*m_framePtr++ = decodeEscapedChar( c );
+				m_frameSize++;
+			}
+
+			// Exceeded the Client's buffer space -->internal error -->reset my Frame state
+			else
+			{
+				initializeFrame();
+			}
+			continue;
+		}
+
+		// Bulk copy the run of regular characters
+		char*  special = (char*) findSpecial( m_dataPtr, end );
+		size_t runLen  = special - m_dataPtr;
+		if ( runLen )
+		{
+			// Exceeded the Client's buffer space -->internal error -->reset my Frame state (and discard the offending character)
+			if ( runLen > maxSizeOfFrame - m_frameSize )
+			{
+				m_dataPtr += maxSizeOfFrame - m_frameSize + 1;
+				initializeFrame();
+				continue;
+			}
+
+			memcpy( m_framePtr, m_dataPtr, runLen );
+			m_framePtr  += runLen;
+			m_frameSize += runLen;
+			m_dataPtr    = special;
+			if ( special == end )
+			{
+				break;
+			}
+		}
+
+		// Process the special character
+		switch ( m_class[(uint8_t) *m_dataPtr++] )
+		{
+		case eCLASS_EOF:
+			// EXIT routine with a success return code
+			m_dataLen = (int) ( end - m_dataPtr );
+			frameSize = m_frameSize;
+			isEof     = true;
+			initializeFrame();  // Reset my internal frame state to be ready for the next frame
+			return true;
+
+		case eCLASS_ESC:
+			m_escaping = true;
+			break;
+
+		default:
+			m_inFrame = false;
+			break;
+		}
+	}
+
+	// If I get here there was no IO error - but still no End-of-Frame
+	m_dataLen = 0;
+	frameSize = m_frameSize;
+	return true;
+}
+
+
+///////////////////////////////////
+bool FastStreamDecoder::isStartOfFrame() noexcept
+{
+	return *m_dataPtr == m_sof;
+}
+
+bool FastStreamDecoder::isEofOfFrame() noexcept
+{
+	return m_class[(uint8_t) *m_dataPtr] == eCLASS_EOF;
+}
+
+bool FastStreamDecoder::isEscapeChar() noexcept
+{
+	return m_class[(uint8_t) *m_dataPtr] == eCLASS_ESC;
+}
+
+bool FastStreamDecoder::isLegalCharacter() noexcept
+{
+	return m_class[(uint8_t) *m_dataPtr] != eCLASS_ILLEGAL;
+}
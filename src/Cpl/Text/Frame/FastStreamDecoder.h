@@ -0,0 +1,153 @@
+#ifndef Cpl_Text_Frame_FastStreamDecoder_h_
+#define Cpl_Text_Frame_FastStreamDecoder_h_
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+/** @file */
+
+
+#include "Cpl/Text/Frame/StreamDecoder.h"
+#include <stdint.h>
+
+
+///
+namespace Cpl {
+///
+namespace Text {
+///
+namespace Frame {
+
+
+
+/** This partially concrete class is a StreamDecoder whose framing characters
+	(and set of legal in-frame characters) are specified at construction time.
+	Instead of processing the input one character at a time (with multiple
+	virtual calls per character), the decoder searches the raw input buffer
+	for the next 'special' character and bulk copies the run of ordinary
+	characters in between into the Client's frame buffer:
+
+		- Outside of a frame, memchr() is used to locate the SOF character.
+		- Inside of a frame, when the set of illegal characters is empty or
+		  is only the null character, memchr() is used to locate the EOF,
+		  escape, and null characters. The search results are cached so that
+		  each character is only searched once per raw input buffer.
+		- Otherwise a 256 entry character class table is used to locate the
+		  next EOF, escape, or illegal character.
+
+	The decoded frames are identical to the frames decoded by the per-character
+	Decoder_::scan() algorithm.
+
+	NOTE: A sub-class IS required to provide the raw input buffer, see
+		  Cpl::Text::Frame::FastAsciiDecoder
+ */
+class FastStreamDecoder : public StreamDecoder
+{
+public:
+	/// Options for the set of characters that are legal within a frame
+	enum LegalChars_T
+	{
+		eALL_CHARS,             //!< All characters are legal
+		eNON_NULL_CHARS,        //!< All characters except '\0' are legal
+		eASCII_CHARS,           //!< Only ASCII characters (0x00-0x7F) are legal
+		ePRINTABLE_CHARS        //!< Only printable ASCII characters (0x20-0x7E) are legal
+	};
+
+protected:
+	/** Constructor.  See Cpl::Text::Frame::StreamDecoder for details about the
+		'rawInputBuffer', 'inputSource', and 'blocking' arguments.  When an
+		illegal character (as specified by 'legalChars') is detected inside of
+		a frame, the current frame is discarded and the decoder begins
+		searching for the next start-of-frame character.
+	 */
+	FastStreamDecoder( char            rawInputBuffer[],
+					   size_t          sizeOfRawInputBuffer,
+					   char            startOfFrame,
+					   char            endOfFrame,
+					   char            escapeChar,
+					   LegalChars_T    legalChars  = ePRINTABLE_CHARS,
+					   Cpl::Io::Input* inputSource = 0,
+					   bool            blocking    = true );
+
+
+public:
+	/// Pull in overloaded methods from base class
+	using Decoder_::scan;
+
+	/// See Cpl::Text::Frame::Decoder
+	bool scan( size_t maxSizeOfFrame, char* frame, size_t& frameSize, bool& isEof ) noexcept;
+
+
+protected:
+	/// See Cpl::Text::Frame::Decoder_
+	bool isStartOfFrame() noexcept;
+
+	/// See Cpl::Text::Frame::Decoder_
+	bool isEofOfFrame() noexcept;
+
+	/// See Cpl::Text::Frame::Decoder_
+	bool isEscapeChar() noexcept;
+
+	/// See Cpl::Text::Frame::Decoder_
+	bool isLegalCharacter() noexcept;
+
+	/// See Cpl::Text::Frame::Decoder_.  Note: Invalidates the cached search results
+	bool read( void* buffer, int numBytes, int& bytesRead );
+
+protected:
+	/** Helper method that returns a pointer to the next EOF, escape, or
+		illegal character in the range [start, end).  Returns 'end' if there
+		is no such character.
+	 */
+	const char* findSpecial( const char* start, const char* end ) noexcept;
+
+protected:
+	/// Character classes
+	enum
+	{
+		eCLASS_REGULAR = 0,     //!< Regular character
+		eCLASS_EOF,             //!< End-of-frame character
+		eCLASS_ESC,             //!< Escape character
+		eCLASS_ILLEGAL          //!< Illegal character
+	};
+
+	/// Maximum number of characters that are searched using memchr()
+	enum { eMAX_SEARCH_CHARS = 3 };
+
+protected:
+	/// Character class table (indexed by the unsigned character value)
+	uint8_t         m_class[256];
+
+	/// Characters that are searched using memchr() (zero when the class table is used)
+	char            m_searchChars[eMAX_SEARCH_CHARS];
+
+	/// Cached search results (null when the result is not known)
+	const char*     m_nextSearch[eMAX_SEARCH_CHARS];
+
+	/// Number of characters that are searched using memchr()
+	unsigned        m_numSearchChars;
+
+	/// SOF character
+	const char      m_sof;
+
+	/// EOF character
+	const char      m_eof;
+
+	/// Escape character
+	const char      m_esc;
+};
+
+
+
+
+
+};      // end namespaces
+};
+};
+#endif  // end header latch
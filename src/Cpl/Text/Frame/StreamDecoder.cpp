@@ -35,7 +35,11 @@ StreamDecoder::StreamDecoder( char            rawInputBuffer[],
 ///////////////////////////////////
 void StreamDecoder::setInput( Cpl::Io::Input& newInFd ) noexcept
 {
-	m_srcPtr = &newInFd;
+	m_srcPtr  = &newInFd;
+
+	// Discard any buffered/partial input from the previous input source
+	m_dataLen = 0;
+	initializeFrame();
 }
 
 
@@ -50,7 +50,8 @@ protected:
 
 public:
 	/** This method allows the Application/consumer to change/Set the Input
-		Stream handle.
+		Stream handle.  Any buffered and/or partially decoded input from the
+		previous Input Stream is discarded.
 	 */
 	void setInput( Cpl::Io::Input& newInFd ) noexcept;
 
@@ -0,0 +1,335 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+
+#include "Catch/catch.hpp"
+#include "Cpl/Text/FString.h"
+#include "Cpl/Text/Frame/AsciiDecoder.h"
+#include "Cpl/Text/Frame/FastAsciiDecoder.h"
+#include "Cpl/Text/Frame/StringDecoder.h"
+#include "Cpl/Io/File/Input.h"
+#include "Cpl/System/Trace.h"
+#include "Cpl/System/_testsupport/Shutdown_TS.h"
+#include <chrono>
+#include <string.h>
+
+
+///
+using namespace Cpl::Text::Frame;
+
+#define SECT_   "_0test"
+
+#define SOF_     '.'
+#define EOF_     ';'
+#define ESC_     '~'
+
+#define MAX_FRAME_SIZE_     16
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+/// Input stream that reads from a memory buffer
+class MemoryInput : public Cpl::Io::Input
+{
+public:
+	///
+	MemoryInput( const char* data, size_t len ) :m_data( data ), m_len( len ), m_offset( 0 ) {}
+
+	///
+	void rewind() { m_offset = 0; }
+
+	///
+	bool read( void* buffer, int numBytes, int& bytesRead )
+	{
+		if ( m_offset >= m_len )
+		{
+			bytesRead = 0;
+			return false;
+		}
+		size_t remaining = m_len - m_offset;
+		bytesRead        = (size_t) numBytes < remaining ? numBytes : (int) remaining;
+		memcpy( buffer, m_data + m_offset, bytesRead );
+		m_offset += bytesRead;
+		return true;
+	}
+
+	///
+	bool available() { return m_offset < m_len; }
+
+	///
+	bool isEos() { return m_offset >= m_len; }
+
+	///
+	void close() {}
+
+	///
+	using Cpl::Io::Input::read;
+
+protected:
+	const char* m_data;
+	size_t      m_len;
+	size_t      m_offset;
+};
+
+/// Fast decoder that accepts all non-null characters (i.e. the memchr() search path)
+template <int BUFSIZE>
+class NonNullDecoder : public FastStreamDecoder
+{
+public:
+	///
+	NonNullDecoder( Cpl::Io::Input* inputSource )
+		:FastStreamDecoder( m_buffer, BUFSIZE, SOF_, EOF_, ESC_, eNON_NULL_CHARS, inputSource )
+	{
+	}
+
+protected:
+	char m_buffer[BUFSIZE];
+};
+
+/// Reference decoder that accepts all non-null characters
+template <int BUFSIZE>
+class RefNonNullDecoder : public StreamDecoder
+{
+public:
+	///
+	RefNonNullDecoder( Cpl::Io::Input* inputSource )
+		:StreamDecoder( m_buffer, BUFSIZE, inputSource )
+	{
+	}
+
+protected:
+	bool isStartOfFrame() noexcept { return *m_dataPtr == SOF_; }
+	bool isEofOfFrame() noexcept { return *m_dataPtr == EOF_; }
+	bool isEscapeChar() noexcept { return *m_dataPtr == ESC_; }
+	bool isLegalCharacter() noexcept { return *m_dataPtr != '\0'; }
+
+	char m_buffer[BUFSIZE];
+};
+
+}; // end anonymous namespace
+
+/// Decodes ALL frames with both decoders and verifies that the results are identical.  Returns the number of frames
+static unsigned compareDecoders( Decoder& reference, Decoder& uut, size_t maxFrameSize=MAX_FRAME_SIZE_ )
+{
+	char     refFrame[128];
+	char     uutFrame[128];
+	unsigned numFrames = 0;
+	for ( ;;)
+	{
+		size_t refSize  = 0;
+		size_t uutSize  = 0;
+		bool   refFound = reference.scan( maxFrameSize, refFrame, refSize );
+		bool   uutFound = uut.scan( maxFrameSize, uutFrame, uutSize );
+		REQUIRE( refFound == uutFound );
+		if ( !refFound )
+		{
+			return numFrames;
+		}
+		REQUIRE( refSize == uutSize );
+		REQUIRE( memcmp( refFrame, uutFrame, refSize ) == 0 );
+		numFrames++;
+	}
+}
+
+/// Compares the non-null decoders using a raw input buffer size of BUFSIZE
+template <int BUFSIZE>
+static unsigned compareNonNull( const char* input, size_t len )
+{
+	MemoryInput                 refInput( input, len );
+	MemoryInput                 uutInput( input, len );
+	RefNonNullDecoder<BUFSIZE>  reference( &refInput );
+	NonNullDecoder<BUFSIZE>     uut( &uutInput );
+	return compareDecoders( reference, uut );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_CASE( "fastdecoder" )
+{
+	Cpl::System::Shutdown_TS::clearAndUseCounter();
+	Cpl::Text::FString<MAX_FRAME_SIZE_ + 1> instring;
+	char                                    buffer[MAX_FRAME_SIZE_];
+	size_t                                  fsize;
+
+	SECTION( "frames" )
+	{
+		Cpl::Io::File::Input  infd( "testinput.txt" );
+		FastAsciiDecoder<7>   decoder( SOF_, EOF_, ESC_, true, &infd );
+
+		static const char* expected[] ={ "hello world", "", "good frame", "just kidding", ".sof", ".more sof", ";eof", ".~;sef", "frame" };
+		for ( unsigned i=0; i < sizeof( expected ) / sizeof( expected[0] ); i++ )
+		{
+			REQUIRE( decoder.scan( sizeof( buffer ), buffer, fsize ) );
+			instring.copyIn( buffer, fsize );
+			CPL_SYSTEM_TRACE_MSG( SECT_, ( "Frame=[%s]", instring.getString() ) );
+			REQUIRE( instring == expected[i] );
+		}
+
+		// Out-of-band data
+		Cpl::Text::FString<64> oob;
+		int                    oobBytes;
+		int                    expectedCount = 41;
+		while ( expectedCount && decoder.oobRead( buffer, expectedCount < (int) sizeof( buffer ) ? expectedCount : (int) sizeof( buffer ), oobBytes ) )
+		{
+			oob.appendTo( buffer, oobBytes );
+			expectedCount -= oobBytes;
+		}
+		REQUIRE( oob == "oob data here  including sof char len=41." );
+
+		REQUIRE( decoder.scan( sizeof( buffer ), buffer, fsize ) );
+		instring.copyIn( buffer, fsize );
+		REQUIRE( instring == "next frame" );
+		REQUIRE( decoder.scan( sizeof( buffer ), buffer, fsize ) == false );
+		infd.close();
+	}
+
+	SECTION( "same as AsciiDecoder" )
+	{
+		static const bool restricted[] ={ true, false };
+		for ( unsigned r=0; r < 2; r++ )
+		{
+			Cpl::Io::File::Input refFd( "testinput.txt" );
+			Cpl::Io::File::Input uutFd( "testinput.txt" );
+			AsciiDecoder<7>      reference( SOF_, EOF_, ESC_, restricted[r], &refFd );
+			FastAsciiDecoder<3>  uut( SOF_, EOF_, ESC_, restricted[r], &uutFd );
+			REQUIRE( compareDecoders( reference, uut ) > 0 );
+		}
+	}
+
+	SECTION( "non-null characters" )
+	{
+		static const char input[] = "junk.abc;.a\0bc;.~\0;.tab\there;..~~\x80\xff;.0123456789abcdef;.0123456789abcdefg;.~;x;.end~";
+		REQUIRE( compareNonNull<1>( input, sizeof( input ) - 1 ) == 5 );
+		REQUIRE( compareNonNull<3>( input, sizeof( input ) - 1 ) == 5 );
+		REQUIRE( compareNonNull<64>( input, sizeof( input ) - 1 ) == 5 );
+
+		MemoryInput        in( input, sizeof( input ) - 1 );
+		NonNullDecoder<5>  uut( &in );
+		REQUIRE( uut.scan( sizeof( buffer ), buffer, fsize ) );
+		instring.copyIn( buffer, fsize );
+		REQUIRE( instring == "abc" );
+		REQUIRE( uut.scan( sizeof( buffer ), buffer, fsize ) );
+		instring.copyIn( buffer, fsize );
+		REQUIRE( instring == "tab\there" );
+		REQUIRE( uut.scan( sizeof( buffer ), buffer, fsize ) );
+		REQUIRE( fsize == 4 );
+		REQUIRE( memcmp( buffer, ".~\x80\xff", 4 ) == 0 );
+		REQUIRE( uut.scan( sizeof( buffer ), buffer, fsize ) );
+		instring.copyIn( buffer, fsize );
+		REQUIRE( instring == "0123456789abcdef" );
+		REQUIRE( uut.scan( sizeof( buffer ), buffer, fsize ) );   // The oversized frame is discarded
+		instring.copyIn( buffer, fsize );
+		REQUIRE( instring == ";x" );
+	}
+
+	REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 0u );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+#define BENCH_INPUT_SIZE_   ( 1024 * 1024 )
+#define BENCH_PASSES_       10
+#define BENCH_BUFSIZE_      128
+
+/// Builds an input stream of frames.  Every 'escapeInterval' payload character is escaped (0 := no escapes)
+static size_t buildInput( char* dst, size_t maxLen, unsigned escapeInterval )
+{
+	static const char payload[] = "RSP:ok tstat idt=72.5 odt=95.1 mode=eCOOLING fan=eAUTO stages=1/2 cph=e3CPH err=0 seq=12345";
+	size_t            len       = 0;
+	unsigned          count     = 0;
+	while ( len + 2 * sizeof( payload ) + 2 < maxLen )
+	{
+		dst[len++] = SOF_;
+		for ( unsigned i=0; i < sizeof( payload ) - 1; i++ )
+		{
+			if ( escapeInterval && ( ++count % escapeInterval ) == 0 )
+			{
+				dst[len++] = ESC_;
+			}
+			dst[len++] = payload[i];
+		}
+		dst[len++] = EOF_;
+		dst[len++] = '\n';
+	}
+	return len;
+}
+
+/// Decodes the entire input 'BENCH_PASSES_' times.  Returns the throughput in MB/sec
+static double benchDecoder( Decoder& decoder, MemoryInput& input, size_t inputLen, unsigned& numFrames )
+{
+	char frame[256];
+	numFrames  = 0;
+	auto start = std::chrono::steady_clock::now();
+	for ( unsigned p=0; p < BENCH_PASSES_; p++ )
+	{
+		input.rewind();
+		size_t fsize;
+		while ( decoder.scan( sizeof( frame ), frame, fsize ) )
+		{
+			numFrames++;
+		}
+	}
+	double secs = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+	return ( (double) inputLen * BENCH_PASSES_ ) / ( 1024.0 * 1024.0 ) / secs;
+}
+
+/// Decodes the entire input 'BENCH_PASSES_' times using a StringDecoder.  Returns the throughput in MB/sec
+static double benchStringDecoder( const char* input, size_t inputLen, unsigned& numFrames )
+{
+	StringDecoder decoder( SOF_, EOF_, ESC_ );
+	char          frame[256];
+	numFrames  = 0;
+	auto start = std::chrono::steady_clock::now();
+	for ( unsigned p=0; p < BENCH_PASSES_; p++ )
+	{
+		const char* ptr = input;
+		size_t      fsize;
+		decoder.setInput( ptr, (int) inputLen );
+		while ( decoder.scan( sizeof( frame ), frame, fsize ) )
+		{
+			numFrames++;
+			ptr = decoder.getRemainder();
+			decoder.setInput( ptr, (int) ( inputLen - ( ptr - input ) ) );
+		}
+	}
+	double secs = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+	return ( (double) inputLen * BENCH_PASSES_ ) / ( 1024.0 * 1024.0 ) / secs;
+}
+
+TEST_CASE( "fastdecoder-benchmark", "[.bench]" )
+{
+	char* input = new char[BENCH_INPUT_SIZE_];
+
+	static const unsigned     escapeIntervals[] ={ 0, 4 };
+	static const char* const  labels[]          ={ "typical", "escape-heavy" };
+	for ( unsigned i=0; i < 2; i++ )
+	{
+		size_t   len = buildInput( input, BENCH_INPUT_SIZE_, escapeIntervals[i] );
+		unsigned refFrames, fastFrames, strFrames, nonNullFrames, fastNonNullFrames;
+
+		MemoryInput                        in( input, len );
+		AsciiDecoder<BENCH_BUFSIZE_>       reference( SOF_, EOF_, ESC_, true, &in );
+		FastAsciiDecoder<BENCH_BUFSIZE_>   fast( SOF_, EOF_, ESC_, true, &in );
+		RefNonNullDecoder<BENCH_BUFSIZE_>  refNonNull( &in );
+		NonNullDecoder<BENCH_BUFSIZE_>     fastNonNull( &in );
+		double refRate         = benchDecoder( reference, in, len, refFrames );
+		double fastRate        = benchDecoder( fast, in, len, fastFrames );
+		double strRate         = benchStringDecoder( input, len, strFrames );
+		double refNonNullRate  = benchDecoder( refNonNull, in, len, nonNullFrames );
+		double fastNonNullRate = benchDecoder( fastNonNull, in, len, fastNonNullFrames );
+		REQUIRE( refFrames == fastFrames );
+		REQUIRE( refFrames == strFrames );
+		REQUIRE( refFrames == nonNullFrames );
+		REQUIRE( refFrames == fastNonNullFrames );
+
+		CPL_SYSTEM_TRACE_MSG( SECT_, ( "%s (%u frames): printable: AsciiDecoder=%.1f MB/s, FastAsciiDecoder=%.1f MB/s.  non-null: StringDecoder=%.1f MB/s, StreamDecoder=%.1f MB/s, FastStreamDecoder=%.1f MB/s",
+									   labels[i], refFrames, refRate, fastRate, strRate, refNonNullRate, fastNonNullRate ) );
+	}
+
+	delete[] input;
+}
@@ -0,0 +1,260 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+/** @file */
+
+#include "Api.h"
+#include <new>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace Driver::NV::File::Mmap;
+
+
+//////////////////////////////////////////////////////////////////////////////
+Api::Api( size_t       numPages,
+          size_t       bytesPerPage,
+          const char*  filename,
+          SyncPolicy_T syncPolicy )
+    : m_fname( filename )
+    , m_storage( 0 )
+    , m_dirty( new( std::nothrow ) uint8_t[(numPages + 7) / 8] )
+    , m_numPages( numPages )
+    , m_pageSize( bytesPerPage )
+    , m_totalSize( numPages * bytesPerPage )
+    , m_numDirty( 0 )
+    , m_osPageSize( (size_t) sysconf( _SC_PAGESIZE ) )
+    , m_fd( -1 )
+    , m_syncPolicy( syncPolicy )
+    , m_started( false )
+{
+}
+
+Api::~Api()
+{
+    stop();
+    delete[] m_dirty;
+}
+
+bool Api::start() noexcept
+{
+    // Skip processing if already started (or no memory for the dirty pages)
+    if ( m_started || !m_dirty )
+    {
+        return false;
+    }
+
+    // Open/Create the file (fails if there is an existing directory with the same file name)
+    m_fd = open( m_fname, O_RDWR | O_CREAT, 0666 );
+    if ( m_fd < 0 )
+    {
+        return false;
+    }
+
+    // Extend the file (if needed).  Any new storage is set to the 'erased value'
+    struct stat info;
+    if ( fstat( m_fd, &info ) != 0 || (info.st_size < (off_t) m_totalSize && ftruncate( m_fd, m_totalSize ) != 0) )
+    {
+        close( m_fd );
+        m_fd = -1;
+        return false;
+    }
+
+    // Map the storage
+    void* storage = mmap( 0, m_totalSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0 );
+    if ( storage == MAP_FAILED )
+    {
+        close( m_fd );
+        m_fd = -1;
+        return false;
+    }
+    m_storage = (uint8_t*) storage;
+    memset( m_dirty, 0, (m_numPages + 7) / 8 );
+    m_numDirty = 0;
+    if ( info.st_size < (off_t) m_totalSize )
+    {
+        memset( m_storage + info.st_size, OPTION_DRIVER_NV_FILE_MMAP_ERASED_VALUE, m_totalSize - info.st_size );
+        if ( msync( m_storage, m_totalSize, MS_SYNC ) != 0 )
+        {
+            munmap( m_storage, m_totalSize );
+            close( m_fd );
+            m_storage = 0;
+            m_fd      = -1;
+            return false;
+        }
+    }
+
+    m_started = true;
+    return true;
+}
+
+void Api::stop() noexcept
+{
+    if ( m_started )
+    {
+        flush();
+        munmap( m_storage, m_totalSize );
+        close( m_fd );
+        m_storage = 0;
+        m_fd      = -1;
+        m_started = false;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+bool Api::write( size_t dstOffset, const void* srcData, size_t numBytesToWrite ) noexcept
+{
+    // Fail if not started
+    if ( !m_started )
+    {
+        return false;
+    }
+
+    // Fail immediately if out-of-range
+    if ( dstOffset + numBytesToWrite > m_totalSize )
+    {
+        return false;
+    }
+
+    // Update the storage one NV page at a time (only pages whose content changes are marked as dirty)
+    const uint8_t* srcPtr    = (const uint8_t*) srcData;
+    size_t         firstPage = 0;
+    size_t         lastPage  = 0;
+    bool           modified  = false;
+    while ( numBytesToWrite )
+    {
+        size_t page      = dstOffset / m_pageSize;
+        size_t pageBytes = m_pageSize - (dstOffset % m_pageSize);
+        size_t numBytes  = numBytesToWrite > pageBytes ? pageBytes : numBytesToWrite;
+        if ( memcmp( m_storage + dstOffset, srcPtr, numBytes ) != 0 )
+        {
+            memcpy( m_storage + dstOffset, srcPtr, numBytes );
+            if ( !modified )
+            {
+                firstPage = page;
+                modified  = true;
+            }
+            lastPage = page;
+            if ( !isDirty( page ) )
+            {
+                m_dirty[page / 8] |= (uint8_t) (1 << (page % 8));
+                m_numDirty++;
+            }
+        }
+
+        dstOffset       += numBytes;
+        srcPtr          += numBytes;
+        numBytesToWrite -= numBytes;
+    }
+
+    // Apply the sync policy
+    if ( modified )
+    {
+        if ( m_syncPolicy == eSYNC_IMMEDIATE )
+        {
+            return flush();
+        }
+        else if ( m_syncPolicy == eSYNC_DEFERRED )
+        {
+            return syncPages( firstPage, lastPage, MS_ASYNC );
+        }
+    }
+
+    return true;
+}
+
+bool Api::read( size_t srcOffset, void* dstData, size_t numBytesToRead ) noexcept
+{
+    // Fail if not started
+    if ( !m_started )
+    {
+        return false;
+    }
+
+    // Fail immediately if out-of-range
+    if ( srcOffset + numBytesToRead > m_totalSize )
+    {
+        return false;
+    }
+
+    memcpy( dstData, m_storage + srcOffset, numBytesToRead );
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+bool Api::flush() noexcept
+{
+    if ( !m_started )
+    {
+        return false;
+    }
+
+    // Sync each contiguous run of dirty pages
+    bool   result = true;
+    size_t page   = 0;
+    while ( m_numDirty && page < m_numPages )
+    {
+        // Skip clean pages (8 pages at time when possible)
+        if ( m_dirty[page / 8] == 0 )
+        {
+            page = (page / 8 + 1) * 8;
+            continue;
+        }
+        if ( !isDirty( page ) )
+        {
+            page++;
+            continue;
+        }
+
+        // Find the end of the run
+        size_t first = page;
+        while ( page < m_numPages && isDirty( page ) )
+        {
+            page++;
+        }
+        if ( !syncPages( first, page - 1, MS_SYNC ) )
+        {
+            result = false;
+            continue;
+        }
+
+        // Mark the run as clean
+        for ( size_t i=first; i < page; i++ )
+        {
+            m_dirty[i / 8] &= (uint8_t) ~(1 << (i % 8));
+        }
+        m_numDirty -= page - first;
+    }
+
+    return result;
+}
+
+bool Api::syncPages( size_t firstPage, size_t lastPage, int flags ) noexcept
+{
+    // msync() requires the start address to be aligned to the OS page size
+    size_t start = firstPage * m_pageSize;
+    size_t end   = (lastPage + 1) * m_pageSize;
+    start       -= start % m_osPageSize;
+    return msync( m_storage + start, end - start, flags ) == 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+size_t Api::getNumPages() const noexcept
+{
+    return m_numPages;
+}
+
+size_t Api::getPageSize() const noexcept
+{
+    return m_pageSize;
+}
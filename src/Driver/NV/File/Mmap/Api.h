@@ -0,0 +1,186 @@
+#ifndef Driver_NV_File_Mmap_Api_h_
+#define Driver_NV_File_Mmap_Api_h_
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+/** @file */
+
+
+#include "colony_config.h"
+#include "Driver/NV/Api.h"
+#include <stdint.h>
+
+
+/// Number of Pages
+#ifndef OPTION_DRIVER_NV_FILE_MMAP_NUM_PAGES
+#define OPTION_DRIVER_NV_FILE_MMAP_NUM_PAGES        512
+#endif
+
+/// Number of bytes per page
+#ifndef OPTION_DRIVER_NV_FILE_MMAP_BYTES_PER_PAGE
+#define OPTION_DRIVER_NV_FILE_MMAP_BYTES_PER_PAGE   128
+#endif
+
+/** The filename to use as the physical storage
+ */
+#ifndef OPTION_DRIVER_NV_FILE_MMAP_FILE_NAME
+#define OPTION_DRIVER_NV_FILE_MMAP_FILE_NAME        "eeprom.bin"
+#endif
+
+/** The value used to erase the physical storage
+ */
+#ifndef OPTION_DRIVER_NV_FILE_MMAP_ERASED_VALUE
+#define OPTION_DRIVER_NV_FILE_MMAP_ERASED_VALUE     0xFF
+#endif
+
+/** The default policy for synchronizing the memory mapped storage with the
+    file.  See Driver::NV::File::Mmap::Api::SyncPolicy_T
+ */
+#ifndef OPTION_DRIVER_NV_FILE_MMAP_SYNC_POLICY
+#define OPTION_DRIVER_NV_FILE_MMAP_SYNC_POLICY      Driver::NV::File::Mmap::Api::eSYNC_DEFERRED
+#endif
+
+///
+namespace Driver {
+///
+namespace NV {
+///
+namespace File {
+///
+namespace Mmap {
+
+
+/** This class implements the Non-volatile storage driver using a POSIX memory
+    mapped file.  The file is mapped once (when the driver is started), i.e.
+    read() and write() are memory copies (vs. the Driver::NV::File::Cpl driver
+    that opens, seeks, and reads/writes the file on every call).  The file
+    format is identical to the Driver::NV::File::Cpl driver, i.e. the drivers
+    can be used interchangeably.
+
+    The driver tracks which NV pages have been modified (a write that does not
+    change the content of a page does not mark the page as dirty).  When the
+    modified pages are flushed to the file is determined by the sync policy:
+
+        eSYNC_IMMEDIATE - Every write() synchronously flushes (msync MS_SYNC)
+                          the pages it modified before it returns.
+        eSYNC_DEFERRED  - Every write() schedules (msync MS_ASYNC) the
+                          write-back of the pages it modified, i.e. the OS
+                          updates the file in the background.  The pages are
+                          synchronously flushed on flush() and stop().
+        eSYNC_ON_STOP   - The pages are only flushed on flush() and stop().
+                          Note: The OS is still free to write back the pages
+                          at any time.
+
+    The interface itself is NOT thread safe. It is the responsibility of
+    the users/clients of the driver to handle any threading issues.
+ */
+class Api : public Driver::NV::Api
+{
+public:
+    /// Sync policies
+    enum SyncPolicy_T
+    {
+        eSYNC_IMMEDIATE,    //!< Synchronous flush on every write
+        eSYNC_DEFERRED,     //!< Asynchronous flush on every write, synchronous flush on flush()/stop()
+        eSYNC_ON_STOP       //!< Synchronous flush only on flush()/stop()
+    };
+
+public:
+    /// Constructor
+    Api( size_t       numPages     = OPTION_DRIVER_NV_FILE_MMAP_NUM_PAGES,
+         size_t       bytesPerPage = OPTION_DRIVER_NV_FILE_MMAP_BYTES_PER_PAGE,
+         const char*  filename     = OPTION_DRIVER_NV_FILE_MMAP_FILE_NAME,
+         SyncPolicy_T syncPolicy   = OPTION_DRIVER_NV_FILE_MMAP_SYNC_POLICY );
+
+    /// Destructor. Stops the driver (if started)
+    ~Api();
+
+public:
+    /// See Driver::NV::Api
+    bool start() noexcept;
+
+    /// See Driver::NV::Api.  Flushes all dirty pages to the file
+    void stop() noexcept;
+
+    /// See Driver::NV::Api
+    bool write( size_t dstOffset, const void* srcData, size_t numBytesToWrite ) noexcept;
+
+    /// See Driver::NV::Api
+    bool read( size_t srcOffset, void* dstData, size_t numBytesToRead ) noexcept;
+
+    /// See Driver::NV::Api
+    size_t getNumPages() const noexcept;
+
+    /// See Driver::NV::Api
+    size_t getPageSize() const noexcept;
+
+public:
+    /** This method synchronously flushes all dirty pages to the file.  The
+        method returns true if successful; else false is returned (the pages
+        remain dirty).
+     */
+    bool flush() noexcept;
+
+    /// Returns the number of NV pages that have not been flushed
+    size_t getNumDirtyPages() const noexcept { return m_numDirty; }
+
+    /// Returns the sync policy
+    SyncPolicy_T getSyncPolicy() const noexcept { return m_syncPolicy; }
+
+protected:
+    /// Helper method: msync's the NV pages [firstPage, lastPage]
+    bool syncPages( size_t firstPage, size_t lastPage, int flags ) noexcept;
+
+    /// Helper method: returns true if the NV page is dirty
+    inline bool isDirty( size_t page ) const noexcept { return (m_dirty[page / 8] & (1 << (page % 8))) != 0; }
+
+protected:
+    /// File name
+    const char*     m_fname;
+
+    /// Memory mapped storage
+    uint8_t*        m_storage;
+
+    /// Dirty page bit array (one bit per NV page)
+    uint8_t*        m_dirty;
+
+    /// number of pages
+    size_t          m_numPages;
+
+    /// bytes per page
+    size_t          m_pageSize;
+
+    /// Actual storage size
+    size_t          m_totalSize;
+
+    /// Number of dirty pages
+    size_t          m_numDirty;
+
+    /// OS page size
+    size_t          m_osPageSize;
+
+    /// File descriptor
+    int             m_fd;
+
+    /// Sync policy
+    SyncPolicy_T    m_syncPolicy;
+
+    /// Started state
+    bool            m_started;
+};
+
+
+
+
+};      // end namespaces
+};
+};
+};
+#endif  // end header latch
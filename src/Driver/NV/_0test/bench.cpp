@@ -0,0 +1,80 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+/** @file */
+
+#include "colony_config.h"
+#include "test.h"
+#include "Cpl/System/Trace.h"
+#include "Cpl/System/ElapsedTime.h"
+#include <memory.h>
+
+#ifndef OPTION_MAX_RECORD_SIZE
+#define OPTION_MAX_RECORD_SIZE      4096
+#endif
+
+///
+using namespace Driver::NV;
+
+
+#define TEST_FAILED     1
+#define TEST_PASSED     0
+
+
+#define SECT_           "_0test"
+
+static uint8_t recordBuffer_[OPTION_MAX_RECORD_SIZE];
+
+
+///////////////////////////////////////////////////////////////////////
+int runbenchmark( Driver::NV::Api& uut,
+                  const char*      label,
+                  size_t           recordSize,
+                  unsigned         numRecords )
+{
+    if ( recordSize > sizeof( recordBuffer_ ) || recordSize > uut.getTotalSize() )
+    {
+        CPL_SYSTEM_TRACE_MSG( SECT_, ("Invalid record size (%lu)", recordSize) );
+        return TEST_FAILED;
+    }
+    size_t numSlots = uut.getTotalSize() / recordSize;
+
+    // Save the records (the content of a record changes on every save)
+    unsigned long startTime = Cpl::System::ElapsedTime::milliseconds();
+    for ( unsigned i=0; i < numRecords; i++ )
+    {
+        memset( recordBuffer_, (int) (i + i / numSlots), recordSize );
+        if ( !uut.write( (i % numSlots) * recordSize, recordBuffer_, recordSize ) )
+        {
+            CPL_SYSTEM_TRACE_MSG( SECT_, ("FAILED to save record %u", i) );
+            return TEST_FAILED;
+        }
+    }
+    unsigned long saveTime = Cpl::System::ElapsedTime::deltaMilliseconds( startTime );
+
+    // Load the records
+    startTime = Cpl::System::ElapsedTime::milliseconds();
+    for ( unsigned i=0; i < numRecords; i++ )
+    {
+        if ( !uut.read( (i % numSlots) * recordSize, recordBuffer_, recordSize ) )
+        {
+            CPL_SYSTEM_TRACE_MSG( SECT_, ("FAILED to load record %u", i) );
+            return TEST_FAILED;
+        }
+    }
+    unsigned long loadTime = Cpl::System::ElapsedTime::deltaMilliseconds( startTime );
+
+    CPL_SYSTEM_TRACE_MSG( SECT_, ("%-20s record=%4lu bytes: save=%7lu records/sec, load=%8lu records/sec",
+                                   label,
+                                   recordSize,
+                                   (unsigned long) (numRecords * 1000ULL / (saveTime ? saveTime : 1)),
+                                   (unsigned long) (numRecords * 1000ULL / (loadTime ? loadTime : 1))) );
+    return TEST_PASSED;
+}
@@ -20,5 +20,15 @@ int runtests( Driver::NV::Api& uut,
               size_t           expectedBytesPerPage,
               size_t           expectedTotalSize );
 
+/** Measures the record save (write) and load (read) throughput of the driver.
+    Records of 'recordSize' bytes are written to (and read back from)
+    consecutive offsets in the storage. Returns zero if all of the operations
+    succeeded.
+ */
+int runbenchmark( Driver::NV::Api& uut,
+                  const char*      label,
+                  size_t           recordSize,
+                  unsigned         numRecords );
+
 
 #endif  // end header latch
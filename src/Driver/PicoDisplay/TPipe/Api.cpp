@@ -16,6 +16,8 @@
 #include "Cpl/Dm/PeriodicScheduler.h"
 #include "Driver/Button/TPipe/Hal.h"
 #include "Driver/LED/TPipe/RedGreenBlue.h"
+#include "Cpl/Text/Encoding/Base64.h"
+#include "DirtyRects.h"
 
 
 static Cpl::Container::Map<Driver::TPipe::RxFrameHandlerApi> frameHandlers_( "ignoreThisParameter_usedToSelecStaticContructor" );
@@ -105,10 +107,23 @@ void Driver::PicoDisplay::Api::setLCDBrightness( uint8_t value )
 
 static Cpl::Text::FString<TPIPE_WORK_BUF_SIZE> buffer_;
 static uint8_t                                 frameCache_[NUM_DISPLAY_BYTES];
+
+#ifndef USE_DRIVER_PICO_DISPLAY_TPIPE_COMPACT_LCD_DATA
 static uint8_t*                                nextFrameCacheByte_;
 static unsigned                                rowIndex_;
 static bool                                    dirty_;
 
+#else
+#define COMPACT_WORK_BUF_SIZE     DRIVER_PICO_DISPLAY_TPIPE_MAX_ENCODED_SIZE( OPTION_DRIVER_PICO_DISPLAY_LCD_WIDTH, OPTION_DRIVER_PICO_DISPLAY_LCD_HEIGHT )
+
+static_assert( ( COMPACT_WORK_BUF_SIZE * 4 ) / 3 + 128 < TPIPE_WORK_BUF_SIZE, "The TPipe work buffer is too small for a Base64 encoded worst case LCD update" );
+
+static uint8_t                                 compactBuf_[COMPACT_WORK_BUF_SIZE];
+static uint16_t                                dirtyX0_[OPTION_DRIVER_PICO_DISPLAY_LCD_HEIGHT];
+static uint16_t                                dirtyX1_[OPTION_DRIVER_PICO_DISPLAY_LCD_HEIGHT];
+static Driver::PicoDisplay::TPipe::DirtyRects  dirtyRects_( frameCache_, dirtyX0_, dirtyX1_, OPTION_DRIVER_PICO_DISPLAY_LCD_WIDTH, OPTION_DRIVER_PICO_DISPLAY_LCD_HEIGHT );
+#endif
+
 void Driver::PicoDisplay::Api::nop()
 {
     // Update Elapsed time
@@ -120,6 +135,7 @@ void Driver::PicoDisplay::Api::nop()
 }
 
 
+#ifndef USE_DRIVER_PICO_DISPLAY_TPIPE_COMPACT_LCD_DATA
 static void beginLCDData()
 {
     nextFrameCacheByte_ = frameCache_;
@@ -167,6 +183,42 @@ static void appendLCDRowData( const void* data, size_t len )
     rowIndex_++;
 }
 
+#else
+static void beginLCDData()
+{
+    dirtyRects_.beginFrame();
+}
+
+static void endLCDData()
+{
+    if ( !dirtyRects_.isDirty() )
+    {
+        return;
+    }
+
+    // Send all of the rectangles - and the update request - as a single TPipe command
+    unsigned numRects;
+    size_t   numBytes = dirtyRects_.encode( compactBuf_, numRects );
+    buffer_ = OPTION_DRIVER_PICO_DISPLAY_TPIP_FRAME_SOF;
+    formatMsecTimeStamp( buffer_, Cpl::System::ElapsedTime::precision().asFlatTime(), true, true );
+    buffer_.formatAppend( " writeLCDRects %u %u ", numRects, (unsigned) numBytes );
+    int    maxLen;
+    int    len    = buffer_.length();
+    char*  dstStr = buffer_.getBuffer( maxLen );
+    size_t encodedLen;
+    if ( Cpl::Text::Encoding::base64Encode( compactBuf_, numBytes, dstStr + len, maxLen + 1 - len, encodedLen ) )
+    {
+        buffer_ += OPTION_DRIVER_PICO_DISPLAY_TPIP_FRAME_EOF;
+        tpipe_.getPipeProcessor().sendRawCommand( buffer_.getString(), buffer_.length() );
+    }
+}
+
+static void appendLCDRowData( const void* data, size_t len )
+{
+    dirtyRects_.appendRow( data, len );
+}
+#endif
+
 void Driver::PicoDisplay::Api::updateLCD( pimoroni::PicoGraphics& graphics )
 {
     beginLCDData();
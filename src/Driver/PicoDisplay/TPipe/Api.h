@@ -47,6 +47,33 @@
          
     NOTE: The simulator makes a copy of the 'screen buffer' and ONLY sends 'deltas' to the simulated
           display.  This has significant positive impact on the performance of 'display' on the simulator
+
+
+    Compact LCD Data (USE_DRIVER_PICO_DISPLAY_TPIPE_COMPACT_LCD_DATA is defined)
+    ----------------------------------------------------------------------------
+    All of the changes for a single updateLCD() call are sent as ONE command
+    containing run length encoded 'dirty rectangles', i.e. the writeLCDData
+    and updateLCD commands are NOT used.  Requires a simulator that supports
+    the writeLCDRects command.
+
+    <DD> <HH:MM:SS.sss> writeLCDRects <n> <len> <b64data>
+    Where:
+         <DD>                is CPU time since power-up/reset:  Format is: DD HH:MM:SS.sss
+         <HH:MM:SS.sss>      is CPU time since power-up/reset:  Format is: DD HH:MM:SS.sss
+         <n>                 Number of rectangles
+         <len>               Number of bytes of binary data (after Base64 decoding)
+         <b64data>           Binary data encoded as a Base64 string (standard alphabet, with padding).
+                             The binary data is <n> rectangles, each rectangle is:
+                                 <x0> <w> <y0> <h>   uint16_t values, little endian ordering
+                                 <rle>               Run length encoded pixels (same pixel layout as
+                                                     writeLCDData). The <rle> data is a sequence of
+                                                     a control byte <c> followed by:
+                                                        c=0x00-0x7F:  (c+1) literal pixel bytes
+                                                        c=0x80-0xFF:  one pixel byte that is repeated
+                                                                      (c-0x80+3) times
+                                                     Note: runs/literals can span rows
+
+    NOTE: The simulator updates the visible screen after all of the rectangles have been written
  
     \endcode
  */
@@ -0,0 +1,181 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+/** @file */
+
+#include "DirtyRects.h"
+#include <string.h>
+
+using namespace Driver::PicoDisplay::TPipe;
+
+#define RLE_MAX_LITERAL     DRIVER_PICO_DISPLAY_TPIPE_RLE_MAX_LITERAL
+#define RLE_MIN_RUN         DRIVER_PICO_DISPLAY_TPIPE_RLE_MIN_RUN
+#define RLE_MAX_RUN         DRIVER_PICO_DISPLAY_TPIPE_RLE_MAX_RUN
+
+
+//////////////////////////////////////////////////
+DirtyRects::DirtyRects( uint8_t* frameCache, uint16_t* dirtyX0, uint16_t* dirtyX1, unsigned width, unsigned height ) noexcept
+    : m_frameCache( frameCache )
+    , m_dirtyX0( dirtyX0 )
+    , m_dirtyX1( dirtyX1 )
+    , m_nextRowPtr( frameCache )
+    , m_width( width )
+    , m_height( height )
+    , m_rowIndex( 0 )
+    , m_dirty( false )
+{
+}
+
+void DirtyRects::beginFrame() noexcept
+{
+    m_nextRowPtr = m_frameCache;
+    m_rowIndex   = 0;
+    m_dirty      = false;
+}
+
+void DirtyRects::appendRow( const void* rowData, size_t len ) noexcept
+{
+    // Capture the changed span of the row
+    const uint8_t* srcPtr = (const uint8_t*) rowData;
+    unsigned       x0     = 0;
+    unsigned       x1     = len;
+    while ( x0 < len && m_nextRowPtr[x0] == srcPtr[x0] )
+    {
+        x0++;
+    }
+    if ( x0 < len )
+    {
+        while ( m_nextRowPtr[x1 - 1] == srcPtr[x1 - 1] )
+        {
+            x1--;
+        }
+        memcpy( m_nextRowPtr + x0, srcPtr + x0, x1 - x0 );
+        m_dirtyX0[m_rowIndex] = x0;
+        m_dirtyX1[m_rowIndex] = x1;
+        m_dirty               = true;
+    }
+    else
+    {
+        m_dirtyX1[m_rowIndex] = 0;
+    }
+
+    m_nextRowPtr += len;
+    m_rowIndex++;
+}
+
+size_t DirtyRects::encode( uint8_t* dst, unsigned& numRects ) noexcept
+{
+    // Coalesce consecutive dirty rows into rectangles
+    uint8_t* dstPtr = dst;
+    unsigned row    = 0;
+    numRects        = 0;
+    while ( m_dirty && row < m_height )
+    {
+        if ( m_dirtyX1[row] == 0 )
+        {
+            row++;
+            continue;
+        }
+
+        unsigned y0 = row;
+        unsigned x0 = m_dirtyX0[row];
+        unsigned x1 = m_dirtyX1[row];
+        while ( ++row < m_height && m_dirtyX1[row] != 0 )
+        {
+            x0 = m_dirtyX0[row] < x0 ? m_dirtyX0[row] : x0;
+            x1 = m_dirtyX1[row] > x1 ? m_dirtyX1[row] : x1;
+        }
+        dstPtr = appendRect( dstPtr, x0, x1 - x0, y0, row - y0 );
+        numRects++;
+    }
+
+    return dstPtr - dst;
+}
+
+static uint8_t* appendUint16( uint8_t* dstPtr, unsigned value )
+{
+    *dstPtr++ = (uint8_t) value;
+    *dstPtr++ = (uint8_t) ( value >> 8 );
+    return dstPtr;
+}
+
+uint8_t* DirtyRects::appendRect( uint8_t* dstPtr, unsigned x0, unsigned w, unsigned y0, unsigned h ) noexcept
+{
+    dstPtr = appendUint16( dstPtr, x0 );
+    dstPtr = appendUint16( dstPtr, w );
+    dstPtr = appendUint16( dstPtr, y0 );
+    dstPtr = appendUint16( dstPtr, h );
+
+    // Note: Runs/literals can span rows, i.e. the rectangle's pixels are treated as single stream
+    uint8_t* literalPtr = 0;    // Control byte of the literal sequence in progress
+    unsigned remaining  = w * h;
+    unsigned col        = 0;
+    uint8_t* srcPtr     = m_frameCache + y0 * m_width + x0;
+    while ( remaining )
+    {
+        // Measure the run at the current pixel
+        uint8_t  pixel  = *srcPtr;
+        unsigned runLen = 1;
+        uint8_t* runPtr = srcPtr;
+        unsigned runCol = col;
+        while ( runLen < remaining && runLen < RLE_MAX_RUN )
+        {
+            if ( ++runCol == w )
+            {
+                runCol  = 0;
+                runPtr += m_width - w;
+            }
+            if ( *( ++runPtr ) != pixel )
+            {
+                break;
+            }
+            runLen++;
+        }
+
+        // Emit a run
+        unsigned consumed = 1;
+        if ( runLen >= RLE_MIN_RUN )
+        {
+            *dstPtr++  = (uint8_t) ( 0x80 + runLen - RLE_MIN_RUN );
+            *dstPtr++  = pixel;
+            literalPtr = 0;
+            consumed   = runLen;
+        }
+
+        // Add the pixel to the current literal sequence
+        else
+        {
+            if ( literalPtr == 0 || *literalPtr == RLE_MAX_LITERAL - 1 )
+            {
+                literalPtr  = dstPtr++;
+                *literalPtr = 0;
+            }
+            else
+            {
+                ( *literalPtr )++;
+            }
+            *dstPtr++ = pixel;
+        }
+
+        // Advance to the next un-encoded pixel
+        remaining -= consumed;
+        while ( consumed-- )
+        {
+            if ( ++col == w )
+            {
+                col     = 0;
+                srcPtr += m_width - w;
+            }
+            srcPtr++;
+        }
+    }
+
+    return dstPtr;
+}
@@ -0,0 +1,117 @@
+#ifndef Driver_PicoDisplay_TPipe_DirtyRects_h_
+#define Driver_PicoDisplay_TPipe_DirtyRects_h_
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+/** @file */
+
+#include <stdint.h>
+#include <stdlib.h>
+
+
+/// Size, in bytes, of a rectangle header: x0, w, y0, h as uint16_t, little endian
+#define DRIVER_PICO_DISPLAY_TPIPE_RECT_HEADER_SIZE      8
+
+/// Maximum number of literal bytes per control byte (control byte: 0x00-0x7F -->(n+1) literal bytes follow)
+#define DRIVER_PICO_DISPLAY_TPIPE_RLE_MAX_LITERAL       128
+
+/// Minimum length of a run (control byte: 0x80-0xFF -->next byte is repeated (n-0x80+3) times)
+#define DRIVER_PICO_DISPLAY_TPIPE_RLE_MIN_RUN           3
+
+/// Maximum length of a run
+#define DRIVER_PICO_DISPLAY_TPIPE_RLE_MAX_RUN           (0x7F + DRIVER_PICO_DISPLAY_TPIPE_RLE_MIN_RUN)
+
+/// Worst case size, in bytes, of the encoded changes for a display of 'w' x 'h' pixels
+#define DRIVER_PICO_DISPLAY_TPIPE_MAX_ENCODED_SIZE(w,h) ((w)*(h) + ((w)*(h) + DRIVER_PICO_DISPLAY_TPIPE_RLE_MAX_LITERAL - 1) / DRIVER_PICO_DISPLAY_TPIPE_RLE_MAX_LITERAL + DRIVER_PICO_DISPLAY_TPIPE_RECT_HEADER_SIZE * (h))
+
+
+///
+namespace Driver {
+///
+namespace PicoDisplay {
+///
+namespace TPipe {
+
+
+/** This class tracks the changed pixels of a RGB332 frame buffer - that is
+    provided one row at a time - and encodes the changes as run length encoded
+    'dirty rectangles'.  Consecutive changed rows are coalesced into a single
+    rectangle.  See the writeLCDRects command in Driver/PicoDisplay/TPipe/Api.h
+    for the encoding.
+
+    The class does not allocate memory, i.e. the caller provides the frame
+    cache (width * height bytes) and the per-row dirty spans (height entries
+    each).
+
+    The class is NOT thread safe.
+ */
+class DirtyRects
+{
+public:
+    /// Constructor
+    DirtyRects( uint8_t* frameCache, uint16_t* dirtyX0, uint16_t* dirtyX1, unsigned width, unsigned height ) noexcept;
+
+public:
+    /// This method is called at the start of each frame
+    void beginFrame() noexcept;
+
+    /** This method is called for each row - in order, starting with the top
+        row - of the frame.  The new row data is compared against (and then
+        copied to) the frame cache.  'len' must be the display width.
+     */
+    void appendRow( const void* rowData, size_t len ) noexcept;
+
+    /// Returns true if at least one pixel changed in the current frame
+    bool isDirty() const noexcept { return m_dirty; }
+
+    /** This method encodes the changes for the current frame into 'dst'.
+        'dst' must be at least DRIVER_PICO_DISPLAY_TPIPE_MAX_ENCODED_SIZE(width,height)
+        bytes.  The number of rectangles is returned via 'numRects'.  The method
+        returns the number of encoded bytes.
+     */
+    size_t encode( uint8_t* dst, unsigned& numRects ) noexcept;
+
+protected:
+    /// Helper method that run-length encodes a rectangle from the frame cache
+    uint8_t* appendRect( uint8_t* dstPtr, unsigned x0, unsigned w, unsigned y0, unsigned h ) noexcept;
+
+protected:
+    /// Copy of the pixels that have been sent
+    uint8_t*        m_frameCache;
+
+    /// First dirty column in a row
+    uint16_t*       m_dirtyX0;
+
+    /// One past the last dirty column in a row (0 when the row is clean)
+    uint16_t*       m_dirtyX1;
+
+    /// Next row in the frame cache
+    uint8_t*        m_nextRowPtr;
+
+    /// Display width, in pixels
+    unsigned        m_width;
+
+    /// Display height, in pixels
+    unsigned        m_height;
+
+    /// Index of the next row
+    unsigned        m_rowIndex;
+
+    /// At least one pixel changed in the current frame
+    bool            m_dirty;
+};
+
+
+} // End namespace(s)
+}
+}
+
+
+#endif // end header latch
@@ -0,0 +1,250 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+
+#include "Catch/catch.hpp"
+#include "Cpl/System/_testsupport/Shutdown_TS.h"
+#include "Cpl/System/Trace.h"
+#include "Driver/PicoDisplay/TPipe/DirtyRects.h"
+#include "Cpl/Text/Encoding/Base64.h"
+#include <string.h>
+#include <stdlib.h>
+
+using namespace Driver::PicoDisplay::TPipe;
+
+#define SECT_       "_0test"
+
+// Default PicoDisplay LCD size
+#define WIDTH_      240
+#define HEIGHT_     135
+#define NUM_PIXELS_ (WIDTH_*HEIGHT_)
+#define MAX_BYTES_  DRIVER_PICO_DISPLAY_TPIPE_MAX_ENCODED_SIZE(WIDTH_,HEIGHT_)
+
+static uint8_t  frameCache_[NUM_PIXELS_];
+static uint16_t dirtyX0_[HEIGHT_];
+static uint16_t dirtyX1_[HEIGHT_];
+static uint8_t  frame_[NUM_PIXELS_];        // The application's frame buffer
+static uint8_t  host_[NUM_PIXELS_];         // The host's (i.e. the simulator's) copy of the display
+static uint8_t  encoded_[MAX_BYTES_];
+static uint8_t  decoded_[MAX_BYTES_];
+static char     text_[( MAX_BYTES_ * 4 ) / 3 + 4];
+
+/// Decodes the rectangles the same way as the simulator's writeLCDRects command. Returns the number of bytes consumed (zero on error)
+static size_t decodeRects( const uint8_t* data, size_t numBytes, unsigned numRects )
+{
+    size_t dataIndex = 0;
+    for ( unsigned r = 0; r < numRects; r++ )
+    {
+        if ( dataIndex + DRIVER_PICO_DISPLAY_TPIPE_RECT_HEADER_SIZE > numBytes )
+        {
+            return 0;
+        }
+        unsigned x = data[dataIndex] + ( data[dataIndex + 1] << 8 );
+        unsigned w = data[dataIndex + 2] + ( data[dataIndex + 3] << 8 );
+        unsigned y = data[dataIndex + 4] + ( data[dataIndex + 5] << 8 );
+        unsigned h = data[dataIndex + 6] + ( data[dataIndex + 7] << 8 );
+        dataIndex += DRIVER_PICO_DISPLAY_TPIPE_RECT_HEADER_SIZE;
+        if ( w == 0 || h == 0 || x + w > WIDTH_ || y + h > HEIGHT_ )
+        {
+            return 0;
+        }
+
+        unsigned numPixels  = w * h;
+        unsigned pixelIndex = 0;
+        while ( pixelIndex < numPixels )
+        {
+            unsigned control = data[dataIndex++];
+            unsigned count   = control < 0x80 ? control + 1 : control - 0x80 + 3;
+            size_t   needed  = control < 0x80 ? count : 1;
+            if ( pixelIndex + count > numPixels || dataIndex + needed > numBytes )
+            {
+                return 0;
+            }
+
+            if ( control < 0x80 )
+            {
+                for ( unsigned i = 0; i <= control; i++, pixelIndex++ )
+                {
+                    host_[( y + pixelIndex / w ) * WIDTH_ + x + pixelIndex % w] = data[dataIndex++];
+                }
+            }
+            else
+            {
+                uint8_t pixel = data[dataIndex++];
+                for ( unsigned i = 0; i < control - 0x80 + 3; i++, pixelIndex++ )
+                {
+                    host_[( y + pixelIndex / w ) * WIDTH_ + x + pixelIndex % w] = pixel;
+                }
+            }
+        }
+    }
+
+    return dataIndex;
+}
+
+/// Sends the current frame through the encoder, the Base64 encoding/decoding, and the decoder. Returns the number of encoded bytes
+static size_t roundTrip( DirtyRects& uut, unsigned& numRects )
+{
+    uut.beginFrame();
+    for ( unsigned row=0; row < HEIGHT_; row++ )
+    {
+        uut.appendRow( frame_ + row * WIDTH_, WIDTH_ );
+    }
+
+    numRects = 0;
+    if ( !uut.isDirty() )
+    {
+        REQUIRE( memcmp( host_, frame_, sizeof( frame_ ) ) == 0 );
+        return 0;
+    }
+
+    size_t numBytes = uut.encode( encoded_, numRects );
+    REQUIRE( numBytes <= MAX_BYTES_ );
+    REQUIRE( numRects > 0 );
+
+    size_t textLen;
+    REQUIRE( Cpl::Text::Encoding::base64Encode( encoded_, numBytes, text_, sizeof( text_ ), textLen ) );
+    REQUIRE( textLen == ( ( numBytes + 2 ) / 3 ) * 4 );
+    size_t binLen;
+    REQUIRE( Cpl::Text::Encoding::base64Decode( text_, textLen, decoded_, sizeof( decoded_ ), binLen ) );
+    REQUIRE( binLen == numBytes );
+    REQUIRE( memcmp( decoded_, encoded_, numBytes ) == 0 );
+
+    REQUIRE( decodeRects( decoded_, binLen, numRects ) == numBytes );
+    REQUIRE( memcmp( host_, frame_, sizeof( frame_ ) ) == 0 );
+    REQUIRE( memcmp( frameCache_, frame_, sizeof( frame_ ) ) == 0 );
+    return numBytes;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_CASE( "dirtyrects" )
+{
+    Cpl::System::Shutdown_TS::clearAndUseCounter();
+    memset( frameCache_, 0, sizeof( frameCache_ ) );
+    memset( frame_, 0, sizeof( frame_ ) );
+    memset( host_, 0, sizeof( host_ ) );
+    DirtyRects uut( frameCache_, dirtyX0_, dirtyX1_, WIDTH_, HEIGHT_ );
+    unsigned   numRects;
+
+    SECTION( "no changes" )
+    {
+        REQUIRE( roundTrip( uut, numRects ) == 0 );
+        REQUIRE( uut.isDirty() == false );
+        REQUIRE( uut.encode( encoded_, numRects ) == 0 );
+        REQUIRE( numRects == 0 );
+    }
+
+    SECTION( "full screen" )
+    {
+        // Solid color: every run is limited to the maximum run length
+        memset( frame_, 0x5A, sizeof( frame_ ) );
+        size_t numBytes = roundTrip( uut, numRects );
+        REQUIRE( numRects == 1 );
+        unsigned numRuns = ( NUM_PIXELS_ + DRIVER_PICO_DISPLAY_TPIPE_RLE_MAX_RUN - 1 ) / DRIVER_PICO_DISPLAY_TPIPE_RLE_MAX_RUN;
+        REQUIRE( numBytes == DRIVER_PICO_DISPLAY_TPIPE_RECT_HEADER_SIZE + numRuns * 2 );
+        REQUIRE( encoded_[0] == 0 );
+        REQUIRE( encoded_[2] == ( WIDTH_ & 0xFF ) );
+        REQUIRE( encoded_[3] == ( WIDTH_ >> 8 ) );
+        REQUIRE( encoded_[4] == 0 );
+        REQUIRE( encoded_[6] == HEIGHT_ );
+        REQUIRE( encoded_[8] == 0xFF );
+
+        // No runs: worst case encoding
+        for ( unsigned i=0; i < NUM_PIXELS_; i++ )
+        {
+            frame_[i] = (uint8_t) ( i & 1 ? 0x11 : 0x22 );
+        }
+        numBytes = roundTrip( uut, numRects );
+        REQUIRE( numRects == 1 );
+        unsigned numLiterals = ( NUM_PIXELS_ + DRIVER_PICO_DISPLAY_TPIPE_RLE_MAX_LITERAL - 1 ) / DRIVER_PICO_DISPLAY_TPIPE_RLE_MAX_LITERAL;
+        REQUIRE( numBytes == DRIVER_PICO_DISPLAY_TPIPE_RECT_HEADER_SIZE + NUM_PIXELS_ + numLiterals );
+        CPL_SYSTEM_TRACE_MSG( SECT_, ( "full screen, worst case: %u bytes (max=%u)", (unsigned) numBytes, (unsigned) MAX_BYTES_ ) );
+    }
+
+    SECTION( "run length limits" )
+    {
+        // Runs that are one/two/three pixels longer than the maximum run length - and that span rows
+        unsigned lengths[] ={ DRIVER_PICO_DISPLAY_TPIPE_RLE_MAX_RUN - 1,
+                              DRIVER_PICO_DISPLAY_TPIPE_RLE_MAX_RUN,
+                              DRIVER_PICO_DISPLAY_TPIPE_RLE_MAX_RUN + 1,
+                              DRIVER_PICO_DISPLAY_TPIPE_RLE_MAX_RUN + 2,
+                              DRIVER_PICO_DISPLAY_TPIPE_RLE_MAX_RUN + 3,
+                              2 * DRIVER_PICO_DISPLAY_TPIPE_RLE_MAX_RUN + 1,
+                              WIDTH_ + 1 };
+        for ( unsigned i=0; i < sizeof( lengths ) / sizeof( lengths[0] ); i++ )
+        {
+            unsigned start = 3 * WIDTH_ + 7 * i;
+            memset( frame_ + start, 0x40 + i, lengths[i] );
+            roundTrip( uut, numRects );
+            REQUIRE( numRects == 1 );
+        }
+
+        // Literal sequences that are longer than the maximum literal length
+        for ( unsigned i=0; i < 2 * WIDTH_; i++ )
+        {
+            frame_[10 * WIDTH_ + 5 + i] = (uint8_t) i;
+        }
+        roundTrip( uut, numRects );
+        REQUIRE( numRects == 1 );
+    }
+
+    SECTION( "partial base64 group" )
+    {
+        // A single changed pixel: 8 byte header + 1 control byte + 1 pixel -->10 bytes (10 % 3 == 1)
+        frame_[5 * WIDTH_ + 9] = 0x33;
+        REQUIRE( roundTrip( uut, numRects ) == 10 );
+        REQUIRE( numRects == 1 );
+
+        // Two separate rectangles, each with two literal pixels -->2 * (8 + 1 + 2) = 22 bytes (22 % 3 == 1)
+        frame_[5 * WIDTH_ + 9]   = 0;
+        frame_[5 * WIDTH_ + 10]  = 0x44;
+        frame_[50 * WIDTH_ + 1]  = 0x55;
+        frame_[50 * WIDTH_ + 2]  = 0x66;
+        REQUIRE( roundTrip( uut, numRects ) == 22 );
+        REQUIRE( numRects == 2 );
+
+        // A 3x2 rectangle: a run of 3 pixels + 3 literal pixels -->8 + 2 + 1 + 3 = 14 bytes (14 % 3 == 2)
+        memset( frame_ + 100 * WIDTH_ + 20, 0x77, 3 );
+        frame_[101 * WIDTH_ + 20] = 0x78;
+        frame_[101 * WIDTH_ + 22] = 0x79;
+        REQUIRE( roundTrip( uut, numRects ) == 14 );
+        REQUIRE( numRects == 1 );
+    }
+
+    SECTION( "random frames" )
+    {
+        srand( 42 );
+        for ( unsigned frame=0; frame < 50; frame++ )
+        {
+            // Random filled rectangles (i.e. long runs) and random noise (i.e. literals)
+            unsigned numChanges = rand() % 8;
+            for ( unsigned i=0; i < numChanges; i++ )
+            {
+                unsigned x0    = rand() % WIDTH_;
+                unsigned y0    = rand() % HEIGHT_;
+                unsigned w     = 1 + rand() % ( WIDTH_ - x0 );
+                unsigned h     = 1 + rand() % ( HEIGHT_ - y0 );
+                uint8_t  color = (uint8_t) rand();
+                bool     noise = rand() % 3 == 0;
+                for ( unsigned y=y0; y < y0 + h; y++ )
+                {
+                    for ( unsigned x=x0; x < x0 + w; x++ )
+                    {
+                        frame_[y * WIDTH_ + x] = noise ? (uint8_t) rand() % 4 : color;
+                    }
+                }
+            }
+            roundTrip( uut, numRects );
+        }
+    }
+
+    REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 0u );
+}
@@ -20,32 +20,8 @@ Maker::Maker( Cpl::Container::Map<RxFrameHandlerApi>& frameHandlerList,
               char                                    startOfFrame,
               char                                    endOfFrame,
               char                                    escapeChar )
-    : StreamDecoder( m_workBuffer, OPTION_DRIVER_TPIPE_RAW_INPUT_SIZE, nullptr, false )
+    : FastStreamDecoder( m_workBuffer, OPTION_DRIVER_TPIPE_RAW_INPUT_SIZE, startOfFrame, endOfFrame, escapeChar, eNON_NULL_CHARS, nullptr, false )
     , m_framer( nullptr, startOfFrame, endOfFrame, escapeChar, false )
     , m_processor( frameHandlerList, *this, m_framer, maxRxFrameSize, verbDelimiters )
-    , m_sof( startOfFrame )
-    , m_eof( endOfFrame )
-    , m_esc( escapeChar )
 {
 }
-
-////////////////////////////////////////////
-bool Maker::isStartOfFrame() noexcept
-{
-    return *m_dataPtr == m_sof;
-}
-
-bool Maker::isEofOfFrame() noexcept
-{
-    return *m_dataPtr == m_eof;
-}
-
-bool Maker::isEscapeChar() noexcept
-{
-    return *m_dataPtr == m_esc;
-}
-
-bool Maker::isLegalCharacter() noexcept
-{
-    return *m_dataPtr != '\0';
-}
@@ -14,6 +14,7 @@
 
 #include "colony_config.h"
 #include "Driver/TPipe/Pipe.h"
+#include "Cpl/Text/Frame/FastStreamDecoder.h"
 
 
 /** The size, in bytes, of the work buffer used to read from the input stream.
@@ -30,9 +31,11 @@ namespace TPipe {
 
 
 /** This concrete class is a "Maker" that assembles the objects needed
-    for TPipe.
+    for TPipe.  The incoming frames are decoded using the bulk scanning
+    Cpl::Text::Frame::FastStreamDecoder (all non-null characters are legal
+    within a frame).
  */
-class Maker : public Cpl::Text::Frame::StreamDecoder
+class Maker : public Cpl::Text::Frame::FastStreamDecoder
 {
 public:
     /** Constructor.  
@@ -63,20 +66,6 @@ public:
     /// Cast-operator: Short-hand for getPipeProcessor()
     operator Pipe& () { return m_processor; }
 
-protected:
-    /// See Cpl::Text::Frame::Decoder_
-    bool isStartOfFrame() noexcept;
-
-    /// See Cpl::Text::Frame::Decoder_
-    bool isEofOfFrame() noexcept;
-
-    /// See Cpl::Text::Frame::Decoder_
-    bool isEscapeChar() noexcept;
-
-    /// See Cpl::Text::Frame::Decoder_
-    bool isLegalCharacter() noexcept;
-
-
 protected:
     /// Framer for the output
     Cpl::Text::Frame::StreamEncoder m_framer;
@@ -86,15 +75,6 @@ protected:
 
     /// Work buffer for raw incoming data (is not a null terminated string)
     char                            m_workBuffer[OPTION_DRIVER_TPIPE_RAW_INPUT_SIZE];
-
-    /// SOF character
-    const char                      m_sof;
-
-    /// EOF character
-    const char                      m_eof;
-
-    /// Escape character
-    const char                      m_esc;
 };
 
 
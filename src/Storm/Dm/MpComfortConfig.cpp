@@ -52,7 +52,7 @@ void MpComfortConfig::hookSetInvalid() noexcept
 
 uint16_t MpComfortConfig::writeCompressorCooling( const Storm::Type::ComfortStageParameters_T newParameters, LockRequest_T lockRequest ) noexcept
 {
-    m_modelDatabase.lock_();
+    lock_();
 
     Storm::Type::ComfortConfig_T          src    = m_data;
     Storm::Type::ComfortStageParameters_T newVal = newParameters;
@@ -60,13 +60,13 @@ uint16_t MpComfortConfig::writeCompressorCooling( const Storm::Type::ComfortStag
     src.compressorCooling = newVal;
     uint16_t result       = write( src, lockRequest );
 
-    m_modelDatabase.unlock_();
+    unlock_();
     return result;
 }
 
 uint16_t MpComfortConfig::writeCompressorHeating( const Storm::Type::ComfortStageParameters_T newParameters, LockRequest_T lockRequest ) noexcept
 {
-    m_modelDatabase.lock_();
+    lock_();
 
     Storm::Type::ComfortConfig_T          src    = m_data;
     Storm::Type::ComfortStageParameters_T newVal = newParameters;
@@ -74,13 +74,13 @@ uint16_t MpComfortConfig::writeCompressorHeating( const Storm::Type::ComfortStag
     src.compressorHeating = newVal;
     uint16_t result       = write( src, lockRequest );
     
-    m_modelDatabase.unlock_();
+    unlock_();
     return result;
 }
 
 uint16_t MpComfortConfig::writeIndoorHeating( const Storm::Type::ComfortStageParameters_T newParameters, LockRequest_T lockRequest ) noexcept
 {
-    m_modelDatabase.lock_();
+    lock_();
 
     Storm::Type::ComfortConfig_T          src    = m_data;
     Storm::Type::ComfortStageParameters_T newVal = newParameters;
@@ -88,7 +88,7 @@ uint16_t MpComfortConfig::writeIndoorHeating( const Storm::Type::ComfortStagePar
     src.indoorHeating = newVal;
     uint16_t result   = write( src, lockRequest );
 
-    m_modelDatabase.unlock_();
+    unlock_();
     return result;
 }
 
@@ -33,13 +33,13 @@ MpCycleInfo::MpCycleInfo( Cpl::Dm::ModelDatabase& myModelBase, const char* symbo
 uint16_t MpCycleInfo::setOnTime( uint32_t newOnCycleTime, LockRequest_T lockRequest ) noexcept
 {
     Storm::Type::CycleInfo_T newData;
-    m_modelDatabase.lock_();
+    lock_();
 
     newData          = m_data;
     newData.onTime   = newOnCycleTime;
 
     uint16_t result = writeData( &newData, sizeof( Storm::Type::CycleInfo_T ), lockRequest );
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
@@ -47,39 +47,39 @@ uint16_t MpCycleInfo::setOnTime( uint32_t newOnCycleTime, LockRequest_T lockRequ
 uint16_t MpCycleInfo::setOffTime( uint32_t newOffCycleTime, LockRequest_T lockRequest ) noexcept
 {
     Storm::Type::CycleInfo_T newData;
-    m_modelDatabase.lock_();
+    lock_();
 
     newData          = m_data;
     newData.offTime  = newOffCycleTime;
 
     uint16_t result = writeData( &newData, sizeof( Storm::Type::CycleInfo_T ), lockRequest );
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
 uint16_t MpCycleInfo::setBeginOnTime( Cpl::System::ElapsedTime::Precision_T newBeginOnCycleTime, LockRequest_T lockRequest ) noexcept
 {
     Storm::Type::CycleInfo_T newData;
-    m_modelDatabase.lock_();
+    lock_();
 
     newData             = m_data;
     newData.beginOnTime = newBeginOnCycleTime;
 
     uint16_t result = writeData( &newData, sizeof( Storm::Type::CycleInfo_T ), lockRequest );
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
 uint16_t MpCycleInfo::setBeginOffTime( Cpl::System::ElapsedTime::Precision_T newBeginOffCycleTime, LockRequest_T lockRequest ) noexcept
 {
     Storm::Type::CycleInfo_T newData;
-    m_modelDatabase.lock_();
+    lock_();
 
     newData              = m_data;
     newData.beginOffTime = newBeginOffCycleTime;
 
     uint16_t result = writeData( &newData, sizeof( Storm::Type::CycleInfo_T ), lockRequest );
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
@@ -87,13 +87,13 @@ uint16_t MpCycleInfo::setBeginOffTime( Cpl::System::ElapsedTime::Precision_T new
 uint16_t MpCycleInfo::setMode( Storm::Type::CycleStatus newMode, LockRequest_T lockRequest ) noexcept
 {
     Storm::Type::CycleInfo_T newData;
-    m_modelDatabase.lock_();
+    lock_();
 
     newData      = m_data;
     newData.mode = newMode;
 
     uint16_t result = writeData( &newData, sizeof( Storm::Type::CycleInfo_T ), lockRequest );
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
@@ -32,26 +32,26 @@ MpEquipmentBeginTimes::MpEquipmentBeginTimes( Cpl::Dm::ModelDatabase& myModelBas
 uint16_t MpEquipmentBeginTimes::setIndoorUnitBeginOnTime( Cpl::System::ElapsedTime::Precision_T newBeginOnCycleTime, LockRequest_T lockRequest ) noexcept
 {
     Storm::Type::EquipmentTimes_T newData;
-    m_modelDatabase.lock_();
+    lock_();
 
     newData                       = m_data;
     newData.indoorUnitBeginOnTime = newBeginOnCycleTime;
 
     uint16_t result = writeData( &newData, sizeof( Storm::Type::EquipmentTimes_T ), lockRequest );
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
 uint16_t MpEquipmentBeginTimes::setIndoorUnitBeginOffTime( Cpl::System::ElapsedTime::Precision_T newBeginOffCycleTime, LockRequest_T lockRequest ) noexcept
 {
     Storm::Type::EquipmentTimes_T newData;
-    m_modelDatabase.lock_();
+    lock_();
 
     newData                        = m_data;
     newData.indoorUnitBeginOffTime = newBeginOffCycleTime;
 
     uint16_t result = writeData( &newData, sizeof( Storm::Type::EquipmentTimes_T ), lockRequest );
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
@@ -59,26 +59,26 @@ uint16_t MpEquipmentBeginTimes::setIndoorUnitBeginOffTime( Cpl::System::ElapsedT
 uint16_t MpEquipmentBeginTimes::setOutdoorUnitBeginOnTime( Cpl::System::ElapsedTime::Precision_T newBeginOnCycleTime, LockRequest_T lockRequest ) noexcept
 {
     Storm::Type::EquipmentTimes_T newData;
-    m_modelDatabase.lock_();
+    lock_();
 
     newData                        = m_data;
     newData.outdoorUnitBeginOnTime = newBeginOnCycleTime;
 
     uint16_t result = writeData( &newData, sizeof( Storm::Type::EquipmentTimes_T ), lockRequest );
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
 uint16_t MpEquipmentBeginTimes::setOutdoorUnitBeginOffTime( Cpl::System::ElapsedTime::Precision_T newBeginOffCycleTime, LockRequest_T lockRequest ) noexcept
 {
     Storm::Type::EquipmentTimes_T newData;
-    m_modelDatabase.lock_();
+    lock_();
 
     newData                         = m_data;
     newData.outdoorUnitBeginOffTime = newBeginOffCycleTime;
 
     uint16_t result = writeData( &newData, sizeof( Storm::Type::EquipmentTimes_T ), lockRequest );
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
@@ -86,26 +86,26 @@ uint16_t MpEquipmentBeginTimes::setOutdoorUnitBeginOffTime( Cpl::System::Elapsed
 uint16_t MpEquipmentBeginTimes::setSystemBeginOnTime( Cpl::System::ElapsedTime::Precision_T newBeginOnCycleTime, LockRequest_T lockRequest ) noexcept
 {
     Storm::Type::EquipmentTimes_T newData;
-    m_modelDatabase.lock_();
+    lock_();
 
     newData                   = m_data;
     newData.systemBeginOnTime = newBeginOnCycleTime;
 
     uint16_t result = writeData( &newData, sizeof( Storm::Type::EquipmentTimes_T ), lockRequest );
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
 uint16_t MpEquipmentBeginTimes::setSystemBeginOffTime( Cpl::System::ElapsedTime::Precision_T newBeginOffCycleTime, LockRequest_T lockRequest ) noexcept
 {
     Storm::Type::EquipmentTimes_T newData;
-    m_modelDatabase.lock_();
+    lock_();
 
     newData                    = m_data;
     newData.systemBeginOffTime = newBeginOffCycleTime;
 
     uint16_t result = writeData( &newData, sizeof( Storm::Type::EquipmentTimes_T ), lockRequest );
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
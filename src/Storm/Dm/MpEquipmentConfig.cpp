@@ -52,65 +52,65 @@ void MpEquipmentConfig::hookSetInvalid() noexcept
 
 uint16_t MpEquipmentConfig::writeIndoorType( Storm::Type::IduType newUnitType, LockRequest_T lockRequest ) noexcept
 {
-    m_modelDatabase.lock_();
+    lock_();
 
     Data src        = m_data;
     src.iduType     = newUnitType;
     validate( src );
     uint16_t result = writeData( &src, sizeof( Data ), lockRequest );
 
-    m_modelDatabase.unlock_();
+    unlock_();
     return result;
 }
 
 uint16_t MpEquipmentConfig::writeIndoorFanMotor( bool hasVspBlower, LockRequest_T lockRequest ) noexcept
 {
-    m_modelDatabase.lock_();
+    lock_();
 
     Data src         = m_data;
     src.hasVspBlower = hasVspBlower;
     validate( src );
     uint16_t result  = writeData( &src, sizeof( Data ), lockRequest );
 
-    m_modelDatabase.unlock_();
+    unlock_();
     return result;
 }
 
 uint16_t MpEquipmentConfig::writeIndoorHeatingStages( uint16_t numIduHeatingStages, LockRequest_T lockRequest ) noexcept
 {
-    m_modelDatabase.lock_();
+    lock_();
 
     Data src                = m_data;
     src.numIduHeatingStages = numIduHeatingStages;
     validate( src );
     uint16_t result         = writeData( &src, sizeof( Data ), lockRequest );
 
-    m_modelDatabase.unlock_();
+    unlock_();
     return result;
 }
 uint16_t MpEquipmentConfig::writeOutdoorType( Storm::Type::OduType newUnitType, LockRequest_T lockRequest ) noexcept
 {
-    m_modelDatabase.lock_();
+    lock_();
 
     Data src        = m_data;
     src.oduType     = newUnitType;
     validate( src );
     uint16_t result = writeData( &src, sizeof( Data ), lockRequest );
 
-    m_modelDatabase.unlock_();
+    unlock_();
     return result;
 }
 
 uint16_t MpEquipmentConfig::writeCompressorStages( uint16_t numStages, LockRequest_T lockRequest ) noexcept
 {
-    m_modelDatabase.lock_();
+    lock_();
 
     Data src          = m_data;
     src.numCompStages = numStages;
     validate( src );
     uint16_t result   = writeData( &src, sizeof( Data ), lockRequest );
 
-    m_modelDatabase.unlock_();
+    unlock_();
     return result;
 }
 
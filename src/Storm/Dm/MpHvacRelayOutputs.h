@@ -75,10 +75,10 @@ public:
         Storm::Type::HvacRelayOutputs_T newData;
         setSafeAllOff( newData );
 
-        m_modelDatabase.lock_();
+        lock_();
         newData.o = m_data.o;
         uint16_t result = write( newData, lockRequest );
-        m_modelDatabase.unlock_();
+        unlock_();
 
         return result;
     }
@@ -89,10 +89,10 @@ public:
         Storm::Type::HvacRelayOutputs_T newData;
         setCapacityOff( newData );
 
-        m_modelDatabase.lock_();
+        lock_();
         newData.o = m_data.o;
         uint16_t result = write( newData, lockRequest );
-        m_modelDatabase.unlock_();
+        unlock_();
 
         return result;
     }
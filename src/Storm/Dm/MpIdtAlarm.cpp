@@ -33,7 +33,7 @@ MpIdtAlarm::MpIdtAlarm( Cpl::Dm::ModelDatabase& myModelBase, const char* symboli
 uint16_t MpIdtAlarm::setAlarm( bool primaryAlarmState, bool secondaryAlarmState, bool isCritical, LockRequest_T lockRequest ) noexcept
 {
     Data newData;
-    m_modelDatabase.lock_();
+    lock_();
 
     newData                = m_data;
     newData.primaryAlarm   = primaryAlarmState;
@@ -50,7 +50,7 @@ uint16_t MpIdtAlarm::setAlarm( bool primaryAlarmState, bool secondaryAlarmState,
         newData.secondaryAck = false;
     }
     uint16_t result = writeData( &newData, sizeof( Data ), lockRequest );
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
@@ -58,13 +58,13 @@ uint16_t MpIdtAlarm::setAlarm( bool primaryAlarmState, bool secondaryAlarmState,
 uint16_t MpIdtAlarm::acknowledgePrimaryAlarm( LockRequest_T lockRequest ) noexcept
 {
     Data newData;
-    m_modelDatabase.lock_();
+    lock_();
 
     newData            = m_data;
     newData.primaryAck = true;
 
     uint16_t result = writeData( &newData, sizeof( Data ), lockRequest );
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
@@ -72,13 +72,13 @@ uint16_t MpIdtAlarm::acknowledgePrimaryAlarm( LockRequest_T lockRequest ) noexce
 uint16_t MpIdtAlarm::acknowledgeSecondaryAlarm( LockRequest_T lockRequest ) noexcept
 {
     Data newData;
-    m_modelDatabase.lock_();
+    lock_();
 
     newData              = m_data;
     newData.secondaryAck = true;
 
     uint16_t result = writeData( &newData, sizeof( Data ), lockRequest );
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
@@ -152,14 +152,14 @@ public:
      */
     inline uint16_t writeCool( float newSetpoint, LockRequest_T lockRequest = eNO_REQUEST ) noexcept
     {
-        m_modelDatabase.lock_();
+        lock_();
 
         float finalHeatSetpt;
         validateSetpoints( newSetpoint, m_data.heatSetpt, newSetpoint, finalHeatSetpt );
         Data src ={ newSetpoint, finalHeatSetpt };
         uint16_t result = writeData( &src, sizeof( Data ), lockRequest );
 
-        m_modelDatabase.unlock_();
+        unlock_();
         return result;
     }
 
@@ -170,14 +170,14 @@ public:
      */
     inline uint16_t writeHeat( float newSetpoint, LockRequest_T lockRequest = eNO_REQUEST ) noexcept
     {
-        m_modelDatabase.lock_();
+        lock_();
 
         float finalCoolSetpt;
         validateSetpoints( m_data.coolSetpt, newSetpoint, finalCoolSetpt, newSetpoint );
         Data src ={ finalCoolSetpt, newSetpoint };
         uint16_t result = writeData( &src, sizeof( Data ), lockRequest );
 
-        m_modelDatabase.unlock_();
+        unlock_();
         return result;
     }
 
@@ -34,7 +34,7 @@ void MpSimpleAlarm::hookSetInvalid() noexcept
 uint16_t MpSimpleAlarm::setAlarm( bool active, bool isCritical, LockRequest_T lockRequest ) noexcept
 {
     Data newData;
-    m_modelDatabase.lock_();
+    lock_();
 
     newData          = m_data;
     newData.active   = active;
@@ -46,7 +46,7 @@ uint16_t MpSimpleAlarm::setAlarm( bool active, bool isCritical, LockRequest_T lo
         newData.acked = false;
     }
     uint16_t result = writeData( &newData, sizeof( Data ), lockRequest );
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
@@ -54,13 +54,13 @@ uint16_t MpSimpleAlarm::setAlarm( bool active, bool isCritical, LockRequest_T lo
 uint16_t MpSimpleAlarm::acknowledgeAlarm( LockRequest_T lockRequest ) noexcept
 {
     Data newData;
-    m_modelDatabase.lock_();
+    lock_();
 
     newData       = m_data;
     newData.acked = true;
 
     uint16_t result = writeData( &newData, sizeof( Data ), lockRequest );
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
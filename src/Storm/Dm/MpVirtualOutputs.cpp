@@ -38,13 +38,13 @@ MpVirtualOutputs::MpVirtualOutputs( Cpl::Dm::ModelDatabase& myModelBase, const c
 uint16_t MpVirtualOutputs::setIndoorFanOutput( uint16_t fanSpeed, LockRequest_T lockRequest ) noexcept
 {
     Storm::Type::VirtualOutputs_T newData;
-    m_modelDatabase.lock_();
+    lock_();
 
     newData           = m_data;
     newData.indoorFan = fanSpeed;
 
     uint16_t result = write( newData, lockRequest );
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
@@ -52,13 +52,13 @@ uint16_t MpVirtualOutputs::setIndoorFanOutput( uint16_t fanSpeed, LockRequest_T
 uint16_t MpVirtualOutputs::setIndoorFanContinousOutput( uint16_t fanContSpeed, LockRequest_T lockRequest ) noexcept
 {
     Storm::Type::VirtualOutputs_T newData;
-    m_modelDatabase.lock_();
+    lock_();
 
     newData               = m_data;
     newData.indoorFanCont = fanContSpeed;
 
     uint16_t result = write( newData, lockRequest );
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
@@ -74,13 +74,13 @@ uint16_t MpVirtualOutputs::setIndoorStageOutput( uint8_t stageIndex, uint16_t st
     }
 
     Storm::Type::VirtualOutputs_T newData;
-    m_modelDatabase.lock_();
+    lock_();
 
     newData                          = m_data;
     newData.indoorStages[stageIndex] = stageOutput;
 
     uint16_t result = write( newData );
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
@@ -89,13 +89,13 @@ uint16_t MpVirtualOutputs::setIndoorStageOutput( uint8_t stageIndex, uint16_t st
 uint16_t MpVirtualOutputs::setOutdoorFanOutput( uint16_t fanSpeed, LockRequest_T lockRequest ) noexcept
 {
     Storm::Type::VirtualOutputs_T newData;
-    m_modelDatabase.lock_();
+    lock_();
 
     newData            = m_data;
     newData.outdoorFan = fanSpeed;
 
     uint16_t result = write( newData, lockRequest );
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
@@ -110,13 +110,13 @@ uint16_t MpVirtualOutputs::setOutdoorStageOutput( uint8_t stageIndex, uint16_t s
     }
 
     Storm::Type::VirtualOutputs_T newData;
-    m_modelDatabase.lock_();
+    lock_();
 
     newData                           = m_data;
     newData.outdoorStages[stageIndex] = stageOutput;
 
     uint16_t result = write( newData );
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
@@ -124,13 +124,13 @@ uint16_t MpVirtualOutputs::setOutdoorStageOutput( uint8_t stageIndex, uint16_t s
 uint16_t MpVirtualOutputs::setSovToCooling( LockRequest_T lockRequest ) noexcept
 {
     Storm::Type::VirtualOutputs_T newData;
-    m_modelDatabase.lock_();
+    lock_();
 
     newData              = m_data;
     newData.sovInHeating = false;
 
     uint16_t result = write( newData, lockRequest );
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
@@ -138,13 +138,13 @@ uint16_t MpVirtualOutputs::setSovToCooling( LockRequest_T lockRequest ) noexcept
 uint16_t MpVirtualOutputs::setSovToHeating( LockRequest_T lockRequest ) noexcept
 {
     Storm::Type::VirtualOutputs_T newData;
-    m_modelDatabase.lock_();
+    lock_();
 
     newData              = m_data;
     newData.sovInHeating = true;
 
     uint16_t result = write( newData, lockRequest );
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
@@ -152,7 +152,7 @@ uint16_t MpVirtualOutputs::setSovToHeating( LockRequest_T lockRequest ) noexcept
 uint16_t MpVirtualOutputs::setOutdoorOff( LockRequest_T lockRequest ) noexcept
 {
     Storm::Type::VirtualOutputs_T newData;
-    m_modelDatabase.lock_();
+    lock_();
 
     newData              = m_data;
     for ( int i=0; i < STORM_MAX_OUTDOOR_STAGES; i++ )
@@ -162,7 +162,7 @@ uint16_t MpVirtualOutputs::setOutdoorOff( LockRequest_T lockRequest ) noexcept
     newData.outdoorFan = STORM_DM_MP_VIRTUAL_OUTPUTS_OFF;
 
     uint16_t result = write( newData, lockRequest );
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
@@ -170,7 +170,7 @@ uint16_t MpVirtualOutputs::setOutdoorOff( LockRequest_T lockRequest ) noexcept
 uint16_t MpVirtualOutputs::setIndoorOff( LockRequest_T lockRequest ) noexcept
 {
     Storm::Type::VirtualOutputs_T newData;
-    m_modelDatabase.lock_();
+    lock_();
 
     newData              = m_data;
     for ( int i=0; i < STORM_MAX_INDOOR_STAGES; i++ )
@@ -181,7 +181,7 @@ uint16_t MpVirtualOutputs::setIndoorOff( LockRequest_T lockRequest ) noexcept
     newData.indoorFanCont = STORM_DM_MP_VIRTUAL_OUTPUTS_OFF;
 
     uint16_t result = write( newData, lockRequest );
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
@@ -189,13 +189,13 @@ uint16_t MpVirtualOutputs::setIndoorOff( LockRequest_T lockRequest ) noexcept
 uint16_t MpVirtualOutputs::setSafeAllOff( LockRequest_T lockRequest ) noexcept
 {
     Storm::Type::VirtualOutputs_T newData;
-    m_modelDatabase.lock_();
+    lock_();
 
     setSafeAllOff( newData );
     newData.sovInHeating = m_data.sovInHeating;
 
     uint16_t result = write( newData, lockRequest );
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
@@ -203,13 +203,13 @@ uint16_t MpVirtualOutputs::setSafeAllOff( LockRequest_T lockRequest ) noexcept
 uint16_t MpVirtualOutputs::setCapacityOff( LockRequest_T lockRequest ) noexcept
 {
     Storm::Type::VirtualOutputs_T newData ={ 0, };
-    m_modelDatabase.lock_();
+    lock_();
 
     setCapacityOff( newData );
     newData.sovInHeating = m_data.sovInHeating;
 
     uint16_t result = write( newData, lockRequest );
-    m_modelDatabase.unlock_();
+    unlock_();
 
     return result;
 }
@@ -27,13 +27,13 @@ MpWhiteBox::MpWhiteBox( Cpl::Dm::ModelDatabase& myModelBase, const char* symboli
 
 uint16_t MpWhiteBox::resetPulseSettings( LockRequest_T lockRequest ) noexcept
 {
-    m_modelDatabase.lock_();
+    lock_();
 
     Storm::Type::WhiteBox_T src = m_data;
     src.abortOnOffCycle         = false;
     uint16_t result             = writeData( &src, sizeof( Storm::Type::WhiteBox_T ), lockRequest );
 
-    m_modelDatabase.unlock_();
+    unlock_();
     return result;
 }
 
@@ -0,0 +1,231 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+
+#include "Farm.h"
+#include "Storm/Type/ThermostatMode.h"
+#include "Storm/Type/Cph.h"
+#include "Cpl/System/Api.h"
+#include "Cpl/System/ElapsedTime.h"
+#include "Cpl/Io/File/Output.h"
+#include "Cpl/Text/FString.h"
+#include <new>
+
+using namespace Storm::Thermostat::SimFarm;
+
+
+///////////////////////////////
+Farm::Worker::Worker( Cpl::System::Semaphore& doneSema, Instance** instances, unsigned numInstances )
+    : m_doneSema( doneSema )
+    , m_goSema( 0 )
+    , m_instances( instances )
+    , m_numInstances( numInstances )
+    , m_startSec( 0 )
+    , m_endSec( 0 )
+    , m_success( true )
+    , m_exit( false )
+{
+}
+
+void Farm::Worker::beginEpoch( uint32_t startSec, uint32_t endSec ) noexcept
+{
+    m_startSec = startSec;
+    m_endSec   = endSec;
+    m_goSema.signal();
+}
+
+void Farm::Worker::terminate() noexcept
+{
+    m_exit = true;
+    m_goSema.signal();
+}
+
+void Farm::Worker::appRun()
+{
+    for ( ;;)
+    {
+        m_goSema.wait();
+        if ( m_exit )
+        {
+            break;
+        }
+
+        // Step one instance at time through the entire epoch (i.e. keep the instance 'hot' in the cache)
+        for ( unsigned i=0; i < m_numInstances; i++ )
+        {
+            Instance* instance = m_instances[i];
+            for ( uint32_t t=m_startSec; t < m_endSec; t += OPTION_STORM_THERMOSTAT_SIM_FARM_TICK_SEC )
+            {
+                m_success &= instance->step( t );
+            }
+        }
+
+        m_doneSema.signal();
+    }
+}
+
+///////////////////////////////
+Farm::Farm( const Scenario& scenario, unsigned numWorkers, uint32_t epochSeconds )
+    : m_scenario( scenario )
+    , m_doneSema( 0 )
+    , m_instances( 0 )
+    , m_numInstances( 0 )
+    , m_numWorkers( numWorkers ? numWorkers : 1 )
+    , m_epochSec( epochSeconds < OPTION_STORM_THERMOSTAT_SIM_FARM_TICK_SEC ? OPTION_STORM_THERMOSTAT_SIM_FARM_TICK_SEC : epochSeconds )
+    , m_runTimeMs( 0 )
+{
+}
+
+Farm::~Farm()
+{
+    destroyInstances();
+}
+
+void Farm::destroyInstances() noexcept
+{
+    if ( m_instances )
+    {
+        for ( unsigned i=0; i < m_numInstances; i++ )
+        {
+            delete m_instances[i];
+        }
+        delete[] m_instances;
+        m_instances    = 0;
+        m_numInstances = 0;
+    }
+}
+
+///////////////////////////////
+bool Farm::run() noexcept
+{
+    // Create the instances
+    destroyInstances();
+    unsigned numInstances = m_scenario.getNumInstances();
+    m_instances           = new( std::nothrow ) Instance * [numInstances];
+    if ( m_instances == 0 )
+    {
+        return false;
+    }
+    for ( unsigned g=0; g < m_scenario.getNumGroups(); g++ )
+    {
+        const Scenario::Group_T& group = m_scenario.getGroup( g );
+        for ( unsigned i=0; i < group.count; i++ )
+        {
+            Instance* instance = new( std::nothrow ) Instance( group, m_scenario.getProfile( group.profileIndex ) );
+            if ( instance == 0 )
+            {
+                destroyInstances();
+                return false;
+            }
+            m_instances[m_numInstances++] = instance;
+            instance->start();
+        }
+    }
+
+    // Create the workers (no more workers than instances)
+    unsigned              numWorkers = m_numWorkers < m_numInstances ? m_numWorkers : m_numInstances;
+    unsigned              numStarted = 0;
+    unsigned              first      = 0;
+    Worker**              workers    = new( std::nothrow ) Worker * [numWorkers]();
+    Cpl::System::Thread** threads    = new( std::nothrow ) Cpl::System::Thread * [numWorkers]();
+    bool                  success    = workers != 0 && threads != 0;
+    for ( unsigned w=0; success && w < numWorkers; w++ )
+    {
+        Cpl::Text::FString<16> name;
+        name.format( "SimFarm%u", w );
+        unsigned count = m_numInstances / numWorkers + ( w < m_numInstances % numWorkers ? 1 : 0 );
+        workers[w]     = new( std::nothrow ) Worker( m_doneSema, m_instances + first, count );
+        threads[w]     = workers[w] ? Cpl::System::Thread::create( *workers[w], name.getString(), CPL_SYSTEM_THREAD_PRIORITY_NORMAL, 0, 0, false ) : 0;
+        success        = threads[w] != 0;
+        numStarted    += success ? 1 : 0;
+        first         += count;
+    }
+
+    // Run the simulation in lock-step epochs
+    unsigned long startTime = Cpl::System::ElapsedTime::milliseconds();
+    uint32_t      duration  = m_scenario.getDurationSeconds();
+    for ( uint32_t t=0; success && t < duration; t += m_epochSec )
+    {
+        uint32_t end = t + m_epochSec < duration ? t + m_epochSec : duration;
+        for ( unsigned w=0; w < numStarted; w++ )
+        {
+            workers[w]->beginEpoch( t, end );
+        }
+        for ( unsigned w=0; w < numStarted; w++ )
+        {
+            m_doneSema.wait();
+        }
+    }
+    m_runTimeMs = Cpl::System::ElapsedTime::deltaMilliseconds( startTime );
+
+    // Tear down the workers
+    for ( unsigned w=0; w < numStarted; w++ )
+    {
+        workers[w]->terminate();
+        while ( workers[w]->isRunning() )
+        {
+            Cpl::System::Api::sleep( 1 );
+        }
+        Cpl::System::Thread::destroy( *threads[w] );
+        success &= workers[w]->isSuccess();
+    }
+    for ( unsigned w=0; workers && w < numWorkers; w++ )
+    {
+        delete workers[w];
+    }
+    delete[] workers;
+    delete[] threads;
+    return success;
+}
+
+///////////////////////////////
+bool Farm::writeStats( Cpl::Io::Output& dst ) noexcept
+{
+    Cpl::Text::FString<256> buffer;
+    bool io = dst.write( "id,profile,mode,coolSetpoint,heatSetpoint,compressorStages,indoorStages,cph,simulatedHours,"
+                         "onCycles,cyclesPerHour,dutyCycle,shortestOnCycleSec,longestOnCycleSec,"
+                         "meanAbsError,maxAbsError,secondsOutsideBand,minIdt,maxIdt\n" );
+    for ( unsigned i=0; io && i < m_numInstances; i++ )
+    {
+        const Scenario::Group_T& cfg   = m_instances[i]->getConfig();
+        const Instance::Stats_T& stats = m_instances[i]->getStats();
+        io = dst.write( buffer, "%u,%s,%s,%.1f,%.1f,%u,%u,%s,%.2f,%lu,%.2f,%.3f,%lu,%lu,%.3f,%.3f,%lu,%.2f,%.2f\n",
+                        i,
+                        m_scenario.getProfile( cfg.profileIndex ).name.getString(),
+                        Storm::Type::ThermostatMode::_from_integral( cfg.thermostatMode )._to_string(),
+                        cfg.coolSetpoint,
+                        cfg.heatSetpoint,
+                        cfg.numCompressorStages,
+                        cfg.numIndoorStages,
+                        Storm::Type::Cph::_from_integral( cfg.comfort.cph )._to_string(),
+                        stats.simulatedSeconds / 3600.0,
+                        (unsigned long) stats.numOnCycles,
+                        stats.cyclesPerHour(),
+                        stats.dutyCycle(),
+                        (unsigned long) stats.shortestOnCycleSec,
+                        (unsigned long) stats.longestOnCycleSec,
+                        stats.meanAbsError(),
+                        stats.maxAbsError,
+                        (unsigned long) stats.secondsOutsideBand,
+                        stats.minIdt,
+                        stats.maxIdt );
+    }
+    return io;
+}
+
+bool Farm::writeStats( const char* fileName ) noexcept
+{
+    Cpl::Io::File::Output fd( fileName, true, true );
+    if ( !fd.isOpened() )
+    {
+        return false;
+    }
+    return writeStats( fd );
+}
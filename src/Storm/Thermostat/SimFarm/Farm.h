@@ -0,0 +1,177 @@
+#ifndef Storm_Thermostat_SimFarm_Farm_h_
+#define Storm_Thermostat_SimFarm_Farm_h_
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+/** @file */
+
+#include "colony_config.h"
+#include "Storm/Thermostat/SimFarm/Instance.h"
+#include "Cpl/System/Runnable.h"
+#include "Cpl/System/Semaphore.h"
+#include "Cpl/System/Thread.h"
+#include "Cpl/Io/Output.h"
+
+
+/** The amount of simulated time, in seconds, that the workers advance their
+    instances between synchronization points.
+ */
+#ifndef OPTION_STORM_THERMOSTAT_SIM_FARM_EPOCH_SEC
+#define OPTION_STORM_THERMOSTAT_SIM_FARM_EPOCH_SEC      (15*60)
+#endif
+
+
+///
+namespace Storm {
+///
+namespace Thermostat {
+///
+namespace SimFarm {
+
+
+/** This concrete class is a batch runner that executes all of the
+    thermostat+house instances defined by a Scenario as fast as possible, i.e.
+    in virtual time.  The instances are partitioned (contiguously) across a
+    pool of worker threads.  All workers advance their instances in lock-step
+    epochs of OPTION_STORM_THERMOSTAT_SIM_FARM_EPOCH_SEC of simulated time,
+    i.e. when an epoch completes all instances are at the same simulated time.
+
+    Since the instances are fully independent (each has its own Model
+    Database, Model Points, and Components), the results are deterministic
+    and do NOT depend on the number of worker threads.
+
+    Usage:
+        Scenario scenario;
+        scenario.load( "myscenario.txt" );
+        Farm farm( scenario, numThreads );
+        if ( farm.run() )
+        {
+            farm.writeStats( "results.csv" );
+        }
+
+    The class is NOT thread safe, i.e. its methods should only be called from
+    a single thread.
+ */
+class Farm
+{
+public:
+    /// Constructor.  Note: The Scenario instance MUST stay in scope for the life of the Farm instance.
+    Farm( const Scenario& scenario, unsigned numWorkers, uint32_t epochSeconds = OPTION_STORM_THERMOSTAT_SIM_FARM_EPOCH_SEC );
+
+    /// Destructor
+    ~Farm();
+
+public:
+    /** This method creates the instances and runs the simulation for the
+        scenario's duration.  The method blocks until the simulation has
+        completed.  Returns false if the instances could not be allocated or
+        one or more instance's Components failed.
+     */
+    bool run() noexcept;
+
+    /// Returns the number of instances (only valid after run() has been called)
+    inline unsigned getNumInstances() const noexcept { return m_numInstances; }
+
+    /// Returns the Nth instance (only valid after run() has been called).  Note: 'index' is NOT range checked
+    inline const Instance& getInstance( unsigned index ) const noexcept { return *m_instances[index]; }
+
+    /// Returns the wall clock time, in milliseconds, of the last run()
+    inline unsigned long getRunTimeMs() const noexcept { return m_runTimeMs; }
+
+public:
+    /** This method writes the per-instance statistics, as comma separated
+        values (with a header row), to the specified stream.  Returns false
+        if there was an IO error.
+     */
+    bool writeStats( Cpl::Io::Output& dst ) noexcept;
+
+    /// Same as writeStats(), except the output is written to the specified file
+    bool writeStats( const char* fileName ) noexcept;
+
+protected:
+    /// Worker thread that steps a contiguous range of instances
+    class Worker : public Cpl::System::Runnable
+    {
+    public:
+        /// Constructor
+        Worker( Cpl::System::Semaphore& doneSema, Instance** instances, unsigned numInstances );
+
+    public:
+        /// Steps the instances through the simulated time range [startSec, endSec).  Non-blocking
+        void beginEpoch( uint32_t startSec, uint32_t endSec ) noexcept;
+
+        /// Terminates the worker's thread.  Non-blocking
+        void terminate() noexcept;
+
+        /// Returns false if one or more Components failed
+        inline bool isSuccess() const noexcept { return m_success; }
+
+    protected:
+        /// See Cpl::System::Runnable
+        void appRun();
+
+    protected:
+        /// Semaphore to signal when an epoch has completed
+        Cpl::System::Semaphore& m_doneSema;
+
+        /// Semaphore to start an epoch
+        Cpl::System::Semaphore  m_goSema;
+
+        /// First instance
+        Instance**              m_instances;
+
+        /// Number of instances
+        unsigned                m_numInstances;
+
+        /// Start time of the current epoch
+        uint32_t                m_startSec;
+
+        /// End time of the current epoch
+        uint32_t                m_endSec;
+
+        /// Success status
+        bool                    m_success;
+
+        /// Request to terminate
+        volatile bool           m_exit;
+    };
+
+protected:
+    /// Helper method
+    void destroyInstances() noexcept;
+
+protected:
+    /// Scenario
+    const Scenario&         m_scenario;
+
+    /// Semaphore used by the Workers to indicate that an epoch has completed
+    Cpl::System::Semaphore  m_doneSema;
+
+    /// Instances
+    Instance**              m_instances;
+
+    /// Number of instances
+    unsigned                m_numInstances;
+
+    /// Number of worker threads
+    unsigned                m_numWorkers;
+
+    /// Epoch duration
+    uint32_t                m_epochSec;
+
+    /// Wall clock time of the last run
+    unsigned long           m_runTimeMs;
+};
+
+
+};      // end namespaces
+};
+};
+#endif  // end header latch
@@ -0,0 +1,299 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+
+#include "Instance.h"
+#include <math.h>
+#include <string.h>
+
+using namespace Storm::Thermostat::SimFarm;
+
+// Helper macro: creates model point in the invalid state
+#define MP_INVALID(n)       mp_##n( m_modelDb, #n )
+
+// House parameters (same as the Storm::Thermostat::SimHouse::House)
+#define RESISTANCE_NO_CAPACITY      50
+#define RESISTANCE_COOLING_CAPCITY  (RESISTANCE_NO_CAPACITY*2.0/3.0)
+#define RESISTANCE_HEATING_CAPCITY  (RESISTANCE_COOLING_CAPCITY*3.0)
+
+
+///////////////////////////////
+static float initialIdt( const Scenario::Group_T& config )
+{
+    // Start the house at the 'active' set-point
+    if ( config.thermostatMode == Storm::Type::ThermostatMode::eCOOLING )
+    {
+        return config.coolSetpoint;
+    }
+    if ( config.thermostatMode == Storm::Type::ThermostatMode::eHEATING || config.thermostatMode == Storm::Type::ThermostatMode::eID_HEATING )
+    {
+        return config.heatSetpoint;
+    }
+    return ( config.coolSetpoint + config.heatSetpoint ) / 2.0F;
+}
+
+///////////////////////////////
+Instance::Instance( const Scenario::Group_T& config, const Scenario::Profile_T& odtProfile )
+    : m_config( config )
+    , m_profile( odtProfile )
+    , m_modelDb()
+    , MP_INVALID( setpoints )
+    , MP_INVALID( userMode )
+    , MP_INVALID( fanMode )
+    , MP_INVALID( maxAirFilterHours )
+    , MP_INVALID( primaryRawIdt )
+    , MP_INVALID( secondaryRawIdt )
+    , MP_INVALID( activeIdt )
+    , MP_INVALID( outdoorTemp )
+    , MP_INVALID( relayOutputs )
+    , MP_INVALID( idtAlarms )
+    , MP_INVALID( noActiveConditioningAlarm )
+    , MP_INVALID( userCfgModeAlarm )
+    , MP_INVALID( airFilterAlert )
+    , MP_INVALID( enabledSecondaryIdt )
+    , MP_INVALID( equipmentConfig )
+    , MP_INVALID( comfortConfig )
+    , MP_INVALID( systemForcedOffRefCnt )
+    , MP_INVALID( systemConfig )
+    , MP_INVALID( systemOn )
+    , MP_INVALID( equipmentBeginTimes )
+    , MP_INVALID( resetPiPulse )
+    , MP_INVALID( operatingModeChanged )
+    , MP_INVALID( deltaIdtError )
+    , MP_INVALID( deltaSetpoint )
+    , MP_INVALID( setpointChanged )
+    , MP_INVALID( activeSetpoint )
+    , MP_INVALID( freezePiRefCnt )
+    , MP_INVALID( inhibitfRefCnt )
+    , MP_INVALID( pvOut )
+    , MP_INVALID( sumError )
+    , MP_INVALID( pvInhibited )
+    , MP_INVALID( vOutputs )
+    , MP_INVALID( cycleInfo )
+    , MP_INVALID( loopCounter )
+    , MP_INVALID( airFilterOperationTime )
+    , MP_INVALID( whiteBox )
+    , m_idtSelection( { &mp_primaryRawIdt, &mp_secondaryRawIdt, &mp_enabledSecondaryIdt },
+                      { &mp_activeIdt, &mp_systemForcedOffRefCnt, &mp_idtAlarms } )
+    , m_operatingMode( { &mp_setpoints, &mp_userMode, &mp_activeIdt, &mp_equipmentBeginTimes, &mp_systemOn, &mp_systemForcedOffRefCnt, &mp_equipmentConfig, &mp_comfortConfig },
+                       { &mp_operatingModeChanged, &mp_resetPiPulse, &mp_systemForcedOffRefCnt, &mp_systemConfig, &mp_noActiveConditioningAlarm, &mp_userCfgModeAlarm } )
+    , m_piPreProcess( { &mp_activeIdt, &mp_systemConfig, &mp_operatingModeChanged, &mp_setpoints },
+                      { &mp_activeSetpoint, &mp_deltaIdtError, &mp_deltaSetpoint, &mp_setpointChanged } )
+    , m_pi( { &mp_resetPiPulse, &mp_deltaIdtError, &mp_systemConfig, &mp_freezePiRefCnt, &mp_inhibitfRefCnt },
+            { &mp_pvOut, &mp_sumError, &mp_pvInhibited } )
+    , m_controlCooling( m_equipmentCooling,
+                        { &mp_systemConfig, &mp_pvOut, &mp_vOutputs, &mp_equipmentBeginTimes, &mp_systemOn, &mp_cycleInfo, &mp_operatingModeChanged, &mp_whiteBox },
+                        { &mp_vOutputs, &mp_cycleInfo, &mp_systemOn } )
+    , m_controlIdHeating( m_equipmentIndoorHeating,
+                          { &mp_systemConfig, &mp_pvOut, &mp_vOutputs, &mp_equipmentBeginTimes, &mp_systemOn, &mp_cycleInfo, &mp_operatingModeChanged, &mp_whiteBox },
+                          { &mp_vOutputs, &mp_cycleInfo, &mp_systemOn } )
+    , m_controlOff( m_equipmentOff,
+                    { &mp_systemConfig, &mp_pvOut, &mp_vOutputs, &mp_equipmentBeginTimes, &mp_systemOn, &mp_cycleInfo, &mp_operatingModeChanged, &mp_whiteBox },
+                    { &mp_vOutputs, &mp_cycleInfo, &mp_systemOn } )
+    , m_fanControl( { &mp_fanMode, &mp_systemConfig, &mp_vOutputs, &mp_equipmentBeginTimes },
+                    { &mp_vOutputs } )
+    , m_airFilterMonitor( { &mp_maxAirFilterHours, &mp_airFilterOperationTime, &mp_vOutputs, &mp_airFilterAlert },
+                          { &mp_airFilterAlert, &mp_airFilterOperationTime } )
+    , m_hvacRelayOutputs( { &mp_vOutputs, &mp_equipmentBeginTimes, &mp_systemForcedOffRefCnt, &mp_systemOn },
+                          { &mp_equipmentBeginTimes, &mp_relayOutputs } )
+    , m_stage1Cooling( 0, 0 )
+    , m_stage1IndoorHeat( 0, 0 )
+    , m_stage2IndoorHeat( 1, 1 )
+    , m_stage3IndoorHeat( 2, 2 )
+    , m_equipmentCooling( m_stage1Cooling )
+    , m_equipmentIndoorHeating( m_stage1IndoorHeat, m_stage2IndoorHeat, m_stage3IndoorHeat )
+    , m_equipmentOff()
+    , m_house( OPTION_STORM_THERMOSTAT_SIM_FARM_TICK_SEC
+               , initialIdt( config )
+               , 120.0                          // max odt
+               , -20.0                          // min odt
+               , 0.33                           // ODT Cooling load rating
+               , 0.80                           // ODT Heating load rating
+               , RESISTANCE_NO_CAPACITY         // systemEnvResistance
+               , RESISTANCE_COOLING_CAPCITY     // systemCoolingEnvResistance
+               , RESISTANCE_HEATING_CAPCITY )   // systemHeatingEnvResistance
+    , m_onCycleStart( 0 )
+    , m_now( 0 )
+    , m_equipmentOn( false )
+{
+}
+
+///////////////////////////////
+void Instance::start() noexcept
+{
+    // Initialize the Model Points (same as the Algorithm's functional test)
+    mp_setpoints.write( m_config.coolSetpoint, m_config.heatSetpoint );
+    mp_userMode.write( Storm::Type::ThermostatMode::_from_integral( m_config.thermostatMode ) );
+    mp_fanMode.write( Storm::Type::FanMode::eAUTO );
+    mp_primaryRawIdt.write( initialIdt( m_config ) );
+    mp_secondaryRawIdt.write( initialIdt( m_config ) );
+    mp_activeIdt.setInvalid();
+    mp_outdoorTemp.write( m_profile.getOdt( 0 ) );
+    mp_relayOutputs.setSafeAllOff();
+    mp_idtAlarms.setAlarm( false, false, false );
+    mp_noActiveConditioningAlarm.setAlarm( false, false );
+    mp_userCfgModeAlarm.setAlarm( false, false );
+    mp_airFilterAlert.setAlarm( false, false );
+    mp_maxAirFilterHours.write( 360 );
+    mp_airFilterOperationTime.write( { 0, 0 } );
+    mp_enabledSecondaryIdt.write( false );
+    mp_equipmentConfig.writeCompressorStages( m_config.numCompressorStages );
+    mp_equipmentConfig.writeIndoorFanMotor( false );
+    mp_equipmentConfig.writeIndoorHeatingStages( m_config.numIndoorStages );
+    mp_equipmentConfig.writeIndoorType( Storm::Type::IduType::_from_integral( m_config.iduType ) );
+    mp_equipmentConfig.writeOutdoorType( Storm::Type::OduType::_from_integral( m_config.oduType ) );
+    mp_comfortConfig.writeCompressorCooling( m_config.comfort );
+    mp_comfortConfig.writeCompressorHeating( m_config.comfort );
+    mp_comfortConfig.writeIndoorHeating( m_config.comfort );
+    mp_systemForcedOffRefCnt.reset();
+    mp_systemConfig.setInvalid();           // Algorithm will update this!
+    mp_systemOn.write( false );
+    mp_resetPiPulse.write( false );
+    mp_operatingModeChanged.write( false );
+    mp_deltaIdtError.write( 0.0F );
+    mp_deltaSetpoint.write( 0.0F );
+    mp_setpointChanged.write( false );
+    mp_activeSetpoint.setInvalid();         // Algorithm will update this!
+    mp_freezePiRefCnt.reset();
+    mp_inhibitfRefCnt.reset();
+    mp_pvOut.write( 0.0F );
+    mp_sumError.write( 0.0F );
+    mp_pvInhibited.write( false );
+    Storm::Type::VirtualOutputs_T zeroVOutputs = { 0, };
+    mp_vOutputs.write( zeroVOutputs );
+    Storm::Type::CycleInfo_T zeroCycleInfo;
+    mp_cycleInfo.write( zeroCycleInfo );
+    Storm::Type::EquipmentTimes_T zeroEquipmentBeginTimes;
+    mp_equipmentBeginTimes.write( zeroEquipmentBeginTimes );
+    mp_loopCounter.write( 0 );
+
+    // Start the Components
+    Cpl::System::ElapsedTime::Precision_T interval = { OPTION_STORM_THERMOSTAT_SIM_FARM_ALGORITHM_INTERVAL_SEC, 0 };
+    m_idtSelection.start( interval );
+    m_operatingMode.start( interval );
+    m_piPreProcess.start( interval );
+    m_pi.start( interval );
+    m_controlCooling.start( interval );
+    m_controlIdHeating.start( interval );
+    m_controlOff.start( interval );
+    m_fanControl.start( interval );
+    m_airFilterMonitor.start( interval );
+    m_hvacRelayOutputs.start( interval );
+
+    // Reset the statistics
+    memset( &m_stats, 0, sizeof( m_stats ) );
+    m_stats.minIdt = initialIdt( m_config );
+    m_stats.maxIdt = m_stats.minIdt;
+    m_onCycleStart = 0;
+    m_now          = 0;
+    m_equipmentOn  = false;
+}
+
+bool Instance::step( uint32_t elapsedSeconds ) noexcept
+{
+    Cpl::System::ElapsedTime::Precision_T now = { elapsedSeconds, 0 };
+    m_now = elapsedSeconds;
+
+    // Reset all Pulse MPs
+    mp_resetPiPulse.write( false );
+
+    // Execute the algorithm (the Components self-time on the virtual time)
+    bool success = true;
+    success &= m_idtSelection.doWork( success, now );
+    success &= m_operatingMode.doWork( success, now );
+    success &= m_piPreProcess.doWork( success, now );
+    success &= m_pi.doWork( success, now );
+    success &= m_controlCooling.doWork( success, now );
+    success &= m_controlIdHeating.doWork( success, now );
+    success &= m_controlOff.doWork( success, now );
+    success &= m_fanControl.doWork( success, now );
+    success &= m_airFilterMonitor.doWork( success, now );
+    success &= m_hvacRelayOutputs.doWork( success, now );
+
+    // Clear any/all WhiteBox 'Pulse' flags
+    mp_whiteBox.resetPulseSettings();
+
+    // Update the house and collect the results
+    executeHouse( elapsedSeconds );
+    updateStats();
+    return success;
+}
+
+///////////////////////////////
+void Instance::executeHouse( uint32_t elapsedSeconds ) noexcept
+{
+    float                           odt = m_profile.getOdt( elapsedSeconds );
+    Storm::Type::SystemConfig_T     sysCfg;
+    Storm::Type::HvacRelayOutputs_T relays;
+    mp_outdoorTemp.write( odt );
+    if ( mp_systemConfig.read( sysCfg ) && mp_relayOutputs.read( relays ) )
+    {
+        bool   cooling;
+        double capacity = Storm::Utils::SimHouse::getActiveCapacity( sysCfg, relays, cooling );
+        mp_primaryRawIdt.write( (float) m_house.tick( odt, capacity, cooling ) );
+    }
+}
+
+void Instance::updateStats() noexcept
+{
+    m_stats.simulatedSeconds += OPTION_STORM_THERMOSTAT_SIM_FARM_TICK_SEC;
+
+    // Cycle statistics (based on the first stage of the equipment)
+    Storm::Type::HvacRelayOutputs_T relays;
+    bool equipmentOn = mp_relayOutputs.read( relays ) && ( relays.y1 || relays.w1 );
+    if ( equipmentOn )
+    {
+        m_stats.onTimeSeconds += OPTION_STORM_THERMOSTAT_SIM_FARM_TICK_SEC;
+        if ( !m_equipmentOn )
+        {
+            m_stats.numOnCycles++;
+            m_onCycleStart = m_now;
+        }
+    }
+    else if ( m_equipmentOn )
+    {
+        uint32_t duration = m_now - m_onCycleStart;
+        if ( m_stats.shortestOnCycleSec == 0 || duration < m_stats.shortestOnCycleSec )
+        {
+            m_stats.shortestOnCycleSec = duration;
+        }
+        if ( duration > m_stats.longestOnCycleSec )
+        {
+            m_stats.longestOnCycleSec = duration;
+        }
+    }
+    m_equipmentOn = equipmentOn;
+
+    // Comfort statistics
+    float idt;
+    float setpoint;
+    if ( mp_activeIdt.read( idt ) && mp_activeSetpoint.read( setpoint ) )
+    {
+        float absError = fabsf( idt - setpoint );
+        m_stats.comfortSamples++;
+        m_stats.sumAbsError += absError;
+        if ( absError > m_stats.maxAbsError )
+        {
+            m_stats.maxAbsError = absError;
+        }
+        if ( absError > OPTION_STORM_THERMOSTAT_SIM_FARM_COMFORT_BAND )
+        {
+            m_stats.secondsOutsideBand += OPTION_STORM_THERMOSTAT_SIM_FARM_TICK_SEC;
+        }
+        if ( idt < m_stats.minIdt )
+        {
+            m_stats.minIdt = idt;
+        }
+        if ( idt > m_stats.maxIdt )
+        {
+            m_stats.maxIdt = idt;
+        }
+    }
+}
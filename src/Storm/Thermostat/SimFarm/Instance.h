@@ -0,0 +1,274 @@
+#ifndef Storm_Thermostat_SimFarm_Instance_h_
+#define Storm_Thermostat_SimFarm_Instance_h_
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+/** @file */
+
+#include "colony_config.h"
+#include "Storm/Thermostat/SimFarm/Scenario.h"
+#include "Storm/Component/AirFilterMonitor.h"
+#include "Storm/Component/Control.h"
+#include "Storm/Component/Equipment/Cooling.h"
+#include "Storm/Component/Equipment/IndoorHeating.h"
+#include "Storm/Component/Equipment/Off.h"
+#include "Storm/Component/Equipment/Stage/BasicCooling.h"
+#include "Storm/Component/Equipment/Stage/BasicIndoorHeat.h"
+#include "Storm/Component/FanControl.h"
+#include "Storm/Component/HvacRelayOutputs.h"
+#include "Storm/Component/IdtSelection.h"
+#include "Storm/Component/OperatingMode.h"
+#include "Storm/Component/Pi.h"
+#include "Storm/Component/PiPreProcess.h"
+#include "Storm/Dm/MpIdtAlarm.h"
+#include "Storm/Dm/MpSimpleAlarm.h"
+#include "Storm/Dm/MpSetpoints.h"
+#include "Storm/Dm/MpFanMode.h"
+#include "Storm/Dm/MpThermostatMode.h"
+#include "Storm/Dm/MpEquipmentConfig.h"
+#include "Storm/Dm/MpVirtualOutputs.h"
+#include "Storm/Dm/MpEquipmentBeginTimes.h"
+#include "Storm/Dm/MpComfortConfig.h"
+#include "Storm/Dm/MpCycleInfo.h"
+#include "Storm/Dm/MpSystemConfig.h"
+#include "Storm/Dm/MpHvacRelayOutputs.h"
+#include "Storm/Dm/MpWhiteBox.h"
+#include "Storm/Utils/SimHouse.h"
+#include "Cpl/Dm/ModelDatabase.h"
+#include "Cpl/Dm/Mp/Uint32.h"
+#include "Cpl/Dm/Mp/Float.h"
+#include "Cpl/Dm/Mp/Bool.h"
+#include "Cpl/Dm/Mp/RefCounter.h"
+#include "Cpl/Dm/Mp/ElapsedPrecisionTime.h"
+#include "Cpl/System/ElapsedTime.h"
+
+
+/// The simulation tick period in seconds (i.e. how often the house simulation is executed)
+#ifndef OPTION_STORM_THERMOSTAT_SIM_FARM_TICK_SEC
+#define OPTION_STORM_THERMOSTAT_SIM_FARM_TICK_SEC               1
+#endif
+
+/// The algorithm's processing interval in seconds (same as the Storm::Thermostat::Algorithm)
+#ifndef OPTION_STORM_THERMOSTAT_SIM_FARM_ALGORITHM_INTERVAL_SEC
+#define OPTION_STORM_THERMOSTAT_SIM_FARM_ALGORITHM_INTERVAL_SEC 2
+#endif
+
+/// The +/- band, in degrees Fahrenheit, around the active set-point that is considered 'comfortable'
+#ifndef OPTION_STORM_THERMOSTAT_SIM_FARM_COMFORT_BAND
+#define OPTION_STORM_THERMOSTAT_SIM_FARM_COMFORT_BAND           1.0F
+#endif
+
+
+///
+namespace Storm {
+///
+namespace Thermostat {
+///
+namespace SimFarm {
+
+
+/** This concrete class is a single, self contained, thermostat+house
+    simulation instance.  Each instance has its own Model Database, Model
+    Points, control algorithm Components (assembled the same as the
+    Storm::Thermostat::Algorithm), and Storm::Utils::SimHouse.
+
+    The instance is NOT driven by a timer/mailbox.  Instead the step() method
+    is called with the current VIRTUAL time, i.e. the simulation runs as fast
+    as the CPU allows and is deterministic.  The Components 'self-time' on the
+    supplied time.
+
+    The class is NOT thread safe, i.e. an instance can only be stepped by one
+    thread at a time.  However, since instances do not share any state,
+    different instances can be stepped concurrently by different threads.
+ */
+class Instance
+{
+public:
+    /// Per-instance cycle and comfort statistics
+    struct Stats_T
+    {
+        uint32_t    simulatedSeconds;       //!< Total simulated time
+        uint32_t    numOnCycles;            //!< Number of (first stage) equipment on cycles
+        uint32_t    onTimeSeconds;          //!< Total time the (first stage) equipment was on
+        uint32_t    shortestOnCycleSec;     //!< Duration of the shortest completed on cycle (0 if no completed cycles)
+        uint32_t    longestOnCycleSec;      //!< Duration of the longest completed on cycle
+        uint32_t    secondsOutsideBand;     //!< Time the indoor temperature was outside of the comfort band
+        uint32_t    comfortSamples;         //!< Number of samples used for the comfort statistics
+        double      sumAbsError;            //!< Sum of |IDT - active set-point| (over comfortSamples)
+        float       maxAbsError;            //!< Maximum |IDT - active set-point|
+        float       minIdt;                 //!< Minimum indoor temperature
+        float       maxIdt;                 //!< Maximum indoor temperature
+
+        /// Returns the mean |IDT - active set-point|
+        inline double meanAbsError() const noexcept { return comfortSamples ? sumAbsError / comfortSamples : 0.0; }
+
+        /// Returns the number of on cycles per hour
+        inline double cyclesPerHour() const noexcept { return simulatedSeconds ? numOnCycles * 3600.0 / simulatedSeconds : 0.0; }
+
+        /// Returns the equipment duty cycle (0.0 to 1.0)
+        inline double dutyCycle() const noexcept { return simulatedSeconds ? onTimeSeconds / (double) simulatedSeconds : 0.0; }
+    };
+
+public:
+    /// Constructor
+    Instance( const Scenario::Group_T& config, const Scenario::Profile_T& odtProfile );
+
+public:
+    /** This method initializes the Model Points and starts the Components.
+        Must be called once before step() is called.
+     */
+    void start() noexcept;
+
+    /** This method advances the simulation by one tick, i.e. the Components
+        are executed (when their interval has expired) and the house
+        simulation is executed.  'elapsedSeconds' is the virtual time and
+        MUST increment by OPTION_STORM_THERMOSTAT_SIM_FARM_TICK_SEC on each
+        call.  Returns false if one or more Components failed.
+     */
+    bool step( uint32_t elapsedSeconds ) noexcept;
+
+    /// Returns the instance's statistics
+    inline const Stats_T& getStats() const noexcept { return m_stats; }
+
+    /// Returns the instance's configuration
+    inline const Scenario::Group_T& getConfig() const noexcept { return m_config; }
+
+    /// Returns the instance's Model Database
+    inline Cpl::Dm::ModelDatabase& getModelDatabase() noexcept { return m_modelDb; }
+
+protected:
+    /// Helper method: Executes the house simulation
+    void executeHouse( uint32_t elapsedSeconds ) noexcept;
+
+    /// Helper method: Updates the statistics
+    void updateStats() noexcept;
+
+protected:
+    /// Configuration
+    const Scenario::Group_T&    m_config;
+
+    /// Outdoor temperature profile
+    const Scenario::Profile_T&  m_profile;
+
+    /// Model Database (MUST be declared before the model points)
+    Cpl::Dm::ModelDatabase      m_modelDb;
+
+public:
+    // Model Points (see Storm/Thermostat/ModelPoints.h for descriptions)
+    Storm::Dm::MpSetpoints              mp_setpoints;               //!< Model Point
+    Storm::Dm::MpThermostatMode         mp_userMode;                //!< Model Point
+    Storm::Dm::MpFanMode                mp_fanMode;                 //!< Model Point
+    Cpl::Dm::Mp::Uint32                 mp_maxAirFilterHours;       //!< Model Point
+    Cpl::Dm::Mp::Float                  mp_primaryRawIdt;           //!< Model Point
+    Cpl::Dm::Mp::Float                  mp_secondaryRawIdt;         //!< Model Point
+    Cpl::Dm::Mp::Float                  mp_activeIdt;               //!< Model Point
+    Cpl::Dm::Mp::Float                  mp_outdoorTemp;             //!< Model Point
+    Storm::Dm::MpHvacRelayOutputs       mp_relayOutputs;            //!< Model Point
+    Storm::Dm::MpIdtAlarm               mp_idtAlarms;               //!< Model Point
+    Storm::Dm::MpSimpleAlarm            mp_noActiveConditioningAlarm;   //!< Model Point
+    Storm::Dm::MpSimpleAlarm            mp_userCfgModeAlarm;        //!< Model Point
+    Storm::Dm::MpSimpleAlarm            mp_airFilterAlert;          //!< Model Point
+    Cpl::Dm::Mp::Bool                   mp_enabledSecondaryIdt;     //!< Model Point
+    Storm::Dm::MpEquipmentConfig        mp_equipmentConfig;         //!< Model Point
+    Storm::Dm::MpComfortConfig          mp_comfortConfig;           //!< Model Point
+    Cpl::Dm::Mp::RefCounter             mp_systemForcedOffRefCnt;   //!< Model Point
+    Storm::Dm::MpSystemConfig           mp_systemConfig;            //!< Model Point
+    Cpl::Dm::Mp::Bool                   mp_systemOn;                //!< Model Point
+    Storm::Dm::MpEquipmentBeginTimes    mp_equipmentBeginTimes;     //!< Model Point
+    Cpl::Dm::Mp::Bool                   mp_resetPiPulse;            //!< Model Point
+    Cpl::Dm::Mp::Bool                   mp_operatingModeChanged;    //!< Model Point
+    Cpl::Dm::Mp::Float                  mp_deltaIdtError;           //!< Model Point
+    Cpl::Dm::Mp::Float                  mp_deltaSetpoint;           //!< Model Point
+    Cpl::Dm::Mp::Bool                   mp_setpointChanged;         //!< Model Point
+    Cpl::Dm::Mp::Float                  mp_activeSetpoint;          //!< Model Point
+    Cpl::Dm::Mp::RefCounter             mp_freezePiRefCnt;          //!< Model Point
+    Cpl::Dm::Mp::RefCounter             mp_inhibitfRefCnt;          //!< Model Point
+    Cpl::Dm::Mp::Float                  mp_pvOut;                   //!< Model Point
+    Cpl::Dm::Mp::Float                  mp_sumError;                //!< Model Point
+    Cpl::Dm::Mp::Bool                   mp_pvInhibited;             //!< Model Point
+    Storm::Dm::MpVirtualOutputs         mp_vOutputs;                //!< Model Point
+    Storm::Dm::MpCycleInfo              mp_cycleInfo;               //!< Model Point
+    Cpl::Dm::Mp::Uint32                 mp_loopCounter;             //!< Model Point
+    Cpl::Dm::Mp::ElapsedPrecisionTime   mp_airFilterOperationTime;  //!< Model Point
+    Storm::Dm::MpWhiteBox               mp_whiteBox;                //!< Model Point
+
+protected:
+    /// Component
+    Storm::Component::IdtSelection      m_idtSelection;
+
+    /// Component
+    Storm::Component::OperatingMode     m_operatingMode;
+
+    /// Component
+    Storm::Component::PiPreProcess      m_piPreProcess;
+
+    /// Component
+    Storm::Component::Pi                m_pi;
+
+    /// Component
+    Storm::Component::Control           m_controlCooling;
+
+    /// Component
+    Storm::Component::Control           m_controlIdHeating;
+
+    /// Component
+    Storm::Component::Control           m_controlOff;
+
+    /// Component
+    Storm::Component::FanControl        m_fanControl;
+
+    /// Component
+    Storm::Component::AirFilterMonitor  m_airFilterMonitor;
+
+    /// Component
+    Storm::Component::HvacRelayOutputs  m_hvacRelayOutputs;
+
+    /// Cooling stage
+    Storm::Component::Equipment::Stage::BasicCooling    m_stage1Cooling;
+
+    /// Indoor Heating stage
+    Storm::Component::Equipment::Stage::BasicIndoorHeat m_stage1IndoorHeat;
+
+    /// Indoor Heating stage
+    Storm::Component::Equipment::Stage::BasicIndoorHeat m_stage2IndoorHeat;
+
+    /// Indoor Heating stage
+    Storm::Component::Equipment::Stage::BasicIndoorHeat m_stage3IndoorHeat;
+
+    /// Equipment
+    Storm::Component::Equipment::Cooling        m_equipmentCooling;
+
+    /// Equipment
+    Storm::Component::Equipment::IndoorHeating  m_equipmentIndoorHeating;
+
+    /// Equipment
+    Storm::Component::Equipment::Off            m_equipmentOff;
+
+    /// House simulation
+    Storm::Utils::SimHouse      m_house;
+
+    /// Statistics
+    Stats_T                     m_stats;
+
+    /// Start time of the current on cycle
+    uint32_t                    m_onCycleStart;
+
+    /// Current virtual time
+    uint32_t                    m_now;
+
+    /// Current (first stage) equipment state
+    bool                        m_equipmentOn;
+};
+
+
+};      // end namespaces
+};
+};
+#endif  // end header latch
@@ -0,0 +1,332 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+
+#include "Scenario.h"
+#include "Storm/Type/ThermostatMode.h"
+#include "Storm/Type/IduType.h"
+#include "Storm/Type/OduType.h"
+#include "Storm/Type/Cph.h"
+#include "Cpl/Io/File/Input.h"
+#include "Cpl/Io/LineReader.h"
+#include "Cpl/Text/atob.h"
+#include <string.h>
+
+using namespace Storm::Thermostat::SimFarm;
+
+
+///////////////////////////////
+float Scenario::Profile_T::getOdt( uint32_t elapsedSeconds ) const noexcept
+{
+    if ( numSamples == 0 )
+    {
+        return 0.0F;
+    }
+
+    // The profile repeats after the last sample, i.e. interpolate between the last and first sample
+    uint32_t periodSec = secondsPerSample * numSamples;
+    uint32_t offset    = elapsedSeconds % periodSec;
+    unsigned idx       = offset / secondsPerSample;
+    unsigned nextIdx   = idx + 1 < numSamples ? idx + 1 : 0;
+    float    fraction  = ( offset % secondsPerSample ) / (float) secondsPerSample;
+    return odt[idx] + ( odt[nextIdx] - odt[idx] ) * fraction;
+}
+
+///////////////////////////////
+Scenario::Scenario() noexcept
+{
+    clear();
+}
+
+void Scenario::clear() noexcept
+{
+    m_durationSec = 0;
+    m_numProfiles = 0;
+    m_numGroups   = 0;
+}
+
+unsigned Scenario::getNumInstances() const noexcept
+{
+    unsigned total = 0;
+    for ( unsigned i=0; i < m_numGroups; i++ )
+    {
+        total += m_groups[i].count;
+    }
+    return total;
+}
+
+///////////////////////////////
+bool Scenario::load( const char* fileName, Cpl::Text::String* errorMsg ) noexcept
+{
+    Cpl::Io::File::Input fd( fileName );
+    if ( !fd.isOpened() )
+    {
+        if ( errorMsg )
+        {
+            errorMsg->format( "Unable to open scenario file: %s", fileName );
+        }
+        return false;
+    }
+
+    return parse( fd, errorMsg );
+}
+
+bool Scenario::parse( Cpl::Io::Input& src, Cpl::Text::String* errorMsg ) noexcept
+{
+    clear();
+    Cpl::Io::LineReader                                         reader( src );
+    Cpl::Text::FString<OPTION_STORM_THERMOSTAT_SIM_FARM_MAX_LINE_LEN> line;
+    unsigned                                                    lineNum = 0;
+    bool                                                        io      = true;
+    while ( io )
+    {
+        // Note: The last line of the file is not required to have a newline
+        io = reader.readln( line );
+        if ( !io && line.isEmpty() )
+        {
+            break;
+        }
+        lineNum++;
+
+        if ( line.truncated() )
+        {
+            if ( errorMsg )
+            {
+                errorMsg->format( "line %u: Line is too long (max=%d)", lineNum, OPTION_STORM_THERMOSTAT_SIM_FARM_MAX_LINE_LEN );
+            }
+            return false;
+        }
+
+        int   maxLen;
+        char* buffer = line.getBuffer( maxLen );
+        if ( !parseLine( buffer, errorMsg ) )
+        {
+            if ( errorMsg )
+            {
+                Cpl::Text::FString<OPTION_STORM_THERMOSTAT_SIM_FARM_MAX_LINE_LEN> msg = *errorMsg;
+                errorMsg->format( "line %u: %s", lineNum, msg.getString() );
+            }
+            return false;
+        }
+    }
+
+    // A scenario must simulate 'something'
+    if ( m_durationSec == 0 || m_numGroups == 0 )
+    {
+        if ( errorMsg )
+        {
+            errorMsg->format( "Missing 'duration' and/or 'instances' directives" );
+        }
+        return false;
+    }
+
+    return true;
+}
+
+bool Scenario::parseLine( char* line, Cpl::Text::String* errorMsg ) noexcept
+{
+    Cpl::Text::Tokenizer::Basic tokens( line );
+    const char*                 directive = tokens.next();
+
+    // Skip blank lines and comments
+    if ( directive == 0 || *directive == '#' )
+    {
+        return true;
+    }
+
+    if ( strcmp( directive, "duration" ) == 0 )
+    {
+        float hours;
+        if ( !nextFloat( tokens, hours ) || hours <= 0.0F || tokens.next() != 0 )
+        {
+            if ( errorMsg )
+            {
+                errorMsg->format( "Invalid 'duration' directive" );
+            }
+            return false;
+        }
+        m_durationSec = (uint32_t) ( hours * 60.0F * 60.0F );
+        return true;
+    }
+
+    if ( strcmp( directive, "profile" ) == 0 )
+    {
+        return parseProfile( tokens, errorMsg );
+    }
+
+    if ( strcmp( directive, "instances" ) == 0 )
+    {
+        return parseInstances( tokens, errorMsg );
+    }
+
+    if ( errorMsg )
+    {
+        errorMsg->format( "Unknown directive (%s)", directive );
+    }
+    return false;
+}
+
+bool Scenario::parseProfile( Cpl::Text::Tokenizer::Basic& tokens, Cpl::Text::String* errorMsg ) noexcept
+{
+    if ( m_numProfiles >= OPTION_STORM_THERMOSTAT_SIM_FARM_MAX_PROFILES )
+    {
+        if ( errorMsg )
+        {
+            errorMsg->format( "Too many profiles (max=%d)", OPTION_STORM_THERMOSTAT_SIM_FARM_MAX_PROFILES );
+        }
+        return false;
+    }
+
+    Profile_T&    profile = m_profiles[m_numProfiles];
+    const char*   name    = tokens.next();
+    unsigned long minutes;
+    if ( name == 0 || !nextUnsigned( tokens, minutes ) || minutes == 0 )
+    {
+        if ( errorMsg )
+        {
+            errorMsg->format( "Invalid 'profile' directive" );
+        }
+        return false;
+    }
+    profile.name             = name;
+    profile.secondsPerSample = (uint32_t) ( minutes * 60 );
+    profile.numSamples       = 0;
+
+    const char* token;
+    while ( ( token = tokens.next() ) != 0 )
+    {
+        double odt;
+        if ( profile.numSamples >= OPTION_STORM_THERMOSTAT_SIM_FARM_MAX_PROFILE_SAMPLES || !Cpl::Text::a2d( odt, token ) )
+        {
+            if ( errorMsg )
+            {
+                errorMsg->format( "Invalid profile sample (%s) or too many samples (max=%d)", token, OPTION_STORM_THERMOSTAT_SIM_FARM_MAX_PROFILE_SAMPLES );
+            }
+            return false;
+        }
+        profile.odt[profile.numSamples++] = (float) odt;
+    }
+
+    if ( profile.numSamples == 0 )
+    {
+        if ( errorMsg )
+        {
+            errorMsg->format( "Profile (%s) has no samples", name );
+        }
+        return false;
+    }
+
+    m_numProfiles++;
+    return true;
+}
+
+bool Scenario::parseInstances( Cpl::Text::Tokenizer::Basic& tokens, Cpl::Text::String* errorMsg ) noexcept
+{
+    if ( m_numGroups >= OPTION_STORM_THERMOSTAT_SIM_FARM_MAX_GROUPS )
+    {
+        if ( errorMsg )
+        {
+            errorMsg->format( "Too many 'instances' directives (max=%d)", OPTION_STORM_THERMOSTAT_SIM_FARM_MAX_GROUPS );
+        }
+        return false;
+    }
+
+    Group_T&      group = m_groups[m_numGroups];
+    unsigned long count, compressorStages, indoorStages, minOn, minOff;
+    const char*   profileName;
+    const char*   mode;
+    const char*   idu;
+    const char*   odu;
+    const char*   cph;
+    if ( !nextUnsigned( tokens, count ) ||
+         ( profileName = tokens.next() ) == 0 ||
+         ( mode = tokens.next() ) == 0 ||
+         !nextFloat( tokens, group.coolSetpoint ) ||
+         !nextFloat( tokens, group.heatSetpoint ) ||
+         !nextUnsigned( tokens, compressorStages ) ||
+         !nextUnsigned( tokens, indoorStages ) ||
+         ( idu = tokens.next() ) == 0 ||
+         ( odu = tokens.next() ) == 0 ||
+         ( cph = tokens.next() ) == 0 ||
+         !nextUnsigned( tokens, minOn ) ||
+         !nextUnsigned( tokens, minOff ) ||
+         tokens.next() != 0 )
+    {
+        if ( errorMsg )
+        {
+            errorMsg->format( "Invalid 'instances' directive" );
+        }
+        return false;
+    }
+
+    // Look-up the profile
+    unsigned idx;
+    for ( idx=0; idx < m_numProfiles; idx++ )
+    {
+        if ( m_profiles[idx].name == profileName )
+        {
+            break;
+        }
+    }
+    if ( idx == m_numProfiles )
+    {
+        if ( errorMsg )
+        {
+            errorMsg->format( "Unknown profile (%s)", profileName );
+        }
+        return false;
+    }
+
+    // Convert the enums
+    auto maybeMode = Storm::Type::ThermostatMode::_from_string_nothrow( mode );
+    auto maybeIdu  = Storm::Type::IduType::_from_string_nothrow( idu );
+    auto maybeOdu  = Storm::Type::OduType::_from_string_nothrow( odu );
+    auto maybeCph  = Storm::Type::Cph::_from_string_nothrow( cph );
+    if ( !maybeMode || !maybeIdu || !maybeOdu || !maybeCph || *maybeCph == +Storm::Type::Cph::eNUM_OPTIONS )
+    {
+        if ( errorMsg )
+        {
+            errorMsg->format( "Invalid enum value(s): mode=%s, idu=%s, odu=%s, cph=%s", mode, idu, odu, cph );
+        }
+        return false;
+    }
+
+    group.count                = (unsigned) count;
+    group.profileIndex         = idx;
+    group.thermostatMode       = *maybeMode;
+    group.numCompressorStages  = (uint16_t) compressorStages;
+    group.numIndoorStages      = (uint16_t) indoorStages;
+    group.iduType              = *maybeIdu;
+    group.oduType              = *maybeOdu;
+    group.comfort.cph          = *maybeCph;
+    group.comfort.minOnTime    = (uint32_t) minOn;
+    group.comfort.minOffTime   = (uint32_t) minOff;
+    m_numGroups++;
+    return true;
+}
+
+///////////////////////////////
+bool Scenario::nextFloat( Cpl::Text::Tokenizer::Basic& tokens, float& value ) noexcept
+{
+    double      temp;
+    const char* token = tokens.next();
+    if ( token == 0 || !Cpl::Text::a2d( temp, token ) )
+    {
+        return false;
+    }
+    value = (float) temp;
+    return true;
+}
+
+bool Scenario::nextUnsigned( Cpl::Text::Tokenizer::Basic& tokens, unsigned long& value ) noexcept
+{
+    const char* token = tokens.next();
+    return token != 0 && Cpl::Text::a2ul( value, token );
+}
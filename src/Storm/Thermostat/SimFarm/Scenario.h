@@ -0,0 +1,204 @@
+#ifndef Storm_Thermostat_SimFarm_Scenario_h_
+#define Storm_Thermostat_SimFarm_Scenario_h_
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+/** @file */
+
+#include "colony_config.h"
+#include "Storm/Type/ComfortConfig.h"
+#include "Cpl/Io/Input.h"
+#include "Cpl/Text/FString.h"
+#include "Cpl/Text/Tokenizer/Basic.h"
+#include <stdint.h>
+
+
+/// Maximum number of outdoor temperature profiles in a scenario
+#ifndef OPTION_STORM_THERMOSTAT_SIM_FARM_MAX_PROFILES
+#define OPTION_STORM_THERMOSTAT_SIM_FARM_MAX_PROFILES           16
+#endif
+
+/// Maximum number of samples in an outdoor temperature profile
+#ifndef OPTION_STORM_THERMOSTAT_SIM_FARM_MAX_PROFILE_SAMPLES
+#define OPTION_STORM_THERMOSTAT_SIM_FARM_MAX_PROFILE_SAMPLES    (24*4)
+#endif
+
+/// Maximum number of instance groups in a scenario
+#ifndef OPTION_STORM_THERMOSTAT_SIM_FARM_MAX_GROUPS
+#define OPTION_STORM_THERMOSTAT_SIM_FARM_MAX_GROUPS             64
+#endif
+
+/// Maximum length of a profile name
+#ifndef OPTION_STORM_THERMOSTAT_SIM_FARM_MAX_NAME_LEN
+#define OPTION_STORM_THERMOSTAT_SIM_FARM_MAX_NAME_LEN           31
+#endif
+
+/// Maximum length of a line in a scenario file
+#ifndef OPTION_STORM_THERMOSTAT_SIM_FARM_MAX_LINE_LEN
+#define OPTION_STORM_THERMOSTAT_SIM_FARM_MAX_LINE_LEN           1024
+#endif
+
+
+///
+namespace Storm {
+///
+namespace Thermostat {
+///
+namespace SimFarm {
+
+
+/** This class contains the content of a simulation farm scenario, i.e. the
+    outdoor temperature profiles, the simulated run time, and the equipment
+    configuration of the thermostat+house instances.
+
+    A scenario file is a text file with one directive per line.  Tokens are
+    separated by white space, blank lines and lines starting with '#' are
+    ignored.  The supported directives are:
+
+        duration <hours>
+            The amount of simulated time, e.g. 'duration 24' simulates a day.
+
+        profile <name> <minutesPerSample> <odt0> <odt1> ... <odtN>
+            An outdoor temperature (in degrees Fahrenheit) profile.  The
+            temperature is linearly interpolated between samples, and the
+            profile repeats after the last sample (i.e. 24 samples with 60
+            minutes per sample is a daily profile).
+
+        instances <count> <profile> <thermostatMode> <coolSetpoint> <heatSetpoint>
+                  <compressorStages> <indoorStages> <iduType> <oduType> <cph>
+                  <minOnSec> <minOffSec>
+            Creates 'count' thermostat+house instances that use the specified
+            profile and equipment configuration.  The thermostat mode, IDU
+            type, ODU type, and CPH fields are the Storm::Type enum names, e.g.
+            'eCOOLING', 'eFURNACE', 'eAC', 'e3CPH'.  The CPH, minimum on time,
+            and minimum off time are applied to all operating modes.
+
+    Example:
+        duration 24
+        profile  summer 60 75 74 73 73 74 76 79 83 87 90 93 95 96 97 97 96 94 91 88 85 82 80 78 76
+        instances 100 summer eCOOLING 75 68 1 1 eFURNACE eAC e3CPH 300 300
+ */
+class Scenario
+{
+public:
+    /// Outdoor temperature profile
+    struct Profile_T
+    {
+        /// Profile name
+        Cpl::Text::FString<OPTION_STORM_THERMOSTAT_SIM_FARM_MAX_NAME_LEN> name;
+
+        /// Time, in seconds, between samples
+        uint32_t    secondsPerSample;
+
+        /// Number of samples
+        unsigned    numSamples;
+
+        /// Outdoor temperature samples
+        float       odt[OPTION_STORM_THERMOSTAT_SIM_FARM_MAX_PROFILE_SAMPLES];
+
+        /// Returns the (interpolated) outdoor temperature at the specified simulated time
+        float getOdt( uint32_t elapsedSeconds ) const noexcept;
+    };
+
+    /// Group of instances with the same configuration
+    struct Group_T
+    {
+        unsigned    count;                  //!< Number of instances in the group
+        unsigned    profileIndex;           //!< Index of the group's outdoor temperature profile
+        int         thermostatMode;         //!< The actual type is: Storm::Type::ThermostatMode
+        float       coolSetpoint;           //!< Cooling set-point in degrees Fahrenheit
+        float       heatSetpoint;           //!< Heating set-point in degrees Fahrenheit
+        uint16_t    numCompressorStages;    //!< Number of compressor stages
+        uint16_t    numIndoorStages;        //!< Number of indoor heating stages
+        int         iduType;                //!< The actual type is: Storm::Type::IduType
+        int         oduType;                //!< The actual type is: Storm::Type::OduType
+        Storm::Type::ComfortStageParameters_T comfort;  //!< Comfort settings (applied to all operating modes)
+    };
+
+public:
+    /// Constructor.  Creates an empty scenario
+    Scenario() noexcept;
+
+public:
+    /** This method parses a scenario file.  Any previous content is discarded.
+        Returns true if successful; else false is returned and an optional
+        error message (that includes the offending line number) is returned
+        via 'errorMsg'.
+     */
+    bool load( const char* fileName, Cpl::Text::String* errorMsg=0 ) noexcept;
+
+    /** Same as load(), except the scenario is read from the specified stream
+     */
+    bool parse( Cpl::Io::Input& src, Cpl::Text::String* errorMsg=0 ) noexcept;
+
+    /** This method parses a single (NULL terminated) scenario line. The
+        content of 'line' is modified. Returns true if successful; else
+        false is returned and an optional error message is returned via
+        'errorMsg'.
+     */
+    bool parseLine( char* line, Cpl::Text::String* errorMsg=0 ) noexcept;
+
+    /// Discards the current content
+    void clear() noexcept;
+
+public:
+    /// Returns the simulated run time in seconds
+    inline uint32_t getDurationSeconds() const noexcept { return m_durationSec; }
+
+    /// Returns the number of profiles
+    inline unsigned getNumProfiles() const noexcept { return m_numProfiles; }
+
+    /// Returns the Nth profile.  Note: 'index' is NOT range checked
+    inline const Profile_T& getProfile( unsigned index ) const noexcept { return m_profiles[index]; }
+
+    /// Returns the number of instance groups
+    inline unsigned getNumGroups() const noexcept { return m_numGroups; }
+
+    /// Returns the Nth group.  Note: 'index' is NOT range checked
+    inline const Group_T& getGroup( unsigned index ) const noexcept { return m_groups[index]; }
+
+    /// Returns the total number of instances (across all groups)
+    unsigned getNumInstances() const noexcept;
+
+protected:
+    /// Helper method
+    bool parseProfile( Cpl::Text::Tokenizer::Basic& tokens, Cpl::Text::String* errorMsg ) noexcept;
+
+    /// Helper method
+    bool parseInstances( Cpl::Text::Tokenizer::Basic& tokens, Cpl::Text::String* errorMsg ) noexcept;
+
+    /// Helper method: converts the next token to a float
+    static bool nextFloat( Cpl::Text::Tokenizer::Basic& tokens, float& value ) noexcept;
+
+    /// Helper method: converts the next token to an unsigned long
+    static bool nextUnsigned( Cpl::Text::Tokenizer::Basic& tokens, unsigned long& value ) noexcept;
+
+protected:
+    /// Simulated run time
+    uint32_t    m_durationSec;
+
+    /// Number of profiles
+    unsigned    m_numProfiles;
+
+    /// Number of groups
+    unsigned    m_numGroups;
+
+    /// Profiles
+    Profile_T   m_profiles[OPTION_STORM_THERMOSTAT_SIM_FARM_MAX_PROFILES];
+
+    /// Groups
+    Group_T     m_groups[OPTION_STORM_THERMOSTAT_SIM_FARM_MAX_GROUPS];
+};
+
+
+};      // end namespaces
+};
+};
+#endif  // end header latch
@@ -0,0 +1,216 @@
+/*-----------------------------------------------------------------------------
+* This file is part of the Colony.Core Project.  The Colony.Core Project is an
+* open source project with a BSD type of licensing agreement.  See the license
+* agreement (license.txt) in the top/ directory or on the Internet at
+* http://integerfox.com/colony.core/license.txt
+*
+* Copyright (c) 2014-2022  John T. Taylor
+*
+* Redistributions of the source code must retain the above copyright notice.
+*----------------------------------------------------------------------------*/
+
+#include "Catch/catch.hpp"
+#include "Storm/Thermostat/SimFarm/Farm.h"
+#include "Cpl/System/_testsupport/Shutdown_TS.h"
+#include "Cpl/System/Trace.h"
+#include "Cpl/Io/File/Api.h"
+#include "Cpl/Io/File/Input.h"
+#include "Cpl/Io/File/Output.h"
+#include "Cpl/Io/LineReader.h"
+#include "Cpl/Math/real.h"
+#include <string.h>
+
+using namespace Storm::Thermostat::SimFarm;
+
+#define SECT_           "_0test"
+
+#define SCENARIO_FILE_  "scenario.txt"
+#define RESULTS_FILE_   "results.csv"
+
+static const char* scenario_ =
+"# Test scenario\n"
+"duration 6\n"
+"profile summer 60 85 88 92 95 97 95\n"
+"profile winter 60 20 18 15 12 15 20\n"
+"\n"
+"instances 2 summer eCOOLING 75 68 1 1 eFURNACE eAC e3CPH 300 300\n"
+"instances 1 summer eCOOLING 75 68 1 1 eFURNACE eAC e6CPH 180 180\n"
+"instances 2 winter eHEATING 78 68 0 2 eFURNACE eAC e3CPH 300 300\n"
+"instances 1 winter eID_HEATING 78 70 1 1 eFURNACE eAC e5CPH 300 300";   // No trailing newline
+
+
+static void writeFile( const char* fname, const char* content )
+{
+    Cpl::Io::File::Output fd( fname, true, true );
+    REQUIRE( fd.isOpened() );
+    REQUIRE( fd.write( content ) );
+}
+
+static bool parseLine( Scenario& uut, const char* line, Cpl::Text::String* errorMsg=0 )
+{
+    Cpl::Text::FString<OPTION_STORM_THERMOSTAT_SIM_FARM_MAX_LINE_LEN> buffer( line );
+    int   maxLen;
+    char* ptr = buffer.getBuffer( maxLen );
+    return uut.parseLine( ptr, errorMsg );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TEST_CASE( "SimFarm" )
+{
+    Cpl::System::Shutdown_TS::clearAndUseCounter();
+    Cpl::Text::FString<256> errMsg;
+
+    SECTION( "profile" )
+    {
+        Scenario uut;
+        REQUIRE( parseLine( uut, "profile bob 1 10 20 40" ) );
+        REQUIRE( uut.getNumProfiles() == 1 );
+        const Scenario::Profile_T& profile = uut.getProfile( 0 );
+        REQUIRE( profile.name == "bob" );
+        REQUIRE( profile.numSamples == 3 );
+        REQUIRE( Cpl::Math::areFloatsEqual( profile.getOdt( 0 ), 10.0F ) );
+        REQUIRE( Cpl::Math::areFloatsEqual( profile.getOdt( 30 ), 15.0F ) );
+        REQUIRE( Cpl::Math::areFloatsEqual( profile.getOdt( 60 ), 20.0F ) );
+        REQUIRE( Cpl::Math::areFloatsEqual( profile.getOdt( 150 ), 25.0F ) ); // Wraps from the last sample to the first sample
+        REQUIRE( Cpl::Math::areFloatsEqual( profile.getOdt( 180 ), 10.0F ) );
+    }
+
+    SECTION( "parse errors" )
+    {
+        Scenario uut;
+        REQUIRE( parseLine( uut, "   # comment" ) );
+        REQUIRE( parseLine( uut, "" ) );
+        REQUIRE( parseLine( uut, "bob 1 2 3", &errMsg ) == false );
+        CPL_SYSTEM_TRACE_MSG( SECT_, ( "errMsg=%s", errMsg.getString() ) );
+        REQUIRE( parseLine( uut, "duration", &errMsg ) == false );
+        REQUIRE( parseLine( uut, "duration 0" ) == false );
+        REQUIRE( parseLine( uut, "profile bob 60" ) == false );
+        REQUIRE( parseLine( uut, "profile bob 60 12 abc" ) == false );
+        REQUIRE( parseLine( uut, "instances 1 bob eCOOLING 75 68 1 1 eFURNACE eAC e3CPH 300 300", &errMsg ) == false );
+        CPL_SYSTEM_TRACE_MSG( SECT_, ( "errMsg=%s", errMsg.getString() ) );
+        REQUIRE( parseLine( uut, "profile bob 60 12 13" ) );
+        REQUIRE( parseLine( uut, "instances 1 bob eBOB 75 68 1 1 eFURNACE eAC e3CPH 300 300", &errMsg ) == false );
+        CPL_SYSTEM_TRACE_MSG( SECT_, ( "errMsg=%s", errMsg.getString() ) );
+        REQUIRE( parseLine( uut, "instances 1 bob eCOOLING 75 68 1 1 eFURNACE eAC eNUM_OPTIONS 300 300" ) == false );
+        REQUIRE( parseLine( uut, "instances 1 bob eCOOLING 75 68 1 1 eFURNACE eAC e3CPH 300" ) == false );
+        REQUIRE( parseLine( uut, "instances 1 bob eCOOLING 75 68 1 1 eFURNACE eAC e3CPH 300 300 1" ) == false );
+        REQUIRE( parseLine( uut, "instances 3 bob eCOOLING 75 68 1 1 eFURNACE eAC e3CPH 300 300" ) );
+        REQUIRE( uut.getNumInstances() == 3 );
+
+        // Missing duration
+        writeFile( SCENARIO_FILE_, "profile bob 60 12 13\ninstances 1 bob eCOOLING 75 68 1 1 eFURNACE eAC e3CPH 300 300\n" );
+        REQUIRE( uut.load( SCENARIO_FILE_, &errMsg ) == false );
+        CPL_SYSTEM_TRACE_MSG( SECT_, ( "errMsg=%s", errMsg.getString() ) );
+
+        // Error line number
+        writeFile( SCENARIO_FILE_, "duration 1\n\nprofile bob\n" );
+        REQUIRE( uut.load( SCENARIO_FILE_, &errMsg ) == false );
+        CPL_SYSTEM_TRACE_MSG( SECT_, ( "errMsg=%s", errMsg.getString() ) );
+        REQUIRE( errMsg.startsWith( "line 3:" ) );
+
+        REQUIRE( uut.load( "file-does-not-exist.txt", &errMsg ) == false );
+    }
+
+    SECTION( "run" )
+    {
+        writeFile( SCENARIO_FILE_, scenario_ );
+        Scenario scenario;
+        REQUIRE( scenario.load( SCENARIO_FILE_, &errMsg ) );
+        REQUIRE( scenario.getDurationSeconds() == 6 * 60 * 60 );
+        REQUIRE( scenario.getNumProfiles() == 2 );
+        REQUIRE( scenario.getNumGroups() == 4 );
+        REQUIRE( scenario.getNumInstances() == 6 );
+
+        Farm single( scenario, 1 );
+        Farm multi( scenario, 4, 10 * 60 );
+        REQUIRE( single.run() );
+        REQUIRE( multi.run() );
+        CPL_SYSTEM_TRACE_MSG( SECT_, ( "run times: single=%lu ms, multi=%lu ms", single.getRunTimeMs(), multi.getRunTimeMs() ) );
+        REQUIRE( single.getNumInstances() == 6 );
+        REQUIRE( multi.getNumInstances() == 6 );
+
+        for ( unsigned i=0; i < single.getNumInstances(); i++ )
+        {
+            const Instance::Stats_T& stats = single.getInstance( i ).getStats();
+            CPL_SYSTEM_TRACE_MSG( SECT_, ( "#%u: cycles=%lu, cph=%.2f, duty=%.2f, minOn=%lu, meanErr=%.3f, maxErr=%.3f, outside=%lu, idt=[%.2f, %.2f]",
+                                           i,
+                                           (unsigned long) stats.numOnCycles,
+                                           stats.cyclesPerHour(),
+                                           stats.dutyCycle(),
+                                           (unsigned long) stats.shortestOnCycleSec,
+                                           stats.meanAbsError(),
+                                           stats.maxAbsError,
+                                           (unsigned long) stats.secondsOutsideBand,
+                                           stats.minIdt,
+                                           stats.maxIdt ) );
+
+            // Every instance actively conditions the house and holds the set-point
+            REQUIRE( stats.simulatedSeconds == scenario.getDurationSeconds() );
+            REQUIRE( stats.numOnCycles > 0 );
+            REQUIRE( stats.onTimeSeconds > 0 );
+            REQUIRE( stats.comfortSamples > 0 );
+            REQUIRE( stats.meanAbsError() < 2.0 );
+            REQUIRE( stats.shortestOnCycleSec >= single.getInstance( i ).getConfig().comfort.minOnTime );
+
+            // The results do not depend on the number of workers or the epoch size
+            const Instance::Stats_T& other = multi.getInstance( i ).getStats();
+            REQUIRE( memcmp( &stats, &other, sizeof( stats ) ) == 0 );
+        }
+
+        // Identical configurations produce identical results
+        REQUIRE( memcmp( &single.getInstance( 0 ).getStats(), &single.getInstance( 1 ).getStats(), sizeof( Instance::Stats_T ) ) == 0 );
+
+        // Results file: header + one line per instance
+        REQUIRE( single.writeStats( RESULTS_FILE_ ) );
+        Cpl::Io::File::Input    fd( RESULTS_FILE_ );
+        Cpl::Io::LineReader     reader( fd );
+        Cpl::Text::FString<512> line;
+        unsigned                numLines = 0;
+        while ( reader.readln( line ) )
+        {
+            if ( numLines == 0 )
+            {
+                REQUIRE( line.startsWith( "id,profile,mode," ) );
+            }
+            else if ( numLines == 1 )
+            {
+                REQUIRE( line.startsWith( "0,summer,eCOOLING," ) );
+            }
+            numLines++;
+        }
+        fd.close();
+        REQUIRE( numLines == 7 );
+        Cpl::Io::File::Api::remove( RESULTS_FILE_ );
+    }
+
+    Cpl::Io::File::Api::remove( SCENARIO_FILE_ );
+    REQUIRE( Cpl::System::Shutdown_TS::getAndClearCounter() == 0u );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+#define BENCH_NUM_INSTANCES_    256
+
+TEST_CASE( "SimFarm-bench", "[.bench]" )
+{
+    Scenario scenario;
+    char     line[OPTION_STORM_THERMOSTAT_SIM_FARM_MAX_LINE_LEN];
+    strcpy( line, "duration 24" );
+    REQUIRE( scenario.parseLine( line ) );
+    strcpy( line, "profile summer 60 75 74 73 73 74 76 79 83 87 90 93 95 96 97 97 96 94 91 88 85 82 80 78 76" );
+    REQUIRE( scenario.parseLine( line ) );
+    snprintf( line, sizeof( line ), "instances %d summer eCOOLING 75 68 1 1 eFURNACE eAC e3CPH 300 300", BENCH_NUM_INSTANCES_ );
+    REQUIRE( scenario.parseLine( line ) );
+
+    static const unsigned numWorkers[] = { 1, 2, 4, 8 };
+    for ( unsigned i=0; i < sizeof( numWorkers ) / sizeof( numWorkers[0] ); i++ )
+    {
+        Farm uut( scenario, numWorkers[i] );
+        REQUIRE( uut.run() );
+        double simHours = ( (double) scenario.getDurationSeconds() * uut.getNumInstances() ) / 3600.0;
+        CPL_SYSTEM_TRACE_MSG( SECT_, ( "workers=%u: %u instances x 24h in %lu ms (%.0f simulated hours/sec)",
+                                       numWorkers[i],
+                                       uut.getNumInstances(),
+                                       uut.getRunTimeMs(),
+                                       simHours * 1000.0 / ( uut.getRunTimeMs() ? uut.getRunTimeMs() : 1 ) ) );
+    }
+}
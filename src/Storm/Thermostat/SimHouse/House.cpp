@@ -68,70 +68,8 @@ void House::executeSimulation()
          mp_relayOutputs.read( relays ) == true &&
          mp_houseSimEnabled.read( simEnabled ) == true && simEnabled )
     {
-        double capacity = 0.0;
-        bool   cooling  = true;
-
-        // Cooling capacity
-        if ( sysCfg.currentOpMode == Storm::Type::OperatingMode::eCOOLING && sysCfg.numCompressorStages != 0 )
-        {
-            double stageCapacity = 1.0 / sysCfg.numCompressorStages;
-            capacity += relays.y1 ? stageCapacity : 0.0;
-            if ( sysCfg.numCompressorStages > 1 )
-            {
-                capacity += relays.y2 ? stageCapacity : 0.0;
-            }
-        }
-
-        // Compressor + Indoor Heating capacity
-        else if ( sysCfg.currentOpMode == Storm::Type::OperatingMode::eHEATING )
-        {
-            cooling = false;
-
-            // HeatPump with Electric heat
-            if ( sysCfg.indoorUnitType == Storm::Type::IduType::eAIR_HANDLER && (sysCfg.numCompressorStages + sysCfg.numIndoorStages != 0) )
-            {
-                double stageCapacity = 1.0 / (sysCfg.numCompressorStages + sysCfg.numIndoorStages);
-                capacity += relays.y1 ? stageCapacity : 0.0;
-                if ( sysCfg.numCompressorStages > 1 )
-                {
-                    capacity += relays.y2 ? stageCapacity : 0.0;
-                }
-                if ( sysCfg.numIndoorStages > 0 )
-                {
-                    capacity += relays.w1 ? stageCapacity : 0.0;
-                }
-                if ( sysCfg.numIndoorStages > 1 )
-                {
-                    capacity += relays.w2 ? stageCapacity : 0.0;
-                }
-                if ( sysCfg.numIndoorStages > 2 )
-                {
-                    capacity += relays.w3 ? stageCapacity : 0.0;
-                }
-            }
-
-            // DUAL fuel
-            else  if ( sysCfg.indoorUnitType == Storm::Type::IduType::eFURNACE && sysCfg.numCompressorStages != 0 )
-            {
-                // TODO
-            }
-        }
-
-        // Indoor Heating capacity
-        else if ( sysCfg.currentOpMode == Storm::Type::OperatingMode::eID_HEATING && sysCfg.numIndoorStages != 0 )
-        {
-            cooling = false;
-            double stageCapacity = 1.0 / sysCfg.numIndoorStages;
-            capacity += relays.w1 ? stageCapacity : 0.0;
-            if ( sysCfg.numIndoorStages > 1 )
-            {
-                capacity += relays.w2 ? stageCapacity : 0.0;
-            }
-            if ( sysCfg.numIndoorStages > 2 )
-            {
-                capacity += relays.w3 ? stageCapacity : 0.0;
-            }
-        }
+        bool   cooling;
+        double capacity = Storm::Utils::SimHouse::getActiveCapacity( sysCfg, relays, cooling );
 
         // Run the simulation
         double idt = m_sim.tick( odt, capacity, cooling );
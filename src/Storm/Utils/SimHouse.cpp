@@ -11,6 +11,8 @@
 /** @file */
 
 #include "SimHouse.h"
+#include "Storm/Type/OperatingMode.h"
+#include "Storm/Type/IduType.h"
 
 using namespace Storm::Utils;
 
@@ -74,3 +76,75 @@ double SimHouse::tick( double currentOdt, double percentActiveCapacity, bool coo
     m_sim.accumulate( inPotential, resistance );
     return m_sim.finish() + m_minOdt;
 }
+
+double SimHouse::getActiveCapacity( const Storm::Type::SystemConfig_T&     sysCfg,
+                                    const Storm::Type::HvacRelayOutputs_T& relays,
+                                    bool&                                  coolingCapacity ) noexcept
+{
+    double capacity = 0.0;
+    coolingCapacity = true;
+
+    // Cooling capacity
+    if ( sysCfg.currentOpMode == Storm::Type::OperatingMode::eCOOLING && sysCfg.numCompressorStages != 0 )
+    {
+        double stageCapacity = 1.0 / sysCfg.numCompressorStages;
+        capacity += relays.y1 ? stageCapacity : 0.0;
+        if ( sysCfg.numCompressorStages > 1 )
+        {
+            capacity += relays.y2 ? stageCapacity : 0.0;
+        }
+    }
+
+    // Compressor + Indoor Heating capacity
+    else if ( sysCfg.currentOpMode == Storm::Type::OperatingMode::eHEATING )
+    {
+        coolingCapacity = false;
+
+        // HeatPump with Electric heat
+        if ( sysCfg.indoorUnitType == Storm::Type::IduType::eAIR_HANDLER && (sysCfg.numCompressorStages + sysCfg.numIndoorStages != 0) )
+        {
+            double stageCapacity = 1.0 / (sysCfg.numCompressorStages + sysCfg.numIndoorStages);
+            capacity += relays.y1 ? stageCapacity : 0.0;
+            if ( sysCfg.numCompressorStages > 1 )
+            {
+                capacity += relays.y2 ? stageCapacity : 0.0;
+            }
+            if ( sysCfg.numIndoorStages > 0 )
+            {
+                capacity += relays.w1 ? stageCapacity : 0.0;
+            }
+            if ( sysCfg.numIndoorStages > 1 )
+            {
+                capacity += relays.w2 ? stageCapacity : 0.0;
+            }
+            if ( sysCfg.numIndoorStages > 2 )
+            {
+                capacity += relays.w3 ? stageCapacity : 0.0;
+            }
+        }
+
+        // DUAL fuel
+        else  if ( sysCfg.indoorUnitType == Storm::Type::IduType::eFURNACE && sysCfg.numCompressorStages != 0 )
+        {
+            // TODO
+        }
+    }
+
+    // Indoor Heating capacity
+    else if ( sysCfg.currentOpMode == Storm::Type::OperatingMode::eID_HEATING && sysCfg.numIndoorStages != 0 )
+    {
+        coolingCapacity = false;
+        double stageCapacity = 1.0 / sysCfg.numIndoorStages;
+        capacity += relays.w1 ? stageCapacity : 0.0;
+        if ( sysCfg.numIndoorStages > 1 )
+        {
+            capacity += relays.w2 ? stageCapacity : 0.0;
+        }
+        if ( sysCfg.numIndoorStages > 2 )
+        {
+            capacity += relays.w3 ? stageCapacity : 0.0;
+        }
+    }
+
+    return capacity;
+}
@@ -13,6 +13,8 @@
 /** @file */
 
 #include "Storm/Utils/SimSystem.h"
+#include "Storm/Type/SystemConfig.h"
+#include "Storm/Type/HvacRelayOutputs.h"
 
 ///
 namespace Storm {
@@ -95,6 +97,15 @@ public:
      */
     double tick( double currentOdt, double percentActiveCapacity, bool coolingCapacity ) noexcept;
 
+public:
+    /** This method returns the percent active capacity (0.0 to 1.0) for the
+        specified system configuration and relay outputs, i.e. the arguments
+        for the tick() method. 'coolingCapacity' is set to true when the
+        active capacity is cooling capacity.
+     */
+    static double getActiveCapacity( const Storm::Type::SystemConfig_T&     sysCfg,
+                                     const Storm::Type::HvacRelayOutputs_T& relays,
+                                     bool&                                  coolingCapacity ) noexcept;
 };
 
 
@@ -0,0 +1,11 @@
+#ifndef COLONY_CONFIG_H_
+#define COLONY_CONFIG_H_
+
+//
+#define USE_CPL_SYSTEM_TRACE
+
+// Use the slice-by-8/carry-less-multiply CRC kernels
+#define USE_CPL_CHECKSUM_ACCELERATED_CRC
+
+
+#endif
@@ -0,0 +1,2 @@
+# share a common main
+../../../main.cpp
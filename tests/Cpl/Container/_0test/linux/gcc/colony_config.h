@@ -1,6 +1,9 @@
 #ifndef COLONY_CONFIG_H_
 #define COLONY_CONFIG_H_
 
+//
+#define USE_CPL_SYSTEM_TRACE
+
 // For C tests
 #define CPL_CONTAINER_ITEM_FATAL_ERROR_HANDLER myFatalErrorHandler
 #ifdef __cplusplus
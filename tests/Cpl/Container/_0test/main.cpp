@@ -1,4 +1,5 @@
 #include "Cpl/System/Api.h"
+#include "Cpl/System/Trace.h"
 #define CATCH_CONFIG_RUNNER  
 #include "Catch/catch.hpp"
 
@@ -6,6 +7,10 @@ int main( int argc, char* argv[] )
 {
     // Initialize Colony
     Cpl::System::Api::initialize();
+    Cpl::System::Api::enableScheduling();
+
+    CPL_SYSTEM_TRACE_ENABLE();
+    CPL_SYSTEM_TRACE_ENABLE_SECTION( "_0test" );
 
     // Run the test(s)
     return Catch::Session().run( argc, argv );
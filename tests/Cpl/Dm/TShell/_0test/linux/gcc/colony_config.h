@@ -7,6 +7,9 @@
 // Enable ASSERT macros
 #define USE_CPL_SYSTEM_ASSERT_MACROS
 
+// Model Point statistics
+#define USE_CPL_DM_MODEL_POINT_STATS
+
 //
 #define MY_DIR_COMMAND	"ls"
 
@@ -0,0 +1,10 @@
+# Unit under test
+#src/Cpl/Dm
+#src/Cpl/Dm/Mp < Uint32.cpp
+
+# tests
+src/Cpl/Dm/_0test
+
+src/Cpl/Io/Stdio/_ansi
+
+
@@ -0,0 +1 @@
+../../../realtime/main.cpp
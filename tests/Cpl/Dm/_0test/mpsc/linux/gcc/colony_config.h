@@ -0,0 +1,11 @@
+#ifndef COLONY_CONFIG_H_
+#define COLONY_CONFIG_H_
+
+//
+#define USE_CPL_SYSTEM_TRACE
+
+// Use the lock-free MPSC queues
+#define USE_CPL_ITC_MAILBOX_MPSC_QUEUE
+#define USE_CPL_DM_EVENT_LOOP_MPSC_QUEUE
+
+#endif
@@ -0,0 +1,10 @@
+#ifndef COLONY_CONFIG_H_
+#define COLONY_CONFIG_H_
+
+//
+#define USE_CPL_SYSTEM_TRACE
+
+// Event Loop profiling
+#define USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+
+#endif
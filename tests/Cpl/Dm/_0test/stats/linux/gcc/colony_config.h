@@ -0,0 +1,10 @@
+#ifndef COLONY_CONFIG_H_
+#define COLONY_CONFIG_H_
+
+//
+#define USE_CPL_SYSTEM_TRACE
+
+// Model Point statistics
+#define USE_CPL_DM_MODEL_POINT_STATS
+
+#endif
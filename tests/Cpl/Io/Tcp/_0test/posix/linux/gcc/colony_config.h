@@ -0,0 +1,10 @@
+#ifndef COLONY_CONFIG_H_
+#define COLONY_CONFIG_H_
+
+//
+#define USE_CPL_SYSTEM_TRACE
+
+// Set Posix/Linux
+#define TESTING_POSIX
+
+#endif
@@ -0,0 +1,14 @@
+# Unit under test
+src/Cpl/Io/Tcp/Posix
+
+# tests
+src/Cpl/Io/Tcp/Posix/_0test
+
+
+# Platforms
+src/Cpl/Io/Stdio/_posix
+[cpp11] /top/libdirs/platform_cpp11_default_for_test_libdirs.b
+[cpp11] /top/libdirs/platform_cpp11_default_realtime_libdirs.b
+[posix|posix64] /top/libdirs/platform_posix_default_for_test_libdirs.b
+[posix|posix64] /top/libdirs/platform_posix_default_realtime_libdirs.b
+/top/libdirs/platform_posix_always_libdirs.b
@@ -0,0 +1,7 @@
+# Unit under test
+#src/Cpl/Itc
+
+# tests
+src/Cpl/Itc/_0test   > simmvc.cpp
+
+src/Cpl/Io/Stdio/_ansi
@@ -0,0 +1,3 @@
+# Use common (across compilers) libdirs.b
+../../libdirs.b
+../libdirs.b
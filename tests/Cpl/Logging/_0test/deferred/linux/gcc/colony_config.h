@@ -0,0 +1,10 @@
+#ifndef COLONY_CONFIG_H_
+#define COLONY_CONFIG_H_
+
+//
+#define USE_CPL_SYSTEM_TRACE
+
+// Defer the formatting of the log entry text to the log sink
+#define USE_CPL_LOGGING_DEFERRED_FORMATTING
+
+#endif
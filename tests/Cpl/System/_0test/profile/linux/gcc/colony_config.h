@@ -0,0 +1,12 @@
+#ifndef COLONY_CONFIG_H_
+#define COLONY_CONFIG_H_
+
+//
+#define USE_CPL_SYSTEM_TRACE
+
+// Event Loop profiling
+#define USE_CPL_SYSTEM_EVENT_LOOP_PROFILE
+//
+#define MY_DIR_COMMAND	"ls"
+
+#endif
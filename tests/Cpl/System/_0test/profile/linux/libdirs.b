@@ -0,0 +1,17 @@
+# Unit under test
+#src/Cpl/System
+#src/Cpl/System/_trace
+#src/Cpl/System/_trace/_stdout
+
+# tests
+src/Cpl/System/_0test
+
+
+# Platforms
+src/Cpl/Io/Stdio/_ansi
+[cpp11] /top/libdirs/platform_cpp11_default_for_test_libdirs.b
+[cpp11] /top/libdirs/platform_cpp11_default_realtime_libdirs.b
+[posix|posix64] /top/libdirs/platform_posix_default_for_test_libdirs.b
+[posix|posix64] /top/libdirs/platform_posix_default_realtime_libdirs.b
+/top/libdirs/platform_posix_always_libdirs.b
+
@@ -3,6 +3,10 @@
 
 //
 #define USE_CPL_SYSTEM_TRACE
+
+// Lock-free trace buffers and call-site caches
+#define USE_CPL_SYSTEM_TRACE_LOCK_FREE
+
 //
 #define MY_DIR_COMMAND	"ls"
 
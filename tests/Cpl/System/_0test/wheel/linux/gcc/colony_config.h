@@ -0,0 +1,13 @@
+#ifndef COLONY_CONFIG_H_
+#define COLONY_CONFIG_H_
+
+//
+#define USE_CPL_SYSTEM_TRACE
+
+// Use the timing wheel implementation of the Timer Manager
+#define USE_CPL_SYSTEM_TIMER_MANAGER_TIMING_WHEEL
+
+//
+#define MY_DIR_COMMAND	"ls"
+
+#endif
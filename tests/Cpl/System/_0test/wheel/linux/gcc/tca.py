@@ -0,0 +1,16 @@
+#!/usr/bin/python3
+"""Invokes NQBP's tca_base.py script"""
+
+import os
+import sys
+
+# Make sure the environment is properly set
+NQBP_BIN = os.environ.get('NQBP_BIN')
+if ( NQBP_BIN == None ):
+    sys.exit( "ERROR: The environment variable NQBP_BIN is not set!" )
+sys.path.append( NQBP_BIN )
+
+# Find the Package & Workspace root
+from other import tca_base
+tca_base.run( sys.argv )
+
@@ -0,0 +1,2 @@
+# Use common (across compilers) libdirs.b
+../libdirs.b
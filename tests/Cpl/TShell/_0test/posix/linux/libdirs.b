@@ -0,0 +1,19 @@
+# Unit under test
+src/Cpl/TShell/Posix
+src/Cpl/TShell
+src/Cpl/TShell/Cmd
+
+# tests
+src/Cpl/TShell/Posix/_0test
+
+# supporting infrastructure
+src/Cpl/Io/Tcp/Posix
+src/Cpl/Text/Frame
+
+# Platforms
+src/Cpl/Io/Stdio/_posix
+[cpp11] /top/libdirs/platform_cpp11_default_for_test_libdirs.b
+[cpp11] /top/libdirs/platform_cpp11_default_realtime_libdirs.b
+[posix|posix64] /top/libdirs/platform_posix_default_for_test_libdirs.b
+[posix|posix64] /top/libdirs/platform_posix_default_realtime_libdirs.b
+/top/libdirs/platform_posix_always_libdirs.b
@@ -1,6 +1,8 @@
 #ifndef COLONY_CONFIG_H_
 #define COLONY_CONFIG_H_
 
-// No Config/Options required
+//
+#define USE_CPL_SYSTEM_TRACE
+
 
 #endif
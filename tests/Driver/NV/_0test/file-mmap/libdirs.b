@@ -0,0 +1,5 @@
+# UUT
+src/Driver/NV/File/Mmap
+
+# Baseline (for the benchmark)
+src/Driver/NV/File/Cpl
@@ -0,0 +1,124 @@
+#include "Cpl/System/Api.h"
+#include "Cpl/System/Trace.h"
+#include "Driver/NV/_0test/test.h"
+#include "Driver/NV/File/Mmap/Api.h"
+#include "Driver/NV/File/Cpl/Api.h"
+#include <string.h>
+
+#define SECT_           "_0test"
+
+#define NUM_BENCH_RECORDS_  20000
+
+static Driver::NV::File::Mmap::Api uut_;
+
+
+/// Mmap specific tests: dirty page tracking, and the file format
+static int testMmap()
+{
+    Driver::NV::File::Mmap::Api uut( OPTION_DRIVER_NV_FILE_MMAP_NUM_PAGES, OPTION_DRIVER_NV_FILE_MMAP_BYTES_PER_PAGE, OPTION_DRIVER_NV_FILE_MMAP_FILE_NAME, Driver::NV::File::Mmap::Api::eSYNC_ON_STOP );
+    uint8_t                     buffer[OPTION_DRIVER_NV_FILE_MMAP_BYTES_PER_PAGE * 2];
+    uint8_t                     buffer2[sizeof( buffer )];
+    if ( !uut.start() || uut.start() )
+    {
+        CPL_SYSTEM_TRACE_MSG( SECT_, ("FAILED: start") );
+        return 1;
+    }
+
+    // Write that spans 3 pages
+    memset( buffer, 0x5A, sizeof( buffer ) );
+    size_t offset = OPTION_DRIVER_NV_FILE_MMAP_BYTES_PER_PAGE + 1;
+    if ( !uut.write( offset, buffer, sizeof( buffer ) ) || uut.getNumDirtyPages() != 3 )
+    {
+        CPL_SYSTEM_TRACE_MSG( SECT_, ("FAILED: dirty pages. Expected 3, actual=%lu", uut.getNumDirtyPages()) );
+        return 1;
+    }
+
+    // Re-writing the same content does not dirty a page
+    if ( !uut.flush() || uut.getNumDirtyPages() != 0 || !uut.write( offset, buffer, sizeof( buffer ) ) || uut.getNumDirtyPages() != 0 )
+    {
+        CPL_SYSTEM_TRACE_MSG( SECT_, ("FAILED: no-change write. Dirty pages=%lu", uut.getNumDirtyPages()) );
+        return 1;
+    }
+
+    // The content is persistent - and readable by the Cpl::Io::File driver (i.e. same file format)
+    buffer[0] = 0xA5;
+    if ( !uut.write( offset, buffer, 1 ) || uut.getNumDirtyPages() != 1 )
+    {
+        CPL_SYSTEM_TRACE_MSG( SECT_, ("FAILED: single byte write") );
+        return 1;
+    }
+    uut.stop();
+    if ( uut.getNumDirtyPages() != 0 || uut.read( offset, buffer2, 1 ) )
+    {
+        CPL_SYSTEM_TRACE_MSG( SECT_, ("FAILED: stop") );
+        return 1;
+    }
+    Driver::NV::File::Cpl::Api fileDriver( OPTION_DRIVER_NV_FILE_MMAP_NUM_PAGES, OPTION_DRIVER_NV_FILE_MMAP_BYTES_PER_PAGE, OPTION_DRIVER_NV_FILE_MMAP_FILE_NAME );
+    memset( buffer2, 0, sizeof( buffer2 ) );
+    if ( !fileDriver.start() || !fileDriver.read( offset, buffer2, sizeof( buffer2 ) ) || memcmp( buffer, buffer2, sizeof( buffer ) ) != 0 )
+    {
+        CPL_SYSTEM_TRACE_MSG( SECT_, ("FAILED: file format") );
+        return 1;
+    }
+    fileDriver.stop();
+
+    CPL_SYSTEM_TRACE_MSG( SECT_, ("Mmap tests PASSED") );
+    return 0;
+}
+
+/// Compare save/load throughput against the Cpl::Io::File driver
+static int benchmark()
+{
+    Driver::NV::File::Cpl::Api  fileDriver;
+    Driver::NV::File::Mmap::Api immediate( OPTION_DRIVER_NV_FILE_MMAP_NUM_PAGES, OPTION_DRIVER_NV_FILE_MMAP_BYTES_PER_PAGE, OPTION_DRIVER_NV_FILE_MMAP_FILE_NAME, Driver::NV::File::Mmap::Api::eSYNC_IMMEDIATE );
+    Driver::NV::File::Mmap::Api deferred( OPTION_DRIVER_NV_FILE_MMAP_NUM_PAGES, OPTION_DRIVER_NV_FILE_MMAP_BYTES_PER_PAGE, OPTION_DRIVER_NV_FILE_MMAP_FILE_NAME, Driver::NV::File::Mmap::Api::eSYNC_DEFERRED );
+    Driver::NV::File::Mmap::Api onStop( OPTION_DRIVER_NV_FILE_MMAP_NUM_PAGES, OPTION_DRIVER_NV_FILE_MMAP_BYTES_PER_PAGE, OPTION_DRIVER_NV_FILE_MMAP_FILE_NAME, Driver::NV::File::Mmap::Api::eSYNC_ON_STOP );
+    struct { Driver::NV::Api* uut; const char* label; } drivers[] ={
+        { &fileDriver, "File::Cpl" },
+        { &immediate,  "Mmap (immediate)" },
+        { &deferred,   "Mmap (deferred)" },
+        { &onStop,     "Mmap (on stop)" },
+    };
+
+    static const size_t recordSizes[] ={ 64, 512, 4096 };
+    for ( size_t r=0; r < sizeof( recordSizes ) / sizeof( recordSizes[0] ); r++ )
+    {
+        for ( size_t i=0; i < sizeof( drivers ) / sizeof( drivers[0] ); i++ )
+        {
+            if ( !drivers[i].uut->start() || runbenchmark( *drivers[i].uut, drivers[i].label, recordSizes[r], NUM_BENCH_RECORDS_ ) != 0 )
+            {
+                return 1;
+            }
+            drivers[i].uut->stop();
+        }
+    }
+    return 0;
+}
+
+
+int main( int argc, char* argv[] )
+{
+    // Initialize Colony
+    Cpl::System::Api::initialize();
+    Cpl::System::Api::enableScheduling();
+
+    CPL_SYSTEM_TRACE_ENABLE();
+    CPL_SYSTEM_TRACE_ENABLE_SECTION( "_0test" );
+    CPL_SYSTEM_TRACE_SET_INFO_LEVEL( Cpl::System::Trace::eVERBOSE );
+
+    // Run the test(s)
+    int result = runtests( uut_,
+                           OPTION_DRIVER_NV_FILE_MMAP_NUM_PAGES,
+                           OPTION_DRIVER_NV_FILE_MMAP_BYTES_PER_PAGE,
+                           OPTION_DRIVER_NV_FILE_MMAP_NUM_PAGES * OPTION_DRIVER_NV_FILE_MMAP_BYTES_PER_PAGE );
+    uut_.stop();
+    if ( result == 0 )
+    {
+        result = testMmap();
+    }
+    if ( result == 0 )
+    {
+        result = benchmark();
+    }
+    return result;
+}
@@ -0,0 +1,4 @@
+# Use common (across compilers) libdirs.b
+../../../libdirs.b
+../../../../libdirs.b
+../libdirs.b
@@ -0,0 +1,2 @@
+# use common main.cpp
+../../../main.cpp
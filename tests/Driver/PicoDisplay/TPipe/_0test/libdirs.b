@@ -0,0 +1,8 @@
+# Test App
+src/Driver/PicoDisplay/TPipe/_0test
+
+# Unit under test
+src/Driver/PicoDisplay/TPipe < DirtyRects.cpp
+
+# support
+src/Cpl/Text/Encoding
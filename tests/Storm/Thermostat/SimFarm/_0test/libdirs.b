@@ -0,0 +1,17 @@
+# UUT
+src/Storm/Thermostat/SimFarm
+
+# Test(s)
+src/Storm/Thermostat/SimFarm/_0test
+
+# Application
+src/Storm/Component
+src/Storm/Component/Equipment
+src/Storm/Component/Equipment/Stage
+
+# infrastructure
+src/Storm/Type
+src/Storm/Dm
+src/Storm/Utils
+src/Cpl/Io/File
+src/Cpl/Math
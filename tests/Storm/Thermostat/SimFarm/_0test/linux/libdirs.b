@@ -0,0 +1,11 @@
+# Platforms
+src/Cpl/Io/File/_posix
+src/Cpl/Io/File/_posix/_api
+src/Cpl/Io/Stdio/_posix
+
+[cpp11] /top/libdirs/platform_cpp11_default_for_test_libdirs.b
+[cpp11] /top/libdirs/platform_cpp11_default_realtime_libdirs.b
+[posix|posix64] /top/libdirs/platform_posix_default_for_test_libdirs.b
+[posix|posix64] /top/libdirs/platform_posix_default_realtime_libdirs.b
+
+/top/libdirs/platform_posix_always_libdirs.b